@@ -21,7 +21,7 @@ git clone ${DOWNLOADURL}
 # build lib
 cd ${DIRNAME}
 ./autogen.sh
-./configure --prefix=${CURDIR}/${INSTALLDIR} --disable-shared --enable-static
+./configure --prefix=${CURDIR}/${INSTALLDIR} --disable-shared --enable-static --enable-module-recovery --enable-module-ecdh --enable-module-extrakeys --enable-module-schnorrsig
 make
 make install
 cd ..
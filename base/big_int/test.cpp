@@ -1,7 +1,431 @@
 #include "arith_uint256.h"
+#include "tinyformat.h"
+#include "uint256.h"
+#include "utilstrencodings.h"
+#undef NDEBUG
+#include <assert.h>
 #include <iostream>
+#include <locale.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 
+// The result must not depend on where the first mismatch is: flip each
+// byte in turn, covering every word lane and the byte tail.
+static void test_constant_time()
+{
+  for (size_t len = 1; len <= 67; len++) {
+    std::vector<unsigned char> a(len), b;
+    for (size_t i = 0; i < len; i++)
+      a[i] = (unsigned char)(i * 37 + 11);
+    b = a;
+    assert(ConstantTimeEqual(a.data(), b.data(), len));
+    assert(TimingResistantEqual(a, b));
+    for (size_t pos = 0; pos < len; pos++) {
+      for (int bit = 0; bit < 8; bit++) {
+        b[pos] ^= 1 << bit;
+        assert(!ConstantTimeEqual(a.data(), b.data(), len));
+        assert(!TimingResistantEqual(a, b));
+        b[pos] ^= 1 << bit;
+      }
+    }
+
+    std::vector<unsigned char> zero(len, 0), out(len);
+    assert(ConstantTimeIsZero(zero.data(), len));
+    for (size_t pos = 0; pos < len; pos++) {
+      zero[pos] = 0x80;
+      assert(!ConstantTimeIsZero(zero.data(), len));
+      zero[pos] = 0;
+    }
+    ConstantTimeSelect(out.data(), a.data(), zero.data(), len, true);
+    assert(out == a);
+    ConstantTimeSelect(out.data(), a.data(), zero.data(), len, false);
+    assert(out == zero);
+    ConstantTimeCopy(out.data(), a.data(), len, false);
+    assert(out == zero);
+    ConstantTimeCopy(out.data(), a.data(), len, true);
+    assert(out == a);
+  }
+
+  // Length mismatches are never equal, whichever side is longer.
+  assert(!TimingResistantEqual(std::string("abc"), std::string("abcabc")));
+  assert(!TimingResistantEqual(std::string("abcabc"), std::string("abc")));
+  assert(!TimingResistantEqual(std::string(""), std::string("a")));
+  assert(TimingResistantEqual(std::string(""), std::string("")));
+
+  uint256 h1 = uint256S("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+  for (int pos = 0; pos < 32; pos++) {
+    uint256 h2 = h1;
+    *(h2.begin() + pos) ^= 1;
+    assert(!TimingResistantEqual(h1, h2));
+  }
+  assert(TimingResistantEqual(h1, uint256(h1)));
+  assert(uint256().IsNullConstantTime() && !h1.IsNullConstantTime());
+  std::cout << "constant time: ok" << std::endl;
+}
+
+// Every split of the input across two Update() calls must give the same
+// result as the one-shot functions, including splits inside a hex pair or
+// a base64/base32 group.
+static void test_streaming_codecs()
+{
+  std::vector<unsigned char> data;
+  for (int i = 0; i < 23; i++)
+    data.push_back((unsigned char)(i * 89 + 7));
+
+  for (size_t len = 0; len <= data.size(); len++) {
+    const std::string hex = HexStr(data.begin(), data.begin() + len);
+    const std::string b64 = EncodeBase64(data.data(), len);
+    const std::string b32 = EncodeBase32(data.data(), len);
+    const std::vector<unsigned char> want(data.begin(), data.begin() + len);
+    for (size_t split = 0; split <= len; split++) {
+      std::string out;
+      HexEncoder hex_enc;
+      hex_enc.Update(data.data(), split, out);
+      hex_enc.Update(data.data() + split, len - split, out);
+      assert(out == hex);
+
+      out.clear();
+      Base64Encoder b64_enc;
+      b64_enc.Update(data.data(), split, out);
+      b64_enc.Update(data.data() + split, len - split, out);
+      b64_enc.Finalize(out);
+      assert(out == b64);
+
+      out.clear();
+      Base32Encoder b32_enc;
+      b32_enc.Update(data.data(), split, out);
+      b32_enc.Update(data.data() + split, len - split, out);
+      b32_enc.Finalize(out);
+      assert(out == b32);
+    }
+    for (size_t split = 0; split <= hex.size(); split++) {
+      std::vector<unsigned char> vch;
+      HexDecoder dec;
+      bool ok = dec.Update(hex.data(), split, vch);
+      ok = dec.Update(hex.data() + split, hex.size() - split, vch) && ok;
+      ok = dec.Finalize() && ok;
+      assert(ok && vch == want && dec.Consumed() == hex.size());
+    }
+    for (size_t split = 0; split <= b64.size(); split++) {
+      std::vector<unsigned char> vch;
+      Base64Decoder dec;
+      bool ok = dec.Update(b64.data(), split, vch);
+      ok = dec.Update(b64.data() + split, b64.size() - split, vch) && ok;
+      ok = dec.Finalize() && ok;
+      assert(ok && vch == want);
+    }
+    for (size_t split = 0; split <= b32.size(); split++) {
+      std::vector<unsigned char> vch;
+      Base32Decoder dec;
+      bool ok = dec.Update(b32.data(), split, vch);
+      ok = dec.Update(b32.data() + split, b32.size() - split, vch) && ok;
+      ok = dec.Finalize() && ok;
+      assert(ok && vch == want);
+    }
+  }
+
+  // One byte at a time carries the partial group through every state
+  {
+    std::string out;
+    Base64Encoder enc;
+    for (unsigned char c : data)
+      enc.Update(&c, 1, out);
+    enc.Finalize(out);
+    assert(out == EncodeBase64(data.data(), data.size()));
+    std::string str;
+    Base64Decoder dec;
+    bool ok = true;
+    for (char c : out)
+      ok = dec.Update(&c, 1, str) && ok;
+    ok = dec.Finalize() && ok;
+    assert(ok && str == std::string(data.begin(), data.end()));
+  }
+
+  // Padding
+  {
+    std::string str;
+    Base64Decoder b64;
+    bool ok = b64.Update("Zm9vYg==", 8, str);
+    ok = b64.Finalize() && ok;
+    assert(ok && str == "foob");
+    b64.Reset();
+    str.clear();
+    ok = b64.Update("Zm9vYg", 6, str);
+    const bool finalized = b64.Finalize();
+    assert(ok && !finalized);
+    Base32Decoder b32;
+    str.clear();
+    ok = b32.Update("mzxw6===", 8, str);
+    ok = b32.Finalize() && ok;
+    assert(ok && str == "foo");
+  }
+
+  // The offset of the first bad character is reported wherever the input is split
+  const std::string bad_hex = "00ff 12g4";
+  const std::string bad_b64 = "Zm9v!mFy";
+  const std::string after_pad = "Zg==Zg==";
+  for (size_t split = 0; split <= bad_hex.size(); split++) {
+    std::vector<unsigned char> vch;
+    HexDecoder dec;
+    dec.Update(bad_hex.data(), split, vch);
+    dec.Update(bad_hex.data() + split, bad_hex.size() - split, vch);
+    const bool finalized = dec.Finalize();
+    assert(dec.Failed() && dec.ErrorOffset() == 7 && !finalized);
+  }
+  for (size_t split = 0; split <= bad_b64.size(); split++) {
+    std::vector<unsigned char> vch;
+    Base64Decoder dec;
+    dec.Update(bad_b64.data(), split, vch);
+    dec.Update(bad_b64.data() + split, bad_b64.size() - split, vch);
+    const bool finalized = dec.Finalize();
+    assert(dec.Failed() && dec.ErrorOffset() == 4 && !finalized);
+
+    dec.Reset();
+    vch.clear();
+    dec.Update(after_pad.data(), split, vch);
+    dec.Update(after_pad.data() + split, after_pad.size() - split, vch);
+    assert(dec.Failed() && dec.ErrorOffset() == 4);
+  }
+  {
+    // Whitespace only between pairs, never inside one
+    std::vector<unsigned char> vch;
+    HexDecoder dec;
+    bool ok = dec.Update("0 0", 3, vch);
+    assert(!ok && dec.ErrorOffset() == 1);
+    dec.Reset();
+    ok = dec.Update("abc", 3, vch);
+    ok = dec.Finalize() && ok;
+    assert(!ok);
+  }
+  {
+    // The container overloads only grow to the decoded size, not the input size
+    const std::string b64(4000, 'A');
+    std::vector<unsigned char> vch;
+    Base64Decoder dec;
+    const bool ok = dec.Update(b64.data(), b64.size(), vch);
+    assert(ok && vch.size() == 3000);
+    assert(vch.capacity() <= 3002);
+  }
+  std::cout << "streaming codecs: ok" << std::endl;
+}
+
+// The buffer and fd variants must write exactly what the std::string
+// overload returns, byte and code point widths alike.
+static void test_paragraph()
+{
+  // Two columns a word with utf8, four bytes without
+  assert(FormatParagraph(std::string("\xc3\xa4\xc3\xb6 \xc3\xa4\xc3\xb6 \xc3\xa4\xc3\xb6"), 5, 0, true) ==
+         "\xc3\xa4\xc3\xb6 \xc3\xa4\xc3\xb6\n\xc3\xa4\xc3\xb6");
+  assert(FormatParagraph(std::string("\xc3\xa4\xc3\xb6 \xc3\xa4\xc3\xb6 \xc3\xa4\xc3\xb6"), 5, 0, false) ==
+         "\xc3\xa4\xc3\xb6\n\xc3\xa4\xc3\xb6\n\xc3\xa4\xc3\xb6");
+
+  std::string text;
+  for (int i = 0; i < 800; i++) {
+    text += i % 3 ? "gr\xc3\xbc\xc3\x9f" : (i % 5 ? "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e" : "word");
+    text += i % 17 == 16 ? "\n" : " ";
+  }
+  char path[] = "/tmp/niuparagraphXXXXXX";
+  const int fd = mkstemp(path);
+  assert(fd >= 0);
+  unlink(path);
+  for (size_t width : {5, 12, 40, 79}) {
+    for (size_t indent : {0, 4}) {
+      for (bool utf8 : {false, true}) {
+        const std::string want = FormatParagraph(text, width, indent, utf8);
+        std::vector<char> buf(want.size() + 8, 'x');
+        size_t size = FormatParagraph(buf.data(), buf.size(), text.data(), text.size(), width, indent, utf8);
+        assert(size == want.size());
+        assert(std::string(buf.data(), want.size()) == want && buf[want.size()] == 'x');
+        // Truncated, but still the full size back
+        size = FormatParagraph(buf.data(), 10, text.data(), text.size(), width, indent, utf8);
+        assert(size == want.size());
+        assert(std::string(buf.data(), 10) == want.substr(0, 10));
+
+        // Larger than WriteParagraph()'s stack buffer, so it flushes on the way
+        const int truncated = ftruncate(fd, 0);
+        const off_t pos = lseek(fd, 0, SEEK_SET);
+        assert(truncated == 0 && pos == 0);
+        const bool ok = WriteParagraph(fd, text, width, indent, utf8);
+        assert(ok);
+        std::string written(want.size() + 1, '\0');
+        const ssize_t read = pread(fd, &written[0], written.size(), 0);
+        assert(read == (ssize_t)want.size());
+        written.resize(want.size());
+        assert(written == want);
+      }
+    }
+  }
+  close(fd);
+  const bool ok = WriteParagraph(-1, text);
+  assert(!ok);
+  std::cout << "paragraph: ok" << std::endl;
+}
+
+// ep points into in, so in has to outlive it
+static bool Parse(const char* in, Endpoint& ep, uint16_t default_port = 0)
+{
+  return ParseEndpoint(in, strlen(in), ep, default_port);
+}
+
+static void test_endpoint()
+{
+  Endpoint ep;
+  bool ok = Parse("[2001:db8::1]:8333", ep);
+  assert(ok && ep.Host() == "2001:db8::1" && ep.port == 8333 && ep.type == Endpoint::HOST_IPV6);
+  ok = Parse("[::ffff:1.2.3.4]:1", ep);
+  assert(ok && ep.Host() == "::ffff:1.2.3.4" && ep.port == 1);
+  // No port takes the default, bracketed or not
+  ok = Parse("[::1]", ep, 18333);
+  assert(ok && ep.Host() == "::1" && ep.port == 18333 && ep.type == Endpoint::HOST_IPV6);
+  ok = Parse("fe80::1:2", ep, 7);
+  assert(ok && ep.Host() == "fe80::1:2" && ep.port == 7 && ep.type == Endpoint::HOST_IPV6);
+  ok = Parse("10.0.0.1", ep, 8333);
+  assert(ok && ep.port == 8333 && ep.type == Endpoint::HOST_IPV4);
+  ok = Parse("seed.niublock.org:65535", ep);
+  assert(ok && ep.Host() == "seed.niublock.org" && ep.port == 65535 && ep.type == Endpoint::HOST_NAME);
+
+  // A colon promises a port, and it has to fit in 16 bits
+  const char* bad[] = {"[::1]:", "host:", "1.2.3.4:", "host:65536", "[::1]:99999", "host:-1",
+                       "host:80a", "host: 80", "[::1]8333", "[::1", "[1.2.3.4]:80", "1.2.3.256",
+                       "2001:db8::1::2", "", "[]:80", "bad host:80", "host:0"};
+  for (const char* in : bad) {
+    ep.port = 42;
+    ok = Parse(in, ep);
+    assert(!ok && ep.port == 42);
+  }
+
+  // One per line: blanks, comments, surrounding whitespace and CRLF are all fine
+  const std::string list = "# peers\n\n  [::1]:1  \r\n1.2.3.4:2\nhost:\n\t\n#[::1]:3\nname\r\n[::1]:70000\n";
+  std::vector<Endpoint> eps;
+  std::vector<size_t> bad_lines;
+  size_t failed = ParseEndpoints(list.data(), list.size(), eps, 9, &bad_lines);
+  assert(failed == 2);
+  assert(bad_lines == std::vector<size_t>({5, 9}));
+  assert(eps.size() == 3);
+  assert(eps[0].Host() == "::1" && eps[0].port == 1);
+  assert(eps[1].Host() == "1.2.3.4" && eps[1].port == 2);
+  assert(eps[2].Host() == "name" && eps[2].port == 9);
+  // Appended to what is already there, and no trailing newline needed
+  failed = ParseEndpoints("a:1\nb", 5, eps);
+  assert(failed == 0 && eps.size() == 5 && eps[4].Host() == "b");
+  failed = ParseEndpoints("", 0, eps);
+  failed += ParseEndpoints("\n\n", 2, eps);
+  assert(failed == 0 && eps.size() == 5);
+  std::cout << "endpoint: ok" << std::endl;
+}
+
+// The digit-pair writers must agree with tinyformat at every digit-count
+// boundary and at both ends of the 64-bit range.
+static void test_int_to_str()
+{
+  const uint64_t unsigned_cases[] = {0, 9, 10, 99, 100, 999, 1000, 4294967295ULL, 4294967296ULL,
+                                     9999999999999999999ULL, 10000000000000000000ULL, UINT64_MAX};
+  char buf[INTSTR_MAX_SIZE];
+  for (uint64_t n : unsigned_cases) {
+    const size_t len = WriteUInt64(buf, n);
+    assert(std::string(buf, len) == tfm::format("%u", n));
+    assert(u64tostr(n) == tfm::format("%u", n));
+    assert(u64tohex(n) == tfm::format("%x", n));
+  }
+  assert(u64tostr(UINT64_MAX) == "18446744073709551615");
+
+  const int64_t signed_cases[] = {0, 9, 10, 99, 100, -1, -9, -10, -99, -100, INT64_MAX, INT64_MIN, INT64_MIN + 1};
+  for (int64_t n : signed_cases) {
+    const size_t len = WriteInt64(buf, n);
+    assert(std::string(buf, len) == tfm::format("%d", n));
+    assert(i64tostr(n) == tfm::format("%d", n));
+  }
+  assert(i64tostr(INT64_MIN) == "-9223372036854775808" && i64tostr(INT64_MAX) == "9223372036854775807");
+  assert(itostr(INT32_MIN) == tfm::format("%d", INT32_MIN) && itostr(INT32_MAX) == tfm::format("%d", INT32_MAX));
+
+  // width pads with zeros, never truncates, and is capped at 16 digits
+  size_t len = WriteHex64(buf, 0, 0);
+  assert(std::string(buf, len) == "0");
+  len = WriteHex64(buf, 0xabc, 0);
+  assert(std::string(buf, len) == tfm::format("%x", 0xabc));
+  len = WriteHex64(buf, 0xabc, 8);
+  assert(std::string(buf, len) == tfm::format("%08x", 0xabc));
+  len = WriteHex64(buf, 0x123456789aULL, 8);
+  assert(std::string(buf, len) == tfm::format("%08x", 0x123456789aULL));
+  len = WriteHex64(buf, 0xabc, 40);
+  assert(std::string(buf, len) == tfm::format("%016x", 0xabc));
+  len = WriteHex64(buf, UINT64_MAX, 40);
+  assert(std::string(buf, len) == "ffffffffffffffff");
+  assert(u64tohex(1, 8) == "00000001");
+  std::cout << "int to str: ok" << std::endl;
+}
+
+// TINYFORMAT_FMT() call sites are parsed once into ParsedFormat; what they
+// print must not differ from the runtime parser.
+static void test_static_format()
+{
+  const std::string hash = "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f";
+  assert(strprintf(TINYFORMAT_FMT("")) == tfm::format(""));
+  assert(strprintf(TINYFORMAT_FMT("no specs, 100%% literal")) == "no specs, 100% literal");
+  assert(strprintf(TINYFORMAT_FMT("%%%%")) == tfm::format("%%%%"));
+  assert(strprintf(TINYFORMAT_FMT("height=%d hash=%s\n"), 5, hash) == tfm::format("height=%d hash=%s\n", 5, hash));
+  for (int i = -3; i <= 3; i++) {
+    const double d = i * 12.345678;
+    assert(strprintf(TINYFORMAT_FMT("[%5d|%-5d|%05d|% d|%+d]"), i, i, i, i, i) ==
+           tfm::format("[%5d|%-5d|%05d|% d|%+d]", i, i, i, i, i));
+    assert(strprintf(TINYFORMAT_FMT("%x %X %#o %c %.3s %10s"), i & 0xff, i + 300, i + 8, 'a' + i, hash, "r") ==
+           tfm::format("%x %X %#o %c %.3s %10s", i & 0xff, i + 300, i + 8, 'a' + i, hash, "r"));
+    assert(strprintf(TINYFORMAT_FMT("%.8g %e %f % .2f tail %% end"), d, d, d, d) ==
+           tfm::format("%.8g %e %f % .2f tail %% end", d, d, d, d));
+    // '*' falls back to the runtime parser
+    assert(strprintf(TINYFORMAT_FMT("%*d|%.*f"), i + 4, i, 2, d) == tfm::format("%*d|%.*f", i + 4, i, 2, d));
+  }
+
+  // %p of a char* prints the address, as operator<< does for void*
+  const char* ptr = hash.c_str() + 3;
+  std::ostringstream addr;
+  addr << (const void*)ptr;
+  assert(tfm::format("%p", ptr) == addr.str() && strprintf(TINYFORMAT_FMT("%p"), ptr) == addr.str());
+
+  // The stream overload leaves the stream's own state as it found it
+  std::ostringstream out, ref;
+  out << std::hex;
+  ref << std::hex;
+  tfm::format(out, TINYFORMAT_FMT("no specs"));
+  tfm::format(out, TINYFORMAT_FMT("%d-%s|"), 255, "ff");
+  tfm::format(ref, "no specs");
+  tfm::format(ref, "%d-%s|", 255, "ff");
+  out << 255;
+  ref << 255;
+  assert(out.str() == ref.str() && out.str() == "no specs255-ff|ff");
+  std::cout << "static format: ok" << std::endl;
+}
+
+// Floats are formatted in the classic locale whatever LC_NUMERIC the
+// process has selected, as the ostream backend did.
+static void test_format_locale()
+{
+  // "" picks up LC_ALL/LC_NUMERIC from the environment, as daemons calling
+  // setlocale(LC_ALL, "") do
+  const char* const candidates[] = {"", "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR"};
+  const char* found = nullptr;
+  for (const char* name : candidates) {
+    char buf[16];
+    if (setlocale(LC_NUMERIC, name) && (snprintf(buf, sizeof(buf), "%.2f", 1.5), std::string(buf) != "1.50")) {
+      found = name;
+      break;
+    }
+  }
+  if (!found) {
+    setlocale(LC_NUMERIC, "C");
+    std::cout << "format locale: skipped, no locale with another decimal point" << std::endl;
+    return;
+  }
+  assert(tfm::format("%.2f", 1.5) == "1.50");
+  assert(tfm::format("%g|%e|%10.3f", 0.25, 1.5, -2.5) == "0.25|1.500000e+00|    -2.500");
+  assert(strprintf(TINYFORMAT_FMT("%.2f"), 1.5) == "1.50");
+  assert(tfm::format("%f", 1e300).find(',') == std::string::npos);
+  setlocale(LC_NUMERIC, "C");
+  std::cout << "format locale: ok (" << (*found ? found : "from environment") << ")" << std::endl;
+}
 
 int main()
 {
@@ -9,4 +433,12 @@ int main()
   arith_uint256 b(std::string("1"));
   t += b;
   std::cout << "t + b: " << t.ToString() << std::endl;
+
+  test_constant_time();
+  test_streaming_codecs();
+  test_paragraph();
+  test_endpoint();
+  test_int_to_str();
+  test_static_format();
+  test_format_locale();
 }
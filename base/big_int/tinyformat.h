@@ -134,9 +134,14 @@ namespace tfm = tinyformat;
 // Implementation details.
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <locale.h>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 
 #ifndef TINYFORMAT_ERROR
 #   define TINYFORMAT_ERROR(reason) assert(0 && reason)
@@ -162,6 +167,15 @@ namespace tfm = tinyformat;
 #   define TINYFORMAT_HIDDEN
 #endif
 
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(_GNU_SOURCE)
+//  newlocale/uselocale switch the locale of one thread only.  Elsewhere the
+//  decimal point snprintf wrote is put back to '.' after the call.
+#   define TINYFORMAT_USE_USELOCALE
+#   ifdef __APPLE__
+#       include <xlocale.h>
+#   endif
+#endif
+
 namespace tinyformat {
 
 class format_error: public std::runtime_error
@@ -366,6 +380,390 @@ TINYFORMAT_DEFINE_FORMATVALUE_CHAR(unsigned char)
 #undef TINYFORMAT_DEFINE_FORMATVALUE_CHAR
 
 
+//------------------------------------------------------------------------------
+// Buffer formatting backend (added for NiuBlock)
+//
+// tfm::format() returning std::string appends straight to the result instead
+// of going through std::ostringstream.  Built-in integer, floating point,
+// character and string types are converted by hand, reproducing the output
+// of the libstdc++ stream inserters for the state the format spec describes;
+// any other type is formatted by formatValue() into a temporary stream, so
+// user overloads of operator<< and formatValue() keep working.
+
+namespace detail {
+
+// Stream state described by one conversion spec, without a stream
+struct FormatSpec
+{
+    enum
+    {
+        SHOWPOS   = 1 << 0,
+        SHOWBASE  = 1 << 1,
+        SHOWPOINT = 1 << 2,
+        UPPERCASE = 1 << 3,
+        BOOLALPHA = 1 << 4
+    };
+
+    const char* fmtBegin;  // spec text, for formatValue()
+    const char* fmtEnd;
+    int width;
+    int precision;
+    int flags;
+    char fill;
+    char adjust;           // 'l'eft, 'i'nternal, or 0 for right
+    char base;             // 'd', 'o', 'x', or 0 for none
+    char floatField;       // 'f'ixed, 'e' scientific, or 0 for general
+    bool spacePadPositive;
+    int ntrunc;
+};
+
+inline void applyFormatSpec(std::ostream& out, const FormatSpec& spec)
+{
+    std::ios::fmtflags flags = out.flags() & ~(std::ios::adjustfield |
+        std::ios::basefield | std::ios::floatfield | std::ios::showbase |
+        std::ios::boolalpha | std::ios::showpoint | std::ios::showpos |
+        std::ios::uppercase);
+    if(spec.adjust == 'l') flags |= std::ios::left;
+    if(spec.adjust == 'i') flags |= std::ios::internal;
+    if(spec.base == 'd') flags |= std::ios::dec;
+    if(spec.base == 'o') flags |= std::ios::oct;
+    if(spec.base == 'x') flags |= std::ios::hex;
+    if(spec.floatField == 'f') flags |= std::ios::fixed;
+    if(spec.floatField == 'e') flags |= std::ios::scientific;
+    if(spec.flags & FormatSpec::SHOWPOS) flags |= std::ios::showpos;
+    if(spec.flags & FormatSpec::SHOWBASE) flags |= std::ios::showbase;
+    if(spec.flags & FormatSpec::SHOWPOINT) flags |= std::ios::showpoint;
+    if(spec.flags & FormatSpec::UPPERCASE) flags |= std::ios::uppercase;
+    if(spec.flags & FormatSpec::BOOLALPHA) flags |= std::ios::boolalpha;
+    out.flags(flags);
+    out.width(spec.width);
+    out.precision(spec.precision);
+    out.fill(spec.fill);
+}
+
+// Pad text appended at buf[start] to the spec width.  Strings pad before the
+// text unless left adjusted; numbers with internal adjustment pad after a
+// leading sign or "0x", as std::num_put does.
+inline void padToWidth(std::string& buf, size_t start, const FormatSpec& spec, bool numeric)
+{
+    const size_t len = buf.size() - start;
+    if(spec.width <= 0 || len >= static_cast<size_t>(spec.width))
+        return;
+    const size_t n = spec.width - len;
+    if(spec.adjust == 'l')
+        buf.append(n, spec.fill);
+    else if(numeric && spec.adjust == 'i')
+    {
+        size_t prefix = 0;
+        if(len >= 2 && buf[start] == '0' && (buf[start+1] == 'x' || buf[start+1] == 'X'))
+            prefix = 2;
+        else if(len >= 1 && (buf[start] == '-' || buf[start] == '+'))
+            prefix = 1;
+        buf.insert(start + prefix, n, spec.fill);
+    }
+    else
+        buf.insert(start, n, spec.fill);
+}
+
+inline void appendPadded(std::string& buf, const FormatSpec& spec, const char* s, size_t len)
+{
+    const size_t start = buf.size();
+    buf.append(s, len);
+    padToWidth(buf, start, spec, false);
+}
+
+// Integer as std::num_put prints it: value is the magnitude in decimal and
+// the two's complement pattern in octal and hex, where signs never appear.
+inline void appendInteger(std::string& buf, const FormatSpec& spec,
+                          unsigned long long value, bool negative, bool isSigned)
+{
+    static const char digitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char tmp[32];
+    char* const end = tmp + sizeof(tmp);
+    char* p = end;
+    if(spec.base == 'x')
+    {
+        const char* digits = (spec.flags & FormatSpec::UPPERCASE) ? "0123456789ABCDEF" : "0123456789abcdef";
+        const bool nonzero = value != 0;
+        do { *--p = digits[value & 15]; value >>= 4; } while(value);
+        if(nonzero && (spec.flags & FormatSpec::SHOWBASE))
+        {
+            *--p = (spec.flags & FormatSpec::UPPERCASE) ? 'X' : 'x';
+            *--p = '0';
+        }
+    }
+    else if(spec.base == 'o')
+    {
+        const bool nonzero = value != 0;
+        do { *--p = '0' + (value & 7); value >>= 3; } while(value);
+        if(nonzero && (spec.flags & FormatSpec::SHOWBASE))
+            *--p = '0';
+    }
+    else
+    {
+        while(value >= 100)
+        {
+            const unsigned int i = static_cast<unsigned int>(value % 100) * 2;
+            value /= 100;
+            *--p = digitPairs[i + 1];
+            *--p = digitPairs[i];
+        }
+        if(value >= 10)
+        {
+            *--p = digitPairs[value * 2 + 1];
+            *--p = digitPairs[value * 2];
+        }
+        else
+            *--p = static_cast<char>('0' + value);
+        if(negative)
+            *--p = '-';
+        else if(isSigned && (spec.flags & FormatSpec::SHOWPOS))
+            *--p = '+';
+    }
+    const size_t start = buf.size();
+    buf.append(p, end - p);
+    padToWidth(buf, start, spec, true);
+}
+
+template<typename T>
+inline void appendSigned(std::string& buf, const FormatSpec& spec, T value)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    if(spec.base == 'x' || spec.base == 'o')
+        appendInteger(buf, spec, static_cast<U>(value), false, true);
+    else if(value < 0)
+        appendInteger(buf, spec, 0 - static_cast<unsigned long long>(value), true, true);
+    else
+        appendInteger(buf, spec, static_cast<unsigned long long>(value), false, true);
+}
+
+// snprintf follows the process LC_NUMERIC, while the ostream path always
+// used the classic locale. Switch the calling thread to "C" for the call.
+#ifdef TINYFORMAT_USE_USELOCALE
+class ClassicNumericScope
+{
+public:
+    ClassicNumericScope() : m_old(static_cast<locale_t>(0))
+    {
+        static const locale_t classic = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+        if(classic)
+            m_old = uselocale(classic);
+    }
+    ~ClassicNumericScope()
+    {
+        if(m_old)
+            uselocale(m_old);
+    }
+    void fixDecimalPoint(char*, int&) const {}
+private:
+    ClassicNumericScope(const ClassicNumericScope&);
+    ClassicNumericScope& operator=(const ClassicNumericScope&);
+    locale_t m_old;
+};
+#else
+// Without a per-thread locale, replace the locale's decimal point instead.
+// printf never groups digits without the ' flag, so nothing else differs.
+class ClassicNumericScope
+{
+public:
+    ClassicNumericScope()
+    {
+        const lconv* conv = localeconv();
+        m_point = conv && conv->decimal_point && conv->decimal_point[0] ? conv->decimal_point : ".";
+        m_pointLen = strlen(m_point);
+    }
+    void fixDecimalPoint(char* out, int& len) const
+    {
+        if(m_pointLen == 1 && m_point[0] == '.')
+            return;
+        char* p = strstr(out, m_point);
+        if(!p)
+            return;
+        *p = '.';
+        memmove(p + 1, p + m_pointLen, len - (p - out) - m_pointLen + 1);
+        len -= static_cast<int>(m_pointLen - 1);
+    }
+private:
+    ClassicNumericScope(const ClassicNumericScope&);
+    ClassicNumericScope& operator=(const ClassicNumericScope&);
+    const char* m_point;
+    size_t m_pointLen;
+};
+#endif
+
+// Floating point as std::num_put prints it, which builds a printf format
+// from the stream flags in the same way.
+inline void appendFloat(std::string& buf, const FormatSpec& spec, double value)
+{
+    char fmt[8];
+    char* f = fmt;
+    *f++ = '%';
+    if(spec.flags & FormatSpec::SHOWPOS) *f++ = '+';
+    if(spec.flags & FormatSpec::SHOWPOINT) *f++ = '#';
+    *f++ = '.';
+    *f++ = '*';
+    const bool upper = (spec.flags & FormatSpec::UPPERCASE) != 0;
+    *f++ = spec.floatField == 'f' ? 'f' : spec.floatField == 'e' ? (upper ? 'E' : 'e') : (upper ? 'G' : 'g');
+    *f = '\0';
+    const int precision = spec.precision < 0 ? 6 : spec.precision;
+    ClassicNumericScope classic;
+    char tmp[64];
+    int len = snprintf(tmp, sizeof(tmp), fmt, precision, value);
+    if(len < 0)
+        return;
+    const size_t start = buf.size();
+    if(static_cast<size_t>(len) < sizeof(tmp))
+    {
+        classic.fixDecimalPoint(tmp, len);
+        buf.append(tmp, len);
+    }
+    else
+    {
+        // Only fixed notation of huge values gets here
+        buf.resize(start + len + 1);
+        snprintf(&buf[start], len + 1, fmt, precision, value);
+        classic.fixDecimalPoint(&buf[start], len);
+        buf.resize(start + len);
+    }
+    padToWidth(buf, start, spec, true);
+}
+
+// "%.Ns": tinyformat writes the first N characters of the value formatted
+// by a default constructed stream, without padding.
+template<typename T>
+inline void appendTruncated(std::string& buf, const T& value, int ntrunc)
+{
+    std::ostringstream tmp;
+    tmp << value;
+    const std::string result = tmp.str();
+    buf.append(result, 0, (std::min)(static_cast<size_t>(ntrunc), result.size()));
+}
+
+inline void appendTruncated(std::string& buf, const char* value, int ntrunc)
+{
+    size_t len = 0;
+    while(len < static_cast<size_t>(ntrunc) && value[len] != 0)
+        ++len;
+    buf.append(value, len);
+}
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const std::string& value)
+{
+    if(spec.ntrunc >= 0)
+        buf.append(value, 0, (std::min)(static_cast<size_t>(spec.ntrunc), value.size()));
+    else
+        appendPadded(buf, spec, value.data(), value.size());
+}
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const char* value)
+{
+    if(*(spec.fmtEnd-1) == 'p')
+    {
+        FormatSpec ptrSpec = spec;
+        ptrSpec.base = 'x';
+        ptrSpec.flags = (spec.flags & ~FormatSpec::UPPERCASE) | FormatSpec::SHOWBASE;
+        appendInteger(buf, ptrSpec, reinterpret_cast<std::uintptr_t>(value), false, false);
+    }
+    else if(!value)
+        return; // operator<< sets badbit and prints nothing
+    else if(spec.ntrunc >= 0)
+        appendTruncated(buf, value, spec.ntrunc);
+    else
+        appendPadded(buf, spec, value, strlen(value));
+}
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, char* value)
+{
+    formatValueToBuffer(buf, spec, static_cast<const char*>(value));
+}
+
+template<size_t N>
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const char (&value)[N])
+{
+    formatValueToBuffer(buf, spec, static_cast<const char*>(value));
+}
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, bool value)
+{
+    if(*(spec.fmtEnd-1) == 'c')
+    {
+        const char c = value;
+        appendPadded(buf, spec, &c, 1);
+    }
+    else if(spec.ntrunc >= 0)
+        buf.append(value ? "1" : "0", (std::min)(spec.ntrunc, 1));
+    else if(spec.flags & FormatSpec::BOOLALPHA)
+        value ? appendPadded(buf, spec, "true", 4) : appendPadded(buf, spec, "false", 5);
+    else
+        appendSigned(buf, spec, static_cast<long>(value));
+}
+
+// Character types print as integers for integer conversions, else as text
+#define TINYFORMAT_DEFINE_FORMATBUFFER_CHAR(charType)                        \
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec,    \
+                                charType value)                              \
+{                                                                            \
+    switch(*(spec.fmtEnd-1))                                                 \
+    {                                                                        \
+        case 'u': case 'd': case 'i': case 'o': case 'X': case 'x':          \
+            appendSigned(buf, spec, static_cast<int>(value)); break;         \
+        default:                                                             \
+        {                                                                    \
+            const char c = static_cast<char>(value);                         \
+            appendPadded(buf, spec, &c, 1);                                  \
+            break;                                                           \
+        }                                                                    \
+    }                                                                        \
+}
+TINYFORMAT_DEFINE_FORMATBUFFER_CHAR(char)
+TINYFORMAT_DEFINE_FORMATBUFFER_CHAR(signed char)
+TINYFORMAT_DEFINE_FORMATBUFFER_CHAR(unsigned char)
+#undef TINYFORMAT_DEFINE_FORMATBUFFER_CHAR
+
+// Integers: %c prints the value as a char, "%.Ns" truncates the plain
+// decimal form, everything else goes through appendInteger()
+#define TINYFORMAT_DEFINE_FORMATBUFFER_INT(intType, append)                  \
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec,    \
+                                intType value)                               \
+{                                                                            \
+    if(*(spec.fmtEnd-1) == 'c')                                              \
+    {                                                                        \
+        const char c = static_cast<char>(value);                             \
+        appendPadded(buf, spec, &c, 1);                                      \
+    }                                                                        \
+    else if(spec.ntrunc >= 0)                                                \
+        appendTruncated(buf, value, spec.ntrunc);                            \
+    else                                                                     \
+        append;                                                              \
+}
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(short, appendSigned(buf, spec, value))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(int, appendSigned(buf, spec, value))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(long, appendSigned(buf, spec, value))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(long long, appendSigned(buf, spec, value))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(unsigned short, appendInteger(buf, spec, value, false, false))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(unsigned int, appendInteger(buf, spec, value, false, false))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(unsigned long, appendInteger(buf, spec, value, false, false))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(unsigned long long, appendInteger(buf, spec, value, false, false))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(float, appendFloat(buf, spec, value))
+TINYFORMAT_DEFINE_FORMATBUFFER_INT(double, appendFloat(buf, spec, value))
+#undef TINYFORMAT_DEFINE_FORMATBUFFER_INT
+
+// Everything else, including user types, through formatValue() and a stream
+template<typename T>
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const T& value)
+{
+    std::ostringstream tmp;
+    applyFormatSpec(tmp, spec);
+    formatValue(tmp, spec.fmtBegin, spec.fmtEnd, spec.ntrunc, value);
+    buf += tmp.str();
+}
+
+} // namespace detail
+
+
 //------------------------------------------------------------------------------
 // Tools for emulating variadic templates in C++98.  The basic idea here is
 // stolen from the boost preprocessor metaprogramming library and cut down to
@@ -501,6 +899,7 @@ class FormatArg
         explicit FormatArg(const T& value)
             : m_value(static_cast<const void*>(&value)),
             m_formatImpl(&formatImpl<T>),
+            m_formatToBufferImpl(&formatToBufferImpl<T>),
             m_toIntImpl(&toIntImpl<T>)
         { }
 
@@ -510,6 +909,11 @@ class FormatArg
             m_formatImpl(out, fmtBegin, fmtEnd, ntrunc, m_value);
         }
 
+        void formatToBuffer(std::string& buf, const FormatSpec& spec) const
+        {
+            m_formatToBufferImpl(buf, spec, m_value);
+        }
+
         int toInt() const
         {
             return m_toIntImpl(m_value);
@@ -523,6 +927,13 @@ class FormatArg
             formatValue(out, fmtBegin, fmtEnd, ntrunc, *static_cast<const T*>(value));
         }
 
+        template<typename T>
+        TINYFORMAT_HIDDEN static void formatToBufferImpl(std::string& buf,
+                        const FormatSpec& spec, const void* value)
+        {
+            formatValueToBuffer(buf, spec, *static_cast<const T*>(value));
+        }
+
         template<typename T>
         TINYFORMAT_HIDDEN static int toIntImpl(const void* value)
         {
@@ -532,6 +943,8 @@ class FormatArg
         const void* m_value;
         void (*m_formatImpl)(std::ostream& out, const char* fmtBegin,
                              const char* fmtEnd, int ntrunc, const void* value);
+        void (*m_formatToBufferImpl)(std::string& buf, const FormatSpec& spec,
+                                     const void* value);
         int (*m_toIntImpl)(const void* value);
 };
 
@@ -576,34 +989,37 @@ inline const char* printFormatStringLiteral(std::ostream& out, const char* fmt)
 }
 
 
-// Parse a format string and set the stream state accordingly.
+// Parse a format spec into a FormatSpec.
 //
 // The format mini-language recognized here is meant to be the one from C99,
 // with the form "%[flags][width][.precision][length]type".
 //
 // Formatting options which can't be natively represented using the ostream
-// state are returned in spacePadPositive (for space padded positive numbers)
-// and ntrunc (for truncating conversions).  argIndex is incremented if
-// necessary to pull out variable width and precision .  The function returns a
-// pointer to the character after the end of the current format spec.
-inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositive,
-                                         int& ntrunc, const char* fmtStart,
-                                         const detail::FormatArg* formatters,
-                                         int& argIndex, int numFormatters)
+// state are returned in spec.spacePadPositive (for space padded positive
+// numbers) and spec.ntrunc (for truncating conversions).  argIndex is
+// incremented if necessary to pull out variable width and precision.  The
+// function returns a pointer to the character after the end of the current
+// format spec.
+inline const char* parseFormatSpec(FormatSpec& spec, const char* fmtStart,
+                                   const detail::FormatArg* formatters,
+                                   int& argIndex, int numFormatters)
 {
+    spec.fmtBegin = fmtStart;
+    spec.fmtEnd = fmtStart;
+    spec.width = 0;
+    spec.precision = 6;
+    spec.flags = 0;
+    spec.fill = ' ';
+    spec.adjust = 0;
+    spec.base = 0;
+    spec.floatField = 0;
+    spec.spacePadPositive = false;
+    spec.ntrunc = -1;
     if(*fmtStart != '%')
     {
         TINYFORMAT_ERROR("tinyformat: Not enough conversion specifiers in format string");
         return fmtStart;
     }
-    // Reset stream state to defaults.
-    out.width(0);
-    out.precision(6);
-    out.fill(' ');
-    // Reset most flags; ignore irrelevant unitbuf & skipws.
-    out.unsetf(std::ios::adjustfield | std::ios::basefield |
-               std::ios::floatfield | std::ios::showbase | std::ios::boolalpha |
-               std::ios::showpoint | std::ios::showpos | std::ios::uppercase);
     bool precisionSet = false;
     bool widthSet = false;
     int widthExtra = 0;
@@ -614,30 +1030,30 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
         switch(*c)
         {
             case '#':
-                out.setf(std::ios::showpoint | std::ios::showbase);
+                spec.flags |= FormatSpec::SHOWPOINT | FormatSpec::SHOWBASE;
                 continue;
             case '0':
                 // overridden by left alignment ('-' flag)
-                if(!(out.flags() & std::ios::left))
+                if(spec.adjust != 'l')
                 {
                     // Use internal padding so that numeric values are
                     // formatted correctly, eg -00010 rather than 000-10
-                    out.fill('0');
-                    out.setf(std::ios::internal, std::ios::adjustfield);
+                    spec.fill = '0';
+                    spec.adjust = 'i';
                 }
                 continue;
             case '-':
-                out.fill(' ');
-                out.setf(std::ios::left, std::ios::adjustfield);
+                spec.fill = ' ';
+                spec.adjust = 'l';
                 continue;
             case ' ':
                 // overridden by show positive sign, '+' flag.
-                if(!(out.flags() & std::ios::showpos))
-                    spacePadPositive = true;
+                if(!(spec.flags & FormatSpec::SHOWPOS))
+                    spec.spacePadPositive = true;
                 continue;
             case '+':
-                out.setf(std::ios::showpos);
-                spacePadPositive = false;
+                spec.flags |= FormatSpec::SHOWPOS;
+                spec.spacePadPositive = false;
                 widthExtra = 1;
                 continue;
             default:
@@ -649,7 +1065,7 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
     if(*c >= '0' && *c <= '9')
     {
         widthSet = true;
-        out.width(parseIntAndAdvance(c));
+        spec.width = parseIntAndAdvance(c);
     }
     if(*c == '*')
     {
@@ -662,11 +1078,11 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
         if(width < 0)
         {
             // negative widths correspond to '-' flag set
-            out.fill(' ');
-            out.setf(std::ios::left, std::ios::adjustfield);
+            spec.fill = ' ';
+            spec.adjust = 'l';
             width = -width;
         }
-        out.width(width);
+        spec.width = width;
         ++c;
     }
     // 3) Parse precision
@@ -689,7 +1105,7 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
             else if(*c == '-') // negative precisions ignored, treated as zero.
                 parseIntAndAdvance(++c);
         }
-        out.precision(precision);
+        spec.precision = precision;
         precisionSet = true;
     }
     // 4) Ignore any C99 length modifier
@@ -703,36 +1119,36 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
     switch(*c)
     {
         case 'u': case 'd': case 'i':
-            out.setf(std::ios::dec, std::ios::basefield);
+            spec.base = 'd';
             intConversion = true;
             break;
         case 'o':
-            out.setf(std::ios::oct, std::ios::basefield);
+            spec.base = 'o';
             intConversion = true;
             break;
         case 'X':
-            out.setf(std::ios::uppercase);
+            spec.flags |= FormatSpec::UPPERCASE;
         case 'x': case 'p':
-            out.setf(std::ios::hex, std::ios::basefield);
+            spec.base = 'x';
             intConversion = true;
             break;
         case 'E':
-            out.setf(std::ios::uppercase);
+            spec.flags |= FormatSpec::UPPERCASE;
         case 'e':
-            out.setf(std::ios::scientific, std::ios::floatfield);
-            out.setf(std::ios::dec, std::ios::basefield);
+            spec.floatField = 'e';
+            spec.base = 'd';
             break;
         case 'F':
-            out.setf(std::ios::uppercase);
+            spec.flags |= FormatSpec::UPPERCASE;
         case 'f':
-            out.setf(std::ios::fixed, std::ios::floatfield);
+            spec.floatField = 'f';
             break;
         case 'G':
-            out.setf(std::ios::uppercase);
+            spec.flags |= FormatSpec::UPPERCASE;
         case 'g':
-            out.setf(std::ios::dec, std::ios::basefield);
+            spec.base = 'd';
             // As in boost::format, let stream decide float format.
-            out.flags(out.flags() & ~std::ios::floatfield);
+            spec.floatField = 0;
             break;
         case 'a': case 'A':
             TINYFORMAT_ERROR("tinyformat: the %a and %A conversion specs "
@@ -743,9 +1159,9 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
             break;
         case 's':
             if(precisionSet)
-                ntrunc = static_cast<int>(out.precision());
+                spec.ntrunc = spec.precision;
             // Make %s print booleans as "true" and "false"
-            out.setf(std::ios::boolalpha);
+            spec.flags |= FormatSpec::BOOLALPHA;
             break;
         case 'n':
             // Not supported - will cause problems!
@@ -754,6 +1170,7 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
         case '\0':
             TINYFORMAT_ERROR("tinyformat: Conversion spec incorrectly "
                              "terminated by end of string");
+            spec.fmtEnd = c;
             return c;
         default:
             break;
@@ -764,14 +1181,33 @@ inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositi
         // padded with zeros on the left).  This isn't really supported by the
         // iostreams, but we can approximately simulate it with the width if
         // the width isn't otherwise used.
-        out.width(out.precision() + widthExtra);
-        out.setf(std::ios::internal, std::ios::adjustfield);
-        out.fill('0');
+        spec.width = spec.precision + widthExtra;
+        spec.adjust = 'i';
+        spec.fill = '0';
     }
+    spec.fmtEnd = c+1;
     return c+1;
 }
 
 
+// Parse a format string and set the stream state accordingly, see
+// parseFormatSpec().
+inline const char* streamStateFromFormat(std::ostream& out, bool& spacePadPositive,
+                                         int& ntrunc, const char* fmtStart,
+                                         const detail::FormatArg* formatters,
+                                         int& argIndex, int numFormatters)
+{
+    FormatSpec spec;
+    const char* fmtEnd = parseFormatSpec(spec, fmtStart, formatters, argIndex, numFormatters);
+    if(*fmtStart != '%')
+        return fmtEnd;
+    applyFormatSpec(out, spec);
+    spacePadPositive = spec.spacePadPositive;
+    ntrunc = spec.ntrunc;
+    return fmtEnd;
+}
+
+
 //------------------------------------------------------------------------------
 inline void formatImpl(std::ostream& out, const char* fmt,
                        const detail::FormatArg* formatters,
@@ -831,6 +1267,70 @@ inline void formatImpl(std::ostream& out, const char* fmt,
     out.fill(origFill);
 }
 
+
+// As printFormatStringLiteral(), appending to a string
+inline const char* appendFormatStringLiteral(std::string& buf, const char* fmt)
+{
+    const char* c = fmt;
+    for(;; ++c)
+    {
+        switch(*c)
+        {
+            case '\0':
+                buf.append(fmt, c - fmt);
+                return c;
+            case '%':
+                buf.append(fmt, c - fmt);
+                if(*(c+1) != '%')
+                    return c;
+                // for "%%", tack trailing % onto next literal section.
+                fmt = ++c;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+// As formatImpl(), appending to a string without an intermediate stream
+inline void formatImplToBuffer(std::string& buf, const char* fmt,
+                               const detail::FormatArg* formatters,
+                               int numFormatters)
+{
+    for (int argIndex = 0; argIndex < numFormatters; ++argIndex)
+    {
+        fmt = appendFormatStringLiteral(buf, fmt);
+        FormatSpec spec;
+        const char* fmtEnd = parseFormatSpec(spec, fmt, formatters, argIndex, numFormatters);
+        if (argIndex >= numFormatters)
+        {
+            TINYFORMAT_ERROR("tinyformat: Not enough format arguments");
+            return;
+        }
+        const FormatArg& arg = formatters[argIndex];
+        if(!spec.spacePadPositive)
+            arg.formatToBuffer(buf, spec);
+        else
+        {
+            // Format with a '+' sign and turn it into a space, then pad the
+            // munged text again like formatImpl() does
+            const size_t start = buf.size();
+            FormatSpec plusSpec = spec;
+            plusSpec.flags |= FormatSpec::SHOWPOS;
+            arg.formatToBuffer(buf, plusSpec);
+            for(size_t i = start, iend = buf.size(); i < iend; ++i)
+                if(buf[i] == '+') buf[i] = ' ';
+            padToWidth(buf, start, spec, false);
+        }
+        fmt = fmtEnd;
+    }
+
+    fmt = appendFormatStringLiteral(buf, fmt);
+    if(*fmt != '\0')
+        TINYFORMAT_ERROR("tinyformat: Too many conversion specifiers in format string");
+}
+
 } // namespace detail
 
 
@@ -848,6 +1348,8 @@ class FormatList
 
         friend void vformat(std::ostream& out, const char* fmt,
                             const FormatList& list);
+        friend void vformat(std::string& buf, const char* fmt,
+                            const FormatList& list);
 
     private:
         const detail::FormatArg* m_formatters;
@@ -947,6 +1449,12 @@ inline void vformat(std::ostream& out, const char* fmt, FormatListRef list)
     detail::formatImpl(out, fmt, list.m_formatters, list.m_N);
 }
 
+/// Format list of arguments, appending the result to buf.
+inline void vformat(std::string& buf, const char* fmt, FormatListRef list)
+{
+    detail::formatImplToBuffer(buf, fmt, list.m_formatters, list.m_N);
+}
+
 
 #ifdef TINYFORMAT_USE_VARIADIC_TEMPLATES
 
@@ -962,9 +1470,10 @@ void format(std::ostream& out, const char* fmt, const Args&... args)
 template<typename... Args>
 std::string format(const char* fmt, const Args&... args)
 {
-    std::ostringstream oss;
-    format(oss, fmt, args...);
-    return oss.str();
+    std::string result;
+    result.reserve(128);
+    vformat(result, fmt, makeFormatList(args...));
+    return result;
 }
 
 /// Format list of arguments to std::cout, according to the given format string
@@ -990,9 +1499,9 @@ inline void format(std::ostream& out, const char* fmt)
 
 inline std::string format(const char* fmt)
 {
-    std::ostringstream oss;
-    format(oss, fmt);
-    return oss.str();
+    std::string result;
+    vformat(result, fmt, makeFormatList());
+    return result;
 }
 
 inline void printf(const char* fmt)
@@ -1017,9 +1526,10 @@ void format(std::ostream& out, const char* fmt, TINYFORMAT_VARARGS(n))    \
 template<TINYFORMAT_ARGTYPES(n)>                                          \
 std::string format(const char* fmt, TINYFORMAT_VARARGS(n))                \
 {                                                                         \
-    std::ostringstream oss;                                               \
-    format(oss, fmt, TINYFORMAT_PASSARGS(n));                             \
-    return oss.str();                                                     \
+    std::string result;                                                   \
+    result.reserve(128);                                                  \
+    vformat(result, fmt, makeFormatList(TINYFORMAT_PASSARGS(n)));         \
+    return result;                                                        \
 }                                                                         \
                                                                           \
 template<TINYFORMAT_ARGTYPES(n)>                                          \
@@ -1044,13 +1554,294 @@ TINYFORMAT_FOREACH_ARGNUM(TINYFORMAT_MAKE_FORMAT_FUNCS)
 template<typename... Args>
 std::string format(const std::string &fmt, const Args&... args)
 {
-    std::ostringstream oss;
-    format(oss, fmt.c_str(), args...);
-    return oss.str();
+    return format(fmt.c_str(), args...);
+}
+
+
+//------------------------------------------------------------------------------
+// Compile-time checked format strings (added for NiuBlock)
+//
+// Wrapping a literal format string in TINYFORMAT_FMT() lets the compiler
+// check the number of arguments and their types against the conversion
+// specifiers:
+//
+//   std::string s = strprintf(TINYFORMAT_FMT("height=%d hash=%s"), height, hash);
+//
+// The string is parsed once per call site instead of once per call, and each
+// argument is formatted by a direct call rather than through FormatArg.
+// Plain const char* format strings keep using the runtime path above.
+
+namespace detail {
+
+// Base class of the literal wrappers made by TINYFORMAT_FMT()
+struct StaticFormatTag {};
+
+// C++11 constexpr functions are single expressions, so the parser below is
+// written as recursion over the format string.
+constexpr bool isFlagChar(char c)
+{
+    return c == '#' || c == '0' || c == '-' || c == ' ' || c == '+';
+}
+constexpr bool isLengthChar(char c)
+{
+    return c == 'l' || c == 'h' || c == 'L' || c == 'j' || c == 'z' || c == 't';
+}
+constexpr const char* skipFlags(const char* c)
+{
+    return isFlagChar(*c) ? skipFlags(c + 1) : c;
+}
+constexpr const char* skipDigits(const char* c)
+{
+    return (*c >= '0' && *c <= '9') ? skipDigits(c + 1) : c;
+}
+constexpr const char* skipWidth(const char* c)
+{
+    return *c == '*' ? c + 1 : skipDigits(c);
+}
+constexpr const char* skipPrecision(const char* c)
+{
+    return *c != '.' ? c : c[1] == '*' ? c + 2 : c[1] == '-' ? skipDigits(c + 2) : skipDigits(c + 1);
+}
+constexpr const char* skipLength(const char* c)
+{
+    return isLengthChar(*c) ? skipLength(c + 1) : c;
+}
+// Conversion character of the spec whose '%' is at c[-1]
+constexpr const char* conversionOf(const char* c)
+{
+    return skipLength(skipPrecision(skipWidth(skipFlags(c))));
+}
+// Arguments consumed by that spec: the value plus any '*' width/precision
+constexpr int specArgs(const char* c)
+{
+    return 1 + (*skipFlags(c) == '*') + (*skipWidth(skipFlags(c)) == '.' && skipWidth(skipFlags(c))[1] == '*');
+}
+constexpr bool isSupportedConversion(char c)
+{
+    return c == 'd' || c == 'i' || c == 'u' || c == 'o' || c == 'x' || c == 'X' ||
+           c == 'e' || c == 'E' || c == 'f' || c == 'F' || c == 'g' || c == 'G' ||
+           c == 'c' || c == 's' || c == 'p';
+}
+// Whether every spec ends in a conversion tinyformat supports
+constexpr bool isValidFormat(const char* c)
+{
+    return *c == '\0' ? true
+         : *c != '%' ? isValidFormat(c + 1)
+         : c[1] == '%' ? isValidFormat(c + 2)
+         : isSupportedConversion(*conversionOf(c + 1)) && isValidFormat(conversionOf(c + 1) + 1);
+}
+constexpr bool hasVariableWidth(const char* c)
+{
+    return *c == '\0' ? false
+         : *c != '%' ? hasVariableWidth(c + 1)
+         : c[1] == '%' ? hasVariableWidth(c + 2)
+         : specArgs(c + 1) > 1 || hasVariableWidth(conversionOf(c + 1) + 1);
+}
+// Number of arguments the format string consumes; only valid if isValidFormat()
+constexpr int countFormatArgs(const char* c)
+{
+    return *c == '\0' ? 0
+         : *c != '%' ? countFormatArgs(c + 1)
+         : c[1] == '%' ? countFormatArgs(c + 2)
+         : specArgs(c + 1) + countFormatArgs(conversionOf(c + 1) + 1);
+}
+// What argument i is used for: its conversion character, or '*' for a
+// variable width or precision
+constexpr char formatArgKind(const char* c, int i)
+{
+    return *c == '\0' ? '\0'
+         : *c != '%' ? formatArgKind(c + 1, i)
+         : c[1] == '%' ? formatArgKind(c + 2, i)
+         : i < specArgs(c + 1) - 1 ? '*'
+         : i == specArgs(c + 1) - 1 ? *conversionOf(c + 1)
+         : formatArgKind(conversionOf(c + 1) + 1, i - specArgs(c + 1));
+}
+
+template<typename T>
+constexpr bool formatArgMatches(char kind)
+{
+    typedef typename std::decay<T>::type U;
+    return kind == 's' ? true
+         : kind == '*' || kind == 'c' ? (std::is_integral<U>::value || std::is_enum<U>::value)
+         : kind == 'd' || kind == 'i' || kind == 'u' || kind == 'o' || kind == 'x' || kind == 'X'
+             ? (std::is_integral<U>::value || std::is_enum<U>::value)
+         : kind == 'p' ? (std::is_pointer<U>::value || std::is_same<U, std::nullptr_t>::value)
+         : std::is_arithmetic<U>::value;
+}
+
+template<typename S, int I>
+inline void checkFormatArgs() {}
+
+template<typename S, int I, typename T, typename... Rest>
+inline void checkFormatArgs()
+{
+    static_assert(formatArgMatches<T>(formatArgKind(S::value(), I)),
+                  "tinyformat: argument type does not match its conversion specifier");
+    checkFormatArgs<S, I + 1, Rest...>();
+}
+
+// Format string split at its conversion specifiers, with the stream state of
+// each specifier captured once so formatting only has to apply it.
+template<int N>
+struct ParsedFormat
+{
+    std::string literals[N];    // text before each spec, "%%" collapsed
+    FormatSpec specs[N];
+    std::string tail;
+
+    explicit ParsedFormat(const char* fmt)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            fmt = appendFormatStringLiteral(literals[i], fmt);
+            int argIndex = 0;
+            fmt = parseFormatSpec(specs[i], fmt, 0, argIndex, 0);
+        }
+        appendFormatStringLiteral(tail, fmt);
+    }
+};
+
+// A format string without specs is all tail; spelled out so that no
+// zero-length arrays are declared.
+template<>
+struct ParsedFormat<0>
+{
+    std::string tail;
+
+    explicit ParsedFormat(const char* fmt)
+    {
+        appendFormatStringLiteral(tail, fmt);
+    }
+};
+
+template<int N>
+inline void formatParsedArgs(std::ostream&, const ParsedFormat<N>&, int) {}
+
+template<int N, typename T, typename... Rest>
+inline void formatParsedArgs(std::ostream& out, const ParsedFormat<N>& parsed, int i,
+                             const T& value, const Rest&... rest)
+{
+    const FormatSpec& spec = parsed.specs[i];
+    out.write(parsed.literals[i].data(), parsed.literals[i].size());
+    applyFormatSpec(out, spec);
+    if (!spec.spacePadPositive)
+        formatValue(out, spec.fmtBegin, spec.fmtEnd, spec.ntrunc, value);
+    else
+    {
+        // Same workaround as in formatImpl()
+        std::ostringstream tmpStream;
+        tmpStream.copyfmt(out);
+        tmpStream.setf(std::ios::showpos);
+        formatValue(tmpStream, spec.fmtBegin, spec.fmtEnd, spec.ntrunc, value);
+        std::string result = tmpStream.str();
+        for (size_t j = 0, jend = result.size(); j < jend; ++j)
+            if (result[j] == '+') result[j] = ' ';
+        out << result;
+    }
+    formatParsedArgs(out, parsed, i + 1, rest...);
+}
+
+template<int N>
+inline void formatParsedArgs(std::string&, const ParsedFormat<N>&, int) {}
+
+template<int N, typename T, typename... Rest>
+inline void formatParsedArgs(std::string& buf, const ParsedFormat<N>& parsed, int i,
+                             const T& value, const Rest&... rest)
+{
+    const FormatSpec& spec = parsed.specs[i];
+    buf += parsed.literals[i];
+    if (!spec.spacePadPositive)
+        formatValueToBuffer(buf, spec, value);
+    else
+    {
+        // Same workaround as in formatImplToBuffer()
+        const size_t start = buf.size();
+        FormatSpec plusSpec = spec;
+        plusSpec.flags |= FormatSpec::SHOWPOS;
+        formatValueToBuffer(buf, plusSpec, value);
+        for (size_t j = start, jend = buf.size(); j < jend; ++j)
+            if (buf[j] == '+') buf[j] = ' ';
+        padToWidth(buf, start, spec, false);
+    }
+    formatParsedArgs(buf, parsed, i + 1, rest...);
+}
+
+template<typename S>
+struct is_static_format
+{
+    static const bool value = std::is_base_of<StaticFormatTag, S>::value;
+};
+
+} // namespace detail
+
+/// Format list of arguments to the stream according to a TINYFORMAT_FMT()
+/// format string, checked at compile time.
+template<typename S, typename... Args>
+typename std::enable_if<detail::is_static_format<S>::value>::type
+format(std::ostream& out, const S&, const Args&... args)
+{
+    static_assert(detail::isValidFormat(S::value()),
+                  "tinyformat: unsupported or unterminated conversion specifier");
+    static_assert(detail::countFormatArgs(S::value()) == sizeof...(Args),
+                  "tinyformat: number of arguments does not match the format string");
+    detail::checkFormatArgs<S, 0, Args...>();
+
+    if (detail::hasVariableWidth(S::value()))
+    {
+        // '*' reads width or precision from the arguments; leave that to
+        // the runtime parser.
+        vformat(out, S::value(), makeFormatList(args...));
+        return;
+    }
+    // Parsed on first use, once per call site (thread-safe in C++11)
+    static const detail::ParsedFormat<sizeof...(Args)> parsed(S::value());
+
+    std::streamsize origWidth = out.width();
+    std::streamsize origPrecision = out.precision();
+    std::ios::fmtflags origFlags = out.flags();
+    char origFill = out.fill();
+
+    detail::formatParsedArgs(out, parsed, 0, args...);
+    out.write(parsed.tail.data(), parsed.tail.size());
+
+    out.width(origWidth);
+    out.precision(origPrecision);
+    out.flags(origFlags);
+    out.fill(origFill);
+}
+
+template<typename S, typename... Args>
+typename std::enable_if<detail::is_static_format<S>::value, std::string>::type
+format(const S&, const Args&... args)
+{
+    static_assert(detail::isValidFormat(S::value()),
+                  "tinyformat: unsupported or unterminated conversion specifier");
+    static_assert(detail::countFormatArgs(S::value()) == sizeof...(Args),
+                  "tinyformat: number of arguments does not match the format string");
+    detail::checkFormatArgs<S, 0, Args...>();
+
+    std::string result;
+    result.reserve(128);
+    if (detail::hasVariableWidth(S::value()))
+    {
+        vformat(result, S::value(), makeFormatList(args...));
+        return result;
+    }
+    static const detail::ParsedFormat<sizeof...(Args)> parsed(S::value());
+    detail::formatParsedArgs(result, parsed, 0, args...);
+    result += parsed.tail;
+    return result;
 }
 
 } // namespace tinyformat
 
+/// Wrap a string literal so that tfm::format()/strprintf() check it at
+/// compile time. Must be given a literal, not a variable.
+#define TINYFORMAT_FMT(str)                                                   \
+    ([]{ struct TinyformatStaticFormat : tinyformat::detail::StaticFormatTag  \
+         { static constexpr const char* value() { return str; } };            \
+         return TinyformatStaticFormat(); }())
+
 #define strprintf tfm::format
 
 #endif // TINYFORMAT_H_INCLUDED
@@ -14,6 +14,7 @@
 #include <vector>
 //#include "crypto/common.h"
 #include "common.h"
+#include "utilstrencodings.h"
 
 
 /** Template base class for fixed-sized opaque blobs. */
@@ -46,6 +47,17 @@ public:
 
     inline int Compare(const base_blob& other) const { return memcmp(data, other.data, sizeof(data)); }
 
+    /** Comparison whose timing does not depend on the contents, for secrets. */
+    bool EqualConstantTime(const base_blob& other) const
+    {
+        return ConstantTimeEqual(data, other.data, sizeof(data));
+    }
+
+    bool IsNullConstantTime() const
+    {
+        return ConstantTimeIsZero(data, sizeof(data));
+    }
+
     friend inline bool operator==(const base_blob& a, const base_blob& b) { return a.Compare(b) == 0; }
     friend inline bool operator!=(const base_blob& a, const base_blob& b) { return a.Compare(b) != 0; }
     friend inline bool operator<(const base_blob& a, const base_blob& b) { return a.Compare(b) < 0; }
@@ -139,6 +151,17 @@ public:
     }
 };
 
+/** base_blob has no operator[], and its width is fixed: compare whole words. */
+inline bool TimingResistantEqual(const uint160& a, const uint160& b)
+{
+    return a.EqualConstantTime(b);
+}
+
+inline bool TimingResistantEqual(const uint256& a, const uint256& b)
+{
+    return a.EqualConstantTime(b);
+}
+
 /* uint256 from const char *.
  * This is a separate function because the constructor uint256(const char*) can result
  * in dangerously catching uint256(0).
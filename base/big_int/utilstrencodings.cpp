@@ -7,10 +7,12 @@
 
 #include "tinyformat.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <errno.h>
 #include <limits>
+#include <unistd.h>
 
 static const std::string CHARS_ALPHA_NUM = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 
@@ -91,29 +93,233 @@ std::vector<unsigned char> ParseHex(const std::string& str)
     return ParseHex(str.c_str());
 }
 
-void SplitHostPort(std::string in, int &portOut, std::string &hostOut) {
+/** Parse a port number the way ParseInt32() would (optional '+', leading zeros). */
+static bool ParsePortLenient(const char* p, size_t len, uint16_t& port)
+{
+    if (len && *p == '+') {
+        ++p;
+        --len;
+    }
+    if (!len)
+        return false;
+    uint32_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+        n = n * 10 + (p[i] - '0');
+        if (n >= 0x10000)
+            return false;
+    }
+    if (n == 0)
+        return false;
+    port = n;
+    return true;
+}
+
+/** Strict port: 1-65535 in plain decimal without sign or leading zeros. */
+static bool ParsePortStrict(const char* p, size_t len, uint16_t& port)
+{
+    if (!len || len > 5 || *p == '0' || *p == '+')
+        return false;
+    return ParsePortLenient(p, len, port);
+}
+
+void SplitHostPort(const std::string& in, int &portOut, std::string &hostOut) {
+    size_t len = in.size();
     size_t colon = in.find_last_of(':');
     // if a : is found, and it either follows a [...], or no other : is in the string, treat it as port separator
     bool fHaveColon = colon != in.npos;
     bool fBracketed = fHaveColon && (in[0]=='[' && in[colon-1]==']'); // if there is a colon, and in[0]=='[', colon is not 0, so in[colon-1] is safe
     bool fMultiColon = fHaveColon && (in.find_last_of(':',colon-1) != in.npos);
     if (fHaveColon && (colon==0 || fBracketed || !fMultiColon)) {
-        int32_t n;
-        if (ParseInt32(in.substr(colon + 1), &n) && n > 0 && n < 0x10000) {
-            in = in.substr(0, colon);
+        uint16_t n;
+        if (ParsePortLenient(in.data() + colon + 1, in.size() - colon - 1, n)) {
+            len = colon;
             portOut = n;
         }
     }
-    if (in.size()>0 && in[0] == '[' && in[in.size()-1] == ']')
-        hostOut = in.substr(1, in.size()-2);
+    if (len>0 && in[0] == '[' && in[len-1] == ']')
+        hostOut.assign(in, 1, len-2);
     else
-        hostOut = in;
+        hostOut.assign(in, 0, len);
 }
 
-std::string EncodeBase64(const unsigned char* pch, size_t len)
+/** Dotted quad with four decimal parts of at most 255 and no leading zeros. */
+static bool IsIPv4Literal(const char* p, size_t len)
+{
+    size_t i = 0;
+    for (int part = 0; part < 4; part++) {
+        if (part > 0) {
+            if (i == len || p[i] != '.')
+                return false;
+            ++i;
+        }
+        size_t start = i;
+        unsigned int n = 0;
+        while (i < len && i - start < 4 && p[i] >= '0' && p[i] <= '9')
+            n = n * 10 + (p[i++] - '0');
+        if (i == start || n > 255 || (p[start] == '0' && i - start > 1))
+            return false;
+    }
+    return i == len;
+}
+
+/** RFC 4291 text form: up to eight hex groups, at most one "::", optional IPv4 tail. */
+static bool IsIPv6Literal(const char* p, size_t len)
+{
+    size_t i = 0;
+    int groups = 0;
+    bool compressed = false;
+    if (len >= 2 && p[0] == ':' && p[1] == ':') {
+        compressed = true;
+        i = 2;
+    } else if (len && p[0] == ':') {
+        return false;
+    }
+    while (i < len) {
+        size_t start = i;
+        while (i < len && HexDigit(p[i]) >= 0)
+            ++i;
+        if (i < len && p[i] == '.') {
+            // embedded IPv4 address, must be the last two groups
+            if (!IsIPv4Literal(p + start, len - start))
+                return false;
+            groups += 2;
+            break;
+        }
+        if (i == start || i - start > 4)
+            return false;
+        ++groups;
+        if (i == len)
+            break;
+        if (p[i] != ':')
+            return false;
+        if (++i < len && p[i] == ':') {
+            if (compressed)
+                return false;
+            compressed = true;
+            ++i;
+        } else if (i == len) {
+            return false; // trailing single ':'
+        }
+    }
+    return compressed ? groups <= 7 : groups == 8;
+}
+
+/** Classify a host that contains no ':'. Digits-and-dots must form an IPv4 address. */
+static bool ClassifyHost(const char* p, size_t len, Endpoint::HostType& type)
+{
+    if (len == 0 || len > 255)
+        return false;
+    bool numeric = true;
+    for (size_t i = 0; i < len; i++) {
+        char c = p[i];
+        if ((c >= '0' && c <= '9') || c == '.')
+            continue;
+        numeric = false;
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '_'))
+            return false;
+    }
+    if (numeric) {
+        type = Endpoint::HOST_IPV4;
+        return IsIPv4Literal(p, len);
+    }
+    type = Endpoint::HOST_NAME;
+    return true;
+}
+
+bool ParseEndpoint(const char* in, size_t len, Endpoint& ep, uint16_t default_port)
+{
+    const char* host = in;
+    size_t host_len = len;
+    const char* port = nullptr;
+    size_t port_len = 0;
+    Endpoint::HostType type;
+
+    if (len && in[0] == '[') {
+        const char* close = (const char*)memchr(in, ']', len);
+        if (!close)
+            return false;
+        host = in + 1;
+        host_len = close - host;
+        const size_t rest = in + len - (close + 1);
+        if (rest) {
+            if (close[1] != ':')
+                return false;
+            port = close + 2;
+            port_len = rest - 1;
+        }
+        if (!IsIPv6Literal(host, host_len))
+            return false;
+        type = Endpoint::HOST_IPV6;
+    } else {
+        const char* colon = (const char*)memchr(in, ':', len);
+        if (colon && memchr(colon + 1, ':', in + len - (colon + 1))) {
+            // more than one ':' without brackets: a bare IPv6 literal, no port
+            if (!IsIPv6Literal(in, len))
+                return false;
+            type = Endpoint::HOST_IPV6;
+        } else {
+            if (colon) {
+                host_len = colon - in;
+                port = colon + 1;
+                port_len = in + len - port;
+            }
+            if (!ClassifyHost(host, host_len, type))
+                return false;
+        }
+    }
+
+    uint16_t n = default_port;
+    if (port && !ParsePortStrict(port, port_len, n))
+        return false;
+    ep.host = host;
+    ep.host_len = host_len;
+    ep.port = n;
+    ep.type = type;
+    return true;
+}
+
+size_t ParseEndpoints(const char* in, size_t len, std::vector<Endpoint>& out,
+                      uint16_t default_port, std::vector<size_t>* bad_lines)
 {
-    static const char *pbase64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const char* end = in + len;
+    size_t lines = 1;
+    for (const char* p = in; (p = (const char*)memchr(p, '\n', end - p)); ++p)
+        ++lines;
+    out.reserve(out.size() + lines);
+
+    size_t bad = 0;
+    size_t line = 0;
+    for (const char* p = in; p < end; ) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        const char* eol = nl ? nl : end;
+        ++line;
+        const char* b = p;
+        const char* e = eol;
+        while (b < e && isspace(*b))
+            ++b;
+        while (e > b && isspace(e[-1]))
+            --e;
+        if (b < e && *b != '#') {
+            Endpoint ep;
+            if (ParseEndpoint(b, e - b, ep, default_port)) {
+                out.push_back(ep);
+            } else {
+                ++bad;
+                if (bad_lines)
+                    bad_lines->push_back(line);
+            }
+        }
+        p = eol + 1;
+    }
+    return bad;
+}
+
+static const char *pbase64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+std::string EncodeBase64(const unsigned char* pch, size_t len)
+{
     std::string strRet = "";
     strRet.reserve((len+2)/3*4);
 
@@ -161,25 +367,25 @@ std::string EncodeBase64(const std::string& str)
     return EncodeBase64((const unsigned char*)str.c_str(), str.size());
 }
 
-std::vector<unsigned char> DecodeBase64(const char* p, bool* pfInvalid)
+static const int decode64_table[256] =
 {
-    static const int decode64_table[256] =
-    {
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, 62, -1, -1, -1, 63, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1,
-        -1, -1, -1, -1, -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
-        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1, -1, 26, 27, 28,
-        29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
-        49, 50, 51, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-    };
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, 62, -1, -1, -1, 63, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1,
+    -1, -1, -1, -1, -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1, -1, 26, 27, 28,
+    29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+    49, 50, 51, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
 
+std::vector<unsigned char> DecodeBase64(const char* p, bool* pfInvalid)
+{
     if (pfInvalid)
         *pfInvalid = false;
 
@@ -246,14 +452,17 @@ std::vector<unsigned char> DecodeBase64(const char* p, bool* pfInvalid)
 
 std::string DecodeBase64(const std::string& str)
 {
-    std::vector<unsigned char> vchRet = DecodeBase64(str.c_str());
-    return std::string((const char*)vchRet.data(), vchRet.size());
+    // Decode straight into the result instead of going through a vector;
+    // like DecodeBase64(const char*) this stops at the first invalid char.
+    std::string strRet;
+    Base64Decoder().Update(str.c_str(), str.size(), strRet);
+    return strRet;
 }
 
+static const char *pbase32 = "abcdefghijklmnopqrstuvwxyz234567";
+
 std::string EncodeBase32(const unsigned char* pch, size_t len)
 {
-    static const char *pbase32 = "abcdefghijklmnopqrstuvwxyz234567";
-
     std::string strRet="";
     strRet.reserve((len+4)/5*8);
 
@@ -314,25 +523,25 @@ std::string EncodeBase32(const std::string& str)
     return EncodeBase32((const unsigned char*)str.c_str(), str.size());
 }
 
-std::vector<unsigned char> DecodeBase32(const char* p, bool* pfInvalid)
+static const int decode32_table[256] =
 {
-    static const int decode32_table[256] =
-    {
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 26, 27, 28, 29, 30, 31, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
-        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1, -1,  0,  1,  2,
-         3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
-        23, 24, 25, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-    };
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 26, 27, 28, 29, 30, 31, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1, -1,  0,  1,  2,
+     3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+    23, 24, 25, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
 
+std::vector<unsigned char> DecodeBase32(const char* p, bool* pfInvalid)
+{
     if (pfInvalid)
         *pfInvalid = false;
 
@@ -433,10 +642,215 @@ std::vector<unsigned char> DecodeBase32(const char* p, bool* pfInvalid)
 
 std::string DecodeBase32(const std::string& str)
 {
-    std::vector<unsigned char> vchRet = DecodeBase32(str.c_str());
-    return std::string((const char*)vchRet.data(), vchRet.size());
+    std::string strRet;
+    Base32Decoder().Update(str.c_str(), str.size(), strRet);
+    return strRet;
+}
+
+static const char hexmap[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
+                                 '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+size_t HexEncoder::Update(const unsigned char* in, size_t len, char* out)
+{
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = hexmap[in[i] >> 4];
+        out[2 * i + 1] = hexmap[in[i] & 15];
+    }
+    return 2 * len;
+}
+
+void HexEncoder::Update(const unsigned char* in, size_t len, std::string& str)
+{
+    size_t old_size = str.size();
+    str.resize(old_size + 2 * len);
+    Update(in, len, &str[old_size]);
+}
+
+void HexDecoder::Reset()
+{
+    m_consumed = 0;
+    m_error_offset = 0;
+    m_high = -1;
+    m_failed = false;
+}
+
+size_t HexDecoder::Update(const char* in, size_t len, unsigned char* out)
+{
+    if (m_failed)
+        return 0;
+    unsigned char* p = out;
+    for (size_t i = 0; i < len; i++) {
+        signed char c = HexDigit(in[i]);
+        if (c < 0) {
+            // whitespace may only separate complete bytes, as in ParseHex()
+            if (m_high < 0 && isspace(in[i]))
+                continue;
+            m_failed = true;
+            m_error_offset = m_consumed + i;
+            m_consumed += i;
+            return p - out;
+        }
+        if (m_high < 0) {
+            m_high = c;
+        } else {
+            *p++ = (m_high << 4) | c;
+            m_high = -1;
+        }
+    }
+    m_consumed += len;
+    return p - out;
+}
+
+bool HexDecoder::Update(const char* in, size_t len, std::vector<unsigned char>& vch)
+{
+    size_t old_size = vch.size();
+    // a pending high nibble from the previous chunk yields at most one extra byte
+    vch.resize(old_size + (len + 1) / 2);
+    vch.resize(old_size + Update(in, len, vch.data() + old_size));
+    return !m_failed;
+}
+
+bool HexDecoder::Finalize()
+{
+    if (!m_failed && m_high >= 0) {
+        m_failed = true;
+        m_error_offset = m_consumed;
+    }
+    return !m_failed;
 }
 
+size_t BaseNEncoder::Update(const unsigned char* in, size_t len, char* out)
+{
+    const uint32_t mask = (1U << m_bits_per_char) - 1;
+    char* p = out;
+    for (size_t i = 0; i < len; i++) {
+        m_bits = (m_bits << 8) | in[i];
+        m_nbits += 8;
+        while (m_nbits >= m_bits_per_char) {
+            m_nbits -= m_bits_per_char;
+            *p++ = m_alphabet[(m_bits >> m_nbits) & mask];
+        }
+    }
+    m_count = (m_count + (p - out)) % m_group;
+    return p - out;
+}
+
+void BaseNEncoder::Update(const unsigned char* in, size_t len, std::string& str)
+{
+    // whole groups of output for every started group of input bytes, which
+    // also covers the bits carried over from the previous chunk
+    const size_t group_bytes = m_group * m_bits_per_char / 8;
+    size_t old_size = str.size();
+    str.resize(old_size + (len + group_bytes - 1) / group_bytes * m_group);
+    str.resize(old_size + Update(in, len, &str[old_size]));
+}
+
+size_t BaseNEncoder::Finalize(char* out)
+{
+    char* p = out;
+    if (m_nbits) {
+        const uint32_t mask = (1U << m_bits_per_char) - 1;
+        *p++ = m_alphabet[(m_bits << (m_bits_per_char - m_nbits)) & mask];
+        m_count = (m_count + 1) % m_group;
+    }
+    while (m_count) {
+        *p++ = '=';
+        m_count = (m_count + 1) % m_group;
+    }
+    Reset();
+    return p - out;
+}
+
+void BaseNEncoder::Finalize(std::string& str)
+{
+    char buf[8];
+    str.append(buf, Finalize(buf));
+}
+
+void BaseNDecoder::Reset()
+{
+    m_bits = 0;
+    m_nbits = 0;
+    m_pos = 0;
+    m_padding = false;
+    m_done = false;
+    m_consumed = 0;
+    m_error_offset = 0;
+    m_failed = false;
+}
+
+bool BaseNDecoder::Fail(size_t offset)
+{
+    m_failed = true;
+    m_error_offset = offset;
+    return false;
+}
+
+size_t BaseNDecoder::Update(const char* in, size_t len, unsigned char* out)
+{
+    if (m_failed)
+        return 0;
+    unsigned char* p = out;
+    for (size_t i = 0; i < len; i++) {
+        int dec = m_table[(unsigned char)in[i]];
+        if (dec >= 0 && !m_padding && !m_done) {
+            m_bits = (m_bits << m_bits_per_char) | dec;
+            m_nbits += m_bits_per_char;
+            if (m_nbits >= 8) {
+                m_nbits -= 8;
+                *p++ = m_bits >> m_nbits;
+            }
+            m_bits &= (1U << m_nbits) - 1;
+            m_pos = (m_pos + 1) % m_group;
+        } else if (in[i] == '=' && !m_done &&
+                   (m_padding || (((m_pad_positions >> m_pos) & 1) && m_bits == 0))) {
+            // padding starts where the decoder functions accept it and
+            // requires the dangling bits to be zero
+            m_padding = true;
+            m_pos = (m_pos + 1) % m_group;
+            if (m_pos == 0)
+                m_done = true;
+        } else {
+            m_consumed += i;
+            Fail(m_consumed);
+            return p - out;
+        }
+    }
+    m_consumed += len;
+    return p - out;
+}
+
+bool BaseNDecoder::Update(const char* in, size_t len, std::vector<unsigned char>& vch)
+{
+    size_t old_size = vch.size();
+    vch.resize(old_size + MaxDecoded(len));
+    vch.resize(old_size + Update(in, len, vch.data() + old_size));
+    return !m_failed;
+}
+
+bool BaseNDecoder::Update(const char* in, size_t len, std::string& str)
+{
+    size_t old_size = str.size();
+    str.resize(old_size + MaxDecoded(len));
+    str.resize(old_size + Update(in, len, (unsigned char*)&str[old_size]));
+    return !m_failed;
+}
+
+bool BaseNDecoder::Finalize()
+{
+    if (!m_failed && m_pos != 0)
+        return Fail(m_consumed);
+    return !m_failed;
+}
+
+// 4n+2 and 4n+3 base64 characters may be followed by padding
+Base64Encoder::Base64Encoder() : BaseNEncoder(pbase64, 6, 4) {}
+Base64Decoder::Base64Decoder() : BaseNDecoder(decode64_table, 6, 4, (1U << 2) | (1U << 3)) {}
+
+// 8n+2, 8n+4, 8n+5 and 8n+7 base32 characters may be followed by padding
+Base32Encoder::Base32Encoder() : BaseNEncoder(pbase32, 5, 8) {}
+Base32Decoder::Base32Decoder() : BaseNDecoder(decode32_table, 5, 8, (1U << 2) | (1U << 4) | (1U << 5) | (1U << 7)) {}
+
 static bool ParsePrechecks(const std::string& str)
 {
     if (str.empty()) // No empty string allowed
@@ -527,55 +941,255 @@ bool ParseDouble(const std::string& str, double *out)
     return text.eof() && !text.fail();
 }
 
-std::string FormatParagraph(const std::string& in, size_t width, size_t indent)
+/** Byte offset reached after skipping cols characters from ptr, or end. */
+static size_t AdvanceColumns(const char* in, size_t ptr, size_t end, size_t cols, bool utf8)
+{
+    if (!utf8)
+        return cols >= end - ptr ? end : ptr + cols;
+    while (ptr < end && cols) {
+        // skip the lead byte and all of its continuation bytes
+        ++ptr;
+        while (ptr < end && (in[ptr] & 0xC0) == 0x80)
+            ++ptr;
+        --cols;
+    }
+    return ptr;
+}
+
+static const char spaces[64] = {
+    ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+    ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+    ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+    ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ' };
+
+/**
+ * Word wrapping shared by the FormatParagraph() variants. Output goes to
+ * sink.Write(const char*, size_t) as slices of the input, so no line is
+ * ever copied.
+ */
+template<typename Sink>
+static void FormatParagraphImpl(Sink& sink, const char* in, size_t len, size_t width, size_t indent, bool utf8)
 {
-    std::stringstream out;
     size_t ptr = 0;
     size_t indented = 0;
-    while (ptr < in.size())
+    while (ptr < len)
     {
-        size_t lineend = in.find_first_of('\n', ptr);
-        if (lineend == std::string::npos) {
-            lineend = in.size();
-        }
-        const size_t linelen = lineend - ptr;
+        const char* nl = (const char*)memchr(in + ptr, '\n', len - ptr);
+        const size_t lineend = nl ? nl - in : len;
         const size_t rem_width = width - indented;
-        if (linelen <= rem_width) {
-            out << in.substr(ptr, linelen + 1);
+        // lim is the start of the character in column rem_width
+        const size_t lim = AdvanceColumns(in, ptr, lineend, rem_width, utf8);
+        if (lim == lineend) {
+            sink.Write(in + ptr, std::min(lineend + 1, len) - ptr);
             ptr = lineend + 1;
             indented = 0;
         } else {
-            size_t finalspace = in.find_last_of(" \n", ptr + rem_width);
-            if (finalspace == std::string::npos || finalspace < ptr) {
+            // No newline before lineend, so only spaces can break the line
+            size_t finalspace = lim;
+            while (finalspace > ptr && in[finalspace] != ' ')
+                --finalspace;
+            if (in[finalspace] != ' ') {
                 // No place to break; just include the entire word and move on
-                finalspace = in.find_first_of("\n ", ptr);
-                if (finalspace == std::string::npos) {
+                const char* sp = (const char*)memchr(in + lim, ' ', lineend - lim);
+                finalspace = sp ? sp - in : lineend;
+                if (finalspace == len) {
                     // End of the string, just add it and break
-                    out << in.substr(ptr);
+                    sink.Write(in + ptr, len - ptr);
                     break;
                 }
             }
-            out << in.substr(ptr, finalspace - ptr) << "\n";
+            sink.Write(in + ptr, finalspace - ptr);
+            sink.Write("\n", 1);
             if (in[finalspace] == '\n') {
                 indented = 0;
             } else if (indent) {
-                out << std::string(indent, ' ');
+                for (size_t n = indent; n > 0; n -= std::min(n, sizeof(spaces)))
+                    sink.Write(spaces, std::min(n, sizeof(spaces)));
                 indented = indent;
             }
             ptr = finalspace + 1;
         }
     }
-    return out.str();
+}
+
+/** Sink that writes into a fixed buffer and counts what did not fit. */
+class BufferSink
+{
+public:
+    BufferSink(char* out, size_t out_size) : m_out(out), m_size(out_size), m_total(0) {}
+
+    void Write(const char* p, size_t n)
+    {
+        if (m_total < m_size)
+            memcpy(m_out + m_total, p, std::min(n, m_size - m_total));
+        m_total += n;
+    }
+
+    size_t Total() const { return m_total; }
+
+private:
+    char* m_out;
+    size_t m_size;
+    size_t m_total;
+};
+
+/** Sink that batches output in a stack buffer and flushes it to an fd. */
+class FdSink
+{
+public:
+    explicit FdSink(int fd) : m_fd(fd), m_used(0), m_ok(true) {}
+
+    void Write(const char* p, size_t n)
+    {
+        while (n) {
+            if (m_used == sizeof(m_buf))
+                Flush();
+            size_t chunk = std::min(n, sizeof(m_buf) - m_used);
+            memcpy(m_buf + m_used, p, chunk);
+            m_used += chunk;
+            p += chunk;
+            n -= chunk;
+        }
+    }
+
+    bool Flush()
+    {
+        const char* p = m_buf;
+        while (m_ok && p < m_buf + m_used) {
+            ssize_t ret = write(m_fd, p, m_buf + m_used - p);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0)
+                m_ok = false;
+            else
+                p += ret;
+        }
+        m_used = 0;
+        return m_ok;
+    }
+
+private:
+    int m_fd;
+    char m_buf[4096];
+    size_t m_used;
+    bool m_ok;
+};
+
+std::string FormatParagraph(const std::string& in, size_t width, size_t indent, bool utf8)
+{
+    // Measure first so the result is allocated exactly once
+    BufferSink counter(nullptr, 0);
+    FormatParagraphImpl(counter, in.data(), in.size(), width, indent, utf8);
+    std::string out(counter.Total(), '\0');
+    BufferSink sink(&out[0], out.size());
+    FormatParagraphImpl(sink, in.data(), in.size(), width, indent, utf8);
+    return out;
+}
+
+size_t FormatParagraph(char* out, size_t out_size, const char* in, size_t len,
+                       size_t width, size_t indent, bool utf8)
+{
+    BufferSink sink(out, out_size);
+    FormatParagraphImpl(sink, in, len, width, indent, utf8);
+    return sink.Total();
+}
+
+bool WriteParagraph(int fd, const std::string& in, size_t width, size_t indent, bool utf8)
+{
+    FdSink sink(fd);
+    FormatParagraphImpl(sink, in.data(), in.size(), width, indent, utf8);
+    return sink.Flush();
+}
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static inline size_t CountDigits(uint64_t n)
+{
+    size_t digits = 1;
+    for (;;) {
+        if (n < 10) return digits;
+        if (n < 100) return digits + 1;
+        if (n < 1000) return digits + 2;
+        if (n < 10000) return digits + 3;
+        n /= 10000;
+        digits += 4;
+    }
+}
+
+size_t WriteUInt64(char* out, uint64_t n)
+{
+    const size_t len = CountDigits(n);
+    char* p = out + len;
+    while (n >= 100) {
+        const unsigned int i = (n % 100) * 2;
+        n /= 100;
+        *--p = digit_pairs[i + 1];
+        *--p = digit_pairs[i];
+    }
+    if (n >= 10) {
+        *--p = digit_pairs[n * 2 + 1];
+        *--p = digit_pairs[n * 2];
+    } else {
+        *--p = '0' + n;
+    }
+    return len;
+}
+
+size_t WriteInt64(char* out, int64_t n)
+{
+    if (n >= 0)
+        return WriteUInt64(out, n);
+    *out = '-';
+    // negate in unsigned arithmetic so that INT64_MIN does not overflow
+    return 1 + WriteUInt64(out + 1, 0 - (uint64_t)n);
+}
+
+size_t WriteHex64(char* out, uint64_t n, size_t width)
+{
+    size_t len = 1;
+    while (len < 16 && (n >> (4 * len)))
+        ++len;
+    if (width > 16)
+        width = 16;
+    if (len < width)
+        len = width;
+    for (size_t i = len; i > 0; n >>= 4)
+        out[--i] = hexmap[n & 15];
+    return len;
 }
 
 std::string i64tostr(int64_t n)
 {
-    return strprintf("%d", n);
+    char buf[INTSTR_MAX_SIZE];
+    return std::string(buf, WriteInt64(buf, n));
+}
+
+std::string u64tostr(uint64_t n)
+{
+    char buf[INTSTR_MAX_SIZE];
+    return std::string(buf, WriteUInt64(buf, n));
 }
 
 std::string itostr(int n)
 {
-    return strprintf("%d", n);
+    char buf[INTSTR_MAX_SIZE];
+    return std::string(buf, WriteInt64(buf, n));
+}
+
+std::string u64tohex(uint64_t n, size_t width)
+{
+    char buf[INTSTR_MAX_SIZE];
+    return std::string(buf, WriteHex64(buf, n, width));
 }
 
 int64_t atoi64(const char* psz)
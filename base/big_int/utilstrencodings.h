@@ -10,6 +10,7 @@
 #define BITCOIN_UTILSTRENCODINGS_H
 
 #include <stdint.h>
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -48,9 +49,223 @@ std::string DecodeBase32(const std::string& str);
 std::string EncodeBase32(const unsigned char* pch, size_t len);
 std::string EncodeBase32(const std::string& str);
 
-void SplitHostPort(std::string in, int &portOut, std::string &hostOut);
+/**
+ * Incremental hex encoder. Input may be fed in arbitrary chunks; every
+ * call writes exactly 2*len characters to the caller's buffer.
+ */
+class HexEncoder
+{
+public:
+    /** Encode len bytes into out, which must have room for 2*len chars.
+     * @returns the number of characters written. */
+    size_t Update(const unsigned char* in, size_t len, char* out);
+    /** Append the encoding of len bytes to str. */
+    void Update(const unsigned char* in, size_t len, std::string& str);
+};
+
+/**
+ * Incremental hex decoder, the streaming counterpart of ParseHex().
+ * A dangling nibble is carried across Update() calls, and whitespace is
+ * accepted between (but not inside) byte pairs. Unlike ParseHex() any
+ * other character is an error, reported at its offset in the stream.
+ */
+class HexDecoder
+{
+public:
+    HexDecoder() { Reset(); }
+
+    /** Decode len chars into out, which must have room for (len + 1) / 2 bytes.
+     * Stops at the first invalid character.
+     * @returns the number of bytes written. */
+    size_t Update(const char* in, size_t len, unsigned char* out);
+    /** Append the decoding of len chars to vch. @returns false on error. */
+    bool Update(const char* in, size_t len, std::vector<unsigned char>& vch);
+    /** Signal end of input. @returns false if the stream was invalid or
+     * ended on half a byte. */
+    bool Finalize();
+
+    bool Failed() const { return m_failed; }
+    /** Offset in the stream of the offending character; only valid if Failed(). */
+    size_t ErrorOffset() const { return m_error_offset; }
+    /** Total number of characters consumed so far. */
+    size_t Consumed() const { return m_consumed; }
+    void Reset();
+
+private:
+    size_t m_consumed;
+    size_t m_error_offset;
+    int m_high; //!< pending high nibble, or -1
+    bool m_failed;
+};
+
+/**
+ * Incremental base64/base32 encoder. Leftover bits of an incomplete group
+ * are carried across Update() calls; Finalize() flushes them and writes
+ * the '=' padding.
+ */
+class BaseNEncoder
+{
+public:
+    /** Encode len bytes into out, which must have room for (len + 2) / 3 * 4
+     * chars for base64 or (len + 4) / 5 * 8 for base32.
+     * @returns the number of characters written. */
+    size_t Update(const unsigned char* in, size_t len, char* out);
+    void Update(const unsigned char* in, size_t len, std::string& str);
+    /** Write the final partial group and padding (at most 8 chars) to out.
+     * @returns the number of characters written. */
+    size_t Finalize(char* out);
+    void Finalize(std::string& str);
+    void Reset() { m_bits = 0; m_nbits = 0; m_count = 0; }
+
+protected:
+    BaseNEncoder(const char* alphabet, int bits, int group) : m_alphabet(alphabet), m_bits_per_char(bits), m_group(group) { Reset(); }
+
+private:
+    const char* m_alphabet;
+    int m_bits_per_char;
+    int m_group;    //!< characters per padded group
+    uint32_t m_bits;
+    int m_nbits;
+    size_t m_count; //!< characters produced, modulo m_group
+};
+
+/**
+ * Incremental base64/base32 decoder, the streaming counterpart of
+ * DecodeBase64() and DecodeBase32(). Padding follows the rules of the
+ * pfInvalid checks of those functions, but trailing characters are an
+ * error rather than silently dropped. The first violation is reported at
+ * its offset in the stream.
+ */
+class BaseNDecoder
+{
+public:
+    /** Decode len chars into out, which must have room for len * 3 / 4 + 2
+     * bytes for base64 or len * 5 / 8 + 2 for base32.
+     * Stops at the first invalid character.
+     * @returns the number of bytes written. */
+    size_t Update(const char* in, size_t len, unsigned char* out);
+    bool Update(const char* in, size_t len, std::vector<unsigned char>& vch);
+    bool Update(const char* in, size_t len, std::string& str);
+    /** Signal end of input. @returns false if the stream was invalid or
+     * ended inside an unpadded group. */
+    bool Finalize();
+
+    bool Failed() const { return m_failed; }
+    size_t ErrorOffset() const { return m_error_offset; }
+    size_t Consumed() const { return m_consumed; }
+    void Reset();
+
+protected:
+    BaseNDecoder(const int* table, int bits, int group, unsigned int pad_positions) :
+        m_table(table), m_bits_per_char(bits), m_group(group), m_pad_positions(pad_positions) { Reset(); }
+
+private:
+    bool Fail(size_t offset);
+    /** Upper bound on the bytes decoded from len chars plus the carried bits. */
+    size_t MaxDecoded(size_t len) const { return len / 8 * m_bits_per_char + len % 8 * m_bits_per_char / 8 + 2; }
+
+    const int* m_table;
+    int m_bits_per_char;
+    int m_group;
+    unsigned int m_pad_positions; //!< bitmask of group positions where padding may start
+    uint32_t m_bits;
+    int m_nbits;
+    int m_pos;       //!< characters seen in the current group
+    bool m_padding;  //!< inside the '=' run of the final group
+    bool m_done;     //!< final group complete, no more input allowed
+    size_t m_consumed;
+    size_t m_error_offset;
+    bool m_failed;
+};
+
+class Base64Encoder : public BaseNEncoder
+{
+public:
+    Base64Encoder();
+};
+
+class Base64Decoder : public BaseNDecoder
+{
+public:
+    Base64Decoder();
+};
+
+class Base32Encoder : public BaseNEncoder
+{
+public:
+    Base32Encoder();
+};
+
+class Base32Decoder : public BaseNDecoder
+{
+public:
+    Base32Decoder();
+};
+
+void SplitHostPort(const std::string& in, int &portOut, std::string &hostOut);
+
+/** A host/port pair as returned by ParseEndpoint(). */
+struct Endpoint
+{
+    enum HostType
+    {
+        HOST_NAME,
+        HOST_IPV4,
+        HOST_IPV6,
+    };
+
+    const char* host; //!< points into the parsed input, without brackets
+    size_t host_len;
+    uint16_t port;
+    HostType type;
+
+    std::string Host() const { return std::string(host, host_len); }
+};
+
+/**
+ * Strict, allocation-free counterpart of SplitHostPort(). Accepts
+ * "host", "host:port", "[ipv6]", "[ipv6]:port" and bare IPv6 literals.
+ * IP literals are validated while they are scanned, and anything that
+ * SplitHostPort() would silently keep as part of the host (bad ports,
+ * malformed addresses, stray characters) is rejected.
+ * @param[out] ep    Host slice into in, port (default_port if none given) and host type
+ * @returns true on success; ep is left untouched on failure.
+ */
+bool ParseEndpoint(const char* in, size_t len, Endpoint& ep, uint16_t default_port = 0);
+
+/**
+ * Parse a newline-separated list of endpoints, e.g. a peers file. Blank
+ * lines and lines starting with '#' are skipped, surrounding whitespace
+ * (including a CR of CRLF line endings) is ignored.
+ * @param[out] out        Parsed endpoints are appended here
+ * @param[out] bad_lines  If not null, 1-based numbers of unparsable lines are appended here
+ * @returns the number of unparsable lines.
+ */
+size_t ParseEndpoints(const char* in, size_t len, std::vector<Endpoint>& out,
+                      uint16_t default_port = 0, std::vector<size_t>* bad_lines = nullptr);
+
+/** Buffer size that fits any integer written by the functions below. */
+static const size_t INTSTR_MAX_SIZE = 20;
+
+/**
+ * Write the decimal representation of n to out, two digits at a time from
+ * a digit-pair table. out must have room for INTSTR_MAX_SIZE chars; no
+ * terminating NUL is written.
+ * @returns the number of characters written.
+ */
+size_t WriteUInt64(char* out, uint64_t n);
+size_t WriteInt64(char* out, int64_t n);
+/**
+ * Write n as lowercase hex, zero-padded to at least width digits (at most
+ * 16). out must have room for INTSTR_MAX_SIZE chars.
+ * @returns the number of characters written.
+ */
+size_t WriteHex64(char* out, uint64_t n, size_t width = 0);
+
 std::string i64tostr(int64_t n);
+std::string u64tostr(uint64_t n);
 std::string itostr(int n);
+std::string u64tohex(uint64_t n, size_t width = 0);
 int64_t atoi64(const char* psz);
 int64_t atoi64(const std::string& str);
 int atoi(const std::string& str);
@@ -117,9 +332,108 @@ inline std::string HexStr(const T& vch, bool fSpaces=false)
 
 /**
  * Format a paragraph of text to a fixed width, adding spaces for
- * indentation to any added line.
+ * indentation to any added line. If utf8 is set, width is counted in
+ * code points rather than bytes.
+ */
+std::string FormatParagraph(const std::string& in, size_t width = 79, size_t indent = 0, bool utf8 = false);
+
+/**
+ * Format a paragraph into a caller-provided buffer without allocating.
+ * At most out_size bytes are written and the output is not NUL-terminated.
+ * @returns the size of the complete output; if this exceeds out_size the
+ *   output was truncated.
  */
-std::string FormatParagraph(const std::string& in, size_t width = 79, size_t indent = 0);
+size_t FormatParagraph(char* out, size_t out_size, const char* in, size_t len,
+                       size_t width = 79, size_t indent = 0, bool utf8 = false);
+
+/**
+ * Format a paragraph straight to a file descriptor through a fixed stack
+ * buffer.
+ * @returns false if a write failed.
+ */
+bool WriteParagraph(int fd, const std::string& in, size_t width = 79, size_t indent = 0, bool utf8 = false);
+
+/**
+ * Constant-time primitives. They process whole 64-bit words (which the
+ * compiler is free to widen to SIMD lanes) and never branch on or index by
+ * the data, so their running time depends only on len.
+ */
+
+/** Hide v from the optimizer so it cannot turn a data-independent loop into an early exit. */
+static inline uint64_t ConstantTimeBarrier(uint64_t v)
+{
+#if defined(__GNUC__)
+    __asm__("" : "+r"(v));
+#endif
+    return v;
+}
+
+/** OR of the XOR of two buffers: zero iff they are equal. */
+static inline uint64_t ConstantTimeDiff(const unsigned char* a, const unsigned char* b, size_t len)
+{
+    uint64_t acc = 0;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t wa, wb;
+        memcpy(&wa, a + i, 8);
+        memcpy(&wb, b + i, 8);
+        acc |= wa ^ wb;
+    }
+    for (; i < len; i++)
+        acc |= a[i] ^ b[i];
+    return ConstantTimeBarrier(acc);
+}
+
+/** All-ones if cond is true, zero otherwise, without a branch. */
+static inline uint64_t ConstantTimeMask(bool cond)
+{
+    return 0 - (uint64_t)ConstantTimeBarrier(cond);
+}
+
+static inline bool ConstantTimeEqual(const void* a, const void* b, size_t len)
+{
+    return ConstantTimeDiff((const unsigned char*)a, (const unsigned char*)b, len) == 0;
+}
+
+static inline bool ConstantTimeIsZero(const void* p, size_t len)
+{
+    const unsigned char* c = (const unsigned char*)p;
+    uint64_t acc = 0;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, c + i, 8);
+        acc |= w;
+    }
+    for (; i < len; i++)
+        acc |= c[i];
+    return ConstantTimeBarrier(acc) == 0;
+}
+
+/** out = cond ? a : b. out may alias a or b. */
+static inline void ConstantTimeSelect(void* out, const void* a, const void* b, size_t len, bool cond)
+{
+    unsigned char* o = (unsigned char*)out;
+    const unsigned char* pa = (const unsigned char*)a;
+    const unsigned char* pb = (const unsigned char*)b;
+    const uint64_t mask = ConstantTimeMask(cond);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t wa, wb;
+        memcpy(&wa, pa + i, 8);
+        memcpy(&wb, pb + i, 8);
+        wa = wb ^ ((wa ^ wb) & mask);
+        memcpy(o + i, &wa, 8);
+    }
+    for (; i < len; i++)
+        o[i] = pb[i] ^ ((pa[i] ^ pb[i]) & (unsigned char)mask);
+}
+
+/** if (cond) memcpy(dst, src, len), touching dst either way. */
+static inline void ConstantTimeCopy(void* dst, const void* src, size_t len, bool cond)
+{
+    ConstantTimeSelect(dst, src, dst, len, cond);
+}
 
 /**
  * Timing-attack-resistant comparison.
@@ -130,9 +444,15 @@ template <typename T>
 bool TimingResistantEqual(const T& a, const T& b)
 {
     if (b.size() == 0) return a.size() == 0;
-    size_t accumulator = a.size() ^ b.size();
-    for (size_t i = 0; i < a.size(); i++)
-        accumulator |= a[i] ^ b[i%b.size()];
+    const unsigned char* pa = a.size() ? (const unsigned char*)&a[0] : nullptr;
+    const unsigned char* pb = (const unsigned char*)&b[0];
+    const size_t n = a.size() < b.size() ? a.size() : b.size();
+    uint64_t accumulator = a.size() ^ b.size();
+    accumulator |= ConstantTimeDiff(pa, pb, n);
+    // Only reached on a length mismatch: keep scanning a against b wrapped
+    // around, as the byte-wise version did.
+    for (size_t i = n; i < a.size(); i += b.size())
+        accumulator |= ConstantTimeDiff(pa + i, pb, a.size() - i < b.size() ? a.size() - i : b.size());
     return accumulator == 0;
 }
 
@@ -0,0 +1,44 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * libbitcoin blocks in a BlockStore:
+ *
+ *   AppendBlock(store, block)          block.to_data(writer&) straight into
+ *                                      the segment mapping, no data_chunk
+ *   ReadBlock(store, height, block)    block.from_data(reader&) straight
+ *                                      from the mapping
+ *
+ * Code that only walks a block should take the bytes from
+ * BlockStore::Read() into a BlockView instead, which does not copy the
+ * scripts out.
+ */
+#ifndef NIUBLOCK_BITCOINBLOCKSTORE_H
+#define NIUBLOCK_BITCOINBLOCKSTORE_H
+
+#include "blockstore.h"
+
+#include <bitcoin/bitcoin.hpp>
+
+inline bool AppendBlock(NiuChain::BlockStore& store, const bc::chain::block& block)
+{
+    const size_t size = block.serialized_size();
+    unsigned char* out = store.Prepare(size);
+    if (!out)
+        return false;
+    auto sink = bc::make_unsafe_serializer(out);
+    block.to_data(sink);
+    return store.Append();
+}
+
+inline bool ReadBlock(const NiuChain::BlockStore& store, uint32_t height, bc::chain::block& block)
+{
+    const NiuChain::ArrayView<unsigned char> bytes = store.Read(height);
+    if (bytes.empty())
+        return false;
+    auto source = bc::make_safe_deserializer(bytes.begin(), bytes.end());
+    return block.from_data(source) && block.serialized_size() == bytes.size();
+}
+
+#endif // NIUBLOCK_BITCOINBLOCKSTORE_H
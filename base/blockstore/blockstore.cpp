@@ -0,0 +1,451 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockstore.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NiuChain {
+
+static const unsigned char SEGMENT_MAGIC[8] = {'N', 'I', 'U', 'B', 'L', 'K', 'S', '1'};
+static const unsigned char INDEX_MAGIC[8] = {'N', 'I', 'U', 'B', 'I', 'D', 'X', '1'};
+static const uint32_t SEGMENT_HEADER_SIZE = 8;
+static const uint32_t INDEX_HEADER_SIZE = 8;
+static const uint32_t RECORD_MAGIC = 0x4b4c424e;
+/** magic, block size, height, checksum */
+static const uint32_t RECORD_HEADER_SIZE = 16;
+/** hash, file, offset, size, checksum */
+static const size_t INDEX_ENTRY_SIZE = 32 + 4 + 4 + 4 + 4;
+
+static void PutLE32(unsigned char* out, uint32_t x)
+{
+    for (int i = 0; i < 4; i++)
+        out[i] = (unsigned char)(x >> (8 * i));
+}
+
+static uint32_t Checksum(const unsigned char* data, size_t size)
+{
+    unsigned char hash[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(data, size).Finalize(hash);
+    return ReadLE32(hash);
+}
+
+/** pwrite() all of data, retrying on partial writes and EINTR */
+static bool WriteAt(int fd, const unsigned char* data, size_t size, uint64_t offset)
+{
+    while (size > 0) {
+        const ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+/** pread() all of size bytes, false on error or end of file */
+static bool ReadAt(int fd, unsigned char* data, size_t size, uint64_t offset)
+{
+    while (size > 0) {
+        const ssize_t n = pread(fd, data, size, offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+static bool SyncDirectory(const std::string& dir)
+{
+    const int fd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    const bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+static std::string SegmentPath(const std::string& dir, uint32_t file)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/blk%05u.dat", file);
+    return dir + name;
+}
+
+BlockStore::BlockStore()
+    : m_segment_size(0),
+      m_index_fd(-1),
+      m_file(0),
+      m_offset(0),
+      m_prepared(0),
+      m_committed(0),
+      m_unsynced_file(0),
+      m_stats()
+{
+}
+
+BlockStore::~BlockStore()
+{
+    Close();
+}
+
+void BlockStore::Close()
+{
+    if (m_index_fd >= 0) {
+        Commit();
+        fdatasync(m_index_fd);
+        close(m_index_fd);
+    }
+    for (const Segment& segment : m_segments) {
+        munmap(segment.data, m_segment_size);
+        close(segment.fd);
+    }
+    m_index_fd = -1;
+    m_segments.clear();
+    m_locations.clear();
+    m_heights.clear();
+    m_tip_hash.SetNull();
+    m_file = 0;
+    m_offset = 0;
+    m_prepared = 0;
+    m_committed = 0;
+    m_unsynced_file = 0;
+}
+
+bool BlockStore::OpenSegment(uint32_t file, bool create)
+{
+    const std::string path = SegmentPath(m_dir, file);
+    int fd;
+    if (create) {
+        // Filled in and synced under a temporary name, so a crash never
+        // leaves a segment of the wrong size or without its magic
+        const std::string tmp = path + ".tmp";
+        fd = open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+        if (posix_fallocate(fd, 0, m_segment_size) != 0 ||
+            !WriteAt(fd, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC), 0) || fdatasync(fd) != 0 ||
+            rename(tmp.c_str(), path.c_str()) != 0) {
+            close(fd);
+            unlink(tmp.c_str());
+            return false;
+        }
+        SyncDirectory(m_dir);
+    } else {
+        fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        unsigned char magic[sizeof(SEGMENT_MAGIC)];
+        if (fstat(fd, &st) != 0 || (uint64_t)st.st_size != m_segment_size ||
+            !ReadAt(fd, magic, sizeof(magic), 0) || memcmp(magic, SEGMENT_MAGIC, sizeof(magic)) != 0) {
+            close(fd);
+            return false;
+        }
+    }
+    void* data = mmap(nullptr, m_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    Segment segment;
+    segment.fd = fd;
+    segment.data = static_cast<unsigned char*>(data);
+    m_segments.push_back(segment);
+    return true;
+}
+
+bool BlockStore::Open(const std::string& dir, uint32_t segment_size)
+{
+    Close();
+    m_dir = dir;
+    m_stats = BlockStoreStats();
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+
+    struct stat st;
+    if (stat(SegmentPath(dir, 0).c_str(), &st) == 0)
+        m_segment_size = st.st_size <= UINT32_MAX ? (uint32_t)st.st_size : 0;
+    else
+        m_segment_size = segment_size;
+    if (m_segment_size < SEGMENT_HEADER_SIZE + RECORD_HEADER_SIZE + HEADER_SIZE)
+        return false;
+
+    m_index_fd = open((dir + "/index.dat").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_index_fd < 0)
+        return false;
+    for (uint32_t file = 0; access(SegmentPath(dir, file).c_str(), F_OK) == 0; file++) {
+        if (!OpenSegment(file, false)) {
+            Close();
+            return false;
+        }
+    }
+    if (m_segments.empty() && !OpenSegment(0, true)) {
+        Close();
+        return false;
+    }
+    m_offset = SEGMENT_HEADER_SIZE;
+    if (!LoadIndex() || !Recover()) {
+        Close();
+        return false;
+    }
+    m_unsynced_file = m_file;
+    return true;
+}
+
+void BlockStore::Add(const Location& location, const uint256& hash)
+{
+    m_heights[hash] = (uint32_t)m_locations.size();
+    m_locations.push_back(location);
+    m_tip_hash = hash;
+    m_file = location.file;
+    m_offset = location.offset + location.size;
+}
+
+bool BlockStore::LoadIndex()
+{
+    struct stat st;
+    if (fstat(m_index_fd, &st) != 0)
+        return false;
+    if ((uint64_t)st.st_size < INDEX_HEADER_SIZE) {
+        // New, or torn before the magic made it to disk
+        return ftruncate(m_index_fd, 0) == 0 && WriteAt(m_index_fd, INDEX_MAGIC, sizeof(INDEX_MAGIC), 0);
+    }
+    std::vector<unsigned char> index(st.st_size);
+    if (!ReadAt(m_index_fd, index.data(), index.size(), 0) || memcmp(index.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+        return false;
+
+    // Entries are only written for synced blocks, so the checksum and the
+    // bounds are enough; a block's own bytes are not touched here
+    size_t count = 0;
+    for (const unsigned char* entry = index.data() + INDEX_HEADER_SIZE;
+         (size_t)(index.data() + index.size() - entry) >= INDEX_ENTRY_SIZE; entry += INDEX_ENTRY_SIZE) {
+        if (ReadLE32(entry + 44) != Checksum(entry, 44))
+            break;
+        Location location;
+        location.file = ReadLE32(entry + 32);
+        location.offset = ReadLE32(entry + 36);
+        location.size = ReadLE32(entry + 40);
+        if (location.file >= m_segments.size() || location.file < m_file ||
+            (location.file == m_file && location.offset < m_offset + RECORD_HEADER_SIZE) ||
+            location.offset < SEGMENT_HEADER_SIZE + RECORD_HEADER_SIZE ||
+            location.size > m_segment_size - location.offset)
+            break;
+        Add(location, ReadUint256(entry));
+        count++;
+    }
+    m_committed = count;
+    const uint64_t end = INDEX_HEADER_SIZE + count * INDEX_ENTRY_SIZE;
+    return end == (uint64_t)st.st_size || ftruncate(m_index_fd, end) == 0;
+}
+
+bool BlockStore::Recover()
+{
+    const size_t indexed = m_locations.size();
+    while (true) {
+        // The next block is where the last one ended, or at the start of
+        // the next segment if it did not fit
+        bool found = false;
+        for (uint32_t file = m_file; file < m_segments.size() && file <= m_file + 1 && !found; file++) {
+            const uint32_t offset = file == m_file ? m_offset : SEGMENT_HEADER_SIZE;
+            if (m_segment_size - offset < RECORD_HEADER_SIZE + HEADER_SIZE)
+                continue;
+            const unsigned char* record = m_segments[file].data + offset;
+            const uint32_t size = ReadLE32(record + 4);
+            const unsigned char* block = record + RECORD_HEADER_SIZE;
+            if (ReadLE32(record) != RECORD_MAGIC || size < HEADER_SIZE ||
+                size > m_segment_size - offset - RECORD_HEADER_SIZE || ReadLE32(record + 8) != m_locations.size() ||
+                (!m_locations.empty() && HeaderView(block).previous_block_hash() != m_tip_hash) ||
+                ReadLE32(record + 12) != Checksum(block, size))
+                continue;
+            Location location;
+            location.file = file;
+            location.offset = offset + RECORD_HEADER_SIZE;
+            location.size = size;
+            Add(location, HeaderView(block).hash());
+            found = true;
+        }
+        if (!found)
+            break;
+    }
+    m_stats.recovered = m_locations.size() - indexed;
+    if (m_locations.size() == indexed)
+        return true;
+    if (!WriteIndex(indexed) || fdatasync(m_index_fd) != 0)
+        return false;
+    m_committed = m_locations.size();
+    return true;
+}
+
+unsigned char* BlockStore::Prepare(size_t size)
+{
+    m_prepared = 0;
+    if (!IsOpen() || size < HEADER_SIZE || size > m_segment_size - SEGMENT_HEADER_SIZE - RECORD_HEADER_SIZE)
+        return nullptr;
+    if (size > m_segment_size - m_offset - RECORD_HEADER_SIZE) {
+        if (m_file + 1 == m_segments.size() && !OpenSegment(m_file + 1, true))
+            return nullptr;
+        m_file++;
+        m_offset = SEGMENT_HEADER_SIZE;
+    }
+    m_prepared = size;
+    return m_segments[m_file].data + m_offset + RECORD_HEADER_SIZE;
+}
+
+bool BlockStore::Append()
+{
+    const uint32_t size = (uint32_t)m_prepared;
+    m_prepared = 0;
+    if (size == 0)
+        return false;
+    unsigned char* record = m_segments[m_file].data + m_offset;
+    const unsigned char* block = record + RECORD_HEADER_SIZE;
+    if (!m_locations.empty() && HeaderView(block).previous_block_hash() != m_tip_hash)
+        return false;
+    PutLE32(record, RECORD_MAGIC);
+    PutLE32(record + 4, size);
+    PutLE32(record + 8, (uint32_t)m_locations.size());
+    PutLE32(record + 12, Checksum(block, size));
+    Location location;
+    location.file = m_file;
+    location.offset = m_offset + RECORD_HEADER_SIZE;
+    location.size = size;
+    Add(location, HeaderView(block).hash());
+    m_stats.appended++;
+    m_stats.bytes += size;
+    return true;
+}
+
+bool BlockStore::Append(const unsigned char* data, size_t size)
+{
+    unsigned char* out = Prepare(size);
+    if (!out)
+        return false;
+    memcpy(out, data, size);
+    return Append();
+}
+
+bool BlockStore::WriteIndex(size_t from)
+{
+    std::vector<unsigned char> entries((m_locations.size() - from) * INDEX_ENTRY_SIZE);
+    unsigned char* entry = entries.data();
+    for (size_t height = from; height < m_locations.size(); height++, entry += INDEX_ENTRY_SIZE) {
+        const Location& location = m_locations[height];
+        const uint256 hash = HeaderView(m_segments[location.file].data + location.offset).hash();
+        memcpy(entry, hash.begin(), 32);
+        PutLE32(entry + 32, location.file);
+        PutLE32(entry + 36, location.offset);
+        PutLE32(entry + 40, location.size);
+        PutLE32(entry + 44, Checksum(entry, 44));
+    }
+    return WriteAt(m_index_fd, entries.data(), entries.size(), INDEX_HEADER_SIZE + from * INDEX_ENTRY_SIZE);
+}
+
+bool BlockStore::Commit()
+{
+    if (!IsOpen())
+        return false;
+    if (Pending() == 0)
+        return true;
+    // On Linux this also writes back the pages dirtied through the mapping
+    for (uint32_t file = m_unsynced_file; file <= m_file; file++) {
+        if (fdatasync(m_segments[file].fd) != 0)
+            return false;
+        m_stats.syncs++;
+    }
+    m_unsynced_file = m_file;
+    if (!WriteIndex(m_committed))
+        return false;
+    m_committed = m_locations.size();
+    m_stats.commits++;
+    return true;
+}
+
+bool BlockStore::Rewind(uint32_t height)
+{
+    if (!IsOpen())
+        return false;
+    m_prepared = 0;
+    if (height >= m_locations.size())
+        return true;
+    for (size_t h = height; h < m_locations.size(); h++)
+        m_heights.erase(GetHash(h));
+    const Location& first = m_locations[height];
+    m_file = first.file;
+    m_offset = first.offset - RECORD_HEADER_SIZE;
+    // Keep Open() from finding the dropped blocks again after a crash
+    memset(m_segments[m_file].data + m_offset, 0, 4);
+    m_unsynced_file = std::min(m_unsynced_file, m_file);
+    m_locations.resize(height);
+    m_tip_hash = height ? GetHash(height - 1) : uint256();
+    if (m_committed <= height)
+        return true;
+    // The index entries are trusted as they are, so the dropped blocks must
+    // be gone from it for good before anything is appended in their place
+    m_committed = height;
+    m_stats.syncs += 2;
+    return fdatasync(m_segments[m_file].fd) == 0 &&
+           ftruncate(m_index_fd, INDEX_HEADER_SIZE + (uint64_t)height * INDEX_ENTRY_SIZE) == 0 &&
+           fdatasync(m_index_fd) == 0;
+}
+
+ArrayView<unsigned char> BlockStore::Read(uint32_t height) const
+{
+    if (height >= m_locations.size())
+        return ArrayView<unsigned char>();
+    const Location& location = m_locations[height];
+    return ArrayView<unsigned char>(m_segments[location.file].data + location.offset, location.size);
+}
+
+ArrayView<unsigned char> BlockStore::Read(const uint256& hash) const
+{
+    uint32_t height;
+    if (!Lookup(hash, height))
+        return ArrayView<unsigned char>();
+    return Read(height);
+}
+
+bool BlockStore::Read(uint32_t height, BlockView& block) const
+{
+    const ArrayView<unsigned char> bytes = Read(height);
+    if (bytes.empty()) {
+        block.Clear();
+        return false;
+    }
+    return block.Parse(bytes.data(), bytes.size());
+}
+
+bool BlockStore::Lookup(const uint256& hash, uint32_t& height) const
+{
+    const auto it = m_heights.find(hash);
+    if (it == m_heights.end())
+        return false;
+    height = it->second;
+    return true;
+}
+
+uint256 BlockStore::GetHash(uint32_t height) const
+{
+    if (height >= m_locations.size())
+        return uint256();
+    const Location& location = m_locations[height];
+    return HeaderView(m_segments[location.file].data + location.offset).hash();
+}
+
+} // namespace NiuChain
@@ -0,0 +1,139 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_BLOCKSTORE_H
+#define NIUBLOCK_BLOCKSTORE_H
+
+#include "blockview.h"
+#include "uint256.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NiuChain {
+
+/** Default size of a segment file, see BlockStore::Open() */
+static const uint32_t DEFAULT_BLOCKSTORE_SEGMENT_SIZE = 128 * 1024 * 1024;
+
+struct BlockStoreStats
+{
+    uint64_t appended;          //!< blocks since Open()
+    uint64_t bytes;
+    uint64_t commits;
+    uint64_t syncs;
+    uint64_t recovered;         //!< blocks found past the index by Open()
+};
+
+/**
+ * Serialized blocks on disk, one per height, as Bitcoin Core's blk?????.dat
+ * files with the block index folded in.
+ *
+ * Blocks are appended one after another into segment files of a fixed
+ * size, preallocated and mapped into memory whole, so a read is a pointer
+ * into the mapping: Read() hands out the bytes of a block without a copy
+ * or a system call, ready for BlockView::Parse().  Each block is preceded
+ * by a record header with its size, height and a checksum.
+ *
+ * Append() only copies the block into the mapping; Commit() makes every
+ * block appended since the last commit durable with one fdatasync() of the
+ * segment they went to (two when they crossed into a new one), then writes
+ * their index entries.  The index file, a hash and a location per height,
+ * is not synced: if it lost entries in a crash, Open() finds the blocks
+ * past its end by their record headers and checksums, and follows them
+ * while each links to the one before.
+ *
+ * The heights and the hashes are indexed in memory.  Not thread safe; the
+ * bytes from Read() stay valid until Close(), or until Rewind() drops the
+ * block.
+ */
+class BlockStore
+{
+public:
+    BlockStore();
+    ~BlockStore();
+
+    BlockStore(const BlockStore&) = delete;
+    BlockStore& operator=(const BlockStore&) = delete;
+
+    /** Open or create the store in directory dir; segment_size only applies
+     *  to a new store.  false on I/O error or foreign files. */
+    bool Open(const std::string& dir, uint32_t segment_size = DEFAULT_BLOCKSTORE_SEGMENT_SIZE);
+    /** Commit() and close */
+    void Close();
+    bool IsOpen() const { return m_index_fd >= 0; }
+
+    /** Room for the next block of size bytes, to be filled and then
+     *  finished with Append(); nullptr if it cannot fit a segment */
+    unsigned char* Prepare(size_t size);
+    /** Add the block written to Prepare()'s buffer at Height() + 1; false
+     *  unless it links to the tip */
+    bool Append();
+    bool Append(const unsigned char* data, size_t size);
+    /** Make the appended blocks durable */
+    bool Commit();
+    /** Drop the blocks at height and above */
+    bool Rewind(uint32_t height);
+
+    /** The serialized block, empty if there is none */
+    ArrayView<unsigned char> Read(uint32_t height) const;
+    ArrayView<unsigned char> Read(const uint256& hash) const;
+    bool Read(uint32_t height, BlockView& block) const;
+    /** The height of the block with hash, false if it is not stored */
+    bool Lookup(const uint256& hash, uint32_t& height) const;
+    uint256 GetHash(uint32_t height) const;
+
+    /** Height of the tip, -1 if empty */
+    int Height() const { return (int)m_locations.size() - 1; }
+    const uint256& TipHash() const { return m_tip_hash; }
+    size_t SegmentCount() const { return m_segments.size(); }
+    uint32_t SegmentSize() const { return m_segment_size; }
+    /** Heights not yet committed */
+    size_t Pending() const { return m_locations.size() - m_committed; }
+    const BlockStoreStats& Stats() const { return m_stats; }
+
+private:
+    struct Location
+    {
+        uint32_t file;
+        uint32_t offset;        //!< of the block, after its record header
+        uint32_t size;
+    };
+
+    struct Segment
+    {
+        int fd;
+        unsigned char* data;
+    };
+
+    struct HashHasher
+    {
+        size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+    };
+
+    bool OpenSegment(uint32_t file, bool create);
+    bool LoadIndex();
+    bool Recover();
+    /** Index the block at location, which links to the tip */
+    void Add(const Location& location, const uint256& hash);
+    bool WriteIndex(size_t from);
+
+    std::string m_dir;
+    uint32_t m_segment_size;
+    int m_index_fd;
+    std::vector<Segment> m_segments;
+    std::vector<Location> m_locations;          //!< by height
+    std::unordered_map<uint256, uint32_t, HashHasher> m_heights;
+    uint256 m_tip_hash;
+    uint32_t m_file;            //!< write position
+    uint32_t m_offset;
+    size_t m_prepared;          //!< size given to Prepare(), 0 if none
+    size_t m_committed;         //!< heights in the index file
+    uint32_t m_unsynced_file;   //!< first segment written since the last commit
+    BlockStoreStats m_stats;
+};
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_BLOCKSTORE_H
@@ -0,0 +1,195 @@
+#include "blockstore.h"
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NiuChain;
+
+static void PutCompactSize(std::vector<unsigned char>& out, size_t n)
+{
+  if (n < 253) {
+    out.push_back((unsigned char)n);
+  } else {
+    out.push_back(0xfd);
+    out.push_back((unsigned char)n);
+    out.push_back((unsigned char)(n >> 8));
+  }
+}
+
+/** A block of one coinbase with a script_size byte script, on top of prev */
+static std::vector<unsigned char> Block(const uint256& prev, uint32_t nonce, size_t script_size)
+{
+  std::vector<unsigned char> block = {1, 0, 0, 0};
+  block.insert(block.end(), prev.begin(), prev.end());
+  block.resize(76, 0);
+  for (int i = 0; i < 4; i++)
+    block.push_back((unsigned char)(nonce >> (8 * i)));
+  block.insert(block.end(), {1, 1, 0, 0, 0, 1});
+  block.insert(block.end(), 32, 0);
+  block.insert(block.end(), 4, 0xff);
+  PutCompactSize(block, script_size);
+  block.insert(block.end(), script_size, (unsigned char)nonce);
+  block.insert(block.end(), 4, 0xff);
+  block.insert(block.end(), {1, 0, 0xf2, 0x05, 0x2a, 1, 0, 0, 0, 0});
+  block.insert(block.end(), 4, 0);
+  return block;
+}
+
+static off_t FileSize(const std::string& path)
+{
+  struct stat st;
+  const int ret = stat(path.c_str(), &st);
+  assert(ret == 0);
+  return ret == 0 ? st.st_size : -1;
+}
+
+int main()
+{
+  char dir[] = "/tmp/niublocksXXXXXX";
+  const char* made = mkdtemp(dir);
+  assert(made);
+  const std::string index = std::string(dir) + "/index.dat";
+  std::vector<std::vector<unsigned char>> blocks;
+  std::vector<uint256> hashes;
+  uint256 prev;
+  for (uint32_t i = 0; i < 60; i++) {
+    blocks.push_back(Block(prev, i, 40 + (i * 97) % 900));
+    BlockView view;
+    const bool parsed = view.Parse(blocks.back().data(), blocks.back().size());
+    assert(parsed);
+    hashes.push_back(view.hash());
+    prev = view.hash();
+  }
+
+  // Appends roll over into new segments and read back without a copy
+  {
+    BlockStore store;
+    bool ok = store.Open(dir, 4096);
+    assert(ok && store.Height() == -1 && store.SegmentCount() == 1);
+    for (uint32_t i = 0; i < 50; i++) {
+      ok = store.Append(blocks[i].data(), blocks[i].size());
+      assert(ok);
+    }
+    assert(store.Height() == 49 && store.TipHash() == hashes[49] && store.SegmentCount() > 5);
+    assert(store.Pending() == 50);
+    ok = store.Commit();
+    assert(ok && store.Pending() == 0);
+    assert(store.Stats().syncs >= store.SegmentCount() && store.Stats().commits == 1);
+    for (uint32_t i = 0; i < 50; i++) {
+      const ArrayView<unsigned char> bytes = store.Read(i);
+      assert(bytes.size() == blocks[i].size() && memcmp(bytes.data(), blocks[i].data(), bytes.size()) == 0);
+      assert(store.Read(hashes[i]).data() == bytes.data() && store.GetHash(i) == hashes[i]);
+      uint32_t height;
+      ok = store.Lookup(hashes[i], height);
+      assert(ok && height == i);
+    }
+    BlockView view;
+    ok = store.Read(7, view);
+    assert(ok && view.hash() == hashes[7] && view.data() == store.Read(7).data());
+    ok = store.Read(50, view);
+    assert(!ok && view.IsNull() && store.Read(50).empty() && store.Read(hashes[50]).empty());
+
+    // Blocks must link to the tip and fit in a segment
+    ok = store.Append(blocks[51].data(), blocks[51].size());
+    assert(!ok && store.Height() == 49);
+    const std::vector<unsigned char> huge = Block(hashes[49], 0, 5000);
+    const unsigned char* buffer = store.Prepare(huge.size());
+    ok = store.Append();
+    assert(!buffer && !ok);
+
+    // Blocks appended but not committed are committed on close
+    ok = store.Append(blocks[50].data(), blocks[50].size());
+    assert(ok && store.Pending() == 1);
+  }
+  {
+    BlockStore store;
+    const bool ok = store.Open(dir);
+    assert(ok && store.SegmentSize() == 4096 && store.Height() == 50);
+    assert(store.Stats().recovered == 0 && store.TipHash() == hashes[50]);
+    assert(store.Read(33).size() == blocks[33].size());
+  }
+  std::cout << "store: ok" << std::endl;
+
+  // Index entries lost or torn in a crash are found again from the records
+  {
+    BlockStore store;
+    bool ok = store.Open(dir);
+    assert(ok);
+    for (uint32_t i = 51; i < 60; i++) {
+      ok = store.Append(blocks[i].data(), blocks[i].size());
+      assert(ok);
+    }
+    ok = store.Commit();
+    assert(ok);
+    store.Close();
+    int ret = truncate(index.c_str(), FileSize(index) - 3 * 48 - 20);
+    assert(ret == 0);
+    ok = store.Open(dir);
+    assert(ok && store.Height() == 59 && store.Stats().recovered == 4);
+    assert(store.GetHash(59) == hashes[59] && FileSize(index) == 8 + 60 * 48);
+
+    // A corrupt block ends the recovery
+    unsigned char* bytes = const_cast<unsigned char*>(store.Read(57).data());
+    bytes[100] ^= 1;
+    store.Close();
+    ret = truncate(index.c_str(), 8 + 55 * 48);
+    assert(ret == 0);
+    ok = store.Open(dir);
+    assert(ok && store.Height() == 56 && store.Stats().recovered == 2);
+  }
+  std::cout << "recover: ok" << std::endl;
+
+  // Rewinding drops blocks for good, and new ones go in their place
+  {
+    BlockStore store;
+    bool ok = store.Open(dir);
+    assert(ok && store.Height() == 56);
+    ok = store.Rewind(20);
+    assert(ok && store.Height() == 19 && store.TipHash() == hashes[19]);
+    uint32_t height;
+    ok = store.Lookup(hashes[20], height);
+    assert(!ok && store.Read(20).empty());
+    store.Close();
+    ok = store.Open(dir);
+    assert(ok && store.Height() == 19 && store.Stats().recovered == 0);
+
+    const std::vector<unsigned char> fork = Block(hashes[19], 1000, 40 + (20 * 97) % 900);
+    assert(fork.size() == blocks[20].size());
+    ok = store.Append(fork.data(), fork.size());
+    assert(ok && store.Height() == 20);
+    ok = store.Commit();
+    assert(ok);
+    const uint256 fork_hash = store.TipHash();
+    assert(fork_hash != hashes[20] && store.Read(fork_hash).size() == fork.size());
+    store.Close();
+    // Block 21 sits right after the fork, but does not link to it
+    const int ret = truncate(index.c_str(), 8 + 20 * 48);
+    assert(ret == 0);
+    ok = store.Open(dir);
+    assert(ok && store.Height() == 20 && store.TipHash() == fork_hash);
+    assert(store.Stats().recovered == 1);
+  }
+  std::cout << "rewind: ok" << std::endl;
+
+  // Foreign files are refused
+  {
+    FILE* f = fopen(index.c_str(), "w");
+    fputs("not a block index", f);
+    fclose(f);
+    BlockStore store;
+    const bool ok = store.Open(dir);
+    assert(!ok && !store.IsOpen());
+  }
+  unlink(index.c_str());
+  for (unsigned int i = 0;; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "/blk%05u.dat", i);
+    if (unlink((std::string(dir) + name).c_str()) != 0)
+      break;
+  }
+  rmdir(dir);
+  std::cout << "foreign: ok" << std::endl;
+}
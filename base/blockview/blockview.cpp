@@ -0,0 +1,314 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockview.h"
+#include "merkle.h"
+#include "sha256.h"
+
+#include <new>
+#include <vector>
+
+namespace NiuChain {
+
+/** Smallest serialized input: outpoint, empty script, sequence */
+static const size_t MIN_INPUT_SIZE = 36 + 1 + 4;
+/** Smallest serialized output: value, empty script */
+static const size_t MIN_OUTPUT_SIZE = 8 + 1;
+/** Smallest serialized transaction: version, no input, no output, locktime */
+static const size_t MIN_TRANSACTION_SIZE = 4 + 1 + 1 + 4;
+
+static uint256 Hash(const unsigned char* data, size_t size)
+{
+    uint256 out;
+    CSHA256().Write(data, size).Finalize(out.begin());
+    CSHA256().Write(out.begin(), 32).Finalize(out.begin());
+    return out;
+}
+
+uint256 HeaderView::hash() const
+{
+    return Hash(m_data, HEADER_SIZE);
+}
+
+bool OutPointView::is_null() const
+{
+    for (int i = 0; i < 32; i++) {
+        if (m_data[i])
+            return false;
+    }
+    return index() == 0xffffffff;
+}
+
+uint256 TransactionView::hash() const
+{
+    if (!m_witness)
+        return Hash(m_data, m_size);
+    uint256 out;
+    CSHA256()
+        .Write(m_data, 4)
+        .Write(m_body, m_body_size)
+        .Write(m_data + m_size - 4, 4)
+        .Finalize(out.begin());
+    CSHA256().Write(out.begin(), 32).Finalize(out.begin());
+    return out;
+}
+
+uint256 TransactionView::witness_hash() const
+{
+    return Hash(m_data, m_size);
+}
+
+size_t TransactionView::serialized_size(bool witness) const
+{
+    return witness || !m_witness ? m_size : 4 + m_body_size + 4;
+}
+
+size_t TransactionView::signature_operations() const
+{
+    size_t n = 0;
+    for (const InputView& input : m_inputs)
+        n += input.script().GetSigOpCount(false);
+    for (const OutputView& output : m_outputs)
+        n += output.script().GetSigOpCount(false);
+    return n;
+}
+
+namespace {
+
+/** Bounds checked cursor over the block buffer */
+class Reader
+{
+public:
+    Reader(const unsigned char* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+    const unsigned char* Pos() const { return m_pos; }
+    size_t Remaining() const { return m_end - m_pos; }
+
+    const unsigned char* Skip(size_t size)
+    {
+        if (Remaining() < size)
+            return nullptr;
+        const unsigned char* p = m_pos;
+        m_pos += size;
+        return p;
+    }
+
+    bool ReadByte(unsigned char& b)
+    {
+        const unsigned char* p = Skip(1);
+        if (p)
+            b = *p;
+        return p != nullptr;
+    }
+
+    /** Only the shortest encoding, at most MAX_COMPACT_SIZE */
+    bool ReadCompactSize(uint64_t& size)
+    {
+        unsigned char first;
+        if (!ReadByte(first))
+            return false;
+        const unsigned char* p;
+        if (first < 253) {
+            size = first;
+        } else if (first == 253) {
+            if (!(p = Skip(2)))
+                return false;
+            size = (uint64_t)p[0] | (uint64_t)p[1] << 8;
+            if (size < 253)
+                return false;
+        } else if (first == 254) {
+            if (!(p = Skip(4)))
+                return false;
+            size = ReadLE32(p);
+            if (size < 0x10000)
+                return false;
+        } else {
+            if (!(p = Skip(8)))
+                return false;
+            size = ReadLE64(p);
+            if (size < 0x100000000ULL)
+                return false;
+        }
+        return size <= MAX_COMPACT_SIZE;
+    }
+
+    /** A count of items at least min_size bytes each, which must fit in
+     *  what is left, so a forged count cannot make the arena allocate */
+    bool ReadCount(uint64_t& count, size_t min_size)
+    {
+        return ReadCompactSize(count) && count <= Remaining() / min_size;
+    }
+
+    bool ReadBytes(ScriptView& bytes)
+    {
+        uint64_t size;
+        if (!ReadCompactSize(size))
+            return false;
+        const unsigned char* p = Skip(size);
+        if (!p)
+            return false;
+        bytes = ScriptView(p, size);
+        return true;
+    }
+
+private:
+    const unsigned char* m_pos;
+    const unsigned char* const m_end;
+};
+
+bool ParseTransaction(Reader& reader, NiuMem::Arena& arena, TransactionView& tx)
+{
+    tx.m_data = reader.Pos();
+    if (!reader.Skip(4))
+        return false;
+
+    // Extended serialization: 0x00 marker where the input count would be,
+    // then flags, of which only witnesses are defined
+    uint64_t count;
+    tx.m_witness = false;
+    const unsigned char* body = reader.Pos();
+    if (!reader.ReadCompactSize(count))
+        return false;
+    if (count == 0) {
+        unsigned char flags;
+        if (!reader.ReadByte(flags) || flags != 1)
+            return false;
+        tx.m_witness = true;
+        body = reader.Pos();
+        if (!reader.ReadCount(count, MIN_INPUT_SIZE))
+            return false;
+    } else if (count > reader.Remaining() / MIN_INPUT_SIZE) {
+        return false;
+    }
+    tx.m_body = body;
+
+    InputView* inputs = arena.AllocateArray<InputView>(count);
+    for (uint64_t i = 0; i < count; i++) {
+        InputView* input = new (&inputs[i]) InputView();
+        const unsigned char* prevout = reader.Skip(36);
+        if (!prevout || !reader.ReadBytes(input->m_script))
+            return false;
+        const unsigned char* sequence = reader.Skip(4);
+        if (!sequence)
+            return false;
+        input->m_prevout = OutPointView(prevout);
+        input->m_sequence = ReadLE32(sequence);
+    }
+    tx.m_inputs = ArrayView<InputView>(inputs, count);
+
+    if (!reader.ReadCount(count, MIN_OUTPUT_SIZE))
+        return false;
+    OutputView* outputs = arena.AllocateArray<OutputView>(count);
+    for (uint64_t i = 0; i < count; i++) {
+        OutputView* output = new (&outputs[i]) OutputView();
+        const unsigned char* value = reader.Skip(8);
+        if (!value || !reader.ReadBytes(output->m_script))
+            return false;
+        output->m_value = ReadLE64(value);
+    }
+    tx.m_outputs = ArrayView<OutputView>(outputs, count);
+    tx.m_body_size = reader.Pos() - tx.m_body;
+
+    if (tx.m_witness) {
+        // Witnesses must not all be empty, or the flag is superfluous
+        if (tx.m_inputs.empty())
+            return false;
+        bool any = false;
+        for (size_t i = 0; i < tx.m_inputs.size(); i++) {
+            if (!reader.ReadCount(count, 1))
+                return false;
+            ScriptView* items = arena.AllocateArray<ScriptView>(count);
+            for (uint64_t j = 0; j < count; j++) {
+                new (&items[j]) ScriptView();
+                if (!reader.ReadBytes(items[j]))
+                    return false;
+            }
+            inputs[i].m_witness = ArrayView<ScriptView>(items, count);
+            any |= count != 0;
+        }
+        if (!any)
+            return false;
+    }
+
+    if (!reader.Skip(4))
+        return false;
+    tx.m_size = reader.Pos() - tx.m_data;
+    return true;
+}
+
+} // namespace
+
+BlockView::BlockView()
+    : m_arena(NiuMem::MEM_CHAIN, 64 * 1024),
+      m_data(nullptr),
+      m_size(0),
+      m_total_inputs(0)
+{
+}
+
+void BlockView::Clear()
+{
+    m_arena.Reset();
+    m_data = nullptr;
+    m_size = 0;
+    m_header = HeaderView();
+    m_transactions = ArrayView<TransactionView>();
+    m_total_inputs = 0;
+}
+
+bool BlockView::Parse(const unsigned char* data, size_t size)
+{
+    Clear();
+    Reader reader(data, size);
+    const unsigned char* header = reader.Skip(HEADER_SIZE);
+    uint64_t count;
+    if (!header || !reader.ReadCount(count, MIN_TRANSACTION_SIZE))
+        return false;
+
+    TransactionView* txs = m_arena.AllocateArray<TransactionView>(count);
+    size_t total_inputs = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        TransactionView* tx = new (&txs[i]) TransactionView();
+        if (!ParseTransaction(reader, m_arena, *tx)) {
+            Clear();
+            return false;
+        }
+        total_inputs += tx->inputs().size();
+    }
+    if (reader.Remaining() != 0) {
+        Clear();
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_header = HeaderView(header);
+    m_transactions = ArrayView<TransactionView>(txs, count);
+    m_total_inputs = total_inputs;
+    return true;
+}
+
+size_t BlockView::signature_operations() const
+{
+    size_t n = 0;
+    for (const TransactionView& tx : m_transactions)
+        n += tx.signature_operations();
+    return n;
+}
+
+uint256 BlockView::generate_merkle_root(bool* mutated) const
+{
+    std::vector<uint256> hashes;
+    hashes.reserve(m_transactions.size());
+    for (const TransactionView& tx : m_transactions)
+        hashes.push_back(tx.hash());
+    return ComputeMerkleRoot(std::move(hashes), mutated);
+}
+
+bool BlockView::is_valid_merkle_root() const
+{
+    return !IsNull() && generate_merkle_root() == m_header.merkle();
+}
+
+} // namespace NiuChain
@@ -0,0 +1,208 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_BLOCKVIEW_H
+#define NIUBLOCK_BLOCKVIEW_H
+
+#include "arena.h"
+#include "script.h"
+#include "uint256.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace NiuChain {
+
+/** Largest CompactSize a block may contain, as Core's MAX_SIZE */
+static const uint64_t MAX_COMPACT_SIZE = 0x02000000;
+
+static const size_t HEADER_SIZE = 80;
+
+/** count objects somebody else owns */
+template <typename T>
+class ArrayView
+{
+public:
+    typedef const T* const_iterator;
+
+    ArrayView() : m_data(nullptr), m_size(0) {}
+    ArrayView(const T* data, size_t size) : m_data(data), m_size(size) {}
+
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+    const T& front() const { return m_data[0]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+private:
+    const T* m_data;
+    size_t m_size;
+};
+
+inline uint32_t ReadLE32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+inline uint64_t ReadLE64(const unsigned char* p)
+{
+    return (uint64_t)ReadLE32(p) | (uint64_t)ReadLE32(p + 4) << 32;
+}
+
+inline uint256 ReadUint256(const unsigned char* p)
+{
+    uint256 out;
+    memcpy(out.begin(), p, 32);
+    return out;
+}
+
+/** The 80 serialized bytes of a block header */
+class HeaderView
+{
+public:
+    HeaderView() : m_data(nullptr) {}
+    explicit HeaderView(const unsigned char* data) : m_data(data) {}
+
+    uint32_t version() const { return ReadLE32(m_data); }
+    uint256 previous_block_hash() const { return ReadUint256(m_data + 4); }
+    uint256 merkle() const { return ReadUint256(m_data + 36); }
+    uint32_t timestamp() const { return ReadLE32(m_data + 68); }
+    uint32_t bits() const { return ReadLE32(m_data + 72); }
+    uint32_t nonce() const { return ReadLE32(m_data + 76); }
+    uint256 hash() const;
+
+    const unsigned char* data() const { return m_data; }
+    size_t serialized_size() const { return HEADER_SIZE; }
+
+private:
+    const unsigned char* m_data;
+};
+
+/** The 36 serialized bytes of an outpoint */
+class OutPointView
+{
+public:
+    OutPointView() : m_data(nullptr) {}
+    explicit OutPointView(const unsigned char* data) : m_data(data) {}
+
+    uint256 hash() const { return ReadUint256(m_data); }
+    uint32_t index() const { return ReadLE32(m_data + 32); }
+    /** A coinbase input's outpoint: zero hash, index 0xffffffff */
+    bool is_null() const;
+
+    const unsigned char* data() const { return m_data; }
+
+private:
+    const unsigned char* m_data;
+};
+
+struct InputView
+{
+    OutPointView m_prevout;
+    ScriptView m_script;
+    uint32_t m_sequence;
+    ArrayView<ScriptView> m_witness;
+
+    const OutPointView& previous_output() const { return m_prevout; }
+    const ScriptView& script() const { return m_script; }
+    uint32_t sequence() const { return m_sequence; }
+    const ArrayView<ScriptView>& witness() const { return m_witness; }
+};
+
+struct OutputView
+{
+    uint64_t m_value;
+    ScriptView m_script;
+
+    uint64_t value() const { return m_value; }
+    const ScriptView& script() const { return m_script; }
+};
+
+/**
+ * A transaction inside a block buffer.  The txid is hashed from the buffer
+ * on demand: the whole serialization for a legacy transaction, and version,
+ * inputs and outputs, locktime for one with witnesses.
+ */
+struct TransactionView
+{
+    const unsigned char* m_data;        //!< first byte of the serialization
+    size_t m_size;
+    const unsigned char* m_body;        //!< input count up to the last output
+    size_t m_body_size;
+    ArrayView<InputView> m_inputs;
+    ArrayView<OutputView> m_outputs;
+    bool m_witness;
+
+    uint32_t version() const { return ReadLE32(m_data); }
+    uint32_t locktime() const { return ReadLE32(m_data + m_size - 4); }
+    const ArrayView<InputView>& inputs() const { return m_inputs; }
+    const ArrayView<OutputView>& outputs() const { return m_outputs; }
+
+    uint256 hash() const;
+    uint256 witness_hash() const;
+    bool is_segregated() const { return m_witness; }
+    bool is_coinbase() const { return m_inputs.size() == 1 && m_inputs[0].previous_output().is_null(); }
+    size_t serialized_size(bool witness = true) const;
+    /** Legacy count: input and output scripts, multisig as 20 */
+    size_t signature_operations() const;
+
+    const unsigned char* data() const { return m_data; }
+};
+
+/**
+ * A block parsed in place.  Parse() checks the whole serialization and
+ * records where everything is; scripts and witness items stay byte spans
+ * into the caller's buffer and are only decoded to operations when
+ * something walks them.  The index lives in an arena the view owns, so a
+ * parse costs a handful of bump allocations, and the next Parse() (or the
+ * destructor) frees the previous block in one go.
+ *
+ * The buffer must outlive the view and stay unchanged.  Accessors mirror
+ * libbitcoin's chain::block so code can move across with few edits.
+ */
+class BlockView
+{
+public:
+    BlockView();
+
+    BlockView(const BlockView&) = delete;
+    BlockView& operator=(const BlockView&) = delete;
+
+    /** false for anything but exactly one well formed block, which leaves
+     *  the view empty */
+    bool Parse(const unsigned char* data, size_t size);
+    /** Drop the block, keeping the arena's memory for the next one */
+    void Clear();
+
+    bool IsNull() const { return m_data == nullptr; }
+    const HeaderView& header() const { return m_header; }
+    uint256 hash() const { return m_header.hash(); }
+    const ArrayView<TransactionView>& transactions() const { return m_transactions; }
+    size_t serialized_size() const { return m_size; }
+    size_t total_inputs() const { return m_total_inputs; }
+    size_t signature_operations() const;
+
+    uint256 generate_merkle_root(bool* mutated = nullptr) const;
+    bool is_valid_merkle_root() const;
+
+    const unsigned char* data() const { return m_data; }
+    /** Arena bytes holding the parsed index */
+    size_t ArenaUsed() const { return m_arena.Used(); }
+
+private:
+    NiuMem::Arena m_arena;
+    const unsigned char* m_data;
+    size_t m_size;
+    HeaderView m_header;
+    ArrayView<TransactionView> m_transactions;
+    size_t m_total_inputs;
+};
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_BLOCKVIEW_H
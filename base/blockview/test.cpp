@@ -0,0 +1,214 @@
+#include "blockview.h"
+#include "merkle.h"
+#include "sha256.h"
+#include "utilstrencodings.h"
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+using NiuChain::BlockView;
+using NiuChain::TransactionView;
+
+static const char* GENESIS =
+    "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c3e67768f617fc81bc3"
+    "888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c0101000000010000000000000000000000000000000000000000000000000000"
+    "000000000000ffffffff4d04ffff001d0104455468652054696d65732030332f4a616e2f32303039204368616e63656c6c6f72206f6e2062"
+    "72696e6b206f66207365636f6e64206261696c6f757420666f722062616e6b73ffffffff0100f2052a01000000434104678afdb0fe554827"
+    "1967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5f"
+    "ac00000000";
+
+static void Put32(std::vector<unsigned char>& out, uint32_t x)
+{
+  for (int i = 0; i < 4; i++)
+    out.push_back((unsigned char)(x >> (8 * i)));
+}
+
+static void PutBytes(std::vector<unsigned char>& out, const std::vector<unsigned char>& bytes)
+{
+  out.push_back((unsigned char)bytes.size());
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+static uint256 Hash(const std::vector<unsigned char>& bytes)
+{
+  uint256 out;
+  CSHA256().Write(bytes.data(), bytes.size()).Finalize(out.begin());
+  CSHA256().Write(out.begin(), 32).Finalize(out.begin());
+  return out;
+}
+
+/** A transaction spending n inputs into n outputs, without and with witnesses */
+static void MakeTransaction(int seed, int n, bool witness, std::vector<unsigned char>& legacy,
+                            std::vector<unsigned char>& full)
+{
+  std::vector<unsigned char> body;
+  body.push_back((unsigned char)n);
+  for (int i = 0; i < n; i++) {
+    for (int b = 0; b < 32; b++)
+      body.push_back((unsigned char)(seed * 7 + i + b));
+    Put32(body, i);
+    PutBytes(body, witness ? std::vector<unsigned char>() : std::vector<unsigned char>(3 + i, OP_CHECKSIG));
+    Put32(body, 0xfffffffe);
+  }
+  body.push_back((unsigned char)n);
+  for (int i = 0; i < n; i++) {
+    Put32(body, 1000 * seed + i);
+    Put32(body, 0);
+    std::vector<unsigned char> script = {OP_0, 20};
+    script.resize(22, (unsigned char)seed);
+    PutBytes(body, script);
+  }
+  legacy.clear();
+  Put32(legacy, 2);
+  legacy.insert(legacy.end(), body.begin(), body.end());
+  Put32(legacy, seed);
+  full = legacy;
+  if (!witness)
+    return;
+  full.clear();
+  Put32(full, 2);
+  full.push_back(0);
+  full.push_back(1);
+  full.insert(full.end(), body.begin(), body.end());
+  for (int i = 0; i < n; i++) {
+    full.push_back(2);
+    PutBytes(full, std::vector<unsigned char>(71, 0x30));
+    PutBytes(full, std::vector<unsigned char>(33, 0x02));
+  }
+  Put32(full, seed);
+}
+
+int main()
+{
+  const std::vector<unsigned char> genesis = ParseHex(GENESIS);
+  BlockView block;
+  assert(block.IsNull());
+  bool ok = block.Parse(genesis.data(), genesis.size());
+  assert(ok);
+  assert(block.hash().GetHex() == "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+  assert(block.header().merkle().GetHex() == "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+  assert(block.header().version() == 1 && block.header().timestamp() == 1231006505);
+  assert(block.header().bits() == 0x1d00ffff && block.header().nonce() == 2083236893);
+  assert(block.is_valid_merkle_root() && block.serialized_size() == 285);
+  assert(block.transactions().size() == 1 && block.total_inputs() == 1);
+  const TransactionView& coinbase = block.transactions()[0];
+  assert(coinbase.is_coinbase() && !coinbase.is_segregated());
+  assert(coinbase.outputs()[0].value() == 5000000000ULL);
+  assert(coinbase.inputs()[0].script().size() == 77);
+  assert(coinbase.inputs()[0].script().data() == genesis.data() + 80 + 1 + 4 + 1 + 36 + 1);
+  assert(block.signature_operations() == 1);
+  std::cout << "genesis: ok" << std::endl;
+
+  // Every truncation and a trailing byte fail, and leave the view empty
+  for (size_t size = 0; size < genesis.size(); size++) {
+    ok = block.Parse(genesis.data(), size);
+    assert(!ok);
+    assert(block.IsNull() && block.transactions().empty());
+  }
+  std::vector<unsigned char> longer = genesis;
+  longer.push_back(0);
+  ok = block.Parse(longer.data(), longer.size());
+  assert(!ok);
+
+  // A non-canonical or forged transaction count
+  std::vector<unsigned char> forged(genesis.begin(), genesis.begin() + 80);
+  forged.insert(forged.end(), {0xfd, 0x01, 0x00});
+  forged.insert(forged.end(), genesis.begin() + 81, genesis.end());
+  ok = block.Parse(forged.data(), forged.size());
+  assert(!ok);
+  forged.resize(80);
+  forged.insert(forged.end(), {0xfe, 0x00, 0x00, 0x00, 0x02});
+  forged.resize(forged.size() + 1000);
+  ok = block.Parse(forged.data(), forged.size());
+  assert(!ok);
+  assert(block.ArenaUsed() == 0);
+  std::cout << "malformed: ok" << std::endl;
+
+  // Legacy and witness transactions, txid without witnesses
+  std::vector<unsigned char> raw(genesis.begin(), genesis.begin() + 80);
+  std::vector<uint256> txids;
+  std::vector<uint256> wtxids;
+  const int count = 40;
+  raw.push_back(count + 1);
+  raw.insert(raw.end(), genesis.begin() + 81, genesis.end());
+  txids.push_back(Hash(std::vector<unsigned char>(genesis.begin() + 81, genesis.end())));
+  wtxids.push_back(txids.back());
+  for (int t = 0; t < count; t++) {
+    std::vector<unsigned char> legacy, full;
+    MakeTransaction(t + 1, 1 + t % 4, t % 3 == 0, legacy, full);
+    raw.insert(raw.end(), full.begin(), full.end());
+    txids.push_back(Hash(legacy));
+    wtxids.push_back(Hash(full));
+  }
+  const uint256 root = ComputeMerkleRoot(txids);
+  memcpy(raw.data() + 36, root.begin(), 32);
+  ok = block.Parse(raw.data(), raw.size());
+  assert(ok);
+  assert(block.transactions().size() == count + 1 && block.is_valid_merkle_root());
+  for (size_t t = 0; t < txids.size(); t++) {
+    const TransactionView& tx = block.transactions()[t];
+    assert(tx.hash() == txids[t] && tx.witness_hash() == wtxids[t]);
+    assert(tx.is_segregated() == (t > 0 && (t - 1) % 3 == 0));
+    if (tx.is_segregated()) {
+      assert(tx.inputs()[0].witness().size() == 2 && tx.inputs()[0].witness()[0].size() == 71);
+      assert(tx.serialized_size(false) < tx.serialized_size());
+    }
+    assert(tx.version() == (t ? 2u : 1u) && tx.locktime() == (t ? t : 0));
+  }
+  std::cout << "witness: ok" << std::endl;
+
+  // A changed merkle root is caught, and a superfluous witness flag refused
+  raw[40] ^= 1;
+  ok = block.Parse(raw.data(), raw.size());
+  assert(ok && !block.is_valid_merkle_root());
+  std::vector<unsigned char> legacy, full;
+  MakeTransaction(9, 1, false, legacy, full);
+  std::vector<unsigned char> flagged(genesis.begin(), genesis.begin() + 80);
+  flagged.push_back(1);
+  Put32(flagged, 2);
+  flagged.push_back(0);
+  flagged.push_back(1);
+  flagged.insert(flagged.end(), legacy.begin() + 4, legacy.end() - 4);
+  flagged.push_back(0);
+  Put32(flagged, 0);
+  ok = block.Parse(flagged.data(), flagged.size());
+  assert(!ok);
+
+  // Reparsing reuses the arena
+  ok = block.Parse(raw.data(), raw.size());
+  assert(ok);
+  const size_t used = block.ArenaUsed();
+  for (int i = 0; i < 10; i++) {
+    ok = block.Parse(raw.data(), raw.size());
+    assert(ok && block.ArenaUsed() == used);
+  }
+
+  // A block whose index spans several chunks stops allocating after the first parse
+  std::vector<unsigned char> large(genesis.begin(), genesis.begin() + 80);
+  const int large_count = 10000;
+  large.push_back(0xfd);
+  large.push_back(large_count & 0xff);
+  large.push_back(large_count >> 8);
+  for (int t = 0; t < large_count; t++) {
+    MakeTransaction(t + 1, 1 + t % 4, t % 2 == 0, legacy, full);
+    large.insert(large.end(), full.begin(), full.end());
+  }
+  BlockView fresh;
+  ok = fresh.Parse(large.data(), large.size());
+  assert(ok && fresh.transactions().size() == large_count);
+  // more than twice the largest chunk the arena grows by
+  assert(fresh.ArenaUsed() > 2 << 20);
+  const NiuMem::MemReport before = NiuMem::GetMemReport();
+  for (int i = 0; i < 10; i++) {
+    ok = fresh.Parse(large.data(), large.size());
+    assert(ok && fresh.transactions().size() == large_count);
+  }
+  const NiuMem::MemReport after = NiuMem::GetMemReport();
+  // only the first Reset() merges the chunks
+  assert(after.tags[NiuMem::MEM_CHAIN].allocs <= before.tags[NiuMem::MEM_CHAIN].allocs + 1);
+  fresh.Parse(large.data(), large.size());
+  assert(NiuMem::GetMemReport().tags[NiuMem::MEM_CHAIN].allocs == after.tags[NiuMem::MEM_CHAIN].allocs);
+  std::cout << "arena: ok" << std::endl;
+}
@@ -0,0 +1,399 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainindex.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NiuChain {
+
+static const unsigned char SNAPSHOT_MAGIC[8] = {'N', 'I', 'U', 'H', 'D', 'R', 'S', '1'};
+/** magic, header count */
+static const size_t SNAPSHOT_HEADER_SIZE = 8 + 4;
+/** header, parent id */
+static const size_t SNAPSHOT_ENTRY_SIZE = HEADER_SIZE + 4;
+/** Entries written at a time */
+static const size_t SNAPSHOT_CHUNK = 4096;
+
+static void PutLE32(unsigned char* out, uint32_t x)
+{
+    for (int i = 0; i < 4; i++)
+        out[i] = (unsigned char)(x >> (8 * i));
+}
+
+/** write() all of data, retrying on partial writes and EINTR */
+static bool WriteAll(int fd, const unsigned char* data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+/** read() all of size bytes, false on error or end of file */
+static bool ReadAll(int fd, unsigned char* data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t n = read(fd, data, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool SyncDirectory(const std::string& path)
+{
+    const size_t slash = path.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int fd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    const bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+arith_uint256 GetBlockProof(uint32_t bits)
+{
+    arith_uint256 target;
+    bool negative;
+    bool overflow;
+    target.SetCompact(bits, &negative, &overflow);
+    if (negative || overflow || target == 0)
+        return 0;
+    // We need to compute 2**256 / (target+1), but we can't represent 2**256
+    // as it's too large for an arith_uint256. However, as 2**256 is at least
+    // as large as target+1, it is equal to ((2**256 - target - 1) /
+    // (target+1)) + 1, or ~target / (target+1) + 1.
+    return (~target / (target + 1)) + 1;
+}
+
+/** Turn the lowest '1' bit in the binary representation of a number into a '0'. */
+static inline int InvertLowestOne(int n) { return n & (n - 1); }
+
+int GetSkipHeight(int height)
+{
+    if (height < 2)
+        return 0;
+
+    // Determine which height to jump back to. Any number strictly lower than height is acceptable,
+    // but the following expression seems to perform well in simulations (max 110 steps to go back
+    // up to 2**18 blocks).
+    return (height & 1) ? InvertLowestOne(InvertLowestOne(height - 1)) + 1 : InvertLowestOne(height);
+}
+
+std::vector<int> LocatorHeights(int top)
+{
+    std::vector<int> heights;
+    if (top < 0)
+        return heights;
+    int step = 1;
+    for (int height = top; height > 0; height -= std::min(height, step)) {
+        // Push the top ten, then back off exponentially
+        if (heights.size() >= 10)
+            step <<= 1;
+        heights.push_back(height);
+    }
+    heights.push_back(0);
+    return heights;
+}
+
+ChainIndex::ChainIndex()
+    : m_proof_bits(0),
+      m_proof(0)
+{
+}
+
+void ChainIndex::Clear()
+{
+    m_headers.clear();
+    m_hashes.clear();
+    m_heights.clear();
+    m_chain_work.clear();
+    m_prev.clear();
+    m_skip.clear();
+    m_ids.clear();
+    m_chain.clear();
+}
+
+const arith_uint256& ChainIndex::Proof(uint32_t bits)
+{
+    if (bits != m_proof_bits) {
+        m_proof_bits = bits;
+        m_proof = GetBlockProof(bits);
+    }
+    return m_proof;
+}
+
+void ChainIndex::Link(HeaderId id, HeaderId prev)
+{
+    const arith_uint256& proof = Proof(GetHeader(id).bits());
+    m_prev.push_back(prev);
+    if (prev == NO_HEADER) {
+        m_heights.push_back(0);
+        m_chain_work.push_back(proof);
+        m_skip.push_back(NO_HEADER);
+        return;
+    }
+    const int height = m_heights[prev] + 1;
+    m_heights.push_back(height);
+    m_chain_work.push_back(m_chain_work[prev] + proof);
+    m_skip.push_back(GetAncestor(prev, GetSkipHeight(height)));
+}
+
+void ChainIndex::UpdateTip(HeaderId id)
+{
+    if (!m_chain.empty() && !(m_chain_work[id] > m_chain_work[Tip()]))
+        return;
+    m_chain.resize(m_heights[id] + 1, NO_HEADER);
+    for (HeaderId walk = id; walk != NO_HEADER && m_chain[m_heights[walk]] != walk; walk = m_prev[walk])
+        m_chain[m_heights[walk]] = walk;
+}
+
+HeaderId ChainIndex::AddHeader(const unsigned char* header)
+{
+    const HeaderView view(header);
+    const uint256 hash = view.hash();
+    const HeaderId known = Find(hash);
+    if (known != NO_HEADER)
+        return known;
+    HeaderId prev = NO_HEADER;
+    if (Size() > 0) {
+        prev = Find(view.previous_block_hash());
+        if (prev == NO_HEADER)
+            return NO_HEADER;
+    }
+    if (Size() >= NO_HEADER)
+        return NO_HEADER;
+
+    const HeaderId id = (HeaderId)Size();
+    m_headers.insert(m_headers.end(), header, header + HEADER_SIZE);
+    m_hashes.push_back(hash);
+    Link(id, prev);
+    m_ids.emplace(hash, id);
+    UpdateTip(id);
+    return id;
+}
+
+HeaderId ChainIndex::Find(const uint256& hash) const
+{
+    const auto it = m_ids.find(hash);
+    return it == m_ids.end() ? NO_HEADER : it->second;
+}
+
+HeaderId ChainIndex::GetAncestor(HeaderId id, int height) const
+{
+    if (id == NO_HEADER || height > m_heights[id] || height < 0)
+        return NO_HEADER;
+    if (Contains(id))
+        return m_chain[height];
+
+    HeaderId walk = id;
+    int height_walk = m_heights[id];
+    while (height_walk > height) {
+        const int height_skip = GetSkipHeight(height_walk);
+        const int height_skip_prev = GetSkipHeight(height_walk - 1);
+        if (m_skip[walk] != NO_HEADER &&
+            (height_skip == height ||
+             (height_skip > height && !(height_skip_prev < height_skip - 2 && height_skip_prev >= height)))) {
+            // Only follow skip if prev->skip isn't better than skip->prev.
+            walk = m_skip[walk];
+            height_walk = height_skip;
+        } else {
+            walk = m_prev[walk];
+            height_walk--;
+        }
+    }
+    return walk;
+}
+
+int64_t ChainIndex::GetMedianTimePast(HeaderId id) const
+{
+    if (id == NO_HEADER)
+        return 0;
+    int64_t times[MEDIAN_TIME_SPAN];
+    int count = 0;
+    for (HeaderId walk = id; walk != NO_HEADER && count < MEDIAN_TIME_SPAN; walk = m_prev[walk])
+        times[count++] = GetHeader(walk).timestamp();
+    std::sort(times, times + count);
+    return times[count / 2];
+}
+
+HeaderId ChainIndex::LastCommonAncestor(HeaderId a, HeaderId b) const
+{
+    if (a == NO_HEADER || b == NO_HEADER)
+        return NO_HEADER;
+    if (m_heights[a] > m_heights[b])
+        a = GetAncestor(a, m_heights[b]);
+    else if (m_heights[b] > m_heights[a])
+        b = GetAncestor(b, m_heights[a]);
+    while (a != b && a != NO_HEADER && b != NO_HEADER) {
+        a = m_prev[a];
+        b = m_prev[b];
+    }
+    return a == b ? a : NO_HEADER;
+}
+
+HeaderId ChainIndex::FindFork(HeaderId id) const
+{
+    if (id == NO_HEADER)
+        return NO_HEADER;
+    if (m_heights[id] > Height())
+        id = GetAncestor(id, Height());
+    while (id != NO_HEADER && !Contains(id))
+        id = m_prev[id];
+    return id;
+}
+
+std::vector<uint256> ChainIndex::GetLocator(HeaderId id) const
+{
+    if (id == NO_HEADER)
+        id = Tip();
+    std::vector<uint256> locator;
+    if (id == NO_HEADER)
+        return locator;
+    const std::vector<int> heights = LocatorHeights(m_heights[id]);
+    locator.reserve(heights.size());
+    for (int height : heights) {
+        id = GetAncestor(id, height);
+        locator.push_back(m_hashes[id]);
+    }
+    return locator;
+}
+
+bool ChainIndex::WriteSnapshot(const std::string& path) const
+{
+    const std::string tmp = path + ".tmp";
+    const int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    CSHA256 hasher;
+    std::vector<unsigned char> chunk(SNAPSHOT_HEADER_SIZE);
+    memcpy(chunk.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    PutLE32(chunk.data() + 8, (uint32_t)Size());
+    bool ok = true;
+    for (size_t id = 0; id < Size() && ok; id++) {
+        const size_t at = chunk.size();
+        chunk.resize(at + SNAPSHOT_ENTRY_SIZE);
+        memcpy(chunk.data() + at, m_headers.data() + id * HEADER_SIZE, HEADER_SIZE);
+        PutLE32(chunk.data() + at + HEADER_SIZE, m_prev[id]);
+        if (chunk.size() >= SNAPSHOT_CHUNK * SNAPSHOT_ENTRY_SIZE) {
+            hasher.Write(chunk.data(), chunk.size());
+            ok = WriteAll(fd, chunk.data(), chunk.size());
+            chunk.clear();
+        }
+    }
+    unsigned char checksum[CSHA256::OUTPUT_SIZE];
+    hasher.Write(chunk.data(), chunk.size()).Finalize(checksum);
+    ok = ok && WriteAll(fd, chunk.data(), chunk.size()) && WriteAll(fd, checksum, sizeof(checksum)) &&
+         fdatasync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    SyncDirectory(path);
+    return true;
+}
+
+bool ChainIndex::LoadSnapshot(const std::string& path)
+{
+    Clear();
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    std::vector<unsigned char> data;
+    bool ok = fstat(fd, &st) == 0 && (uint64_t)st.st_size >= SNAPSHOT_HEADER_SIZE + CSHA256::OUTPUT_SIZE;
+    if (ok) {
+        data.resize(st.st_size);
+        ok = ReadAll(fd, data.data(), data.size());
+    }
+    close(fd);
+    if (!ok || memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        return false;
+    const size_t count = ReadLE32(data.data() + 8);
+    const size_t body = data.size() - CSHA256::OUTPUT_SIZE;
+    if ((body - SNAPSHOT_HEADER_SIZE) / SNAPSHOT_ENTRY_SIZE != count ||
+        (body - SNAPSHOT_HEADER_SIZE) % SNAPSHOT_ENTRY_SIZE != 0)
+        return false;
+    unsigned char checksum[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(data.data(), body).Finalize(checksum);
+    if (memcmp(checksum, data.data() + body, sizeof(checksum)) != 0)
+        return false;
+
+    m_headers.reserve(count * HEADER_SIZE);
+    m_hashes.resize(count);
+    m_heights.reserve(count);
+    m_chain_work.reserve(count);
+    m_prev.reserve(count);
+    m_skip.reserve(count);
+    // A header's hash is in its children's previous block hash, so only the
+    // headers without children are hashed
+    std::vector<bool> hashed(count, false);
+    const unsigned char* entry = data.data() + SNAPSHOT_HEADER_SIZE;
+    for (HeaderId id = 0; id < count; id++, entry += SNAPSHOT_ENTRY_SIZE) {
+        const HeaderId prev = ReadLE32(entry + HEADER_SIZE);
+        if (id == 0 ? prev != NO_HEADER : prev >= id) {
+            Clear();
+            return false;
+        }
+        m_headers.insert(m_headers.end(), entry, entry + HEADER_SIZE);
+        Link(id, prev);
+        if (prev == NO_HEADER)
+            continue;
+        const uint256 hash = HeaderView(entry).previous_block_hash();
+        if (hashed[prev] && m_hashes[prev] != hash) {
+            Clear();
+            return false;
+        }
+        m_hashes[prev] = hash;
+        hashed[prev] = true;
+    }
+    m_ids.reserve(count);
+    HeaderId best = NO_HEADER;
+    for (HeaderId id = 0; id < count; id++) {
+        if (!hashed[id])
+            m_hashes[id] = GetHeader(id).hash();
+        if (!m_ids.emplace(m_hashes[id], id).second) {
+            Clear();
+            return false;
+        }
+        if (best == NO_HEADER || m_chain_work[id] > m_chain_work[best])
+            best = id;
+    }
+    if (best != NO_HEADER)
+        UpdateTip(best);
+    return true;
+}
+
+size_t ChainIndex::MemoryUsage() const
+{
+    return m_headers.capacity() + m_hashes.capacity() * sizeof(uint256) + m_heights.capacity() * sizeof(int) +
+           m_chain_work.capacity() * sizeof(arith_uint256) + m_prev.capacity() * sizeof(HeaderId) +
+           m_skip.capacity() * sizeof(HeaderId) + m_chain.capacity() * sizeof(HeaderId) +
+           m_ids.size() * (sizeof(uint256) + sizeof(HeaderId) + 2 * sizeof(void*)) +
+           m_ids.bucket_count() * sizeof(void*);
+}
+
+} // namespace NiuChain
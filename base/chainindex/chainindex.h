@@ -0,0 +1,133 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_CHAININDEX_H
+#define NIUBLOCK_CHAININDEX_H
+
+#include "arith_uint256.h"
+#include "blockview.h"
+#include "uint256.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NiuChain {
+
+/** Position of a header in a ChainIndex, in the order they were added */
+typedef uint32_t HeaderId;
+static const HeaderId NO_HEADER = UINT32_MAX;
+
+/** Headers before a block that its median time past is taken over */
+static const int MEDIAN_TIME_SPAN = 11;
+
+/** Work of a block with the compact target bits, 0 for an invalid target */
+arith_uint256 GetBlockProof(uint32_t bits);
+/** Height the skip pointer of a header at height points to */
+int GetSkipHeight(int height);
+/** Heights of a block locator from top down to 0: the top ten, then
+ *  exponentially further apart, as libbitcoin's block::locator_heights() */
+std::vector<int> LocatorHeights(int top);
+
+/**
+ * Every header known, and the chain with the most work through them,
+ * standing in for Bitcoin Core's block index and CChain.
+ *
+ * Headers are kept as columns rather than as a node per header: the 80
+ * serialized bytes of header i sit at 80 * i in one array, and its hash,
+ * height, chain work, parent and skip pointer at i in arrays of their own,
+ * so walking the chain touches a few dense arrays and no pointers.  A
+ * header's parent always comes before it.
+ *
+ * The skip pointers are Core's pskip, which make GetAncestor() of any
+ * header O(log n).  The most-work chain is also kept as an array by
+ * height, so a header on it finds its ancestors, and the tip finds any
+ * header on the way back, in O(1).
+ *
+ * WriteSnapshot() saves the headers and their parents only; LoadSnapshot()
+ * derives the rest without hashing the chain again.  Headers are not
+ * validated here: proof of work, timestamps and checkpoints are for the
+ * caller.  Not thread safe.
+ */
+class ChainIndex
+{
+public:
+    ChainIndex();
+
+    /** Add the 80 byte header and return its id.  Its parent must be known,
+     *  except for the first header, which is taken as genesis.  A known
+     *  header returns the id it had; NO_HEADER if the parent is missing. */
+    HeaderId AddHeader(const unsigned char* header);
+    /** NO_HEADER if the hash is not known */
+    HeaderId Find(const uint256& hash) const;
+    size_t Size() const { return m_heights.size(); }
+    void Clear();
+
+    HeaderView GetHeader(HeaderId id) const { return HeaderView(m_headers.data() + (size_t)id * HEADER_SIZE); }
+    const uint256& GetHash(HeaderId id) const { return m_hashes[id]; }
+    int GetHeight(HeaderId id) const { return m_heights[id]; }
+    /** Total work of the chain up to and including the header */
+    const arith_uint256& GetChainWork(HeaderId id) const { return m_chain_work[id]; }
+    HeaderId GetPrev(HeaderId id) const { return m_prev[id]; }
+    HeaderId GetSkip(HeaderId id) const { return m_skip[id]; }
+    /** The ancestor of id at height, NO_HEADER if height is out of range */
+    HeaderId GetAncestor(HeaderId id, int height) const;
+    /** Median timestamp of id and up to ten ancestors, 0 for NO_HEADER */
+    int64_t GetMedianTimePast(HeaderId id) const;
+    HeaderId LastCommonAncestor(HeaderId a, HeaderId b) const;
+
+    /** The most-work chain, NO_HEADER tip and -1 height when empty */
+    HeaderId Tip() const { return m_chain.empty() ? NO_HEADER : m_chain.back(); }
+    int Height() const { return (int)m_chain.size() - 1; }
+    /** The header at height on the most-work chain, NO_HEADER if none */
+    HeaderId operator[](int height) const
+    {
+        return height < 0 || height >= (int)m_chain.size() ? NO_HEADER : m_chain[height];
+    }
+    /** The header depth below the tip, so FromTip(0) == Tip() */
+    HeaderId FromTip(int depth) const { return (*this)[Height() - depth]; }
+    bool Contains(HeaderId id) const { return (*this)[m_heights[id]] == id; }
+    /** The last header of id's chain that is also on the most-work chain */
+    HeaderId FindFork(HeaderId id) const;
+    /** Hashes at LocatorHeights() of id's chain, the tip's by default */
+    std::vector<uint256> GetLocator(HeaderId id = NO_HEADER) const;
+
+    /** Write every header to path, replacing it atomically */
+    bool WriteSnapshot(const std::string& path) const;
+    /** Replace the index with a snapshot; false, and empty, if it is
+     *  missing, corrupt or foreign */
+    bool LoadSnapshot(const std::string& path);
+
+    /** Bytes held by the arrays and the hash index, roughly */
+    size_t MemoryUsage() const;
+
+private:
+    struct HashHasher
+    {
+        size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+    };
+
+    /** Fill in the derived columns for the header just appended */
+    void Link(HeaderId id, HeaderId prev);
+    /** Make id the tip if it has more work than the current one */
+    void UpdateTip(HeaderId id);
+    const arith_uint256& Proof(uint32_t bits);
+
+    std::vector<unsigned char> m_headers;
+    std::vector<uint256> m_hashes;
+    std::vector<int> m_heights;
+    std::vector<arith_uint256> m_chain_work;
+    std::vector<HeaderId> m_prev;
+    std::vector<HeaderId> m_skip;
+    std::unordered_map<uint256, HeaderId, HashHasher> m_ids;
+    std::vector<HeaderId> m_chain;      //!< most-work chain by height
+
+    // Targets only change at retargets, so the last proof is usually it
+    uint32_t m_proof_bits;
+    arith_uint256 m_proof;
+};
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_CHAININDEX_H
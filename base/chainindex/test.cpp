@@ -0,0 +1,178 @@
+#include "chainindex.h"
+#include <algorithm>
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <random>
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace NiuChain;
+
+/** Regtest difficulty, two hashes of work a header */
+static const uint32_t EASY_BITS = 0x207fffff;
+
+static std::vector<unsigned char> Header(const uint256& prev, uint32_t time, uint32_t nonce, uint32_t bits = EASY_BITS)
+{
+  std::vector<unsigned char> header(HEADER_SIZE, 0x11);
+  header[0] = 1;
+  header[1] = header[2] = header[3] = 0;
+  memcpy(header.data() + 4, prev.begin(), 32);
+  const uint32_t fields[3] = {time, bits, nonce};
+  for (int f = 0; f < 3; f++)
+    for (int i = 0; i < 4; i++)
+      header[68 + 4 * f + i] = (unsigned char)(fields[f] >> (8 * i));
+  return header;
+}
+
+/** Extend id's chain by count headers, returning the last */
+static HeaderId Extend(ChainIndex& index, HeaderId id, int count, uint32_t nonce, uint32_t bits = EASY_BITS)
+{
+  for (int i = 0; i < count; i++) {
+    const int height = id == NO_HEADER ? 0 : index.GetHeight(id) + 1;
+    const uint256 prev = id == NO_HEADER ? uint256() : index.GetHash(id);
+    // Out of order now and then, as real timestamps are
+    const uint32_t time = 1500000000 + height * 600 - (height % 7 == 3 ? 2000 : 0);
+    const HeaderId next = index.AddHeader(Header(prev, time, nonce, bits).data());
+    assert(next != NO_HEADER && index.GetHeight(next) == height);
+    id = next;
+  }
+  return id;
+}
+
+/** GetAncestor() by walking parents */
+static HeaderId SlowAncestor(const ChainIndex& index, HeaderId id, int height)
+{
+  while (id != NO_HEADER && index.GetHeight(id) > height)
+    id = index.GetPrev(id);
+  return id;
+}
+
+static void CheckSame(const ChainIndex& a, const ChainIndex& b)
+{
+  assert(a.Size() == b.Size() && a.Tip() == b.Tip() && a.Height() == b.Height());
+  for (HeaderId id = 0; id < a.Size(); id++) {
+    assert(a.GetHash(id) == b.GetHash(id) && a.GetHeight(id) == b.GetHeight(id));
+    assert(a.GetChainWork(id) == b.GetChainWork(id) && a.GetPrev(id) == b.GetPrev(id));
+    assert(a.GetSkip(id) == b.GetSkip(id) && b.Find(a.GetHash(id)) == id);
+    assert(memcmp(a.GetHeader(id).data(), b.GetHeader(id).data(), HEADER_SIZE) == 0);
+  }
+  assert(a.GetLocator() == b.GetLocator());
+}
+
+int main()
+{
+  // Core's proof vectors, and libbitcoin's locator heights
+  assert(GetBlockProof(0x1d00ffff) == arith_uint256(0x100010001ULL));
+  assert(GetBlockProof(EASY_BITS) == 2 && GetBlockProof(0) == 0 && GetBlockProof(0x01fedcba) == 0);
+  assert(LocatorHeights(0) == std::vector<int>({0}));
+  assert(LocatorHeights(3) == std::vector<int>({3, 2, 1, 0}));
+  assert(LocatorHeights(20) == std::vector<int>({20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 8, 4, 0}));
+  for (int height = 2; height < 100000; height++)
+    assert(GetSkipHeight(height) < height);
+  std::cout << "proof: ok" << std::endl;
+
+  ChainIndex index;
+  assert(index.Tip() == NO_HEADER && index.Height() == -1 && index.GetLocator().empty());
+  const HeaderId genesis = Extend(index, NO_HEADER, 1, 0);
+  const HeaderId main = Extend(index, genesis, 3000, 1);
+  assert(index.Tip() == main && index.Height() == 3000 && index.GetChainWork(main) == 2 * 3001);
+  const HeaderId again = index.AddHeader(index.GetHeader(1500).data());
+  assert(again == 1500 && index.Size() == 3001);
+  const HeaderId orphan = index.AddHeader(Header(uint256(), 0, 12345).data());
+  assert(orphan == NO_HEADER);
+
+  // A fork from 2000 with as much work stays off the most-work chain
+  const HeaderId fork_point = index[2000];
+  const HeaderId fork = Extend(index, fork_point, 1000, 2);
+  assert(index.Tip() == main && !index.Contains(fork) && index.FindFork(fork) == fork_point);
+  assert(index.LastCommonAncestor(main, fork) == fork_point);
+
+  // Skip pointers and ancestors, on and off the most-work chain
+  std::mt19937 random(42);
+  for (int i = 0; i < 2000; i++) {
+    const HeaderId id = random() % index.Size();
+    const int height = random() % (index.GetHeight(id) + 1);
+    assert(index.GetAncestor(id, height) == SlowAncestor(index, id, height));
+    if (index.GetHeight(id) >= 2)
+      assert(index.GetHeight(index.GetSkip(id)) == GetSkipHeight(index.GetHeight(id)));
+  }
+  assert(index.GetAncestor(fork, 3001) == NO_HEADER && index.GetAncestor(fork, -1) == NO_HEADER);
+  assert(index.FromTip(0) == main && index.GetHeight(index.FromTip(10)) == 2990 && index.FromTip(3001) == NO_HEADER);
+  std::cout << "ancestor: ok" << std::endl;
+
+  // One more header makes the fork the most-work chain
+  const HeaderId reorg = Extend(index, fork, 1, 2);
+  assert(index.Tip() == reorg && index.Height() == 3001 && index.Contains(fork) && !index.Contains(main));
+  assert(index[2000] == fork_point && index[2001] == index.GetAncestor(reorg, 2001));
+  assert(index.FindFork(main) == fork_point);
+  // And a single hard header takes the old chain back
+  const HeaderId hard = Extend(index, main, 1, 3, 0x1d00ffff);
+  assert(index.Tip() == hard && index.Contains(main) && index[3000] == main);
+
+  const std::vector<uint256> locator = index.GetLocator(fork);
+  const std::vector<int> heights = LocatorHeights(3000);
+  assert(locator.size() == heights.size() && locator.front() == index.GetHash(fork));
+  for (size_t i = 0; i < locator.size(); i++)
+    assert(locator[i] == index.GetHash(SlowAncestor(index, fork, heights[i])));
+  assert(locator.back() == index.GetHash(genesis));
+
+  // Median time past, over the eleven headers up to and including id
+  for (HeaderId id : {genesis, (HeaderId)5, main}) {
+    std::vector<int64_t> times;
+    for (HeaderId walk = id; walk != NO_HEADER && times.size() < 11; walk = index.GetPrev(walk))
+      times.push_back(index.GetHeader(walk).timestamp());
+    std::sort(times.begin(), times.end());
+    assert(index.GetMedianTimePast(id) == times[times.size() / 2]);
+  }
+  assert(index.GetMedianTimePast(NO_HEADER) == 0);
+  std::cout << "chain: ok" << std::endl;
+
+  // Snapshots restore the same index, without anything recomputed going wrong
+  char dir[] = "/tmp/niuchainXXXXXX";
+  const char* made = mkdtemp(dir);
+  assert(made);
+  const std::string path = std::string(dir) + "/headers.dat";
+  {
+    ChainIndex loaded;
+    bool ok = loaded.LoadSnapshot(path);
+    assert(!ok);
+    ok = index.WriteSnapshot(path);
+    assert(ok);
+    ok = loaded.LoadSnapshot(path);
+    assert(ok);
+    CheckSame(index, loaded);
+    assert(loaded.GetAncestor(fork, 1234) == index.GetAncestor(fork, 1234));
+
+    ChainIndex empty;
+    ok = empty.WriteSnapshot(path);
+    assert(ok);
+    ok = loaded.LoadSnapshot(path);
+    assert(ok && loaded.Size() == 0 && loaded.Tip() == NO_HEADER);
+
+    // A flipped byte is caught by the checksum
+    ok = index.WriteSnapshot(path);
+    assert(ok);
+    FILE* f = fopen(path.c_str(), "r+");
+    assert(f);
+    int ret = fseek(f, 1000, SEEK_SET);
+    assert(ret == 0);
+    const int c = fgetc(f);
+    ret = fseek(f, 1000, SEEK_SET);
+    assert(ret == 0);
+    ret = fputc(c ^ 1, f);
+    assert(ret != EOF);
+    fclose(f);
+    ok = loaded.LoadSnapshot(path);
+    assert(!ok && loaded.Size() == 0);
+
+    f = fopen(path.c_str(), "w");
+    fputs("not a header snapshot, but long enough to look like one at first", f);
+    fclose(f);
+    ok = loaded.LoadSnapshot(path);
+    assert(!ok);
+  }
+  unlink(path.c_str());
+  rmdir(dir);
+  std::cout << "snapshot: ok" << std::endl;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Script verification of libbitcoin blocks on a CheckQueue, in place of
+ *
+ *   block.connect(state)               -> ConnectBlock(block, state, queue)
+ *
+ * block.connect() verifies every input in turn through
+ * transaction::connect_input(); ConnectBlock() makes one ScriptCheck per
+ * input and fans them out.  connect_input() only reads the transaction
+ * and its populated previous outputs, and libbitcoin's own validator
+ * already calls it from several threads.
+ */
+#ifndef NIUBLOCK_BITCOINCHECKQUEUE_H
+#define NIUBLOCK_BITCOINCHECKQUEUE_H
+
+#include "checkqueue.h"
+
+#include <bitcoin/bitcoin.hpp>
+
+namespace NiuCheck {
+
+/** One input's script against its previous output */
+struct ScriptCheck
+{
+    const bc::chain::transaction* tx;
+    const bc::chain::chain_state* state;
+    uint32_t input;
+    bc::code error;
+
+    bool operator()()
+    {
+        error = tx->connect_input(*state, input);
+        return !error;
+    }
+};
+
+typedef CheckQueue<ScriptCheck> ScriptCheckQueue;
+
+/** Same result as block.connect(state); the error of a failing input
+ *  may differ when several inputs fail */
+inline bc::code ConnectBlock(const bc::chain::block& block, const bc::chain::chain_state& state,
+                             ScriptCheckQueue& queue, CheckQueueStats* stats = nullptr)
+{
+    block.validation.start_connect = bc::asio::steady_clock::now();
+    if (state.is_under_checkpoint())
+        return bc::error::success;
+
+    std::vector<ScriptCheck> checks;
+    checks.reserve(block.total_inputs());
+    for (const bc::chain::transaction& tx : block.transactions()) {
+        if (tx.is_coinbase())
+            continue;
+        for (uint32_t i = 0; i < tx.inputs().size(); i++)
+            checks.push_back({&tx, &state, i, bc::error::success});
+    }
+    size_t failed;
+    const bool ok = queue.Run(checks, &failed);
+    if (stats)
+        *stats = queue.LastStats();
+    return ok ? bc::error::success : checks[failed].error;
+}
+
+} // namespace NiuCheck
+
+#endif // NIUBLOCK_BITCOINCHECKQUEUE_H
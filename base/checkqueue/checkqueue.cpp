@@ -0,0 +1,272 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "checkqueue.h"
+
+#include "tinyformat.h"
+
+#include <assert.h>
+#include <chrono>
+
+namespace NiuCheck {
+
+/** Failed attempts to take a range before a thread parks */
+static const unsigned IDLE_SPINS = 64;
+
+static int64_t NowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** A range [begin, end) of check indices in one deque word */
+static uint64_t PackRange(size_t begin, size_t end)
+{
+    return ((uint64_t)begin << 32) | (uint64_t)end;
+}
+
+static void UnpackRange(uint64_t range, size_t& begin, size_t& end)
+{
+    begin = (size_t)(range >> 32);
+    end = (size_t)(range & 0xffffffff);
+}
+
+std::string CheckQueueStats::ToString() const
+{
+    return strprintf("%u checks on %u threads in %.2fms, efficiency %.0f%%, %u steals%s",
+                     checks, threads, wall_ns / 1e6, Efficiency() * 100, steals,
+                     ok ? "" : strprintf(", failed after %u", executed));
+}
+
+CheckQueueRunner::CheckQueueRunner(unsigned worker_threads, size_t grain)
+    : m_threads(worker_threads + 1),
+      m_grain(grain ? grain : 1),
+      m_deques(new WorkStealingDeque[worker_threads + 1]),
+      m_generation(0),
+      m_active(0),
+      m_stop(false),
+      m_parked(0),
+      m_fn(nullptr),
+      m_context(nullptr),
+      m_remaining(0),
+      m_abort(false),
+      m_failed(0),
+      m_executed(0),
+      m_busy_ns(0),
+      m_steals(0),
+      m_parks(0)
+{
+    for (unsigned i = 0; i < worker_threads; i++)
+        m_workers.emplace_back(&CheckQueueRunner::WorkerMain, this, i + 1);
+}
+
+CheckQueueRunner::~CheckQueueRunner()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cond.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+bool CheckQueueRunner::Run(size_t count, CheckRangeFn fn, void* context, size_t* failed)
+{
+    assert(count < ((uint64_t)1 << 32));
+    std::lock_guard<std::mutex> run_lock(m_run_mutex);
+    const int64_t start = NowNanos();
+    CheckQueueStats stats;
+    stats.checks = count;
+
+    if (m_workers.empty() || count <= m_grain) {
+        // Not worth waking anybody
+        const size_t stop = count ? fn(context, 0, count) : count;
+        stats.threads = 1;
+        stats.ok = stop == count;
+        stats.executed = stats.ok ? count : stop + 1;
+        stats.wall_ns = stats.busy_ns = NowNanos() - start;
+        if (!stats.ok)
+            *failed = stop;
+    } else {
+        m_fn = fn;
+        m_context = context;
+        m_remaining.store(count, std::memory_order_relaxed);
+        m_abort.store(false, std::memory_order_relaxed);
+        m_failed.store(count, std::memory_order_relaxed);
+        m_executed.store(0, std::memory_order_relaxed);
+        m_busy_ns.store(0, std::memory_order_relaxed);
+        m_steals.store(0, std::memory_order_relaxed);
+        m_parks.store(0, std::memory_order_relaxed);
+        // The workers are asleep, so filling their deques is safe; the lock
+        // below publishes the slices to them
+        for (size_t t = 0; t < m_threads; t++) {
+            const size_t begin = count * t / m_threads;
+            const size_t end = count * (t + 1) / m_threads;
+            if (begin < end)
+                m_deques[t].Push(PackRange(begin, end));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_generation++;
+            m_active = (unsigned)m_workers.size();
+        }
+        m_work_cond.notify_all();
+
+        Participate(0);
+
+        // Workers may still be finishing a range, or about to find none left
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done_cond.wait(lock, [this] { return m_active == 0; });
+        }
+        stats.threads = m_threads;
+        stats.ok = !m_abort.load(std::memory_order_relaxed);
+        stats.executed = m_executed.load(std::memory_order_relaxed);
+        stats.busy_ns = m_busy_ns.load(std::memory_order_relaxed);
+        stats.steals = m_steals.load(std::memory_order_relaxed);
+        stats.parks = m_parks.load(std::memory_order_relaxed);
+        stats.wall_ns = NowNanos() - start;
+        if (!stats.ok)
+            *failed = m_failed.load(std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    m_stats = stats;
+    return stats.ok;
+}
+
+CheckQueueStats CheckQueueRunner::LastStats() const
+{
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    return m_stats;
+}
+
+bool CheckQueueRunner::TakeRange(size_t self, uint64_t& range)
+{
+    if (m_deques[self].Pop(range))
+        return true;
+    for (size_t k = 1; k < m_threads; k++) {
+        if (m_deques[(self + k) % m_threads].Steal(range)) {
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void CheckQueueRunner::Park()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_parked.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in WakeParked(): either the waker sees us
+    // parked, or we see its range or the end of the run
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_park_cond.wait(lock, [this] {
+        if (m_remaining.load(std::memory_order_acquire) == 0)
+            return true;
+        for (size_t t = 0; t < m_threads; t++) {
+            if (!m_deques[t].Empty())
+                return true;
+        }
+        return false;
+    });
+    m_parked.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void CheckQueueRunner::WakeParked()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_parked.load(std::memory_order_relaxed) == 0)
+        return;
+    {
+        // A thread between its check and its wait holds m_mutex
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_park_cond.notify_all();
+}
+
+void CheckQueueRunner::Participate(size_t self)
+{
+    WorkStealingDeque& own = m_deques[self];
+    size_t executed = 0;
+    int64_t busy_ns = 0;
+    uint64_t range;
+    unsigned misses = 0;
+    while (m_remaining.load(std::memory_order_acquire) > 0) {
+        if (!TakeRange(self, range)) {
+            // The rest is running elsewhere and may still be split
+            if (++misses < IDLE_SPINS) {
+                std::this_thread::yield();
+            } else {
+                m_parks.fetch_add(1, std::memory_order_relaxed);
+                Park();
+                misses = 0;
+            }
+            continue;
+        }
+        misses = 0;
+        size_t begin, end;
+        UnpackRange(range, begin, end);
+        const size_t taken = end - begin;
+        if (!m_abort.load(std::memory_order_relaxed)) {
+            // Leave the upper halves for thieves, or for ourselves later
+            bool pushed = false;
+            while (end - begin > m_grain && own.Push(PackRange(begin + (end - begin) / 2, end))) {
+                end = begin + (end - begin) / 2;
+                pushed = true;
+            }
+            if (pushed)
+                WakeParked();
+            const int64_t start = NowNanos();
+            const size_t stop = m_fn(m_context, begin, end);
+            busy_ns += NowNanos() - start;
+            if (stop == end) {
+                executed += end - begin;
+            } else {
+                executed += stop - begin + 1;
+                m_abort.store(true, std::memory_order_relaxed);
+                size_t lowest = m_failed.load(std::memory_order_relaxed);
+                while (stop < lowest && !m_failed.compare_exchange_weak(lowest, stop, std::memory_order_relaxed)) {
+                }
+            }
+            // Only count what ran: the pushed halves are counted when taken
+            if (m_remaining.fetch_sub(end - begin, std::memory_order_acq_rel) == end - begin)
+                WakeParked();
+        } else {
+            if (m_remaining.fetch_sub(taken, std::memory_order_acq_rel) == taken)
+                WakeParked();
+        }
+    }
+    m_executed.fetch_add(executed, std::memory_order_relaxed);
+    m_busy_ns.fetch_add(busy_ns, std::memory_order_relaxed);
+}
+
+void CheckQueueRunner::WorkerMain(size_t self)
+{
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_cond.wait(lock, [this, seen] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+        Participate(self);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active == 0)
+                m_done_cond.notify_one();
+        }
+    }
+}
+
+unsigned DefaultWorkerThreads()
+{
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+} // namespace NiuCheck
@@ -0,0 +1,185 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Parallel verification of independent checks, in the spirit of Bitcoin
+ * Core's CCheckQueue: the validating thread collects a block's script
+ * checks and Run() verifies them on a pool of worker threads, with the
+ * calling thread taking part.
+ *
+ * Work is spread by stealing rather than from one shared queue.  Each
+ * thread starts with an equal slice of the checks in its own deque.  It
+ * takes a range from the bottom, pushes back its upper half until the
+ * range is down to the grain size, and runs the rest.  A thread that runs
+ * out steals from the top of another thread's deque, which holds the
+ * largest ranges left.  There is no shared counter to fight over in the
+ * common case, and a slow thread's work moves to the others.
+ *
+ * A thread that finds nothing to steal yields for a while, since the
+ * ranges still running are about to be split, then sleeps until one is
+ * pushed or the run is over, as CCheckQueue's workers wait for checks.
+ *
+ * The first failing check stops the run: ranges taken after it are
+ * skipped, and Run() returns once the ranges that were already running
+ * have finished.
+ */
+#ifndef NIUBLOCK_CHECKQUEUE_H
+#define NIUBLOCK_CHECKQUEUE_H
+
+#include "workstealing.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace NiuCheck {
+
+/** How one Run() went */
+struct CheckQueueStats
+{
+    size_t checks = 0;          //!< checks passed to Run()
+    size_t executed = 0;        //!< checks actually run, fewer after a failure
+    unsigned threads = 0;       //!< threads that took part, including the caller
+    int64_t wall_ns = 0;        //!< Run() from start to end
+    int64_t busy_ns = 0;        //!< time spent in checks, summed over threads
+    uint64_t steals = 0;        //!< ranges taken from another thread's deque
+    uint64_t parks = 0;         //!< times a thread found nothing to steal and slept
+    bool ok = true;
+
+    /** Share of the threads' time spent in checks, 1.0 for a perfect split */
+    double Efficiency() const
+    {
+        if (wall_ns <= 0 || threads == 0)
+            return 1.0;
+        return (double)busy_ns / ((double)wall_ns * threads);
+    }
+    /** busy / wall: how many threads' worth of checking the run achieved */
+    double Speedup() const { return wall_ns > 0 ? (double)busy_ns / wall_ns : 1.0; }
+
+    /** e.g. "2500 checks on 8 threads in 3.10ms, efficiency 91%, 37 steals" */
+    std::string ToString() const;
+};
+
+/**
+ * Runs checks [begin, end) in order and returns the index of the first one
+ * that fails, or end.
+ */
+typedef size_t (*CheckRangeFn)(void* context, size_t begin, size_t end);
+
+/** The thread pool behind CheckQueue, independent of the check type */
+class CheckQueueRunner
+{
+public:
+    /** worker_threads may be 0, which runs everything on the caller;
+     *  ranges are not split below grain checks */
+    CheckQueueRunner(unsigned worker_threads, size_t grain);
+    ~CheckQueueRunner();
+
+    CheckQueueRunner(const CheckQueueRunner&) = delete;
+    CheckQueueRunner& operator=(const CheckQueueRunner&) = delete;
+
+    /** Run checks [0, count).  On failure returns false and sets *failed to
+     *  the lowest failing index among the checks that ran.  One Run() at a
+     *  time; concurrent callers wait for each other. */
+    bool Run(size_t count, CheckRangeFn fn, void* context, size_t* failed);
+
+    unsigned Threads() const { return m_threads; }
+    /** Statistics of the last Run() */
+    CheckQueueStats LastStats() const;
+
+private:
+    /** Take, split and run ranges until none are left */
+    void Participate(size_t self);
+    bool TakeRange(size_t self, uint64_t& range);
+    /** Sleep until a deque has a range or no checks are left */
+    void Park();
+    /** Wake the parked threads, if any */
+    void WakeParked();
+    void WorkerMain(size_t self);
+
+    const unsigned m_threads;           //!< workers and the caller
+    const size_t m_grain;
+    std::unique_ptr<WorkStealingDeque[]> m_deques;   //!< one per thread, 0 is the caller's
+    std::vector<std::thread> m_workers;
+
+    /** Serialises Run() */
+    std::mutex m_run_mutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_cond;
+    std::condition_variable m_done_cond;
+    std::condition_variable m_park_cond;
+    uint64_t m_generation;              //!< guarded by m_mutex, bumped for each Run()
+    unsigned m_active;                  //!< guarded by m_mutex, workers still in this Run()
+    bool m_stop;                        //!< guarded by m_mutex
+    std::atomic<unsigned> m_parked;     //!< threads in Park()
+
+    // State of the current Run(), published to the workers through m_mutex
+    CheckRangeFn m_fn;
+    void* m_context;
+    std::atomic<size_t> m_remaining;    //!< checks neither run nor skipped
+    std::atomic<bool> m_abort;
+    std::atomic<size_t> m_failed;
+    std::atomic<size_t> m_executed;
+    std::atomic<int64_t> m_busy_ns;
+    std::atomic<uint64_t> m_steals;
+    std::atomic<uint64_t> m_parks;
+
+    mutable std::mutex m_stats_mutex;
+    CheckQueueStats m_stats;            //!< guarded by m_stats_mutex
+};
+
+/**
+ * A pool verifying lists of T, where T has bool operator()() returning
+ * whether the check passed.  A check may keep details of a failure in
+ * itself for the caller to read after Run().  Checks of one Run() may run
+ * concurrently, in any order, so they must not share mutable state.
+ */
+template <typename T>
+class CheckQueue
+{
+public:
+    explicit CheckQueue(unsigned worker_threads, size_t grain = 8)
+        : m_runner(worker_threads, grain) {}
+
+    /** Run every check.  On failure returns false and, if failed is given,
+     *  sets it to the index of a failing check. */
+    bool Run(std::vector<T>& checks, size_t* failed = nullptr)
+    {
+        size_t index;
+        const bool ok = m_runner.Run(checks.size(), &RunRange, checks.data(), &index);
+        if (!ok && failed)
+            *failed = index;
+        return ok;
+    }
+
+    unsigned Threads() const { return m_runner.Threads(); }
+    CheckQueueStats LastStats() const { return m_runner.LastStats(); }
+
+private:
+    static size_t RunRange(void* context, size_t begin, size_t end)
+    {
+        T* checks = static_cast<T*>(context);
+        for (size_t i = begin; i < end; i++) {
+            if (!checks[i]())
+                return i;
+        }
+        return end;
+    }
+
+    CheckQueueRunner m_runner;
+};
+
+/** One worker per hardware thread except the validating thread's own */
+unsigned DefaultWorkerThreads();
+
+} // namespace NiuCheck
+
+#endif // NIUBLOCK_CHECKQUEUE_H
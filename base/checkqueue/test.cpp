@@ -0,0 +1,169 @@
+#include "checkqueue.h"
+#undef NDEBUG
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/** Counts how often it ran; fails if told to */
+struct CountingCheck
+{
+  std::atomic<int>* runs;
+  bool pass;
+
+  bool operator()()
+  {
+    runs->fetch_add(1, std::memory_order_relaxed);
+    return pass;
+  }
+};
+
+/** Takes a while if told to */
+struct SlowCheck
+{
+  std::atomic<int>* runs;
+  bool slow;
+
+  bool operator()()
+  {
+    if (slow)
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    runs->fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+};
+
+int main()
+{
+  // The deque on its own: LIFO for the owner, FIFO for thieves
+  NiuCheck::WorkStealingDeque deque;
+  uint64_t item;
+  bool ok = deque.Pop(item);
+  assert(!ok);
+  ok = deque.Steal(item);
+  assert(!ok);
+  for (uint64_t i = 1; i <= 3; i++) {
+    ok = deque.Push(i);
+    assert(ok);
+  }
+  ok = deque.Steal(item);
+  assert(ok && item == 1);
+  ok = deque.Pop(item);
+  assert(ok && item == 3);
+  ok = deque.Pop(item);
+  assert(ok && item == 2);
+  ok = deque.Pop(item);
+  assert(deque.Empty() && !ok);
+  for (size_t i = 0; i < NiuCheck::WorkStealingDeque::CAPACITY; i++) {
+    ok = deque.Push(i);
+    assert(ok);
+  }
+  ok = deque.Push(0);
+  assert(!ok);
+  while (deque.Pop(item)) {
+  }
+
+  // Every item is taken exactly once while thieves race the owner
+  {
+    const uint64_t items = 20000;
+    std::vector<std::atomic<int>> taken(items);
+    for (auto& t : taken)
+      t.store(0);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++) {
+      thieves.emplace_back([&] {
+        uint64_t stolen;
+        while (!done.load()) {
+          if (deque.Steal(stolen))
+            taken[stolen].fetch_add(1);
+          else
+            std::this_thread::yield();
+        }
+      });
+    }
+    for (uint64_t i = 0; i < items; i++) {
+      while (!deque.Push(i))
+        std::this_thread::yield();
+      if (i % 3 == 0 && deque.Pop(item))
+        taken[item].fetch_add(1);
+    }
+    while (!deque.Empty()) {
+      if (deque.Pop(item))
+        taken[item].fetch_add(1);
+    }
+    done = true;
+    for (auto& t : thieves)
+      t.join();
+    for (auto& t : taken)
+      assert(t.load() == 1);
+  }
+  std::cout << "deque: ok" << std::endl;
+
+  for (unsigned workers : {0u, 1u, 4u}) {
+    NiuCheck::CheckQueue<CountingCheck> queue(workers, 4);
+    assert(queue.Threads() == workers + 1);
+    for (int round = 0; round < 50; round++) {
+      const size_t count = (size_t)round * 37;
+      std::vector<std::atomic<int>> runs(count);
+      std::vector<CountingCheck> checks;
+      for (size_t i = 0; i < count; i++) {
+        runs[i].store(0);
+        checks.push_back({&runs[i], true});
+      }
+      ok = queue.Run(checks);
+      assert(ok);
+      for (auto& r : runs)
+        assert(r.load() == 1);
+      const NiuCheck::CheckQueueStats stats = queue.LastStats();
+      assert(stats.ok && stats.checks == count && stats.executed == count);
+      assert(stats.Efficiency() >= 0 && stats.Efficiency() <= 1.0001);
+    }
+
+    // A failure is reported, and stops the rest
+    std::vector<std::atomic<int>> runs(20000);
+    std::vector<CountingCheck> checks;
+    for (size_t i = 0; i < runs.size(); i++) {
+      runs[i].store(0);
+      checks.push_back({&runs[i], i != 123 && i != 9000});
+    }
+    size_t failed = 0;
+    ok = queue.Run(checks, &failed);
+    assert(!ok);
+    assert(failed == 123 || failed == 9000);
+    assert(runs[failed].load() == 1);
+    const NiuCheck::CheckQueueStats stats = queue.LastStats();
+    assert(!stats.ok && stats.executed <= checks.size());
+    if (workers == 0)
+      assert(failed == 123 && stats.executed == 124);
+    std::cout << workers << " workers: " << stats.ToString() << std::endl;
+
+    // and the queue is usable afterwards
+    checks[123].pass = checks[9000].pass = true;
+    ok = queue.Run(checks);
+    assert(ok);
+  }
+
+  // Threads with nothing left to steal sleep instead of spinning, and are
+  // woken for the end of the run
+  {
+    NiuCheck::CheckQueue<SlowCheck> queue(3, 1);
+    for (int round = 0; round < 5; round++) {
+      std::vector<std::atomic<int>> runs(64);
+      std::vector<SlowCheck> checks;
+      for (size_t i = 0; i < runs.size(); i++) {
+        runs[i].store(0);
+        checks.push_back({&runs[i], i == 0 || (round == 4 && i == 63)});
+      }
+      ok = queue.Run(checks);
+      assert(ok);
+      for (auto& r : runs)
+        assert(r.load() == 1);
+      const NiuCheck::CheckQueueStats stats = queue.LastStats();
+      assert(stats.ok && stats.executed == runs.size() && stats.parks > 0);
+    }
+  }
+  std::cout << "check queue: ok" << std::endl;
+}
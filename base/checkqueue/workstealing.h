@@ -0,0 +1,98 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_WORKSTEALING_H
+#define NIUBLOCK_WORKSTEALING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NiuCheck {
+
+/**
+ * Chase-Lev work-stealing deque of 64-bit words, with the memory orderings
+ * of Le et al., "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (PPoPP 2013).
+ *
+ * The owning thread pushes and pops at the bottom; any thread may steal
+ * from the top.  The capacity is fixed: CheckQueue only ever holds the
+ * halves of one range split down to the grain size, which is at most one
+ * entry per bit of the range's length.
+ */
+class WorkStealingDeque
+{
+public:
+    static const size_t CAPACITY = 64;
+
+    WorkStealingDeque() : m_top(0), m_bottom(0)
+    {
+        for (size_t i = 0; i < CAPACITY; i++)
+            m_buffer[i].store(0, std::memory_order_relaxed);
+    }
+
+    /** Owner only; false when full */
+    bool Push(uint64_t item)
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t >= (int64_t)CAPACITY)
+            return false;
+        m_buffer[b & (CAPACITY - 1)].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** Owner only; newest item first */
+    bool Pop(uint64_t& item)
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = m_buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t < b)
+            return true;
+        // Last item: race the thieves for it
+        const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    /** Any thread; oldest item first.  May fail spuriously under contention */
+    bool Steal(uint64_t& item)
+    {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        item = m_buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+    }
+
+    /** Racy unless called by the owner with no thieves around */
+    bool Empty() const
+    {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+private:
+    // top and bottom on separate cache lines: thieves hammer m_top
+    std::atomic<int64_t> m_top;
+    char m_padding[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> m_bottom;
+    std::atomic<uint64_t> m_buffer[CAPACITY];
+};
+
+} // namespace NiuCheck
+
+#endif // NIUBLOCK_WORKSTEALING_H
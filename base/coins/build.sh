@@ -0,0 +1,4 @@
+#!/bin/sh
+
+cd ../crypto && sh build.sh && cd ../coins
+g++  -std=c++11 -O2  test.cpp coins.cpp coinslog.cpp coinscache.cpp ../blockview/blockview.cpp ../script/script.cpp ../merkle/merkle.cpp ../memory/memaccount.cpp ../memory/arena.cpp ../crypto/sha256*.o ../big_int/uint256.cpp ../big_int/utilstrencodings.cpp  -I ./ -I ../blockview -I ../script -I ../merkle -I ../memory -I ../crypto -I ../big_int -lpthread
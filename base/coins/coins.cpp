@@ -0,0 +1,207 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coins.h"
+#include "outpointmap.h"
+
+#include <random>
+
+namespace NiuChain {
+
+uint64_t OutPointHashSalt()
+{
+    static const uint64_t salt = [] {
+        std::random_device random;
+        return (uint64_t)random() << 32 | random();
+    }();
+    return salt;
+}
+
+size_t VarIntSize(uint64_t n)
+{
+    size_t size = 1;
+    while (n > 0x7f) {
+        n = (n >> 7) - 1;
+        size++;
+    }
+    return size;
+}
+
+unsigned char* WriteVarInt(unsigned char* out, uint64_t n)
+{
+    unsigned char tmp[10];
+    int len = 0;
+    while (true) {
+        tmp[len] = (n & 0x7f) | (len ? 0x80 : 0x00);
+        if (n <= 0x7f)
+            break;
+        n = (n >> 7) - 1;
+        len++;
+    }
+    do {
+        *out++ = tmp[len];
+    } while (len--);
+    return out;
+}
+
+bool ReadVarInt(const unsigned char*& pos, const unsigned char* end, uint64_t& n)
+{
+    n = 0;
+    while (pos < end) {
+        const unsigned char b = *pos++;
+        if (n > (UINT64_MAX >> 7))
+            return false;
+        n = (n << 7) | (b & 0x7f);
+        if (!(b & 0x80))
+            return true;
+        if (n == UINT64_MAX)
+            return false;
+        n++;
+    }
+    return false;
+}
+
+uint64_t CompressAmount(uint64_t n)
+{
+    if (n == 0)
+        return 0;
+    int e = 0;
+    while ((n % 10) == 0 && e < 9) {
+        n /= 10;
+        e++;
+    }
+    if (e < 9) {
+        const int d = n % 10;
+        n /= 10;
+        return 1 + (n * 9 + d - 1) * 10 + e;
+    }
+    return 1 + (n - 1) * 10 + 9;
+}
+
+uint64_t DecompressAmount(uint64_t x)
+{
+    if (x == 0)
+        return 0;
+    x--;
+    int e = x % 10;
+    x /= 10;
+    uint64_t n;
+    if (e < 9) {
+        const int d = (x % 9) + 1;
+        x /= 9;
+        n = x * 10 + d;
+    } else {
+        n = x + 1;
+    }
+    while (e) {
+        n *= 10;
+        e--;
+    }
+    return n;
+}
+
+/** Template ID and hash of a standard script, SCRIPT_SPECIAL otherwise */
+static unsigned int ScriptTemplate(const ScriptView& script, ScriptView& hash)
+{
+    switch (script.Match(&hash)) {
+    case TX_PUBKEYHASH: return SCRIPT_P2PKH;
+    case TX_SCRIPTHASH: return SCRIPT_P2SH;
+    case TX_WITNESS_V0_KEYHASH: return SCRIPT_P2WPKH;
+    case TX_WITNESS_V0_SCRIPTHASH: return SCRIPT_P2WSH;
+    default: return SCRIPT_SPECIAL;
+    }
+}
+
+static uint64_t CoinCode(const Coin& coin)
+{
+    return (uint64_t)coin.height * 2 + (coin.coinbase ? 1 : 0);
+}
+
+size_t CompressedCoinSize(const Coin& coin)
+{
+    const uint64_t code = CoinCode(coin);
+    const uint64_t amount = CompressAmount(coin.amount);
+    ScriptView hash;
+    const size_t script = ScriptTemplate(coin.script, hash) != SCRIPT_SPECIAL
+                              ? 1 + hash.size()
+                              : VarIntSize(coin.script.size() + SCRIPT_SPECIAL) + coin.script.size();
+    return VarIntSize(code) + VarIntSize(amount) + script;
+}
+
+void CompressCoin(const Coin& coin, unsigned char* out)
+{
+    out = WriteVarInt(out, CoinCode(coin));
+    out = WriteVarInt(out, CompressAmount(coin.amount));
+    ScriptView hash;
+    const unsigned int id = ScriptTemplate(coin.script, hash);
+    if (id != SCRIPT_SPECIAL) {
+        *out++ = (unsigned char)id;
+        memcpy(out, hash.data(), hash.size());
+        return;
+    }
+    out = WriteVarInt(out, coin.script.size() + SCRIPT_SPECIAL);
+    if (!coin.script.empty())
+        memcpy(out, coin.script.data(), coin.script.size());
+}
+
+bool DecompressCoin(const unsigned char* data, size_t size, Coin& coin)
+{
+    const unsigned char* pos = data;
+    const unsigned char* end = data + size;
+    uint64_t code, amount, id;
+    if (!ReadVarInt(pos, end, code) || code > (uint64_t)UINT32_MAX * 2 + 1)
+        return false;
+    if (!ReadVarInt(pos, end, amount) || !ReadVarInt(pos, end, id))
+        return false;
+    coin.height = (uint32_t)(code >> 1);
+    coin.coinbase = code & 1;
+    coin.amount = DecompressAmount(amount);
+
+    unsigned char script[34];
+    size_t script_size;
+    const size_t left = end - pos;
+    switch (id) {
+    case SCRIPT_P2PKH:
+        if (left != 20)
+            return false;
+        script[0] = OP_DUP;
+        script[1] = OP_HASH160;
+        script[2] = 20;
+        memcpy(script + 3, pos, 20);
+        script[23] = OP_EQUALVERIFY;
+        script[24] = OP_CHECKSIG;
+        script_size = 25;
+        break;
+    case SCRIPT_P2SH:
+        if (left != 20)
+            return false;
+        script[0] = OP_HASH160;
+        script[1] = 20;
+        memcpy(script + 2, pos, 20);
+        script[22] = OP_EQUAL;
+        script_size = 23;
+        break;
+    case SCRIPT_P2WPKH:
+    case SCRIPT_P2WSH:
+        script_size = id == SCRIPT_P2WPKH ? 20 : 32;
+        if (left != script_size)
+            return false;
+        script[0] = OP_0;
+        script[1] = (unsigned char)script_size;
+        memcpy(script + 2, pos, script_size);
+        script_size += 2;
+        break;
+    default:
+        if (id - SCRIPT_SPECIAL != left)
+            return false;
+        coin.script.Assign(pos, left);
+        return true;
+    }
+    coin.script.Assign(script, script_size);
+    return true;
+}
+
+} // namespace NiuChain
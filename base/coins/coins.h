@@ -0,0 +1,80 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_COINS_H
+#define NIUBLOCK_COINS_H
+
+#include "script.h"
+#include "uint256.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace NiuChain {
+
+/** A transaction output's position, the UTXO set's key */
+struct OutPoint
+{
+    uint256 hash;
+    uint32_t n;
+
+    OutPoint() : n(0) {}
+    OutPoint(const uint256& hash_in, uint32_t n_in) : hash(hash_in), n(n_in) {}
+
+    bool operator==(const OutPoint& other) const { return n == other.n && hash == other.hash; }
+    bool operator!=(const OutPoint& other) const { return !(*this == other); }
+};
+
+/** An unspent output: amount, script, and where it was created */
+struct Coin
+{
+    uint64_t amount;
+    Script script;
+    uint32_t height;
+    bool coinbase;
+
+    Coin() : amount(0), height(0), coinbase(false) {}
+    Coin(uint64_t amount_in, const ScriptView& script_in, uint32_t height_in, bool coinbase_in)
+        : amount(amount_in), script(script_in), height(height_in), coinbase(coinbase_in) {}
+};
+
+/**
+ * Coins are stored compressed, in memory and on disk alike, as Bitcoin
+ * Core's CCoinsViewDB does:
+ *
+ *   VARINT(height * 2 + coinbase) VARINT(CompressAmount(amount)) script
+ *
+ * A script of one of the standard templates is its template ID and hash;
+ * anything else is VARINT(size + SCRIPT_SPECIAL) and the bytes.  A P2PKH
+ * coin of a recent block takes about 28 bytes rather than 38.
+ */
+enum ScriptTemplateId : uint8_t {
+    SCRIPT_P2PKH = 0,           //!< 20 byte hash
+    SCRIPT_P2SH = 1,            //!< 20 byte hash
+    SCRIPT_P2WPKH = 2,          //!< 20 byte hash
+    SCRIPT_P2WSH = 3,           //!< 32 byte hash
+    SCRIPT_SPECIAL = 4
+};
+
+/** Core's MSB base-128 varint, one byte for values below 128 */
+size_t VarIntSize(uint64_t n);
+unsigned char* WriteVarInt(unsigned char* out, uint64_t n);
+/** false on a truncated or overlong encoding */
+bool ReadVarInt(const unsigned char*& pos, const unsigned char* end, uint64_t& n);
+
+/** Amounts in satoshi are mostly round numbers; strip trailing zeros */
+uint64_t CompressAmount(uint64_t n);
+uint64_t DecompressAmount(uint64_t x);
+
+size_t CompressedCoinSize(const Coin& coin);
+/** Writes exactly CompressedCoinSize(coin) bytes */
+void CompressCoin(const Coin& coin, unsigned char* out);
+bool DecompressCoin(const unsigned char* data, size_t size, Coin& coin);
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_COINS_H
@@ -0,0 +1,210 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinscache.h"
+
+#include <stdexcept>
+
+namespace NiuChain {
+
+static_assert(sizeof(OutPointMap<CoinsCacheEntry>::Slot) == 80, "a cache slot is 80 bytes");
+
+CoinsCache::CoinsCache(CoinsLog& log, size_t memory_budget)
+    : m_log(log),
+      m_heap_bytes(0),
+      m_budget(memory_budget),
+      m_best_block(log.BestBlock()),
+      m_stats()
+{
+}
+
+CoinsCache::~CoinsCache()
+{
+    Discard();
+}
+
+const unsigned char* CoinsCache::Value(const CoinsCacheEntry& entry) const
+{
+    if (entry.size <= CoinsCacheEntry::INLINE_SIZE)
+        return entry.bytes;
+    unsigned char* heap;
+    memcpy(&heap, entry.bytes, sizeof(heap));
+    return heap;
+}
+
+/** Room for a compressed coin of size bytes, replacing the entry's coin */
+unsigned char* CoinsCache::SetValue(CoinsCacheEntry& entry, size_t size)
+{
+    FreeValue(entry);
+    entry.size = (uint16_t)size;
+    if (size <= CoinsCacheEntry::INLINE_SIZE)
+        return entry.bytes;
+    unsigned char* heap = static_cast<unsigned char*>(NiuMem::Allocate(NiuMem::MEM_CACHE, size));
+    memcpy(entry.bytes, &heap, sizeof(heap));
+    m_heap_bytes += size;
+    return heap;
+}
+
+void CoinsCache::FreeValue(CoinsCacheEntry& entry)
+{
+    if (entry.size > CoinsCacheEntry::INLINE_SIZE) {
+        NiuMem::Deallocate(NiuMem::MEM_CACHE, const_cast<unsigned char*>(Value(entry)), entry.size);
+        m_heap_bytes -= entry.size;
+    }
+    entry.size = 0;
+}
+
+CoinsCacheEntry* CoinsCache::Fetch(const OutPoint& outpoint)
+{
+    CoinsCacheEntry* entry = m_map.Find(outpoint);
+    if (entry) {
+        m_stats.hits++;
+        return entry;
+    }
+    if (!m_log.Get(outpoint, m_buffer))
+        return nullptr;
+    m_stats.misses++;
+    entry = m_map.Insert(outpoint);
+    memcpy(SetValue(*entry, m_buffer.size()), m_buffer.data(), m_buffer.size());
+    return entry;
+}
+
+bool CoinsCache::GetCoin(const OutPoint& outpoint, Coin& coin)
+{
+    const CoinsCacheEntry* entry = Fetch(outpoint);
+    if (!entry || (entry->flags & CoinsCacheEntry::SPENT))
+        return false;
+    return DecompressCoin(Value(*entry), entry->size, coin);
+}
+
+bool CoinsCache::HaveCoin(const OutPoint& outpoint)
+{
+    const CoinsCacheEntry* entry = Fetch(outpoint);
+    return entry && !(entry->flags & CoinsCacheEntry::SPENT);
+}
+
+void CoinsCache::AddCoin(const OutPoint& outpoint, const Coin& coin, bool possible_overwrite)
+{
+    if (coin.script.View().IsUnspendable())
+        return;
+    bool inserted;
+    CoinsCacheEntry* entry = m_map.Insert(outpoint, &inserted);
+    if (inserted)
+        entry->flags = CoinsCacheEntry::SPENT;
+    bool fresh = false;
+    if (!possible_overwrite) {
+        if (!(entry->flags & CoinsCacheEntry::SPENT))
+            throw std::logic_error("Attempted to overwrite an unspent coin (when possible_overwrite is false)");
+        // A spent coin not yet written is still in the log; it needs the
+        // put, or the erase, that a fresh coin would skip
+        fresh = !(entry->flags & CoinsCacheEntry::DIRTY);
+    }
+    CompressCoin(coin, SetValue(*entry, CompressedCoinSize(coin)));
+    entry->flags = (entry->flags & ~CoinsCacheEntry::SPENT) | CoinsCacheEntry::DIRTY |
+                   (fresh ? CoinsCacheEntry::FRESH : 0);
+}
+
+bool CoinsCache::SpendCoin(const OutPoint& outpoint, Coin* moveout)
+{
+    CoinsCacheEntry* entry = Fetch(outpoint);
+    if (!entry || (entry->flags & CoinsCacheEntry::SPENT))
+        return false;
+    if (moveout && !DecompressCoin(Value(*entry), entry->size, *moveout))
+        return false;
+    FreeValue(*entry);
+    if (entry->flags & CoinsCacheEntry::FRESH) {
+        m_map.Erase(outpoint);
+        m_stats.fresh_spends++;
+    } else {
+        entry->flags |= CoinsCacheEntry::DIRTY | CoinsCacheEntry::SPENT;
+    }
+    return true;
+}
+
+bool CoinsCache::Write(bool erase)
+{
+    CoinsLogBatch batch;
+    uint64_t puts = 0;
+    uint64_t erases = 0;
+    m_map.ForEach([&](const OutPoint& outpoint, const CoinsCacheEntry& entry) {
+        if (!(entry.flags & CoinsCacheEntry::DIRTY))
+            return;
+        // FRESH and SPENT together never last, SpendCoin() drops the entry
+        if (entry.flags & CoinsCacheEntry::SPENT) {
+            batch.Erase(outpoint);
+            erases++;
+        } else {
+            batch.Put(outpoint, Value(entry), entry.size);
+            puts++;
+        }
+    });
+    batch.SetBestBlock(m_best_block);
+    if ((batch.Count() || m_best_block != m_log.BestBlock()) && !m_log.Write(batch))
+        return false;
+    m_stats.flushes++;
+    m_stats.flushed_puts += puts;
+    m_stats.flushed_erases += erases;
+
+    if (erase) {
+        m_map.ForEach([&](const OutPoint&, CoinsCacheEntry& entry) { FreeValue(entry); });
+        m_map.Clear();
+    } else {
+        m_map.Retain([&](const OutPoint&, CoinsCacheEntry& entry) {
+            if (entry.flags & CoinsCacheEntry::SPENT)
+                return false;
+            entry.flags = 0;
+            return true;
+        });
+    }
+    return true;
+}
+
+bool CoinsCache::MaybeFlush()
+{
+    return DynamicMemoryUsage() <= m_budget || Flush();
+}
+
+void CoinsCache::Discard()
+{
+    m_map.ForEach([&](const OutPoint&, CoinsCacheEntry& entry) { FreeValue(entry); });
+    m_map.Clear();
+    m_best_block = m_log.BestBlock();
+}
+
+bool UpdateCoins(const TransactionView& tx, CoinsCache& coins, uint32_t height)
+{
+    const bool coinbase = tx.is_coinbase();
+    if (!coinbase) {
+        for (const InputView& input : tx.inputs()) {
+            const OutPointView& prevout = input.previous_output();
+            if (!coins.SpendCoin(OutPoint(prevout.hash(), prevout.index())))
+                return false;
+        }
+    }
+    const uint256 hash = tx.hash();
+    try {
+        for (size_t i = 0; i < tx.outputs().size(); i++) {
+            const OutputView& output = tx.outputs()[i];
+            // Coinbases could repeat before BIP30 and BIP34, see Core's AddCoins()
+            coins.AddCoin(OutPoint(hash, (uint32_t)i), Coin(output.value(), output.script(), height, coinbase),
+                          coinbase);
+        }
+    } catch (const std::logic_error&) {
+        // A transaction repeated within the block, as in CVE-2012-2459
+        return false;
+    }
+    return true;
+}
+
+bool ConnectBlock(const BlockView& block, CoinsCache& coins, uint32_t height)
+{
+    for (const TransactionView& tx : block.transactions()) {
+        if (!UpdateCoins(tx, coins, height))
+            return false;
+    }
+    coins.SetBestBlock(block.hash());
+    return true;
+}
+
+} // namespace NiuChain
@@ -0,0 +1,121 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_COINSCACHE_H
+#define NIUBLOCK_COINSCACHE_H
+
+#include "blockview.h"
+#include "coins.h"
+#include "coinslog.h"
+#include "outpointmap.h"
+
+#include <vector>
+
+namespace NiuChain {
+
+/** Default for CoinsCache's memory budget */
+static const size_t DEFAULT_COINS_CACHE_BYTES = 64 * 1024 * 1024;
+
+/** Value of a cached coin: flags and the compressed coin */
+struct CoinsCacheEntry
+{
+    enum : uint8_t {
+        DIRTY = 1,              //!< differs from the log
+        FRESH = 2,              //!< not in the log at all, so spending it needs no erase record
+        SPENT = 4,              //!< spent, kept only to write the erase
+    };
+    static const size_t INLINE_SIZE = 40;
+
+    uint8_t flags;
+    uint8_t unused;
+    uint16_t size;              //!< of the compressed coin
+    unsigned char bytes[INLINE_SIZE];   //!< the coin, or a pointer to it when larger
+};
+
+struct CoinsCacheStats
+{
+    uint64_t hits;
+    uint64_t misses;            //!< read from the log
+    uint64_t flushes;
+    uint64_t flushed_puts;
+    uint64_t flushed_erases;
+    uint64_t fresh_spends;      //!< created and spent between flushes, never written
+};
+
+/**
+ * The UTXO set in memory, on top of a CoinsLog, as Bitcoin Core's
+ * CCoinsViewCache is on top of the chainstate database.
+ *
+ * Coins stay compressed in a flat OutPointMap: a slot is 80 bytes, key
+ * included, and any coin paying to a standard template fits inline.  Reads
+ * fill the cache from the log; changes are only marked DIRTY, and Flush()
+ * writes them all as one log batch with one sync.  A coin created and spent
+ * between two flushes is FRESH and never reaches the disk.
+ *
+ * DynamicMemoryUsage() counts the table and the out of line coins;
+ * MaybeFlush() flushes once that passes the budget.  Not thread safe.
+ */
+class CoinsCache
+{
+public:
+    explicit CoinsCache(CoinsLog& log, size_t memory_budget = DEFAULT_COINS_CACHE_BYTES);
+    ~CoinsCache();
+
+    CoinsCache(const CoinsCache&) = delete;
+    CoinsCache& operator=(const CoinsCache&) = delete;
+
+    bool GetCoin(const OutPoint& outpoint, Coin& coin);
+    bool HaveCoin(const OutPoint& outpoint);
+    /** Without possible_overwrite, replacing an unspent coin throws
+     *  std::logic_error: the caller has a bug or missed a BIP30 check.
+     *  Unspendable outputs are not added. */
+    void AddCoin(const OutPoint& outpoint, const Coin& coin, bool possible_overwrite);
+    /** false if there is no such unspent coin */
+    bool SpendCoin(const OutPoint& outpoint, Coin* moveout = nullptr);
+
+    void SetBestBlock(const uint256& hash) { m_best_block = hash; }
+    const uint256& GetBestBlock() const { return m_best_block; }
+
+    /** Write every change to the log and empty the cache */
+    bool Flush() { return Write(true); }
+    /** Write every change to the log and keep the unspent coins, clean */
+    bool Sync() { return Write(false); }
+    /** Flush() if over the memory budget */
+    bool MaybeFlush();
+    /** Drop every change since the last flush */
+    void Discard();
+
+    size_t DynamicMemoryUsage() const { return m_map.MemoryUsage() + m_heap_bytes; }
+    size_t MemoryBudget() const { return m_budget; }
+    void SetMemoryBudget(size_t bytes) { m_budget = bytes; }
+    size_t CacheSize() const { return m_map.Size(); }
+    const CoinsCacheStats& Stats() const { return m_stats; }
+
+private:
+    CoinsCacheEntry* Fetch(const OutPoint& outpoint);
+    const unsigned char* Value(const CoinsCacheEntry& entry) const;
+    unsigned char* SetValue(CoinsCacheEntry& entry, size_t size);
+    void FreeValue(CoinsCacheEntry& entry);
+    bool Write(bool erase);
+
+    CoinsLog& m_log;
+    OutPointMap<CoinsCacheEntry> m_map;
+    size_t m_heap_bytes;        //!< coins too large to be inline
+    size_t m_budget;
+    uint256 m_best_block;
+    std::vector<unsigned char> m_buffer;
+    CoinsCacheStats m_stats;
+};
+
+/** Spend the inputs and add the outputs of tx; false if an input is
+ *  missing or spent */
+bool UpdateCoins(const TransactionView& tx, CoinsCache& coins, uint32_t height);
+
+/** UpdateCoins() for every transaction, then the best block.  On failure
+ *  the cache is partly updated: Discard() it rather than flush. */
+bool ConnectBlock(const BlockView& block, CoinsCache& coins, uint32_t height);
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_COINSCACHE_H
@@ -0,0 +1,422 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "coinslog.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace NiuChain {
+
+static const unsigned char FILE_MAGIC[8] = {'N', 'I', 'U', 'C', 'O', 'I', 'N', '1'};
+static const uint32_t BATCH_MAGIC = 0x42434e4e;
+/** magic, record count, payload size, best block */
+static const size_t BATCH_HEADER_SIZE = 4 + 4 + 8 + 32;
+static const size_t CHECKSUM_SIZE = 4;
+/** type, outpoint, and for a put the value size */
+static const size_t RECORD_KEY_SIZE = 1 + 36;
+static const size_t PUT_HEADER_SIZE = RECORD_KEY_SIZE + 4;
+/** Records Compact() buffers before writing them out as one batch */
+static const size_t COMPACT_BATCH_BYTES = 1 << 20;
+
+enum : unsigned char {
+    RECORD_PUT = 1,
+    RECORD_ERASE = 2,
+};
+
+static void PutLE32(unsigned char* out, uint32_t x)
+{
+    for (int i = 0; i < 4; i++)
+        out[i] = (unsigned char)(x >> (8 * i));
+}
+
+static uint32_t GetLE32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t GetLE64(const unsigned char* p)
+{
+    return (uint64_t)GetLE32(p) | (uint64_t)GetLE32(p + 4) << 32;
+}
+
+static uint32_t Checksum(const unsigned char* header, const unsigned char* payload, size_t size)
+{
+    unsigned char hash[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(header, BATCH_HEADER_SIZE).Write(payload, size).Finalize(hash);
+    return GetLE32(hash);
+}
+
+/** pwrite() all of data, retrying on partial writes and EINTR */
+static bool WriteAt(int fd, const unsigned char* data, size_t size, uint64_t offset)
+{
+    while (size > 0) {
+        const ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+/** pread() all of size bytes, false on error or end of file */
+static bool ReadAt(int fd, unsigned char* data, size_t size, uint64_t offset)
+{
+    while (size > 0) {
+        const ssize_t n = pread(fd, data, size, offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+/** Write batch at offset without syncing; returns the bytes written, 0 on error */
+static uint64_t WriteBatch(int fd, uint64_t offset, const unsigned char* records, size_t size, uint32_t count,
+                           const uint256& best_block)
+{
+    unsigned char header[BATCH_HEADER_SIZE];
+    PutLE32(header, BATCH_MAGIC);
+    PutLE32(header + 4, count);
+    PutLE32(header + 8, (uint32_t)size);
+    PutLE32(header + 12, (uint32_t)((uint64_t)size >> 32));
+    memcpy(header + 16, best_block.begin(), 32);
+    unsigned char checksum[CHECKSUM_SIZE];
+    PutLE32(checksum, Checksum(header, records, size));
+    if (!WriteAt(fd, header, sizeof(header), offset) ||
+        !WriteAt(fd, records, size, offset + sizeof(header)) ||
+        !WriteAt(fd, checksum, sizeof(checksum), offset + sizeof(header) + size))
+        return 0;
+    return sizeof(header) + size + sizeof(checksum);
+}
+
+enum BatchCheck {
+    BATCH_WHOLE,
+    BATCH_TAIL,         //!< short or bad, and running to the end of the file
+    BATCH_BAD,          //!< bad checksum, with more of the file after it
+    BATCH_NO_MAGIC,
+    BATCH_READ_ERROR,
+};
+
+/** Read the batch at offset into header and payload, and check it */
+static BatchCheck CheckBatch(int fd, uint64_t offset, uint64_t file_size, unsigned char* header,
+                             std::vector<unsigned char>& payload)
+{
+    if (file_size - offset < BATCH_HEADER_SIZE + CHECKSUM_SIZE)
+        return BATCH_TAIL;
+    if (!ReadAt(fd, header, BATCH_HEADER_SIZE, offset))
+        return BATCH_READ_ERROR;
+    if (GetLE32(header) != BATCH_MAGIC)
+        return BATCH_NO_MAGIC;
+    const uint64_t size = GetLE64(header + 8);
+    if (size > file_size - offset - BATCH_HEADER_SIZE - CHECKSUM_SIZE)
+        return BATCH_TAIL;
+    payload.resize(size);
+    unsigned char checksum[CHECKSUM_SIZE];
+    if (!ReadAt(fd, payload.data(), size, offset + BATCH_HEADER_SIZE) ||
+        !ReadAt(fd, checksum, sizeof(checksum), offset + BATCH_HEADER_SIZE + size))
+        return BATCH_READ_ERROR;
+    if (GetLE32(checksum) != Checksum(header, payload.data(), size))
+        return offset + BATCH_HEADER_SIZE + size + CHECKSUM_SIZE == file_size ? BATCH_TAIL : BATCH_BAD;
+    return BATCH_WHOLE;
+}
+
+/** Whether a whole batch starts anywhere in [from, file_size); true if
+ *  the file cannot be read, as that does not prove there is none */
+static bool FindWholeBatch(int fd, uint64_t from, uint64_t file_size)
+{
+    unsigned char magic[4];
+    PutLE32(magic, BATCH_MAGIC);
+    unsigned char header[BATCH_HEADER_SIZE];
+    std::vector<unsigned char> payload;
+    std::vector<unsigned char> chunk(1 << 16);
+    for (uint64_t at = from; file_size - at >= BATCH_HEADER_SIZE + CHECKSUM_SIZE;) {
+        const size_t size = (size_t)std::min<uint64_t>(chunk.size(), file_size - at);
+        if (!ReadAt(fd, chunk.data(), size, at))
+            return true;
+        for (size_t i = 0; i + sizeof(magic) <= size; i++) {
+            if (memcmp(chunk.data() + i, magic, sizeof(magic)) != 0)
+                continue;
+            const BatchCheck check = CheckBatch(fd, at + i, file_size, header, payload);
+            if (check == BATCH_WHOLE || check == BATCH_READ_ERROR)
+                return true;
+        }
+        // A magic split across chunks is found in the next one
+        at += size - (sizeof(magic) - 1);
+    }
+    return false;
+}
+
+static bool SyncDirectory(const std::string& path)
+{
+    const size_t slash = path.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int fd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    const bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+void CoinsLogBatch::Put(const OutPoint& key, const unsigned char* value, size_t size)
+{
+    const size_t at = m_records.size();
+    m_records.resize(at + PUT_HEADER_SIZE + size);
+    unsigned char* out = m_records.data() + at;
+    out[0] = RECORD_PUT;
+    memcpy(out + 1, key.hash.begin(), 32);
+    PutLE32(out + 33, key.n);
+    PutLE32(out + 37, (uint32_t)size);
+    if (size)
+        memcpy(out + PUT_HEADER_SIZE, value, size);
+    m_count++;
+}
+
+void CoinsLogBatch::Erase(const OutPoint& key)
+{
+    const size_t at = m_records.size();
+    m_records.resize(at + RECORD_KEY_SIZE);
+    unsigned char* out = m_records.data() + at;
+    out[0] = RECORD_ERASE;
+    memcpy(out + 1, key.hash.begin(), 32);
+    PutLE32(out + 33, key.n);
+    m_count++;
+}
+
+void CoinsLogBatch::Clear()
+{
+    m_records.clear();
+    m_count = 0;
+    m_best_block.SetNull();
+}
+
+CoinsLog::CoinsLog()
+    : m_fd(-1),
+      m_size(0),
+      m_live_bytes(0),
+      m_stats()
+{
+}
+
+CoinsLog::~CoinsLog()
+{
+    Close();
+}
+
+void CoinsLog::Close()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+    m_fd = -1;
+    m_size = 0;
+    m_live_bytes = 0;
+    m_best_block.SetNull();
+    m_index.Clear();
+}
+
+bool CoinsLog::Open(const std::string& path)
+{
+    Close();
+    m_path = path;
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        Close();
+        return false;
+    }
+    m_size = st.st_size;
+    m_stats = CoinsLogStats();
+
+    if (m_size < HEADER_BYTES) {
+        // New, or torn before the magic made it to disk
+        if (ftruncate(m_fd, 0) != 0 || !WriteAt(m_fd, FILE_MAGIC, sizeof(FILE_MAGIC), 0) || fdatasync(m_fd) != 0) {
+            Close();
+            return false;
+        }
+        m_size = HEADER_BYTES;
+        return true;
+    }
+    unsigned char magic[sizeof(FILE_MAGIC)];
+    if (!ReadAt(m_fd, magic, sizeof(magic), 0) || memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || !Replay()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool CoinsLog::Replay()
+{
+    uint64_t offset = HEADER_BYTES;
+    unsigned char header[BATCH_HEADER_SIZE];
+    std::vector<unsigned char> payload;
+    while (offset < m_size) {
+        const BatchCheck check = CheckBatch(m_fd, offset, m_size, header, payload);
+        if (check == BATCH_READ_ERROR || check == BATCH_BAD)
+            return false;
+        // Write() syncs each batch before the next is appended, so a crash
+        // can only tear the last one.  A whole batch after a bad header, or
+        // after a size running past the end, is damage in the middle of the
+        // file, and cutting it off would lose flushed coins.
+        if ((check == BATCH_NO_MAGIC || check == BATCH_TAIL) && FindWholeBatch(m_fd, offset + 1, m_size))
+            return false;
+        if (check != BATCH_WHOLE)
+            break;
+        // A batch with a valid checksum but bad records is not a torn write
+        if (!Apply(payload.data(), payload.size(), offset + BATCH_HEADER_SIZE))
+            return false;
+        memcpy(m_best_block.begin(), header + 16, 32);
+        offset += BATCH_HEADER_SIZE + payload.size() + CHECKSUM_SIZE;
+    }
+    if (offset < m_size) {
+        if (ftruncate(m_fd, offset) != 0 || fdatasync(m_fd) != 0)
+            return false;
+        m_size = offset;
+    }
+    return true;
+}
+
+bool CoinsLog::Apply(const unsigned char* payload, size_t size, uint64_t offset)
+{
+    const unsigned char* pos = payload;
+    const unsigned char* end = payload + size;
+    while (pos < end) {
+        if ((size_t)(end - pos) < RECORD_KEY_SIZE)
+            return false;
+        const unsigned char type = pos[0];
+        OutPoint key;
+        memcpy(key.hash.begin(), pos + 1, 32);
+        key.n = GetLE32(pos + 33);
+        if (type == RECORD_PUT) {
+            if ((size_t)(end - pos) < PUT_HEADER_SIZE)
+                return false;
+            const uint32_t value_size = GetLE32(pos + 37);
+            if ((size_t)(end - pos) - PUT_HEADER_SIZE < value_size)
+                return false;
+            bool inserted;
+            Location* location = m_index.Insert(key, &inserted);
+            if (!inserted)
+                m_live_bytes -= PUT_HEADER_SIZE + location->size;
+            location->offset = offset + (pos - payload) + PUT_HEADER_SIZE;
+            location->size = value_size;
+            m_live_bytes += PUT_HEADER_SIZE + value_size;
+            pos += PUT_HEADER_SIZE + value_size;
+        } else if (type == RECORD_ERASE) {
+            const Location* location = m_index.Find(key);
+            if (location) {
+                m_live_bytes -= PUT_HEADER_SIZE + location->size;
+                m_index.Erase(key);
+            }
+            pos += RECORD_KEY_SIZE;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CoinsLog::Get(const OutPoint& key, std::vector<unsigned char>& value)
+{
+    const Location* location = m_index.Find(key);
+    if (!location)
+        return false;
+    value.resize(location->size);
+    m_stats.reads++;
+    if (!ReadAt(m_fd, value.data(), location->size, location->offset))
+        throw std::runtime_error("coins log read error: " + m_path);
+    return true;
+}
+
+bool CoinsLog::Write(const CoinsLogBatch& batch)
+{
+    if (m_fd < 0)
+        return false;
+    const uint64_t written = WriteBatch(m_fd, m_size, batch.m_records.data(), batch.m_records.size(),
+                                        batch.m_count, batch.m_best_block);
+    if (written == 0 || fdatasync(m_fd) != 0) {
+        // Whatever made it to the file fails its checksum; cut it off now,
+        // or the next Open() will
+        const int ignored = ftruncate(m_fd, m_size);
+        (void)ignored;
+        return false;
+    }
+    Apply(batch.m_records.data(), batch.m_records.size(), m_size + BATCH_HEADER_SIZE);
+    m_best_block = batch.m_best_block;
+    m_size += written;
+    m_stats.batches++;
+    m_stats.records += batch.m_count;
+    m_stats.bytes += written;
+    m_stats.syncs++;
+    return true;
+}
+
+bool CoinsLog::Compact()
+{
+    if (m_fd < 0)
+        return false;
+    const std::string tmp = m_path + ".compact";
+    const int fd = open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    bool ok = WriteAt(fd, FILE_MAGIC, sizeof(FILE_MAGIC), 0);
+    uint64_t offset = HEADER_BYTES;
+
+    // The live coins in batches of about COMPACT_BATCH_BYTES, so memory
+    // stays bounded however large the set is; each carries the best block
+    CoinsLogBatch live;
+    live.m_records.reserve(COMPACT_BATCH_BYTES);
+    auto flush = [&]() {
+        live.SetBestBlock(m_best_block);
+        const uint64_t written = ok ? WriteBatch(fd, offset, live.m_records.data(), live.m_records.size(),
+                                                 live.m_count, live.m_best_block) : 0;
+        ok = written != 0;
+        offset += written;
+        live.Clear();
+    };
+    std::vector<unsigned char> value;
+    m_index.ForEach([&](const OutPoint& key, Location& location) {
+        if (!ok)
+            return;
+        value.resize(location.size);
+        ok = ReadAt(m_fd, value.data(), location.size, location.offset);
+        live.Put(key, value.data(), value.size());
+        if (live.SizeBytes() >= COMPACT_BATCH_BYTES)
+            flush();
+    });
+    // An empty set still records its best block
+    if (live.Count() > 0 || offset == HEADER_BYTES)
+        flush();
+    ok = ok && fdatasync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp.c_str(), m_path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    SyncDirectory(m_path);
+    const CoinsLogStats stats = m_stats;
+    const std::string path = m_path;
+    ok = Open(path);
+    m_stats = stats;
+    m_stats.syncs++;
+    return ok;
+}
+
+} // namespace NiuChain
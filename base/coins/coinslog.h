@@ -0,0 +1,124 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_COINSLOG_H
+#define NIUBLOCK_COINSLOG_H
+
+#include "coins.h"
+#include "outpointmap.h"
+
+#include <string>
+#include <vector>
+
+namespace NiuChain {
+
+/** Changes written to the log together, see CoinsLog::Write() */
+class CoinsLogBatch
+{
+public:
+    CoinsLogBatch() : m_count(0) {}
+
+    /** value is a compressed coin, see CompressCoin() */
+    void Put(const OutPoint& key, const unsigned char* value, size_t size);
+    void Erase(const OutPoint& key);
+    void SetBestBlock(const uint256& hash) { m_best_block = hash; }
+
+    size_t Count() const { return m_count; }
+    size_t SizeBytes() const { return m_records.size(); }
+    void Clear();
+
+private:
+    friend class CoinsLog;
+
+    std::vector<unsigned char> m_records;
+    uint32_t m_count;
+    uint256 m_best_block;
+};
+
+struct CoinsLogStats
+{
+    uint64_t batches;           //!< written since Open()
+    uint64_t records;
+    uint64_t bytes;
+    uint64_t syncs;
+    uint64_t reads;
+};
+
+/**
+ * The UTXO set on disk, as an append-only log of batches.
+ *
+ * A batch is a header (record count, payload size, best block), records
+ * that put or erase one compressed coin, and a checksum, appended with one
+ * write() and made durable with one fdatasync(), so flushing the cache
+ * costs a sequential write however many coins changed.  Open() replays
+ * the log into an index of where each live coin's bytes are; a batch torn
+ * by a crash fails its checksum and is cut off, which leaves the set as of
+ * the last complete flush.  Only the last batch can be torn, so a bad one
+ * with more of the log after it fails Open() instead.  Values are read
+ * back with pread() on a cache miss.
+ *
+ * Spent and overwritten coins stay in the file as garbage until Compact()
+ * rewrites the live ones into a fresh log.
+ */
+class CoinsLog
+{
+public:
+    CoinsLog();
+    ~CoinsLog();
+
+    CoinsLog(const CoinsLog&) = delete;
+    CoinsLog& operator=(const CoinsLog&) = delete;
+
+    /** Open or create the log at path; false on I/O error, a foreign file
+     *  or damage before the last batch */
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_fd >= 0; }
+
+    /** The compressed coin at key, false if there is none.  Throws
+     *  std::runtime_error if the log cannot be read, as Core's database
+     *  wrapper does: a coin reported missing would make a valid block
+     *  look like it spends nothing. */
+    bool Get(const OutPoint& key, std::vector<unsigned char>& value);
+    bool Have(const OutPoint& key) const { return m_index.Find(key) != nullptr; }
+
+    /** Append batch and sync; on failure the log is as before */
+    bool Write(const CoinsLogBatch& batch);
+    /** Rewrite the live coins into a new file, dropping the garbage; the
+     *  new file replaces the log once all of it is synced */
+    bool Compact();
+
+    const uint256& BestBlock() const { return m_best_block; }
+    size_t Count() const { return m_index.Size(); }
+    uint64_t FileSize() const { return m_size; }
+    /** Bytes of records no longer live */
+    uint64_t GarbageBytes() const { return m_size - m_live_bytes - HEADER_BYTES; }
+    size_t IndexMemoryUsage() const { return m_index.MemoryUsage(); }
+    const CoinsLogStats& Stats() const { return m_stats; }
+
+private:
+    struct Location
+    {
+        uint64_t offset;        //!< of the value bytes
+        uint32_t size;
+    };
+
+    static const uint64_t HEADER_BYTES = 8;
+
+    /** Index the records of a batch whose payload starts at offset */
+    bool Apply(const unsigned char* payload, size_t size, uint64_t offset);
+    bool Replay();
+
+    std::string m_path;
+    int m_fd;
+    uint64_t m_size;
+    uint64_t m_live_bytes;      //!< records of live coins, as written
+    uint256 m_best_block;
+    OutPointMap<Location> m_index;
+    CoinsLogStats m_stats;
+};
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_COINSLOG_H
@@ -0,0 +1,244 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_OUTPOINTMAP_H
+#define NIUBLOCK_OUTPOINTMAP_H
+
+#include "coins.h"
+#include "memaccount.h"
+
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+namespace NiuChain {
+
+/** Per-process key of the outpoint hash, so nobody can pick txids that
+ *  collide in every node's table */
+uint64_t OutPointHashSalt();
+
+/**
+ * Hash table from outpoint to a small trivially copyable value, with open
+ * addressing and linear probing over one flat array of slots.
+ *
+ * A separate array holds one control byte per slot: empty, deleted, or 7
+ * bits of the key's hash.  A probe scans control bytes, which are dense in
+ * cache, and only compares keys whose 7 bits match, so a miss rarely
+ * touches a slot at all.  There is one allocation for the whole table,
+ * accounted under MEM_CACHE, instead of one node per entry as in
+ * std::unordered_map.
+ *
+ * Pointers to values are invalidated by Insert() and Reserve().
+ */
+template <typename V>
+class OutPointMap
+{
+    static_assert(std::is_trivially_copyable<V>::value, "slots are moved with memcpy");
+
+public:
+    struct Slot
+    {
+        OutPoint key;
+        V value;
+    };
+
+    OutPointMap() : m_ctrl(nullptr), m_slots(nullptr), m_capacity(0), m_size(0), m_deleted(0) {}
+    ~OutPointMap() { Free(); }
+
+    OutPointMap(const OutPointMap&) = delete;
+    OutPointMap& operator=(const OutPointMap&) = delete;
+
+    V* Find(const OutPoint& key)
+    {
+        if (m_size == 0)
+            return nullptr;
+        const uint64_t hash = Hash(key);
+        const uint8_t tag = Tag(hash);
+        for (size_t i = hash & (m_capacity - 1);; i = (i + 1) & (m_capacity - 1)) {
+            if (m_ctrl[i] == tag && m_slots[i].key == key)
+                return &m_slots[i].value;
+            if (m_ctrl[i] == EMPTY)
+                return nullptr;
+        }
+    }
+    const V* Find(const OutPoint& key) const { return const_cast<OutPointMap*>(this)->Find(key); }
+
+    /** The value of key, value-initialised if it was not there */
+    V* Insert(const OutPoint& key, bool* inserted = nullptr)
+    {
+        if ((m_size + m_deleted + 1) * 8 > m_capacity * 7)
+            Rehash(m_size + 1);
+        const uint64_t hash = Hash(key);
+        const uint8_t tag = Tag(hash);
+        size_t free = m_capacity;
+        size_t i = hash & (m_capacity - 1);
+        for (;; i = (i + 1) & (m_capacity - 1)) {
+            if (m_ctrl[i] == tag && m_slots[i].key == key) {
+                if (inserted)
+                    *inserted = false;
+                return &m_slots[i].value;
+            }
+            if (m_ctrl[i] == DELETED && free == m_capacity)
+                free = i;
+            if (m_ctrl[i] == EMPTY)
+                break;
+        }
+        if (free != m_capacity) {
+            i = free;
+            m_deleted--;
+        }
+        m_ctrl[i] = tag;
+        new (&m_slots[i].key) OutPoint(key);
+        new (&m_slots[i].value) V();
+        m_size++;
+        if (inserted)
+            *inserted = true;
+        return &m_slots[i].value;
+    }
+
+    bool Erase(const OutPoint& key)
+    {
+        V* value = Find(key);
+        if (!value)
+            return false;
+        EraseSlot(SlotOf(value));
+        return true;
+    }
+
+    /** Calls f(key, value) for every entry */
+    template <typename F>
+    void ForEach(F f)
+    {
+        for (size_t i = 0; i < m_capacity; i++) {
+            if (!(m_ctrl[i] & 0x80))
+                f(const_cast<const OutPoint&>(m_slots[i].key), m_slots[i].value);
+        }
+    }
+
+    /** Keeps the entries for which keep(key, value) is true */
+    template <typename F>
+    void Retain(F keep)
+    {
+        for (size_t i = 0; i < m_capacity; i++) {
+            if (!(m_ctrl[i] & 0x80) && !keep(const_cast<const OutPoint&>(m_slots[i].key), m_slots[i].value))
+                EraseSlot(i);
+        }
+    }
+
+    /** Room for count entries without growing */
+    void Reserve(size_t count)
+    {
+        if (count * 8 > m_capacity * 7)
+            Rehash(count);
+    }
+
+    /** Drop every entry and the table's memory */
+    void Clear() { Free(); }
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    size_t Capacity() const { return m_capacity; }
+    size_t MemoryUsage() const { return m_capacity * (sizeof(Slot) + 1); }
+
+private:
+    static const uint8_t EMPTY = 0x80;
+    static const uint8_t DELETED = 0xfe;
+    static const size_t MIN_CAPACITY = 16;
+
+    uint64_t Hash(const OutPoint& key) const
+    {
+        uint64_t a, b;
+        memcpy(&a, key.hash.begin(), 8);
+        memcpy(&b, key.hash.begin() + 8, 8);
+        uint64_t h = (a ^ m_salt) + (b ^ ((uint64_t)key.n << 32 | key.n)) * 0x9e3779b97f4a7c15ULL;
+        // MurmurHash3's finalizer
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+    static uint8_t Tag(uint64_t hash) { return (uint8_t)(hash >> 57); }
+
+    size_t SlotOf(const V* value) const
+    {
+        return (reinterpret_cast<const unsigned char*>(value) - reinterpret_cast<const unsigned char*>(m_slots) -
+                offsetof(Slot, value)) / sizeof(Slot);
+    }
+
+    void EraseSlot(size_t i)
+    {
+        // A slot before an empty one ends no probe chain, so it can be empty too
+        if (m_ctrl[(i + 1) & (m_capacity - 1)] == EMPTY) {
+            m_ctrl[i] = EMPTY;
+        } else {
+            m_ctrl[i] = DELETED;
+            m_deleted++;
+        }
+        m_size--;
+    }
+
+    /** New storage for count entries, dropping the deleted marks */
+    void Rehash(size_t count)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * 7 < count * 8)
+            capacity *= 2;
+        // Mostly deleted marks: clean up at the same size rather than grow
+        if (capacity < m_capacity)
+            capacity = m_capacity;
+        else if (capacity == m_capacity && m_deleted == 0)
+            capacity *= 2;
+
+        uint8_t* const old_ctrl = m_ctrl;
+        Slot* const old_slots = m_slots;
+        const size_t old_capacity = m_capacity;
+        unsigned char* memory = static_cast<unsigned char*>(
+            NiuMem::Allocate(NiuMem::MEM_CACHE, capacity * sizeof(Slot) + capacity));
+        // The table is untouched until here, so the caller keeps a valid map
+        if (!memory)
+            throw std::bad_alloc();
+        m_slots = reinterpret_cast<Slot*>(memory);
+        m_ctrl = memory + capacity * sizeof(Slot);
+        memset(m_ctrl, EMPTY, capacity);
+        m_capacity = capacity;
+        m_deleted = 0;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_ctrl[i] & 0x80)
+                continue;
+            size_t j = Hash(old_slots[i].key) & (capacity - 1);
+            while (m_ctrl[j] != EMPTY)
+                j = (j + 1) & (capacity - 1);
+            m_ctrl[j] = old_ctrl[i];
+            memcpy(static_cast<void*>(&m_slots[j]), &old_slots[i], sizeof(Slot));
+        }
+        if (old_capacity)
+            NiuMem::Deallocate(NiuMem::MEM_CACHE, old_slots, old_capacity * sizeof(Slot) + old_capacity);
+    }
+
+    void Free()
+    {
+        if (m_capacity)
+            NiuMem::Deallocate(NiuMem::MEM_CACHE, m_slots, m_capacity * sizeof(Slot) + m_capacity);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_deleted = 0;
+    }
+
+    uint8_t* m_ctrl;
+    Slot* m_slots;
+    size_t m_capacity;          //!< a power of two, or 0
+    size_t m_size;
+    size_t m_deleted;
+    const uint64_t m_salt = OutPointHashSalt();
+};
+
+} // namespace NiuChain
+
+#endif // NIUBLOCK_OUTPOINTMAP_H
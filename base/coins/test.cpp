@@ -0,0 +1,408 @@
+#include "coinscache.h"
+#include "utilstrencodings.h"
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NiuChain;
+
+static OutPoint Key(uint64_t i)
+{
+  OutPoint key;
+  for (int b = 0; b < 32; b++)
+    key.hash.begin()[b] = (unsigned char)((i * 131 + b * 7) >> (b % 4));
+  memcpy(key.hash.begin(), &i, sizeof(i));
+  key.n = (uint32_t)(i % 7);
+  return key;
+}
+
+static Coin P2pkh(uint64_t amount, uint32_t height)
+{
+  std::vector<unsigned char> script = {OP_DUP, OP_HASH160, 20};
+  script.resize(23, (unsigned char)amount);
+  script.insert(script.end(), {OP_EQUALVERIFY, OP_CHECKSIG});
+  return Coin(amount, ScriptView(script.data(), script.size()), height, false);
+}
+
+static bool Same(const Coin& a, const Coin& b)
+{
+  return a.amount == b.amount && a.script == b.script && a.height == b.height && a.coinbase == b.coinbase;
+}
+
+static off_t FileSize(const std::string& path)
+{
+  struct stat st;
+  const int ret = stat(path.c_str(), &st);
+  assert(ret == 0);
+  return ret == 0 ? st.st_size : -1;
+}
+
+int main()
+{
+  // Bitcoin Core's compression vectors
+  assert(CompressAmount(0) == 0x0 && CompressAmount(1) == 0x1 && CompressAmount(1000000) == 0x7);
+  assert(CompressAmount(100000000) == 0x9 && CompressAmount(5000000000ULL) == 0x32);
+  assert(CompressAmount(2100000000000000ULL) == 0x1406f40);
+  const uint64_t amounts[] = {0, 1, 7, 1000, 123456789, 2100000000000000ULL, UINT64_MAX / 10};
+  for (uint64_t n : amounts)
+    assert(DecompressAmount(CompressAmount(n)) == n);
+  const uint64_t varints[] = {0, 127, 128, 16511, 16512, 1ULL << 40, UINT64_MAX};
+  for (uint64_t n : varints) {
+    unsigned char buf[10];
+    const unsigned char* end = WriteVarInt(buf, n);
+    assert((size_t)(end - buf) == VarIntSize(n));
+    const unsigned char* pos = buf;
+    uint64_t back;
+    bool ok = ReadVarInt(pos, end, back);
+    assert(ok && back == n && pos == end);
+    pos = buf;
+    ok = ReadVarInt(pos, end - 1, back);
+    assert(!ok);
+  }
+  std::cout << "varint: ok" << std::endl;
+
+  // Every template round trips, standard ones as ID and hash
+  std::vector<std::vector<unsigned char>> scripts;
+  scripts.push_back({OP_DUP, OP_HASH160, 20});
+  scripts.back().resize(23, 0x11);
+  scripts.back().insert(scripts.back().end(), {OP_EQUALVERIFY, OP_CHECKSIG});
+  scripts.push_back({OP_HASH160, 20});
+  scripts.back().resize(22, 0x22);
+  scripts.back().push_back(OP_EQUAL);
+  scripts.push_back({OP_0, 20});
+  scripts.back().resize(22, 0x33);
+  scripts.push_back({OP_0, 32});
+  scripts.back().resize(34, 0x44);
+  scripts.push_back(ParseHex("4104678afdb0fe5548271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e5"
+                             "1ec112de5c384df7ba0b8d578a4c702b6bf11d5fac"));
+  scripts.push_back({});
+  for (size_t i = 0; i < scripts.size(); i++) {
+    const Coin coin(1234567 * i, ScriptView(scripts[i].data(), scripts[i].size()), 800000 + i, i % 2);
+    std::vector<unsigned char> bytes(CompressedCoinSize(coin));
+    CompressCoin(coin, bytes.data());
+    assert(i >= 4 || bytes.size() <= 3 + 4 + 1 + 32);
+    Coin back;
+    bool ok = DecompressCoin(bytes.data(), bytes.size(), back);
+    assert(ok && Same(coin, back));
+    ok = DecompressCoin(bytes.data(), bytes.size() - 1, back);
+    assert(!ok || bytes.size() == 0);
+  }
+  std::cout << "compress: ok" << std::endl;
+
+  // The flat table against std::map
+  {
+    OutPointMap<uint64_t> map;
+    std::map<uint64_t, uint64_t> reference;
+    std::mt19937_64 random(1);
+    for (int step = 0; step < 200000; step++) {
+      const uint64_t i = random() % 5000;
+      if (random() % 3) {
+        bool inserted;
+        *map.Insert(Key(i), &inserted) = step;
+        assert(inserted == !reference.count(i));
+        reference[i] = step;
+      } else {
+        const bool erased = map.Erase(Key(i));
+        const bool present = reference.erase(i) != 0;
+        assert(erased == present);
+      }
+      assert(map.Size() == reference.size());
+    }
+    for (uint64_t i = 0; i < 5000; i++) {
+      const uint64_t* value = map.Find(Key(i));
+      assert(value ? reference.count(i) && reference[i] == *value : !reference.count(i));
+    }
+    map.Retain([](const OutPoint& key, uint64_t& value) { return key.n != 3 && value % 2 == 0; });
+    size_t kept = 0;
+    map.ForEach([&](const OutPoint& key, uint64_t& value) {
+      assert(key.n != 3 && value % 2 == 0);
+      kept++;
+    });
+    assert(kept == map.Size() && map.MemoryUsage() == map.Capacity() * (sizeof(OutPointMap<uint64_t>::Slot) + 1));
+    // A table no allocator can give leaves the map as it was
+    const size_t capacity = map.Capacity();
+    bool thrown = false;
+    try {
+      map.Reserve((size_t)1 << 48);
+    } catch (const std::bad_alloc&) {
+      thrown = true;
+    }
+    assert(thrown && map.Capacity() == capacity && map.Size() == kept);
+    map.Clear();
+    assert(map.Empty() && map.Capacity() == 0 && !map.Find(Key(1)));
+  }
+  std::cout << "outpointmap: ok" << std::endl;
+
+  char dir[] = "/tmp/niucoinsXXXXXX";
+  const char* made = mkdtemp(dir);
+  assert(made);
+  const std::string path = std::string(dir) + "/coins.log";
+
+  // The log: batches survive reopening, a torn tail is cut off
+  {
+    CoinsLog log;
+    bool ok = log.Open(path);
+    assert(ok && log.Count() == 0 && log.BestBlock().IsNull());
+    CoinsLogBatch batch;
+    for (uint64_t i = 0; i < 100; i++) {
+      const unsigned char value[3] = {(unsigned char)i, 1, 2};
+      batch.Put(Key(i), value, 1 + i % 3);
+    }
+    batch.SetBestBlock(Key(1000).hash);
+    ok = log.Write(batch);
+    assert(ok && log.Count() == 100 && log.GarbageBytes() > 0);
+    batch.Clear();
+    for (uint64_t i = 0; i < 50; i++)
+      batch.Erase(Key(i));
+    const unsigned char big[300] = {9};
+    batch.Put(Key(99), big, sizeof(big));
+    batch.SetBestBlock(Key(1001).hash);
+    ok = log.Write(batch);
+    assert(ok && log.Count() == 50);
+    const off_t good = FileSize(path);
+    batch.Clear();
+    batch.Erase(Key(60));
+    batch.SetBestBlock(Key(1002).hash);
+    ok = log.Write(batch);
+    assert(ok && log.Count() == 49);
+    log.Close();
+    int ret = truncate(path.c_str(), FileSize(path) - 1);
+    assert(ret == 0);
+
+    ok = log.Open(path);
+    assert(ok && log.Count() == 50 && log.BestBlock() == Key(1001).hash);
+    assert(FileSize(path) == good);
+    std::vector<unsigned char> value;
+    ok = log.Get(Key(10), value);
+    assert(!ok);
+    ok = log.Get(Key(60), value);
+    assert(ok && value.size() == 1 && value[0] == 60);
+    ok = log.Get(Key(99), value);
+    assert(ok && value.size() == 300 && value[0] == 9);
+    const uint64_t garbage = log.GarbageBytes();
+    ok = log.Compact();
+    assert(ok && log.GarbageBytes() < garbage && FileSize(path) < good);
+    assert(log.Count() == 50 && log.BestBlock() == Key(1001).hash);
+    ok = log.Get(Key(61), value);
+    assert(ok && value.size() == 1 + 61 % 3 && value[0] == 61);
+    log.Close();
+
+    // A file that is not a coins log is refused
+    const std::string other = std::string(dir) + "/other";
+    FILE* f = fopen(other.c_str(), "w");
+    fputs("not a coins log", f);
+    fclose(f);
+    ok = log.Open(other);
+    assert(!ok);
+    unlink(other.c_str());
+
+    // Only the last batch may be torn: damage before it fails Open() and
+    // leaves the file alone
+    const std::string damaged = std::string(dir) + "/damaged.log";
+    ok = log.Open(damaged);
+    assert(ok);
+    off_t ends[3];
+    for (int b = 0; b < 3; b++) {
+      batch.Clear();
+      for (uint64_t i = 0; i < 10; i++) {
+        const unsigned char value[2] = {(unsigned char)b, (unsigned char)i};
+        batch.Put(Key(100 * b + i), value, sizeof(value));
+      }
+      batch.SetBestBlock(Key(b).hash);
+      ok = log.Write(batch);
+      assert(ok);
+      ends[b] = FileSize(damaged);
+    }
+    log.Close();
+    auto flip = [&](off_t at) {
+      FILE* d = fopen(damaged.c_str(), "r+");
+      assert(d);
+      int ret = fseek(d, at, SEEK_SET);
+      assert(ret == 0);
+      const int c = fgetc(d);
+      ret = fseek(d, at, SEEK_SET);
+      assert(ret == 0);
+      ret = fputc(c ^ 0x40, d);
+      assert(ret != EOF);
+      fclose(d);
+    };
+    // the magic, a record, the checksum and the high bytes of a size
+    for (off_t at : {ends[0], ends[0] + 60, ends[1] - 1, ends[0] + 12}) {
+      flip(at);
+      ok = log.Open(damaged);
+      assert(!ok && FileSize(damaged) == ends[2]);
+      flip(at);
+    }
+    ok = log.Open(damaged);
+    assert(ok && log.Count() == 30 && log.BestBlock() == Key(2).hash);
+    log.Close();
+    flip(ends[1] + 60);
+    ok = log.Open(damaged);
+    assert(ok && log.Count() == 20 && log.BestBlock() == Key(1).hash);
+    assert(FileSize(damaged) == ends[1]);
+
+    // Compacting a set larger than one compaction batch
+    batch.Clear();
+    const unsigned char wide[40] = {7};
+    for (uint64_t i = 0; i < 30000; i++)
+      batch.Put(Key(1000 + i), wide, sizeof(wide));
+    batch.SetBestBlock(Key(3).hash);
+    ok = log.Write(batch);
+    assert(ok && batch.SizeBytes() > (1 << 21));
+    // Nothing left but the headers and checksums of a few batches
+    ok = log.Compact();
+    assert(ok && log.Count() == 30020 && log.GarbageBytes() > 2 * 56 && log.GarbageBytes() < 1000);
+    log.Close();
+    ok = log.Open(damaged);
+    assert(ok && log.Count() == 30020 && log.BestBlock() == Key(3).hash);
+    ok = log.Get(Key(30999), value);
+    assert(ok && value.size() == 40 && value[0] == 7);
+    ok = log.Get(Key(105), value);
+    assert(ok && value.size() == 2 && value[0] == 1 && value[1] == 5);
+
+    // A failed read is an error, not a missing coin
+    ret = truncate(damaged.c_str(), ends[0]);
+    assert(ret == 0);
+    bool threw = false;
+    try {
+      log.Get(Key(30999), value);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    ok = log.Get(Key(10), value);
+    assert(threw && !ok);
+    CoinsCache unreadable(log);
+    Coin coin;
+    threw = false;
+    try {
+      unreadable.GetCoin(Key(30999), coin);
+    } catch (const std::runtime_error&) {
+      threw = true;
+    }
+    assert(threw);
+    log.Close();
+    unlink(damaged.c_str());
+  }
+  unlink(path.c_str());
+  std::cout << "log: ok" << std::endl;
+
+  // The cache: fresh coins never reach the log, spent ones are erased
+  {
+    CoinsLog log;
+    bool ok = log.Open(path);
+    assert(ok);
+    CoinsCache cache(log);
+    for (uint64_t i = 0; i < 1000; i++)
+      cache.AddCoin(Key(i), P2pkh(i + 1, 1), false);
+    for (uint64_t i = 0; i < 100; i++) {
+      ok = cache.SpendCoin(Key(i));
+      assert(ok);
+    }
+    ok = cache.SpendCoin(Key(0));
+    assert(!ok && cache.Stats().fresh_spends == 100);
+    bool threw = false;
+    try {
+      cache.AddCoin(Key(500), P2pkh(1, 1), false);
+    } catch (const std::logic_error&) {
+      threw = true;
+    }
+    assert(threw);
+    cache.AddCoin(Key(500), P2pkh(7, 2), true);
+    cache.SetBestBlock(Key(2000).hash);
+    ok = cache.Flush();
+    assert(ok && log.Count() == 900 && cache.CacheSize() == 0);
+    assert(cache.Stats().flushed_puts == 900 && cache.Stats().flushed_erases == 0);
+
+    // Reads come back from the log, spends of those are written as erases
+    Coin coin;
+    ok = cache.GetCoin(Key(500), coin);
+    assert(ok && Same(coin, P2pkh(7, 2)) && cache.Stats().misses == 1);
+    ok = cache.GetCoin(Key(500), coin);
+    assert(ok && cache.Stats().hits >= 1);
+    ok = cache.SpendCoin(Key(501), &coin);
+    assert(ok && Same(coin, P2pkh(502, 1)));
+    assert(!cache.HaveCoin(Key(501)) && !cache.HaveCoin(Key(5)));
+    cache.AddCoin(Key(501), P2pkh(3, 3), false);
+    ok = cache.SpendCoin(Key(501));
+    assert(ok && cache.Stats().fresh_spends == 100);
+    const std::vector<unsigned char> op_return = {OP_RETURN, 1, 1};
+    cache.AddCoin(Key(5000), Coin(0, ScriptView(op_return.data(), op_return.size()), 3, false), false);
+    assert(!cache.HaveCoin(Key(5000)));
+    ok = cache.Sync();
+    assert(ok && log.Count() == 899 && cache.CacheSize() == 1);
+    assert(cache.Stats().flushed_erases == 1);
+    ok = cache.Flush();
+    assert(ok && cache.Stats().flushes == 3);
+
+    // Discard drops changes, MaybeFlush keeps to the budget
+    cache.AddCoin(Key(6000), P2pkh(1, 4), false);
+    cache.Discard();
+    assert(!cache.HaveCoin(Key(6000)) && cache.GetBestBlock() == Key(2000).hash);
+    cache.SetMemoryBudget(64 * 1024);
+    size_t flushes = cache.Stats().flushes;
+    for (uint64_t i = 10000; i < 20000; i++) {
+      cache.AddCoin(Key(i), P2pkh(i, 5), false);
+      ok = cache.MaybeFlush();
+      assert(ok);
+      assert(cache.DynamicMemoryUsage() <= 2 * cache.MemoryBudget());
+    }
+    assert(cache.Stats().flushes > flushes + 5);
+    ok = cache.Flush();
+    assert(ok && log.Count() == 899 + 10000);
+  }
+  {
+    // Everything is still there after reopening
+    CoinsLog log;
+    bool ok = log.Open(path);
+    assert(ok && log.Count() == 10899 && log.BestBlock() == Key(2000).hash);
+    CoinsCache cache(log);
+    Coin coin;
+    ok = cache.GetCoin(Key(15000), coin);
+    assert(ok && Same(coin, P2pkh(15000, 5)));
+    ok = cache.GetCoin(Key(501), coin);
+    assert(!ok);
+    ok = cache.GetCoin(Key(999), coin);
+    assert(ok);
+  }
+  unlink(path.c_str());
+  std::cout << "cache: ok" << std::endl;
+
+  // Connecting the genesis block adds its P2PK coin, out of line
+  {
+    const std::vector<unsigned char> genesis = ParseHex(
+        "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c3e67768f617fc81bc3"
+        "888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c0101000000010000000000000000000000000000000000000000000000000000"
+        "000000000000ffffffff4d04ffff001d0104455468652054696d65732030332f4a616e2f32303039204368616e63656c6c6f72206f6e2062"
+        "72696e6b206f66207365636f6e64206261696c6f757420666f722062616e6b73ffffffff0100f2052a01000000434104678afdb0fe554827"
+        "1967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5f"
+        "ac00000000");
+    BlockView block;
+    bool ok = block.Parse(genesis.data(), genesis.size());
+    assert(ok);
+    CoinsLog log;
+    ok = log.Open(path);
+    assert(ok);
+    CoinsCache cache(log);
+    ok = ConnectBlock(block, cache, 0);
+    assert(ok && cache.GetBestBlock() == block.hash());
+    const OutPoint coinbase(block.transactions()[0].hash(), 0);
+    Coin coin;
+    ok = cache.GetCoin(coinbase, coin);
+    assert(ok && coin.amount == 5000000000ULL && coin.coinbase && coin.height == 0);
+    assert(coin.script.size() == 67 && cache.DynamicMemoryUsage() > cache.CacheSize() * 81);
+    // Spending the coinbase twice fails
+    ok = cache.SpendCoin(coinbase);
+    assert(ok);
+    ok = cache.SpendCoin(coinbase);
+    assert(!ok);
+  }
+  unlink(path.c_str());
+  rmdir(dir);
+  std::cout << "connect: ok" << std::endl;
+}
@@ -0,0 +1,8 @@
+#!/bin/sh
+
+g++ -std=c++11 -O2 -DENABLE_SSE41 -DENABLE_AVX2 -DENABLE_AVX512 -DENABLE_SHANI -c sha256.cpp
+g++ -std=c++11 -O2 -DENABLE_SSE41 -msse4.1 -c sha256_sse41.cpp
+g++ -std=c++11 -O2 -DENABLE_AVX2 -mavx -mavx2 -c sha256_avx2.cpp
+g++ -std=c++11 -O2 -DENABLE_AVX512 -mavx512f -c sha256_avx512.cpp
+g++ -std=c++11 -O2 -DENABLE_SHANI -msse4 -msha -c sha256_shani.cpp
+g++ -std=c++11 -O2 test.cpp sha256.o sha256_sse41.o sha256_avx2.o sha256_avx512.o sha256_shani.o -I ./
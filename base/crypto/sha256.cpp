@@ -0,0 +1,314 @@
+// Copyright (c) 2014-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sha256.h"
+#include "sha256_internal.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#ifdef ENABLE_SSE41
+namespace sha256d64_sse41 {
+void Transform_4way(unsigned char* out, const unsigned char* in);
+}
+#endif
+
+#ifdef ENABLE_AVX2
+namespace sha256d64_avx2 {
+void Transform_8way(unsigned char* out, const unsigned char* in);
+}
+#endif
+
+#ifdef ENABLE_AVX512
+namespace sha256d64_avx512 {
+void Transform_16way(unsigned char* out, const unsigned char* in);
+}
+#endif
+
+#ifdef ENABLE_SHANI
+namespace sha256_shani {
+void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
+}
+namespace sha256d64_shani {
+void Transform_2way(unsigned char* out, const unsigned char* in);
+}
+#endif
+
+using sha256_internal::ReadBE32;
+using sha256_internal::WriteBE32;
+
+// Internal implementation code.
+namespace
+{
+/// Internal SHA-256 implementation.
+namespace sha256
+{
+uint32_t inline Ch(uint32_t x, uint32_t y, uint32_t z) { return z ^ (x & (y ^ z)); }
+uint32_t inline Maj(uint32_t x, uint32_t y, uint32_t z) { return (x & y) | (z & (x | y)); }
+uint32_t inline Sigma0(uint32_t x) { return (x >> 2 | x << 30) ^ (x >> 13 | x << 19) ^ (x >> 22 | x << 10); }
+uint32_t inline Sigma1(uint32_t x) { return (x >> 6 | x << 26) ^ (x >> 11 | x << 21) ^ (x >> 25 | x << 7); }
+uint32_t inline sigma0(uint32_t x) { return (x >> 7 | x << 25) ^ (x >> 18 | x << 14) ^ (x >> 3); }
+uint32_t inline sigma1(uint32_t x) { return (x >> 17 | x << 15) ^ (x >> 19 | x << 13) ^ (x >> 10); }
+
+/** One round of SHA-256. */
+void inline Round(uint32_t a, uint32_t b, uint32_t c, uint32_t& d, uint32_t e, uint32_t f, uint32_t g, uint32_t& h, uint32_t k)
+{
+    uint32_t t1 = h + Sigma1(e) + Ch(e, f, g) + k;
+    uint32_t t2 = Sigma0(a) + Maj(a, b, c);
+    d += t1;
+    h = t1 + t2;
+}
+
+/** Compress one block, with its K + W words supplied by kw(i) */
+template<typename KW>
+void inline Compress(uint32_t* s, KW kw)
+{
+    uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i += 8) {
+        Round(a, b, c, d, e, f, g, h, kw(i));
+        Round(h, a, b, c, d, e, f, g, kw(i + 1));
+        Round(g, h, a, b, c, d, e, f, kw(i + 2));
+        Round(f, g, h, a, b, c, d, e, kw(i + 3));
+        Round(e, f, g, h, a, b, c, d, kw(i + 4));
+        Round(d, e, f, g, h, a, b, c, kw(i + 5));
+        Round(c, d, e, f, g, h, a, b, kw(i + 6));
+        Round(b, c, d, e, f, g, h, a, kw(i + 7));
+    }
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+/** Compress the block in w, extending its schedule in place */
+void inline CompressWords(uint32_t* s, uint32_t* w)
+{
+    Compress(s, [w](int i) {
+        if (i >= 16)
+            w[i & 15] += sigma0(w[(i + 1) & 15]) + w[(i + 9) & 15] + sigma1(w[(i + 14) & 15]);
+        return sha256_internal::K[i] + w[i & 15];
+    });
+}
+
+/** Perform a number of SHA-256 transformations, processing 64-byte chunks. */
+void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks)
+{
+    while (blocks--) {
+        uint32_t w[16];
+        for (int i = 0; i < 16; i++)
+            w[i] = ReadBE32(chunk + 4 * i);
+        CompressWords(s, w);
+        chunk += 64;
+    }
+}
+
+void TransformD64(unsigned char* out, const unsigned char* in)
+{
+    uint32_t s[8], w[16];
+    memcpy(s, sha256_internal::INIT, sizeof(s));
+    for (int i = 0; i < 16; i++)
+        w[i] = ReadBE32(in + 4 * i);
+    CompressWords(s, w);
+    Compress(s, [](int i) { return sha256_internal::PAD64_KW[i]; });
+
+    // Second hash: the 32 byte digest, then padding for 256 bits
+    memcpy(w, s, sizeof(s));
+    w[8] = 0x80000000;
+    memset(w + 9, 0, 6 * sizeof(uint32_t));
+    w[15] = 256;
+    memcpy(s, sha256_internal::INIT, sizeof(s));
+    CompressWords(s, w);
+
+    for (int i = 0; i < 8; i++)
+        WriteBE32(out + 4 * i, s[i]);
+}
+
+} // namespace sha256
+
+typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
+typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+
+TransformType Transform = sha256::Transform;
+TransformD64Type TransformD64 = sha256::TransformD64;
+TransformD64Type TransformD64_2way = nullptr;
+TransformD64Type TransformD64_4way = nullptr;
+TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
+
+#if defined(__x86_64__) || defined(__i386__)
+/** Register state enabled by the OS, from XCR0 */
+uint64_t XGetBV()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return a | (uint64_t(d) << 32);
+}
+#endif
+
+// Pick the implementation before main() runs; callers may narrow it later
+const std::string g_autodetected = SHA256AutoDetect();
+
+} // namespace
+
+std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Transform = sha256::Transform;
+    TransformD64 = sha256::TransformD64;
+    TransformD64_2way = nullptr;
+    TransformD64_4way = nullptr;
+    TransformD64_8way = nullptr;
+    TransformD64_16way = nullptr;
+
+#if defined(__x86_64__) || defined(__i386__)
+    bool have_sse41 = false, have_avx2 = false, have_avx512 = false, have_shani = false;
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        have_sse41 = (ecx >> 19) & 1;
+        const bool have_xsave = (ecx >> 27) & 1;
+        const uint64_t xcr0 = have_xsave ? XGetBV() : 0;
+        // The OS must save the YMM (and for AVX-512 also the ZMM) registers
+        const bool avx_enabled = (xcr0 & 0x6) == 0x6;
+        const bool avx512_enabled = (xcr0 & 0xe6) == 0xe6;
+        if (__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            have_avx2 = avx_enabled && ((ebx >> 5) & 1);
+            have_avx512 = avx512_enabled && ((ebx >> 16) & 1);
+            have_shani = (ebx >> 29) & 1;
+        }
+    }
+    (void)have_sse41;
+    (void)have_avx2;
+    (void)have_avx512;
+    (void)have_shani;
+
+#ifdef ENABLE_SHANI
+    if (have_shani && have_sse41 && (use_implementation & sha256_implementation::USE_SHANI)) {
+        Transform = sha256_shani::Transform;
+        TransformD64_2way = sha256d64_shani::Transform_2way;
+        ret = "shani(1way,2way)";
+    }
+#endif
+#ifdef ENABLE_SSE41
+    if (have_sse41 && (use_implementation & sha256_implementation::USE_SSE4)) {
+        TransformD64_4way = sha256d64_sse41::Transform_4way;
+        ret += ",sse41(4way)";
+    }
+#endif
+#ifdef ENABLE_AVX2
+    if (have_avx2 && (use_implementation & sha256_implementation::USE_AVX2)) {
+        TransformD64_8way = sha256d64_avx2::Transform_8way;
+        ret += ",avx2(8way)";
+    }
+#endif
+#ifdef ENABLE_AVX512
+    if (have_avx512 && (use_implementation & sha256_implementation::USE_AVX512)) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
+#else
+    (void)use_implementation;
+#endif
+    return ret;
+}
+
+////// SHA-256
+
+CSHA256::CSHA256() : bytes(0)
+{
+    memcpy(s, sha256_internal::INIT, sizeof(s));
+}
+
+CSHA256& CSHA256::Write(const unsigned char* data, size_t len)
+{
+    const unsigned char* end = data + len;
+    size_t bufsize = bytes % 64;
+    if (bufsize && bufsize + len >= 64) {
+        // Fill the buffer, and process it.
+        memcpy(buf + bufsize, data, 64 - bufsize);
+        bytes += 64 - bufsize;
+        data += 64 - bufsize;
+        Transform(s, buf, 1);
+        bufsize = 0;
+    }
+    if (end - data >= 64) {
+        size_t blocks = (end - data) / 64;
+        Transform(s, data, blocks);
+        data += 64 * blocks;
+        bytes += 64 * blocks;
+    }
+    if (end > data) {
+        // Fill the buffer with what remains.
+        memcpy(buf + bufsize, data, end - data);
+        bytes += end - data;
+    }
+    return *this;
+}
+
+void CSHA256::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    static const unsigned char pad[64] = {0x80};
+    unsigned char sizedesc[8];
+    const uint64_t bits = bytes << 3;
+    WriteBE32(sizedesc, uint32_t(bits >> 32));
+    WriteBE32(sizedesc + 4, uint32_t(bits));
+    Write(pad, 1 + ((119 - (bytes % 64)) % 64));
+    Write(sizedesc, 8);
+    for (int i = 0; i < 8; i++)
+        WriteBE32(hash + 4 * i, s[i]);
+}
+
+CSHA256& CSHA256::Reset()
+{
+    bytes = 0;
+    memcpy(s, sha256_internal::INIT, sizeof(s));
+    return *this;
+}
+
+void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    // Widest first; every kernel reads its inputs before writing, and its
+    // outputs never reach past the inputs still to come, so out == in works
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
+    if (TransformD64_8way) {
+        while (blocks >= 8) {
+            TransformD64_8way(out, in);
+            out += 256;
+            in += 512;
+            blocks -= 8;
+        }
+    }
+    if (TransformD64_4way) {
+        while (blocks >= 4) {
+            TransformD64_4way(out, in);
+            out += 128;
+            in += 256;
+            blocks -= 4;
+        }
+    }
+    if (TransformD64_2way) {
+        while (blocks >= 2) {
+            TransformD64_2way(out, in);
+            out += 64;
+            in += 128;
+            blocks -= 2;
+        }
+    }
+    while (blocks) {
+        TransformD64(out, in);
+        out += 32;
+        in += 64;
+        --blocks;
+    }
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2014-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_CRYPTO_SHA256_H
+#define NIUBLOCK_CRYPTO_SHA256_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+/** A hasher class for SHA-256. */
+class CSHA256
+{
+private:
+    uint32_t s[8];
+    unsigned char buf[64];
+    uint64_t bytes;
+
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    CSHA256();
+    CSHA256& Write(const unsigned char* data, size_t len);
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+    CSHA256& Reset();
+};
+
+namespace sha256_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE4 = 1 << 0,      //!< 4-way SSE4.1
+    USE_AVX2 = 1 << 1,      //!< 8-way AVX2
+    USE_AVX512 = 1 << 2,    //!< 16-way AVX-512F
+    USE_SHANI = 1 << 3,     //!< SHA-NI, single block and 2-way
+    USE_ALL = USE_SSE4 | USE_AVX2 | USE_AVX512 | USE_SHANI,
+};
+}
+
+/** Autodetect the best available SHA256 implementation, restricted to
+ *  use_implementation.  Returns the name of the implementation.
+ *
+ *  Runs once on its own when the program starts; call it again only to
+ *  restrict the choice (tests, benchmarks), and not while other threads
+ *  are hashing. */
+std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implementation = sha256_implementation::USE_ALL);
+
+/** Compute multiple double-SHA256's of 64-byte blobs.
+ *  output:  pointer to a blocks*32 byte output buffer
+ *  input:   pointer to a blocks*64 byte input buffer
+ *  blocks:  the number of hashes to compute.
+ *  output may be the same buffer as input: hash i is written to 32*i only
+ *  after input 64*i has been read.
+ */
+void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
+
+#endif // NIUBLOCK_CRYPTO_SHA256_H
@@ -0,0 +1,57 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 8-way double SHA256 of 64 byte messages, built with -mavx -mavx2
+
+#ifdef ENABLE_AVX2
+
+#include "sha256_internal.h"
+
+#include <immintrin.h>
+
+namespace sha256d64_avx2 {
+namespace {
+
+using sha256_internal::ReadBE32;
+using sha256_internal::WriteBE32;
+
+struct Ops
+{
+    typedef __m256i V;
+
+    static V Set1(uint32_t x) { return _mm256_set1_epi32(x); }
+    static V Add(V x, V y) { return _mm256_add_epi32(x, y); }
+    static V Xor(V x, V y) { return _mm256_xor_si256(x, y); }
+    static V Shr(V x, int n) { return _mm256_srli_epi32(x, n); }
+    static V Ror(V x, int n) { return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n)); }
+    static V Ch(V x, V y, V z) { return _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z))); }
+    static V Maj(V x, V y, V z) { return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y))); }
+
+    static V Load(const unsigned char* in, int word)
+    {
+        in += 4 * word;
+        return _mm256_set_epi32(ReadBE32(in + 448), ReadBE32(in + 384), ReadBE32(in + 320), ReadBE32(in + 256),
+                                ReadBE32(in + 192), ReadBE32(in + 128), ReadBE32(in + 64), ReadBE32(in));
+    }
+
+    static void Store(unsigned char* out, int word, V v)
+    {
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<V*>(lanes), v);
+        out += 4 * word;
+        for (int j = 0; j < 8; j++)
+            WriteBE32(out + 32 * j, lanes[j]);
+    }
+};
+
+} // namespace
+
+void Transform_8way(unsigned char* out, const unsigned char* in)
+{
+    sha256_internal::MultiWay<Ops>::TransformD64(out, in);
+}
+
+} // namespace sha256d64_avx2
+
+#endif
@@ -0,0 +1,65 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 16-way double SHA256 of 64 byte messages, built with -mavx512f
+
+#ifdef ENABLE_AVX512
+
+#include "sha256_internal.h"
+
+#include <immintrin.h>
+
+// GCC's masked intrinsics pass _mm512_undefined_epi32() as the unused
+// source, which older releases report as uninitialised
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+namespace sha256d64_avx512 {
+namespace {
+
+using sha256_internal::ReadBE32;
+using sha256_internal::WriteBE32;
+
+struct Ops
+{
+    typedef __m512i V;
+
+    static V Set1(uint32_t x) { return _mm512_set1_epi32(x); }
+    static V Add(V x, V y) { return _mm512_add_epi32(x, y); }
+    static V Xor(V x, V y) { return _mm512_xor_si512(x, y); }
+    static V Shr(V x, int n) { return _mm512_srli_epi32(x, n); }
+    static V Ror(V x, int n) { return _mm512_rorv_epi32(x, _mm512_set1_epi32(n)); }
+    // One vpternlogd each: x ? y : z, and the majority of x, y, z
+    static V Ch(V x, V y, V z) { return _mm512_ternarylogic_epi32(x, y, z, 0xca); }
+    static V Maj(V x, V y, V z) { return _mm512_ternarylogic_epi32(x, y, z, 0xe8); }
+
+    static V Load(const unsigned char* in, int word)
+    {
+        in += 4 * word;
+        return _mm512_set_epi32(ReadBE32(in + 960), ReadBE32(in + 896), ReadBE32(in + 832), ReadBE32(in + 768),
+                                ReadBE32(in + 704), ReadBE32(in + 640), ReadBE32(in + 576), ReadBE32(in + 512),
+                                ReadBE32(in + 448), ReadBE32(in + 384), ReadBE32(in + 320), ReadBE32(in + 256),
+                                ReadBE32(in + 192), ReadBE32(in + 128), ReadBE32(in + 64), ReadBE32(in));
+    }
+
+    static void Store(unsigned char* out, int word, V v)
+    {
+        alignas(64) uint32_t lanes[16];
+        _mm512_store_si512(lanes, v);
+        out += 4 * word;
+        for (int j = 0; j < 16; j++)
+            WriteBE32(out + 32 * j, lanes[j]);
+    }
+};
+
+} // namespace
+
+void Transform_16way(unsigned char* out, const unsigned char* in)
+{
+    sha256_internal::MultiWay<Ops>::TransformD64(out, in);
+}
+
+} // namespace sha256d64_avx512
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Shared by the SHA256 implementations; not part of the interface.
+ *
+ * The N-way SIMD kernels all run the same algorithm on a different vector
+ * type, so the algorithm is written once here as MultiWay<Ops>.  Each
+ * kernel's translation unit is compiled with its own instruction set flags
+ * and instantiates MultiWay with an Ops struct of its own, so no code built
+ * for one instruction set can leak into a caller compiled for another.
+ * For the same reason everything else here has internal linkage.
+ */
+#ifndef NIUBLOCK_CRYPTO_SHA256_INTERNAL_H
+#define NIUBLOCK_CRYPTO_SHA256_INTERNAL_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace sha256_internal {
+
+static inline uint32_t ReadBE32(const unsigned char* ptr)
+{
+    uint32_t x;
+    memcpy(&x, ptr, 4);
+    return __builtin_bswap32(x);
+}
+
+static inline void WriteBE32(unsigned char* ptr, uint32_t x)
+{
+    const uint32_t v = __builtin_bswap32(x);
+    memcpy(ptr, &v, 4);
+}
+
+static const uint32_t INIT[8] = {
+    0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul,
+    0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul,
+};
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/** K[i] + W[i] of the padding block that follows a 64 byte message; the
+ *  block is the same for every message, so its schedule is precomputed */
+static const uint32_t PAD64_KW[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76,
+};
+
+/**
+ * Double SHA256 of Ops::LANES independent 64 byte messages, one per vector
+ * lane.  Ops provides the vector type V and:
+ *
+ *   V Set1(uint32_t), Add(V, V), Xor(V, V), Shr(V, int), Ror(V, int),
+ *   Ch(V, V, V), Maj(V, V, V),
+ *   V Load(const unsigned char* in, int word)  lane j = BE word of in + 64*j
+ *   void Store(unsigned char* out, int word, V) lane j to BE word of out + 32*j
+ */
+template<typename Ops>
+struct MultiWay
+{
+    typedef typename Ops::V V;
+
+    static V Sigma0(V x) { return Ops::Xor(Ops::Xor(Ops::Ror(x, 2), Ops::Ror(x, 13)), Ops::Ror(x, 22)); }
+    static V Sigma1(V x) { return Ops::Xor(Ops::Xor(Ops::Ror(x, 6), Ops::Ror(x, 11)), Ops::Ror(x, 25)); }
+    static V sigma0(V x) { return Ops::Xor(Ops::Xor(Ops::Ror(x, 7), Ops::Ror(x, 18)), Ops::Shr(x, 3)); }
+    static V sigma1(V x) { return Ops::Xor(Ops::Xor(Ops::Ror(x, 17), Ops::Ror(x, 19)), Ops::Shr(x, 10)); }
+
+    /** One round; d and h receive the new e and a */
+    static void Round(V a, V b, V c, V& d, V e, V f, V g, V& h, V kw)
+    {
+        const V t1 = Ops::Add(Ops::Add(h, Sigma1(e)), Ops::Add(Ops::Ch(e, f, g), kw));
+        const V t2 = Ops::Add(Sigma0(a), Ops::Maj(a, b, c));
+        d = Ops::Add(d, t1);
+        h = Ops::Add(t1, t2);
+    }
+
+    /** K[i] + W[i], extending the schedule in w (a 16 word window) */
+    static V KW(V* w, int i)
+    {
+        if (i >= 16) {
+            w[i & 15] = Ops::Add(Ops::Add(w[i & 15], sigma0(w[(i + 1) & 15])),
+                                 Ops::Add(w[(i + 9) & 15], sigma1(w[(i + 14) & 15])));
+        }
+        return Ops::Add(Ops::Set1(K[i]), w[i & 15]);
+    }
+
+    /** Compress one block held in w into s */
+    static void Transform(V* s, V* w)
+    {
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        for (int i = 0; i < 64; i += 8) {
+            Round(a, b, c, d, e, f, g, h, KW(w, i));
+            Round(h, a, b, c, d, e, f, g, KW(w, i + 1));
+            Round(g, h, a, b, c, d, e, f, KW(w, i + 2));
+            Round(f, g, h, a, b, c, d, e, KW(w, i + 3));
+            Round(e, f, g, h, a, b, c, d, KW(w, i + 4));
+            Round(d, e, f, g, h, a, b, c, KW(w, i + 5));
+            Round(c, d, e, f, g, h, a, b, KW(w, i + 6));
+            Round(b, c, d, e, f, g, h, a, KW(w, i + 7));
+        }
+        s[0] = Ops::Add(s[0], a); s[1] = Ops::Add(s[1], b);
+        s[2] = Ops::Add(s[2], c); s[3] = Ops::Add(s[3], d);
+        s[4] = Ops::Add(s[4], e); s[5] = Ops::Add(s[5], f);
+        s[6] = Ops::Add(s[6], g); s[7] = Ops::Add(s[7], h);
+    }
+
+    /** Compress the constant padding block into s */
+    static void TransformPadding(V* s)
+    {
+        V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        for (int i = 0; i < 64; i += 8) {
+            Round(a, b, c, d, e, f, g, h, Ops::Set1(PAD64_KW[i]));
+            Round(h, a, b, c, d, e, f, g, Ops::Set1(PAD64_KW[i + 1]));
+            Round(g, h, a, b, c, d, e, f, Ops::Set1(PAD64_KW[i + 2]));
+            Round(f, g, h, a, b, c, d, e, Ops::Set1(PAD64_KW[i + 3]));
+            Round(e, f, g, h, a, b, c, d, Ops::Set1(PAD64_KW[i + 4]));
+            Round(d, e, f, g, h, a, b, c, Ops::Set1(PAD64_KW[i + 5]));
+            Round(c, d, e, f, g, h, a, b, Ops::Set1(PAD64_KW[i + 6]));
+            Round(b, c, d, e, f, g, h, a, Ops::Set1(PAD64_KW[i + 7]));
+        }
+        s[0] = Ops::Add(s[0], a); s[1] = Ops::Add(s[1], b);
+        s[2] = Ops::Add(s[2], c); s[3] = Ops::Add(s[3], d);
+        s[4] = Ops::Add(s[4], e); s[5] = Ops::Add(s[5], f);
+        s[6] = Ops::Add(s[6], g); s[7] = Ops::Add(s[7], h);
+    }
+
+    static void TransformD64(unsigned char* out, const unsigned char* in)
+    {
+        V s[8], w[16];
+        for (int i = 0; i < 8; i++)
+            s[i] = Ops::Set1(INIT[i]);
+        for (int i = 0; i < 16; i++)
+            w[i] = Ops::Load(in, i);
+        Transform(s, w);
+        TransformPadding(s);
+
+        // Second hash: the 32 byte digest, then padding for 256 bits
+        for (int i = 0; i < 8; i++) {
+            w[i] = s[i];
+            s[i] = Ops::Set1(INIT[i]);
+        }
+        w[8] = Ops::Set1(0x80000000);
+        for (int i = 9; i < 15; i++)
+            w[i] = Ops::Set1(0);
+        w[15] = Ops::Set1(256);
+        Transform(s, w);
+
+        for (int i = 0; i < 8; i++)
+            Ops::Store(out, i, s[i]);
+    }
+};
+
+} // namespace sha256_internal
+
+#endif // NIUBLOCK_CRYPTO_SHA256_INTERNAL_H
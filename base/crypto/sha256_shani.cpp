@@ -0,0 +1,175 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// SHA256 with the x86 SHA extensions, built with -msse4 -msha.
+//
+// The SHA instructions keep the state as two vectors, ABEF and CDGH
+// (highest lane first).  A block is sixteen quad rounds; the message
+// schedule for quad round i is derived from the four before it.
+
+#ifdef ENABLE_SHANI
+
+#include "sha256_internal.h"
+
+#include <immintrin.h>
+
+namespace {
+
+using sha256_internal::K;
+using sha256_internal::PAD64_KW;
+
+/** Byte swap each 32 bit lane */
+inline __m128i Swap(__m128i v)
+{
+    return _mm_shuffle_epi8(v, _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL));
+}
+
+inline __m128i Load(const uint32_t* k)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(k));
+}
+
+/** Four rounds with the message plus constants in kw */
+inline void QuadRound(__m128i& abef, __m128i& cdgh, __m128i kw)
+{
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, kw);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(kw, 0x0e));
+}
+
+/** Message words of quad round i >= 4, in m[i & 3] */
+inline __m128i Schedule(__m128i* m, int i)
+{
+    __m128i& w = m[i & 3];
+    w = _mm_add_epi32(_mm_sha256msg1_epu32(w, m[(i + 1) & 3]), _mm_alignr_epi8(m[(i + 3) & 3], m[(i + 2) & 3], 4));
+    w = _mm_sha256msg2_epu32(w, m[(i + 3) & 3]);
+    return w;
+}
+
+/** a b c d / e f g h in lane order to ABEF / CDGH */
+inline void ToShani(__m128i abcd, __m128i efgh, __m128i& abef, __m128i& cdgh)
+{
+    const __m128i badc = _mm_shuffle_epi32(abcd, 0xb1);
+    const __m128i hgfe = _mm_shuffle_epi32(efgh, 0x1b);
+    abef = _mm_alignr_epi8(badc, hgfe, 8);
+    cdgh = _mm_blend_epi16(hgfe, badc, 0xf0);
+}
+
+/** ABEF / CDGH to a b c d / e f g h in lane order */
+inline void FromShani(__m128i abef, __m128i cdgh, __m128i& abcd, __m128i& efgh)
+{
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    abcd = _mm_blend_epi16(feba, dchg, 0xf0);
+    efgh = _mm_alignr_epi8(dchg, feba, 8);
+}
+
+/** Two independent compressions, interleaved so that one's rounds run
+ *  while the other's wait for their inputs */
+inline void Transform2(__m128i& abef0, __m128i& cdgh0, __m128i* m0,
+                       __m128i& abef1, __m128i& cdgh1, __m128i* m1)
+{
+    const __m128i save_abef0 = abef0, save_cdgh0 = cdgh0;
+    const __m128i save_abef1 = abef1, save_cdgh1 = cdgh1;
+    for (int i = 0; i < 16; i++) {
+        const __m128i k = Load(K + 4 * i);
+        const __m128i w0 = i < 4 ? m0[i] : Schedule(m0, i);
+        const __m128i w1 = i < 4 ? m1[i] : Schedule(m1, i);
+        QuadRound(abef0, cdgh0, _mm_add_epi32(w0, k));
+        QuadRound(abef1, cdgh1, _mm_add_epi32(w1, k));
+    }
+    abef0 = _mm_add_epi32(abef0, save_abef0);
+    cdgh0 = _mm_add_epi32(cdgh0, save_cdgh0);
+    abef1 = _mm_add_epi32(abef1, save_abef1);
+    cdgh1 = _mm_add_epi32(cdgh1, save_cdgh1);
+}
+
+inline void TransformPadding2(__m128i& abef0, __m128i& cdgh0, __m128i& abef1, __m128i& cdgh1)
+{
+    const __m128i save_abef0 = abef0, save_cdgh0 = cdgh0;
+    const __m128i save_abef1 = abef1, save_cdgh1 = cdgh1;
+    for (int i = 0; i < 16; i++) {
+        const __m128i kw = Load(PAD64_KW + 4 * i);
+        QuadRound(abef0, cdgh0, kw);
+        QuadRound(abef1, cdgh1, kw);
+    }
+    abef0 = _mm_add_epi32(abef0, save_abef0);
+    cdgh0 = _mm_add_epi32(cdgh0, save_cdgh0);
+    abef1 = _mm_add_epi32(abef1, save_abef1);
+    cdgh1 = _mm_add_epi32(cdgh1, save_cdgh1);
+}
+
+/** Message of the second hash: the digest, then padding for 256 bits */
+inline void DigestMessage(__m128i abef, __m128i cdgh, __m128i* m)
+{
+    FromShani(abef, cdgh, m[0], m[1]);
+    m[2] = _mm_set_epi64x(0, 0x80000000);
+    m[3] = _mm_set_epi64x(0x10000000000ULL, 0);
+}
+
+inline void StoreDigest(unsigned char* out, __m128i abef, __m128i cdgh)
+{
+    __m128i abcd, efgh;
+    FromShani(abef, cdgh, abcd, efgh);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), Swap(abcd));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), Swap(efgh));
+}
+
+} // namespace
+
+namespace sha256_shani {
+
+void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks)
+{
+    __m128i abef, cdgh;
+    ToShani(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 4)), abef, cdgh);
+    for (; blocks > 0; blocks--, chunk += 64) {
+        const __m128i save_abef = abef, save_cdgh = cdgh;
+        __m128i m[4];
+        for (int i = 0; i < 4; i++)
+            m[i] = Swap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + 16 * i)));
+        for (int i = 0; i < 16; i++) {
+            const __m128i w = i < 4 ? m[i] : Schedule(m, i);
+            QuadRound(abef, cdgh, _mm_add_epi32(w, Load(K + 4 * i)));
+        }
+        abef = _mm_add_epi32(abef, save_abef);
+        cdgh = _mm_add_epi32(cdgh, save_cdgh);
+    }
+    __m128i abcd, efgh;
+    FromShani(abef, cdgh, abcd, efgh);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s), abcd);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s + 4), efgh);
+}
+
+} // namespace sha256_shani
+
+namespace sha256d64_shani {
+
+void Transform_2way(unsigned char* out, const unsigned char* in)
+{
+    __m128i init_abef, init_cdgh;
+    ToShani(Load(sha256_internal::INIT), Load(sha256_internal::INIT + 4), init_abef, init_cdgh);
+
+    __m128i abef0 = init_abef, cdgh0 = init_cdgh, abef1 = init_abef, cdgh1 = init_cdgh;
+    __m128i m0[4], m1[4];
+    for (int i = 0; i < 4; i++) {
+        m0[i] = Swap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * i)));
+        m1[i] = Swap(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 64 + 16 * i)));
+    }
+    Transform2(abef0, cdgh0, m0, abef1, cdgh1, m1);
+    TransformPadding2(abef0, cdgh0, abef1, cdgh1);
+
+    DigestMessage(abef0, cdgh0, m0);
+    DigestMessage(abef1, cdgh1, m1);
+    abef0 = abef1 = init_abef;
+    cdgh0 = cdgh1 = init_cdgh;
+    Transform2(abef0, cdgh0, m0, abef1, cdgh1, m1);
+
+    StoreDigest(out, abef0, cdgh0);
+    StoreDigest(out + 32, abef1, cdgh1);
+}
+
+} // namespace sha256d64_shani
+
+#endif
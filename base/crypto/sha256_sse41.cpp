@@ -0,0 +1,56 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 4-way double SHA256 of 64 byte messages, built with -msse4.1
+
+#ifdef ENABLE_SSE41
+
+#include "sha256_internal.h"
+
+#include <immintrin.h>
+
+namespace sha256d64_sse41 {
+namespace {
+
+using sha256_internal::ReadBE32;
+using sha256_internal::WriteBE32;
+
+struct Ops
+{
+    typedef __m128i V;
+
+    static V Set1(uint32_t x) { return _mm_set1_epi32(x); }
+    static V Add(V x, V y) { return _mm_add_epi32(x, y); }
+    static V Xor(V x, V y) { return _mm_xor_si128(x, y); }
+    static V Shr(V x, int n) { return _mm_srli_epi32(x, n); }
+    static V Ror(V x, int n) { return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n)); }
+    static V Ch(V x, V y, V z) { return _mm_xor_si128(z, _mm_and_si128(x, _mm_xor_si128(y, z))); }
+    static V Maj(V x, V y, V z) { return _mm_or_si128(_mm_and_si128(x, y), _mm_and_si128(z, _mm_or_si128(x, y))); }
+
+    static V Load(const unsigned char* in, int word)
+    {
+        in += 4 * word;
+        return _mm_set_epi32(ReadBE32(in + 192), ReadBE32(in + 128), ReadBE32(in + 64), ReadBE32(in));
+    }
+
+    static void Store(unsigned char* out, int word, V v)
+    {
+        out += 4 * word;
+        WriteBE32(out, _mm_extract_epi32(v, 0));
+        WriteBE32(out + 32, _mm_extract_epi32(v, 1));
+        WriteBE32(out + 64, _mm_extract_epi32(v, 2));
+        WriteBE32(out + 96, _mm_extract_epi32(v, 3));
+    }
+};
+
+} // namespace
+
+void Transform_4way(unsigned char* out, const unsigned char* in)
+{
+    sha256_internal::MultiWay<Ops>::TransformD64(out, in);
+}
+
+} // namespace sha256d64_sse41
+
+#endif
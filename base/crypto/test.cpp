@@ -0,0 +1,88 @@
+#include "sha256.h"
+#include <algorithm>
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static std::string Hex(const unsigned char* p, size_t len)
+{
+  static const char digits[] = "0123456789abcdef";
+  std::string s;
+  for (size_t i = 0; i < len; i++) {
+    s += digits[p[i] >> 4];
+    s += digits[p[i] & 15];
+  }
+  return s;
+}
+
+static std::string Sha256(const std::string& msg, size_t split)
+{
+  split = std::min(split, msg.size());
+  unsigned char hash[CSHA256::OUTPUT_SIZE];
+  CSHA256 hasher;
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(msg.data());
+  hasher.Write(p, split).Write(p + split, msg.size() - split).Finalize(hash);
+  return Hex(hash, sizeof(hash));
+}
+
+static void TestVectors()
+{
+  const std::string million(1000000, 'a');
+  for (size_t split : {0, 1, 63, 64, 65}) {
+    assert(Sha256("", 0) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    assert(Sha256("abc", split) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    assert(Sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", split) ==
+           "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    assert(Sha256(million, split) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  }
+}
+
+/** Double SHA256 of each 64 byte block with the plain hasher */
+static std::vector<unsigned char> Reference(const std::vector<unsigned char>& in)
+{
+  std::vector<unsigned char> out(in.size() / 2);
+  for (size_t i = 0; i < in.size() / 64; i++) {
+    unsigned char once[32];
+    CSHA256().Write(&in[64 * i], 64).Finalize(once);
+    CSHA256().Write(once, 32).Finalize(&out[32 * i]);
+  }
+  return out;
+}
+
+int main()
+{
+  std::vector<unsigned char> in(64 * 67);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = (unsigned char)(i * 151 + (i >> 8) * 7 + 3);
+  // 0 and 1 as well, for the padding words
+  memset(&in[64 * 5], 0, 64);
+  memset(&in[64 * 6], 0xff, 64);
+
+  const std::string standard = SHA256AutoDetect(sha256_implementation::STANDARD);
+  assert(standard == "standard");
+  TestVectors();
+  const std::vector<unsigned char> expect = Reference(in);
+
+  const sha256_implementation::UseImplementation uses[] = {
+    sha256_implementation::STANDARD, sha256_implementation::USE_SSE4, sha256_implementation::USE_AVX2,
+    sha256_implementation::USE_AVX512, sha256_implementation::USE_SHANI, sha256_implementation::USE_ALL,
+  };
+  for (sha256_implementation::UseImplementation use : uses) {
+    const std::string name = SHA256AutoDetect(use);
+    TestVectors();
+    // Every count, so that each kernel and the tails all run
+    for (size_t blocks = 0; blocks <= 67; blocks++) {
+      std::vector<unsigned char> out(32 * blocks);
+      SHA256D64(out.data(), in.data(), blocks);
+      assert(memcmp(out.data(), expect.data(), out.size()) == 0);
+    }
+    // In place, as merkle root computation does
+    std::vector<unsigned char> buf = in;
+    SHA256D64(buf.data(), buf.data(), 67);
+    assert(memcmp(buf.data(), expect.data(), expect.size()) == 0);
+    std::cout << "sha256 " << name << ": ok" << std::endl;
+  }
+}
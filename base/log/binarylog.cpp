@@ -0,0 +1,300 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "binarylog.h"
+
+#include <string.h>
+
+namespace NiuLog {
+
+BinaryLogWriter::BinaryLogWriter()
+    : m_next_id(0), m_last_time(0)
+{
+}
+
+void BinaryLogWriter::StartSession(std::string& out)
+{
+    m_ids.clear();
+    m_next_id = 0;
+    m_last_time = 0;
+    out.push_back(static_cast<char>(BINLOG_SESSION));
+    out.append(BINLOG_MAGIC, sizeof(BINLOG_MAGIC) - 1);
+}
+
+void BinaryLogWriter::Append(std::string& out, const RecordHeader& header)
+{
+    const Key key(header.fmt, header.type);
+    std::unordered_map<Key, uint32_t, KeyHash>::iterator it = m_ids.find(key);
+    if (it == m_ids.end()) {
+        uint32_t id = TEXT_ONLY;
+        if (!strchr(header.type->signature, '?')) {
+            id = m_next_id++;
+            const size_t fmt_len = strlen(header.fmt);
+            const size_t sig_len = strlen(header.type->signature);
+            out.push_back(static_cast<char>(BINLOG_DEFINE));
+            WriteVarInt(out, id);
+            WriteVarInt(out, sig_len);
+            out.append(header.type->signature, sig_len);
+            WriteVarInt(out, fmt_len);
+            out.append(header.fmt, fmt_len);
+        }
+        it = m_ids.insert(std::make_pair(key, id)).first;
+    }
+
+    const char* args = reinterpret_cast<const char*>(&header + 1);
+    if (it->second == TEXT_ONLY) {
+        m_text.clear();
+        AppendLogText(m_text, header);
+        out.push_back(static_cast<char>(BINLOG_TEXT));
+        WriteVarInt(out, header.category);
+        WriteSignedVarInt(out, header.time_micros - m_last_time);
+        WriteVarInt(out, m_text.size());
+        out += m_text;
+    } else {
+        out.push_back(static_cast<char>(BINLOG_MESSAGE));
+        WriteVarInt(out, it->second);
+        WriteVarInt(out, header.category);
+        WriteSignedVarInt(out, header.time_micros - m_last_time);
+        header.type->pack(out, args);
+    }
+    m_last_time = header.time_micros;
+}
+
+void BinaryLogWriter::AppendDropped(std::string& out, uint64_t count)
+{
+    out.push_back(static_cast<char>(BINLOG_DROPPED));
+    WriteVarInt(out, count);
+}
+
+BinaryLogReader::BinaryLogReader(const char* data, size_t size)
+    : m_data(data), m_size(size), m_pos(0), m_entry(0), m_session(false),
+      m_last_time(0), m_error_offset(0)
+{
+}
+
+bool BinaryLogReader::Fail(const std::string& error)
+{
+    m_error = error;
+    m_error_offset = m_entry;
+    return false;
+}
+
+bool BinaryLogReader::ReadByte(unsigned char& b)
+{
+    if (m_pos >= m_size)
+        return Fail("truncated entry");
+    b = static_cast<unsigned char>(m_data[m_pos++]);
+    return true;
+}
+
+bool BinaryLogReader::ReadVarInt(uint64_t& n)
+{
+    n = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        unsigned char b;
+        if (!ReadByte(b))
+            return false;
+        n |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return Fail("varint too long");
+}
+
+bool BinaryLogReader::ReadSignedVarInt(int64_t& n)
+{
+    uint64_t u;
+    if (!ReadVarInt(u))
+        return false;
+    n = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+    return true;
+}
+
+bool BinaryLogReader::ReadBytes(size_t len, const char*& p)
+{
+    if (len > m_size - m_pos)
+        return Fail("truncated entry");
+    p = m_data + m_pos;
+    m_pos += len;
+    return true;
+}
+
+bool BinaryLogReader::ReadString(std::string& str)
+{
+    uint64_t len;
+    const char* p;
+    if (!ReadVarInt(len) || !ReadBytes(len, p))
+        return false;
+    str.assign(p, len);
+    return true;
+}
+
+namespace {
+
+/** Storage for one decoded argument; FormatArg points at the member of the
+ *  original type */
+struct WireValue
+{
+    bool b;
+    char c;
+    signed char y;
+    unsigned char Y;
+    short s;
+    unsigned short S;
+    int i;
+    unsigned int I;
+    long l;
+    unsigned long L;
+    long long q;
+    unsigned long long Q;
+    float f;
+    double d;
+    LogString z;
+    uint256 h;
+    uint160 g;
+};
+
+} // namespace
+
+bool BinaryLogReader::FormatMessage(std::string& out, const Definition& def)
+{
+    const size_t n = def.signature.size();
+    std::vector<WireValue> values(n);
+    std::vector<tfm::detail::FormatArg> args(n);
+    for (size_t k = 0; k < n; ++k) {
+        WireValue& v = values[k];
+        uint64_t u = 0;
+        int64_t i = 0;
+        const char* p;
+        switch (def.signature[k]) {
+        case 's': if (!ReadSignedVarInt(i)) return false; v.s = i; args[k] = tfm::detail::FormatArg(v.s); break;
+        case 'S': if (!ReadVarInt(u)) return false; v.S = u; args[k] = tfm::detail::FormatArg(v.S); break;
+        case 'i': if (!ReadSignedVarInt(i)) return false; v.i = i; args[k] = tfm::detail::FormatArg(v.i); break;
+        case 'I': if (!ReadVarInt(u)) return false; v.I = u; args[k] = tfm::detail::FormatArg(v.I); break;
+        case 'l': if (!ReadSignedVarInt(i)) return false; v.l = i; args[k] = tfm::detail::FormatArg(v.l); break;
+        case 'L': if (!ReadVarInt(u)) return false; v.L = u; args[k] = tfm::detail::FormatArg(v.L); break;
+        case 'q': if (!ReadSignedVarInt(i)) return false; v.q = i; args[k] = tfm::detail::FormatArg(v.q); break;
+        case 'Q': if (!ReadVarInt(u)) return false; v.Q = u; args[k] = tfm::detail::FormatArg(v.Q); break;
+        case 'b':
+            if (!ReadBytes(1, p)) return false;
+            v.b = *p != 0;
+            args[k] = tfm::detail::FormatArg(v.b);
+            break;
+        case 'c': if (!ReadBytes(1, p)) return false; v.c = *p; args[k] = tfm::detail::FormatArg(v.c); break;
+        case 'y': if (!ReadBytes(1, p)) return false; v.y = *p; args[k] = tfm::detail::FormatArg(v.y); break;
+        case 'Y': if (!ReadBytes(1, p)) return false; v.Y = *p; args[k] = tfm::detail::FormatArg(v.Y); break;
+        case 'f':
+            if (!ReadBytes(sizeof(v.f), p)) return false;
+            memcpy(&v.f, p, sizeof(v.f));
+            args[k] = tfm::detail::FormatArg(v.f);
+            break;
+        case 'd':
+            if (!ReadBytes(sizeof(v.d), p)) return false;
+            memcpy(&v.d, p, sizeof(v.d));
+            args[k] = tfm::detail::FormatArg(v.d);
+            break;
+        case 'z':
+            if (!ReadVarInt(u) || !ReadBytes(u, p)) return false;
+            v.z.data = p;
+            v.z.size = u;
+            args[k] = tfm::detail::FormatArg(v.z);
+            break;
+        case 'h':
+            if (!ReadBytes(v.h.size(), p)) return false;
+            memcpy(v.h.begin(), p, v.h.size());
+            args[k] = tfm::detail::FormatArg(v.h);
+            break;
+        case 'g':
+            if (!ReadBytes(v.g.size(), p)) return false;
+            memcpy(v.g.begin(), p, v.g.size());
+            args[k] = tfm::detail::FormatArg(v.g);
+            break;
+        default:
+            return Fail("unknown argument type in signature");
+        }
+    }
+    try {
+        tfm::vformat(out, def.fmt.c_str(), tfm::FormatList(args.data(), static_cast<int>(n)));
+    } catch (const tfm::format_error& e) {
+        // The signature was written for a different format string
+        return Fail(std::string("format error: ") + e.what());
+    }
+    return true;
+}
+
+bool BinaryLogReader::Next(std::string& out)
+{
+    if (Failed())
+        return false;
+    while (m_pos < m_size) {
+        m_entry = m_pos;
+        unsigned char tag;
+        ReadByte(tag);
+        if (!m_session && tag != BINLOG_SESSION)
+            return Fail("not a binary log");
+        switch (tag) {
+        case BINLOG_SESSION: {
+            const char* magic;
+            if (!ReadBytes(sizeof(BINLOG_MAGIC) - 1, magic))
+                return false;
+            if (memcmp(magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC) - 1) != 0)
+                return Fail("bad magic");
+            m_session = true;
+            m_defs.clear();
+            m_last_time = 0;
+            break;
+        }
+        case BINLOG_DEFINE: {
+            uint64_t id;
+            Definition def;
+            if (!ReadVarInt(id) || !ReadString(def.signature) || !ReadString(def.fmt))
+                return false;
+            if (id != m_defs.size())
+                return Fail("format ids out of sequence");
+            m_defs.push_back(def);
+            break;
+        }
+        case BINLOG_MESSAGE:
+        case BINLOG_TEXT: {
+            uint64_t id = 0, category;
+            int64_t dtime;
+            if (tag == BINLOG_MESSAGE) {
+                if (!ReadVarInt(id))
+                    return false;
+                if (id >= m_defs.size())
+                    return Fail("undefined format id");
+            }
+            if (!ReadVarInt(category) || !ReadSignedVarInt(dtime))
+                return false;
+            m_last_time += dtime;
+            AppendLogPrefix(out, m_last_time, category);
+            if (tag == BINLOG_MESSAGE) {
+                if (!FormatMessage(out, m_defs[id]))
+                    return false;
+            } else {
+                uint64_t len;
+                const char* text;
+                if (!ReadVarInt(len) || !ReadBytes(len, text))
+                    return false;
+                out.append(text, len);
+            }
+            if (out.empty() || out[out.size() - 1] != '\n')
+                out.push_back('\n');
+            return true;
+        }
+        case BINLOG_DROPPED: {
+            uint64_t count;
+            if (!ReadVarInt(count))
+                return false;
+            out += strprintf("Log buffer full, dropped %u messages\n", count);
+            return true;
+        }
+        default:
+            return Fail("unknown entry tag");
+        }
+    }
+    return false;
+}
+
+} // namespace NiuLog
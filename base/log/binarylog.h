@@ -0,0 +1,120 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Binary log format.
+ *
+ * With LogOptions::binary the background thread writes records without
+ * formatting them.  A file is a sequence of entries, each starting with a tag
+ * byte:
+ *
+ *   SESSION  "NIULOG1"                      file opened; forget all ids
+ *   DEFINE   id signature fmt               bind id to a format string
+ *   MESSAGE  id category dtime args...      one log call
+ *   TEXT     category dtime text            one log call, already formatted
+ *   DROPPED  count                          records lost to full rings
+ *
+ * Numbers are LEB128 varints, signed ones zigzag mapped; strings are a varint
+ * length and the bytes.  dtime is the signed difference in microseconds to
+ * the previous MESSAGE or TEXT of the session, or to 0 for the first one.
+ * The signature holds one type code per argument (see WireArg), which tells
+ * the decoder how to read the arguments and which C++ type to give them, so
+ * that tinyformat renders them exactly as the text mode would.  Records with
+ * an argument type that has no code are written as TEXT.
+ */
+#ifndef NIUBLOCK_BINARYLOG_H
+#define NIUBLOCK_BINARYLOG_H
+
+#include "logging.h"
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NiuLog {
+
+enum BinaryLogTag : unsigned char {
+    BINLOG_SESSION = 0,
+    BINLOG_DEFINE  = 1,
+    BINLOG_MESSAGE = 2,
+    BINLOG_TEXT    = 3,
+    BINLOG_DROPPED = 4,
+};
+
+static const char BINLOG_MAGIC[] = "NIULOG1";
+
+/** Encodes records for one output file, used by the logger thread */
+class BinaryLogWriter
+{
+public:
+    BinaryLogWriter();
+
+    /** Start a file: ids and the time base start over */
+    void StartSession(std::string& out);
+    void Append(std::string& out, const RecordHeader& header);
+    void AppendDropped(std::string& out, uint64_t count);
+
+private:
+    typedef std::pair<const char*, const RecordType*> Key;
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return std::hash<const void*>()(key.first) * 31 + std::hash<const void*>()(key.second);
+        }
+    };
+
+    static const uint32_t TEXT_ONLY = ~(uint32_t)0;
+
+    std::unordered_map<Key, uint32_t, KeyHash> m_ids;
+    uint32_t m_next_id;
+    int64_t m_last_time;
+    std::string m_text;
+};
+
+/** Turns a binary log back into the text lines the text mode would write */
+class BinaryLogReader
+{
+public:
+    BinaryLogReader(const char* data, size_t size);
+
+    /** Append the next line to out. Returns false at the end of the data or
+     *  on malformed input, see Failed(). */
+    bool Next(std::string& out);
+
+    bool Failed() const { return !m_error.empty(); }
+    const std::string& Error() const { return m_error; }
+    /** Offset of the entry being decoded when the error was found */
+    size_t ErrorOffset() const { return m_error_offset; }
+
+private:
+    struct Definition
+    {
+        std::string fmt;
+        std::string signature;
+    };
+
+    bool Fail(const std::string& error);
+    bool ReadByte(unsigned char& b);
+    bool ReadVarInt(uint64_t& n);
+    bool ReadSignedVarInt(int64_t& n);
+    bool ReadBytes(size_t len, const char*& p);
+    bool ReadString(std::string& str);
+    bool FormatMessage(std::string& out, const Definition& def);
+
+    const char* m_data;
+    size_t m_size;
+    size_t m_pos;
+    size_t m_entry;
+    bool m_session;
+    int64_t m_last_time;
+    std::vector<Definition> m_defs;
+    std::string m_error;
+    size_t m_error_offset;
+};
+
+} // namespace NiuLog
+
+#endif // NIUBLOCK_BINARYLOG_H
@@ -0,0 +1,3 @@
+#!/bin/sh
+
+g++  -std=c++11 -O2  test.cpp logging.cpp binarylog.cpp ../memory/memaccount.cpp ../big_int/uint256.cpp ../big_int/utilstrencodings.cpp  -I ./ -I ../memory -I ../big_int -lpthread
@@ -0,0 +1,518 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "logging.h"
+
+#include "binarylog.h"
+#include "memaccount.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <new>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace NiuLog {
+
+struct CategoryName
+{
+    uint32_t flag;
+    const char* name;
+};
+
+static const CategoryName LogCategories[] = {
+    {NONE, "0"},
+    {NONE, "none"},
+    {NET, "net"},
+    {MEMPOOL, "mempool"},
+    {VALIDATION, "validation"},
+    {BENCH, "bench"},
+    {DB, "db"},
+    {RPC, "rpc"},
+    {ALL, "1"},
+    {ALL, "all"},
+};
+
+const char* LogCategoryName(uint32_t category)
+{
+    if (category == NONE || category == ALL)
+        return "";
+    for (const CategoryName& c : LogCategories) {
+        if (c.flag == category)
+            return c.name;
+    }
+    return "?";
+}
+
+bool GetLogCategory(uint32_t& flag, const std::string& str)
+{
+    if (str.empty()) {
+        flag = ALL;
+        return true;
+    }
+    for (const CategoryName& c : LogCategories) {
+        if (str == c.name) {
+            flag = c.flag;
+            return true;
+        }
+    }
+    return false;
+}
+
+LogRing::LogRing(size_t capacity)
+    : released(0), dropped(0),
+      m_data(static_cast<char*>(NiuMem::Allocate(NiuMem::MEM_LOG, capacity))), m_mask(capacity - 1),
+      m_head(0), m_reserved(0), m_cachedTail(0), m_tail(0)
+{
+    assert(capacity >= 64 && (capacity & (capacity - 1)) == 0);
+    if (!m_data)
+        throw std::bad_alloc();
+}
+
+LogRing::~LogRing()
+{
+    NiuMem::Deallocate(NiuMem::MEM_LOG, m_data, m_mask + 1);
+}
+
+char* LogRing::Reserve(uint32_t size)
+{
+    const uint64_t capacity = m_mask + 1;
+    if (size > capacity / 2)
+        return nullptr;
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    const uint64_t contiguous = capacity - (head & m_mask);
+    // A record that does not fit before the end also uses up the remainder
+    const uint64_t need = size <= contiguous ? size : contiguous + size;
+    if (head + need - m_cachedTail > capacity) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        if (head + need - m_cachedTail > capacity)
+            return nullptr;
+    }
+    if (size > contiguous) {
+        const uint32_t wrap = 0;
+        memcpy(m_data + (head & m_mask), &wrap, sizeof(wrap));
+        head += contiguous;
+    }
+    m_reserved = head;
+    return m_data + (head & m_mask);
+}
+
+const char* LogRing::Record(uint64_t& pos) const
+{
+    uint32_t size;
+    memcpy(&size, m_data + (pos & m_mask), sizeof(size));
+    if (size == 0)
+        pos += (m_mask + 1) - (pos & m_mask);
+    return m_data + (pos & m_mask);
+}
+
+namespace {
+
+/** Let go of the writer thread's side of ring, freeing it if its logger is gone */
+void RetireRing(LogRing* ring)
+{
+    if (ring->released.fetch_or(LogRing::RETIRED, std::memory_order_acq_rel) & LogRing::ORPHANED)
+        delete ring;
+}
+
+/** The ring of the current thread; retired when the thread exits */
+struct ThreadRingHolder
+{
+    Logger* logger = nullptr;
+    LogRing* ring = nullptr;
+
+    ~ThreadRingHolder()
+    {
+        if (ring)
+            RetireRing(ring);
+    }
+};
+
+thread_local ThreadRingHolder g_thread_ring;
+
+/** Output chunks are written with one writev(), each chunk is one iovec */
+const size_t CHUNK_SIZE = 64 * 1024;
+
+} // namespace
+
+struct Logger::Output
+{
+    int fd = -1;
+    uint64_t file_size = 0;
+    std::vector<std::string> chunks;
+    std::vector<struct iovec> iov;
+    BinaryLogWriter binary;
+    bool session_pending = true;    //!< binary mode: file just opened
+    uint64_t dropped_reported = 0;
+    uint64_t dropped_retired = 0;
+
+    struct Entry
+    {
+        int64_t time_micros;
+        const RecordHeader* header;
+        bool operator<(const Entry& other) const { return time_micros < other.time_micros; }
+    };
+    std::vector<Entry> entries;
+};
+
+void AppendLogPrefix(std::string& buf, int64_t time_micros, uint32_t category)
+{
+    // Lines come in time order, so the date part rarely changes
+    static thread_local int64_t cached_second = -1;
+    static thread_local char date[32];
+    const int64_t second = time_micros / 1000000;
+    if (second != cached_second) {
+        const time_t t = second;
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S.", &tm);
+        cached_second = second;
+    }
+    char micros[8];
+    uint32_t us = time_micros % 1000000;
+    for (int i = 5; i >= 0; --i, us /= 10)
+        micros[i] = '0' + us % 10;
+    micros[6] = 'Z';
+    micros[7] = ' ';
+    buf.append(date);
+    buf.append(micros, sizeof(micros));
+    if (category != NONE) {
+        buf.push_back('[');
+        buf.append(LogCategoryName(category));
+        buf.append("] ");
+    }
+}
+
+void AppendLogText(std::string& buf, const RecordHeader& header)
+{
+    const size_t start = buf.size();
+    try {
+        header.type->format(buf, header.fmt, reinterpret_cast<const char*>(&header + 1));
+    } catch (const tfm::format_error& e) {
+        // A bad format string must not take the logger thread down
+        buf.resize(start);
+        buf += "[format error: ";
+        buf += e.what();
+        buf += "] ";
+        buf += header.fmt;
+    }
+}
+
+static bool OpenLogFile(const std::string& path, int& fd, uint64_t& size)
+{
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    size = fstat(fd, &st) == 0 ? st.st_size : 0;
+    return true;
+}
+
+/** Write all iovecs, retrying on partial writes and EINTR */
+static bool WriteAll(int fd, struct iovec* iov, size_t count)
+{
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, std::min<size_t>(count, IOV_MAX));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        while (count > 0 && static_cast<size_t>(n) >= iov->iov_len) {
+            n -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+Logger::Logger()
+    : m_categories(NONE), m_ring_size(LogOptions().ring_size),
+      m_running(false), m_reopen(false), m_flush_requested(0), m_flush_done(0),
+      m_output(new Output)
+{
+}
+
+Logger::~Logger()
+{
+    Stop();
+    if (g_thread_ring.logger == this) {
+        g_thread_ring.ring->released.fetch_or(LogRing::RETIRED, std::memory_order_relaxed);
+        g_thread_ring.logger = nullptr;
+        g_thread_ring.ring = nullptr;
+    }
+    // Threads that logged here may still hold their rings in g_thread_ring
+    // and must not touch freed memory: their rings are freed when they let go.
+    for (LogRing* ring : m_rings) {
+        if (ring->released.fetch_or(LogRing::ORPHANED, std::memory_order_acq_rel) & LogRing::RETIRED)
+            delete ring;
+    }
+    if (m_output->fd >= 0)
+        close(m_output->fd);
+    delete m_output;
+}
+
+int64_t Logger::NowMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+LogRing* Logger::ThreadRing()
+{
+    // An orphaned ring belongs to an earlier logger at the same address
+    if (g_thread_ring.logger == this &&
+        !(g_thread_ring.ring->released.load(std::memory_order_acquire) & LogRing::ORPHANED))
+        return g_thread_ring.ring;
+    return RegisterThread();
+}
+
+LogRing* Logger::RegisterThread()
+{
+    if (g_thread_ring.ring)
+        RetireRing(g_thread_ring.ring);
+    LogRing* ring;
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        ring = new LogRing(m_ring_size);
+        m_rings.push_back(ring);
+    }
+    g_thread_ring.logger = this;
+    g_thread_ring.ring = ring;
+    return ring;
+}
+
+bool Logger::Start(const LogOptions& options)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+        return false;
+    m_options = options;
+    m_output->session_pending = true;
+    if (!m_options.file_path.empty() &&
+        !OpenLogFile(m_options.file_path, m_output->fd, m_output->file_size))
+        return false;
+    {
+        // Only threads that log for the first time get the new size
+        std::lock_guard<std::mutex> rings_lock(m_rings_mutex);
+        size_t size = 64;
+        while (size < m_options.ring_size)
+            size <<= 1;
+        m_ring_size = size;
+    }
+    m_running = true;
+    m_thread = std::thread(&Logger::ThreadMain, this);
+    return true;
+}
+
+void Logger::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+            return;
+        m_running = false;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+void Logger::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running)
+        return;
+    const uint64_t ticket = ++m_flush_requested;
+    m_cond.notify_all();
+    m_cond.wait(lock, [&] { return m_flush_done >= ticket || !m_running; });
+}
+
+void Logger::Reopen()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_reopen = true;
+    }
+    m_cond.notify_all();
+}
+
+uint64_t Logger::Dropped() const
+{
+    std::lock_guard<std::mutex> lock(m_rings_mutex);
+    uint64_t total = m_output->dropped_retired;
+    for (const LogRing* ring : m_rings)
+        total += ring->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Logger::ThreadMain()
+{
+    const std::chrono::milliseconds interval(m_options.flush_interval_ms);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    size_t written = 0;
+    for (;;) {
+        // Keep draining while there is backlog, otherwise poll
+        if (written == 0) {
+            m_cond.wait_for(lock, interval, [&] {
+                return !m_running || m_reopen || m_flush_requested != m_flush_done;
+            });
+        }
+        const uint64_t flush_target = m_flush_requested;
+        const bool stopping = !m_running;
+        const bool reopen = m_reopen;
+        m_reopen = false;
+        lock.unlock();
+
+        bool rotate = reopen;
+        written = WriteBatch(rotate);
+        if (rotate && !m_options.file_path.empty()) {
+            if (m_output->fd >= 0)
+                close(m_output->fd);
+            if (!reopen) {
+                // debug.log -> debug.log.1 -> ... -> debug.log.<max_files>
+                for (unsigned int i = m_options.max_files; i > 1; --i) {
+                    rename(strprintf("%s.%u", m_options.file_path, i - 1).c_str(),
+                           strprintf("%s.%u", m_options.file_path, i).c_str());
+                }
+                if (m_options.max_files > 0)
+                    rename(m_options.file_path.c_str(), (m_options.file_path + ".1").c_str());
+                else
+                    unlink(m_options.file_path.c_str());
+            }
+            if (!OpenLogFile(m_options.file_path, m_output->fd, m_output->file_size))
+                m_output->fd = -1;
+            m_output->session_pending = true;
+        }
+
+        lock.lock();
+        m_flush_done = flush_target;
+        m_cond.notify_all();
+        if (stopping && written == 0)
+            break;
+    }
+}
+
+/** Format and write everything published so far. Returns the number of
+ *  records written and sets rotate once the file has grown too large. */
+size_t Logger::WriteBatch(bool& rotate)
+{
+    Output& out = *m_output;
+    std::vector<std::pair<LogRing*, uint64_t> > rings;
+    std::vector<LogRing*> retired;
+    uint64_t dropped = out.dropped_retired;
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        for (LogRing* ring : m_rings) {
+            // Read retired before head: a retired ring gets no more records
+            if (ring->released.load(std::memory_order_acquire) & LogRing::RETIRED)
+                retired.push_back(ring);
+            rings.push_back(std::make_pair(ring, ring->Head()));
+            dropped += ring->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    out.entries.clear();
+    for (const std::pair<LogRing*, uint64_t>& r : rings) {
+        for (uint64_t pos = r.first->Tail(); pos < r.second; ) {
+            const RecordHeader* header = reinterpret_cast<const RecordHeader*>(r.first->Record(pos));
+            Output::Entry entry = {header->time_micros, header};
+            out.entries.push_back(entry);
+            pos += header->size;
+        }
+    }
+    // Each ring is already in order; this merges them
+    std::stable_sort(out.entries.begin(), out.entries.end());
+
+    size_t chunk = 0;
+    if (out.chunks.empty())
+        out.chunks.resize(1);
+    out.chunks[0].clear();
+    if (m_options.binary && out.session_pending) {
+        out.binary.StartSession(out.chunks[0]);
+        out.session_pending = false;
+    }
+    if (dropped != out.dropped_reported) {
+        if (m_options.binary)
+            out.binary.AppendDropped(out.chunks[0], dropped - out.dropped_reported);
+        else
+            out.chunks[0] += strprintf("Log buffer full, dropped %u messages\n", dropped - out.dropped_reported);
+        out.dropped_reported = dropped;
+    }
+    for (const Output::Entry& entry : out.entries) {
+        std::string* buf = &out.chunks[chunk];
+        if (buf->size() >= CHUNK_SIZE) {
+            if (++chunk == out.chunks.size())
+                out.chunks.resize(chunk + 1);
+            buf = &out.chunks[chunk];
+            buf->clear();
+        }
+        if (buf->capacity() < CHUNK_SIZE)
+            buf->reserve(CHUNK_SIZE + 1024);
+
+        const RecordHeader* header = entry.header;
+        if (m_options.binary) {
+            out.binary.Append(*buf, *header);
+            continue;
+        }
+        AppendLogPrefix(*buf, header->time_micros, header->category);
+        AppendLogText(*buf, *header);
+        if (buf->empty() || (*buf)[buf->size() - 1] != '\n')
+            buf->push_back('\n');
+    }
+
+    out.iov.clear();
+    uint64_t bytes = 0;
+    for (size_t i = 0; i <= chunk; ++i) {
+        if (out.chunks[i].empty())
+            continue;
+        struct iovec v = {&out.chunks[i][0], out.chunks[i].size()};
+        out.iov.push_back(v);
+        bytes += v.iov_len;
+    }
+    if (!out.iov.empty()) {
+        if (m_options.print_to_console && !m_options.binary) {
+            std::vector<struct iovec> iov(out.iov);
+            WriteAll(STDOUT_FILENO, iov.data(), iov.size());
+        }
+        if (out.fd >= 0 && WriteAll(out.fd, out.iov.data(), out.iov.size()))
+            out.file_size += bytes;
+    }
+
+    // Formatting read the records in place, so release them only now
+    for (const std::pair<LogRing*, uint64_t>& r : rings)
+        r.first->Release(r.second);
+    if (!retired.empty()) {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+        for (LogRing* ring : retired) {
+            out.dropped_retired += ring->dropped.load(std::memory_order_relaxed);
+            m_rings.erase(std::find(m_rings.begin(), m_rings.end(), ring));
+            delete ring;
+        }
+    }
+
+    if (m_options.max_file_size > 0 && out.file_size >= m_options.max_file_size)
+        rotate = true;
+    return out.entries.size();
+}
+
+Logger& LogInstance()
+{
+    // Leaked so that it outlives the threads that log to it
+    static Logger* logger = new Logger();
+    return *logger;
+}
+
+} // namespace NiuLog
@@ -0,0 +1,571 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Asynchronous logger.
+ *
+ * A log call copies the format string pointer and its arguments into a
+ * single-producer/single-consumer ring owned by the calling thread and
+ * returns.  A background thread drains the rings of all threads, merges the
+ * records by timestamp, formats them with tinyformat and writes each batch
+ * with one writev() to a size-rotated log file.
+ *
+ * The format string is stored by pointer and must outlive the logger, which
+ * in practice means a string literal.  Arguments are captured by value:
+ * strings are copied into the ring, uint160/uint256 as their raw bytes and
+ * any other trivially copyable type with memcpy.  Other types must be
+ * converted at the call site (e.g. with ToString()).
+ */
+#ifndef NIUBLOCK_LOGGING_H
+#define NIUBLOCK_LOGGING_H
+
+#include "tinyformat.h"
+#include "uint256.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <string.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace NiuLog {
+
+enum LogFlags : uint32_t {
+    NONE        = 0,
+    NET         = (1 <<  0),
+    MEMPOOL     = (1 <<  1),
+    VALIDATION  = (1 <<  2),
+    BENCH       = (1 <<  3),
+    DB          = (1 <<  4),
+    RPC         = (1 <<  5),
+    ALL         = ~(uint32_t)0,
+};
+
+/** Name of a single category as printed in the log, "" for NONE */
+const char* LogCategoryName(uint32_t category);
+
+/** Set category mask from a name as accepted by -debug ("net", "all", ...) */
+bool GetLogCategory(uint32_t& flag, const std::string& str);
+
+/** Wait-free byte ring with one writer and one reader.
+ *
+ * Records are 8-byte aligned and never split: when a record does not fit at
+ * the end, a zero size word tells the reader to continue at offset 0.
+ */
+class LogRing
+{
+public:
+    explicit LogRing(size_t capacity);
+    ~LogRing();
+
+    /** Writer: room for size bytes, or nullptr if the ring is full */
+    char* Reserve(uint32_t size);
+    /** Writer: publish the record returned by the last Reserve() */
+    void Commit(uint32_t size) { m_head.store(m_reserved + size, std::memory_order_release); }
+
+    /** Reader: byte offsets of the published data and of the unread part */
+    uint64_t Head() const { return m_head.load(std::memory_order_acquire); }
+    uint64_t Tail() const { return m_tail.load(std::memory_order_relaxed); }
+    /** Reader: the record starting at offset pos, skipping a wrap marker */
+    const char* Record(uint64_t& pos) const;
+    /** Reader: release everything before pos back to the writer */
+    void Release(uint64_t pos) { m_tail.store(pos, std::memory_order_release); }
+
+    enum : unsigned int {
+        RETIRED  = 1,   //!< the writer thread exited or moved to another logger
+        ORPHANED = 2,   //!< the logger was destroyed before the writer thread
+    };
+    /** RETIRED and ORPHANED flags; whichever side sets its flag second
+     *  frees the ring */
+    std::atomic<unsigned int> released;
+    /** Records dropped because the ring was full */
+    std::atomic<uint64_t> dropped;
+
+private:
+    char* const m_data;
+    const uint64_t m_mask;
+
+    // Writer and reader side on separate cache lines
+    std::atomic<uint64_t> m_head;
+    uint64_t m_reserved;       //!< writer only: head when Reserve() returned
+    uint64_t m_cachedTail;     //!< writer only
+    char m_padding[64];
+    std::atomic<uint64_t> m_tail;
+};
+
+/** How to read back the arguments of a record, one per argument type list */
+struct RecordType
+{
+    /** Render the arguments into text with tinyformat */
+    void (*format)(std::string& out, const char* fmt, const char* args);
+    /** Append the arguments in binary log encoding, see binarylog.h */
+    void (*pack)(std::string& out, const char* args);
+    /** One binary type code per argument; contains '?' if some argument
+     *  has no binary encoding */
+    const char* signature;
+};
+
+/** Fixed part of a record; the encoded arguments follow */
+struct RecordHeader
+{
+    uint32_t size;             //!< whole record, 8-byte aligned; 0 marks a wrap
+    uint32_t category;
+    int64_t time_micros;       //!< microseconds since the epoch
+    const char* fmt;
+    const RecordType* type;
+};
+
+/** A string copied into the ring, formatted like the original std::string */
+struct LogString
+{
+    const char* data;
+    size_t size;
+};
+
+/** How an argument of type T is captured.
+ *
+ * Size() is the number of bytes Encode() writes, Decode() reads them back
+ * into a Decoded value that tinyformat can print.
+ */
+template<typename T, typename Enable = void>
+struct LogArg
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "log arguments must be strings, uint256 or trivially copyable; "
+                  "convert other types at the call site");
+    typedef T Decoded;
+    static size_t Size(const T&) { return sizeof(T); }
+    static char* Encode(char* p, const T& v) { memcpy(p, &v, sizeof(T)); return p + sizeof(T); }
+    static const char* Decode(const char* p, T& v) { memcpy(&v, p, sizeof(T)); return p + sizeof(T); }
+};
+
+struct LogStringArg
+{
+    typedef LogString Decoded;
+    static size_t Size(size_t len) { return sizeof(uint32_t) + len; }
+    static char* Encode(char* p, const char* s, size_t len)
+    {
+        uint32_t n = len;
+        memcpy(p, &n, sizeof(n));
+        memcpy(p + sizeof(n), s, len);
+        return p + sizeof(n) + len;
+    }
+    static const char* Decode(const char* p, LogString& v)
+    {
+        uint32_t n;
+        memcpy(&n, p, sizeof(n));
+        v.data = p + sizeof(n);
+        v.size = n;
+        return v.data + n;
+    }
+};
+
+template<>
+struct LogArg<std::string> : LogStringArg
+{
+    static size_t Size(const std::string& s) { return LogStringArg::Size(s.size()); }
+    static char* Encode(char* p, const std::string& s) { return LogStringArg::Encode(p, s.data(), s.size()); }
+    using LogStringArg::Decode;
+};
+
+// C strings are copied, never kept by pointer.  A null pointer logs as "".
+template<typename T>
+struct LogArg<T, typename std::enable_if<std::is_same<T, const char*>::value ||
+                                         std::is_same<T, char*>::value>::type> : LogStringArg
+{
+    static size_t Size(const char* s) { return LogStringArg::Size(s ? strlen(s) : 0); }
+    static char* Encode(char* p, const char* s) { return LogStringArg::Encode(p, s, s ? strlen(s) : 0); }
+    using LogStringArg::Decode;
+};
+
+template<size_t N>
+struct LogArg<char[N]> : LogStringArg
+{
+    static size_t Size(const char (&s)[N]) { return LogStringArg::Size(strnlen(s, N)); }
+    static char* Encode(char* p, const char (&s)[N]) { return LogStringArg::Encode(p, s, strnlen(s, N)); }
+    using LogStringArg::Decode;
+};
+
+/** Formats the encoded arguments of one record: decodes them left to right,
+ *  then hands the decoded values to tinyformat. */
+template<typename... Rest>
+struct RecordDecoder;
+
+template<>
+struct RecordDecoder<>
+{
+    template<typename... Done>
+    static void Run(std::string& out, const char* fmt, const char*, const Done&... done)
+    {
+        tfm::vformat(out, fmt, tfm::makeFormatList(done...));
+    }
+};
+
+template<typename T, typename... Rest>
+struct RecordDecoder<T, Rest...>
+{
+    template<typename... Done>
+    static void Run(std::string& out, const char* fmt, const char* p, const Done&... done)
+    {
+        typename LogArg<T>::Decoded v;
+        p = LogArg<T>::Decode(p, v);
+        RecordDecoder<Rest...>::Run(out, fmt, p, done..., v);
+    }
+};
+
+template<typename... Args>
+void FormatRecord(std::string& out, const char* fmt, const char* args)
+{
+    RecordDecoder<Args...>::Run(out, fmt, args);
+}
+
+/** Unsigned LEB128: 7 bits per byte, low groups first */
+inline void WriteVarInt(std::string& out, uint64_t n)
+{
+    char buf[10];
+    size_t len = 0;
+    while (n >= 0x80) {
+        buf[len++] = static_cast<char>(n | 0x80);
+        n >>= 7;
+    }
+    buf[len++] = static_cast<char>(n);
+    out.append(buf, len);
+}
+
+/** Signed values are zigzag mapped first so that small negatives stay short */
+inline void WriteSignedVarInt(std::string& out, int64_t n)
+{
+    WriteVarInt(out, (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63));
+}
+
+/** Binary log encoding of a decoded argument.
+ *
+ * code identifies the C++ type, so the decoder can rebuild an argument of
+ * the same type and tinyformat prints it exactly as in text mode.  Types
+ * without an encoding have code '?' and their records are written as text.
+ */
+template<typename T, typename Enable = void>
+struct WireArg
+{
+    static const char code = '?';
+    static void Pack(std::string&, const T&) {}
+};
+
+#define NIULOG_WIRE_VARINT(type, c, write)                              \
+template<>                                                              \
+struct WireArg<type>                                                    \
+{                                                                       \
+    static const char code = c;                                         \
+    static void Pack(std::string& out, type v) { write(out, v); }       \
+};
+NIULOG_WIRE_VARINT(short, 's', WriteSignedVarInt)
+NIULOG_WIRE_VARINT(unsigned short, 'S', WriteVarInt)
+NIULOG_WIRE_VARINT(int, 'i', WriteSignedVarInt)
+NIULOG_WIRE_VARINT(unsigned int, 'I', WriteVarInt)
+NIULOG_WIRE_VARINT(long, 'l', WriteSignedVarInt)
+NIULOG_WIRE_VARINT(unsigned long, 'L', WriteVarInt)
+NIULOG_WIRE_VARINT(long long, 'q', WriteSignedVarInt)
+NIULOG_WIRE_VARINT(unsigned long long, 'Q', WriteVarInt)
+#undef NIULOG_WIRE_VARINT
+
+#define NIULOG_WIRE_RAW(type, c)                                        \
+template<>                                                              \
+struct WireArg<type>                                                    \
+{                                                                       \
+    static const char code = c;                                         \
+    static void Pack(std::string& out, const type& v)                   \
+    {                                                                   \
+        out.append(reinterpret_cast<const char*>(&v), sizeof(v));       \
+    }                                                                   \
+};
+NIULOG_WIRE_RAW(bool, 'b')
+NIULOG_WIRE_RAW(char, 'c')
+NIULOG_WIRE_RAW(signed char, 'y')
+NIULOG_WIRE_RAW(unsigned char, 'Y')
+NIULOG_WIRE_RAW(float, 'f')
+NIULOG_WIRE_RAW(double, 'd')
+#undef NIULOG_WIRE_RAW
+
+template<>
+struct WireArg<LogString>
+{
+    static const char code = 'z';
+    static void Pack(std::string& out, const LogString& v)
+    {
+        WriteVarInt(out, v.size);
+        out.append(v.data, v.size);
+    }
+};
+
+/** Blobs as their raw bytes, 32 for a uint256 */
+template<>
+struct WireArg<uint256>
+{
+    static const char code = 'h';
+    static void Pack(std::string& out, const uint256& v)
+    {
+        out.append(reinterpret_cast<const char*>(v.begin()), v.size());
+    }
+};
+
+template<>
+struct WireArg<uint160>
+{
+    static const char code = 'g';
+    static void Pack(std::string& out, const uint160& v)
+    {
+        out.append(reinterpret_cast<const char*>(v.begin()), v.size());
+    }
+};
+
+/** Unscoped enums print as their underlying integer */
+template<typename T>
+struct WireArg<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+    typedef typename std::underlying_type<T>::type Underlying;
+    static const char code = WireArg<Underlying>::code;
+    static void Pack(std::string& out, T v) { WireArg<Underlying>::Pack(out, static_cast<Underlying>(v)); }
+};
+
+template<typename... Rest>
+struct RecordPacker;
+
+template<>
+struct RecordPacker<>
+{
+    static void Run(std::string&, const char*) {}
+};
+
+template<typename T, typename... Rest>
+struct RecordPacker<T, Rest...>
+{
+    static void Run(std::string& out, const char* p)
+    {
+        typename LogArg<T>::Decoded v;
+        p = LogArg<T>::Decode(p, v);
+        WireArg<typename LogArg<T>::Decoded>::Pack(out, v);
+        RecordPacker<Rest...>::Run(out, p);
+    }
+};
+
+template<typename... Args>
+void PackRecord(std::string& out, const char* args)
+{
+    RecordPacker<Args...>::Run(out, args);
+}
+
+template<typename... Args>
+struct RecordTypeOf
+{
+    static const char signature[sizeof...(Args) + 1];
+    static const RecordType type;
+};
+
+template<typename... Args>
+const char RecordTypeOf<Args...>::signature[sizeof...(Args) + 1] = {
+    WireArg<typename LogArg<Args>::Decoded>::code..., '\0'
+};
+
+template<typename... Args>
+const RecordType RecordTypeOf<Args...>::type = {
+    &FormatRecord<Args...>, &PackRecord<Args...>, RecordTypeOf<Args...>::signature
+};
+
+inline size_t EncodedSize() { return 0; }
+
+template<typename T, typename... Rest>
+inline size_t EncodedSize(const T& v, const Rest&... rest)
+{
+    return LogArg<T>::Size(v) + EncodedSize(rest...);
+}
+
+inline char* EncodeArgs(char* p) { return p; }
+
+template<typename T, typename... Rest>
+inline char* EncodeArgs(char* p, const T& v, const Rest&... rest)
+{
+    return EncodeArgs(LogArg<T>::Encode(p, v), rest...);
+}
+
+struct LogOptions
+{
+    std::string file_path;                      //!< log file, "" for none
+    bool print_to_console = false;              //!< also write to stdout
+    uint64_t max_file_size = 10 * 1024 * 1024;  //!< rotate above this size, 0 never
+    unsigned int max_files = 5;                 //!< keep file_path.1 .. file_path.N
+    size_t ring_size = 1 << 20;                 //!< per-thread ring, power of two
+    unsigned int flush_interval_ms = 10;        //!< background thread poll interval
+    bool binary = false;                        //!< write the binary format of
+                                                //!< binarylog.h instead of text;
+                                                //!< print_to_console is ignored
+};
+
+/** Append the "2026-01-02T03:04:05.678901Z [net] " prefix of a text line */
+void AppendLogPrefix(std::string& buf, int64_t time_micros, uint32_t category);
+/** Append the text of a record.  A format string that does not match its
+ *  arguments gives "[format error: <reason>] <fmt>" instead of throwing. */
+void AppendLogText(std::string& buf, const RecordHeader& header);
+
+class Logger
+{
+public:
+    Logger();
+    ~Logger();
+
+    /** Open the outputs and start the background thread. Records logged
+     *  before Start() stay buffered in their rings. */
+    bool Start(const LogOptions& options);
+    /** Write everything logged so far, then stop the background thread */
+    void Stop();
+    /** Block until everything logged before the call is written */
+    void Flush();
+    /** Reopen the log file, e.g. after it was moved by logrotate */
+    void Reopen();
+
+    void EnableCategory(uint32_t flag) { m_categories.fetch_or(flag, std::memory_order_relaxed); }
+    void DisableCategory(uint32_t flag) { m_categories.fetch_and(~flag, std::memory_order_relaxed); }
+    bool WillLogCategory(uint32_t category) const
+    {
+        return (m_categories.load(std::memory_order_relaxed) & category) != 0;
+    }
+
+    /** Records dropped because a ring was full, summed over all threads */
+    uint64_t Dropped() const;
+
+    template<typename... Args>
+    void Log(uint32_t category, const char* fmt, const Args&... args)
+    {
+        const uint32_t size = (sizeof(RecordHeader) + EncodedSize(args...) + 7) & ~7u;
+        LogRing* ring = ThreadRing();
+        char* p = ring->Reserve(size);
+        if (!p) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        RecordHeader* header = reinterpret_cast<RecordHeader*>(p);
+        header->size = size;
+        header->category = category;
+        header->time_micros = NowMicros();
+        header->fmt = fmt;
+        header->type = &RecordTypeOf<Args...>::type;
+        EncodeArgs(p + sizeof(RecordHeader), args...);
+        ring->Commit(size);
+    }
+
+private:
+    struct Output;
+
+    static int64_t NowMicros();
+    LogRing* ThreadRing();
+    LogRing* RegisterThread();
+    void ThreadMain();
+    size_t WriteBatch(bool& rotate);
+
+    std::atomic<uint32_t> m_categories;
+    size_t m_ring_size;
+
+    mutable std::mutex m_rings_mutex;
+    std::vector<LogRing*> m_rings;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+    bool m_running;
+    bool m_reopen;
+    uint64_t m_flush_requested;
+    uint64_t m_flush_done;
+
+    LogOptions m_options;
+    Output* m_output;
+};
+
+/** The process-wide logger; never destroyed so that threads may log during shutdown */
+Logger& LogInstance();
+
+} // namespace NiuLog
+
+/** Formatting of captured values on the background thread.  Found by
+ *  argument dependent lookup through FormatSpec. */
+namespace tinyformat {
+namespace detail {
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const NiuLog::LogString& value)
+{
+    if (spec.ntrunc >= 0)
+        buf.append(value.data, (std::min)(static_cast<size_t>(spec.ntrunc), value.size));
+    else
+        appendPadded(buf, spec, value.data, value.size);
+}
+
+template<unsigned int BITS>
+inline void appendBlobHex(std::string& buf, const FormatSpec& spec, const base_blob<BITS>& value)
+{
+    static const char hexmap[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    const size_t start = buf.size();
+    buf.resize(start + BITS / 4);
+    char* out = &buf[start];
+    // Same byte order as GetHex(): most significant byte first
+    for (const unsigned char* p = value.end(); p != value.begin(); ) {
+        const unsigned char c = *--p;
+        *out++ = hexmap[c >> 4];
+        *out++ = hexmap[c & 15];
+    }
+    if (spec.ntrunc >= 0 && static_cast<size_t>(spec.ntrunc) < BITS / 4)
+        buf.resize(start + spec.ntrunc);
+    else
+        padToWidth(buf, start, spec, false);
+}
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const uint256& value)
+{
+    appendBlobHex(buf, spec, value);
+}
+
+inline void formatValueToBuffer(std::string& buf, const FormatSpec& spec, const uint160& value)
+{
+    appendBlobHex(buf, spec, value);
+}
+
+} // namespace detail
+} // namespace tinyformat
+
+// Stream formatting of the same values.  These are found by argument
+// dependent lookup, so they live in the namespaces of the value types.
+namespace NiuLog {
+
+inline void formatValue(std::ostream& out, const char*, const char*, int ntrunc, const LogString& value)
+{
+    out.write(value.data, ntrunc >= 0 ? (std::min)(static_cast<size_t>(ntrunc), value.size) : value.size);
+}
+
+} // namespace NiuLog
+
+inline void formatValue(std::ostream& out, const char*, const char*, int ntrunc, const uint256& value)
+{
+    const std::string hex = value.GetHex();
+    out.write(hex.data(), ntrunc >= 0 ? (std::min)(static_cast<size_t>(ntrunc), hex.size()) : hex.size());
+}
+
+inline void formatValue(std::ostream& out, const char*, const char*, int ntrunc, const uint160& value)
+{
+    const std::string hex = value.GetHex();
+    out.write(hex.data(), ntrunc >= 0 ? (std::min)(static_cast<size_t>(ntrunc), hex.size()) : hex.size());
+}
+
+/** Log unconditionally; the format string must be a literal */
+#define LogPrintf(...) NiuLog::LogInstance().Log(NiuLog::NONE, __VA_ARGS__)
+
+/** Log if the category is enabled; arguments are not evaluated otherwise */
+#define LogPrint(category, ...) do {                                    \
+    if (NiuLog::LogInstance().WillLogCategory(category)) {              \
+        NiuLog::LogInstance().Log(category, __VA_ARGS__);               \
+    }                                                                   \
+} while (0)
+
+#endif // NIUBLOCK_LOGGING_H
@@ -0,0 +1,194 @@
+#include "binarylog.h"
+#include "logging.h"
+#undef NDEBUG
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <unistd.h>
+
+static size_t CountLines(const std::string& path)
+{
+  std::ifstream f(path.c_str());
+  std::string line;
+  size_t n = 0;
+  while (std::getline(f, line))
+    n++;
+  return n;
+}
+
+int main()
+{
+  char dir[] = "/tmp/niulogXXXXXX";
+  const char* made = mkdtemp(dir);
+  assert(made);
+  const std::string path = std::string(dir) + "/debug.log";
+
+  NiuLog::LogOptions options;
+  options.file_path = path;
+  options.max_file_size = 0;
+  NiuLog::Logger& logger = NiuLog::LogInstance();
+  logger.EnableCategory(NiuLog::NET);
+  bool started = logger.Start(options);
+  assert(started);
+
+  uint256 hash = uint256S("000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+  std::string peer = "peer=7";
+  LogPrintf("UpdateTip: new best=%s height=%d %s\n", hash, 0, peer);
+  LogPrint(NiuLog::NET, "received: %s (%u bytes) %s\n", "version", 102u, std::string(40, 'x'));
+  LogPrint(NiuLog::MEMPOOL, "not logged %d\n", 1);
+  // Not enough arguments: the line says so and the logger thread lives on
+  LogPrintf("height=%d hash=%s\n", 5);
+  logger.Flush();
+  {
+    std::ifstream f(path.c_str());
+    std::string line;
+    std::getline(f, line);
+    assert(line.find("UpdateTip: new best=" + hash.GetHex() + " height=0 peer=7") != std::string::npos);
+    std::getline(f, line);
+    assert(line.find("[net] received: version (102 bytes) " + std::string(40, 'x')) != std::string::npos);
+    std::getline(f, line);
+    assert(line.find("[format error: ") != std::string::npos && line.find("] height=%d hash=%s") != std::string::npos);
+    const bool more = (bool)std::getline(f, line);
+    assert(!more);
+  }
+
+  // Several threads; every record must arrive exactly once
+  const int threads = 4, per_thread = 20000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([t] {
+      for (int i = 0; i < per_thread; i++)
+        LogPrintf("thread %d message %d %.3f\n", t, i, i * 0.5);
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  logger.Flush();
+  const size_t lines = CountLines(path);
+  assert(lines + logger.Dropped() == 3 + threads * per_thread);
+
+  // Call-site latency with the background thread draining
+  const uint64_t dropped = logger.Dropped();
+  const int rounds = 20, n = 5000;
+  double elapsed = 0;
+  for (int r = 0; r < rounds; r++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+      LogPrintf("UpdateTip: new best=%s height=%d\n", hash, i);
+    auto end = std::chrono::steady_clock::now();
+    elapsed += std::chrono::duration<double, std::nano>(end - start).count();
+    logger.Flush();
+  }
+  assert(logger.Dropped() == dropped);
+  std::cout << "log call: " << elapsed / (rounds * n) << " ns" << std::endl;
+  logger.Stop();
+
+  // Rotation keeps at most max_files old files
+  options.max_file_size = 4096;
+  options.max_files = 2;
+  started = logger.Start(options);
+  assert(started);
+  for (int i = 0; i < 1000; i++) {
+    LogPrintf("rotate %d\n", i);
+    if (i % 100 == 0)
+      logger.Flush();
+  }
+  logger.Flush();
+  logger.Stop();
+  assert(access((path + ".1").c_str(), F_OK) == 0);
+  assert(access((path + ".2").c_str(), F_OK) == 0);
+  assert(access((path + ".3").c_str(), F_OK) != 0);
+
+  // Binary mode decodes to the same text
+  const std::string bin_path = std::string(dir) + "/binary.log";
+  options = NiuLog::LogOptions();
+  options.file_path = bin_path;
+  options.binary = true;
+  started = logger.Start(options);
+  assert(started);
+  std::vector<std::string> expected;
+  for (int i = 0; i < 1000; i++) {
+    LogPrintf("UpdateTip: new best=%s height=%d log2_work=%.8g tx=%lu\n", hash, i, 85.1 + i, 1000000ul * i);
+    expected.push_back(strprintf("UpdateTip: new best=%s height=%d log2_work=%.8g tx=%lu\n", hash.GetHex(), i, 85.1 + i, 1000000ul * i));
+    LogPrint(NiuLog::NET, "%s: %5s|%-4d|%c|%x|%s\n", peer, "ab", -i, 'q', (short)-i, i % 2 == 0);
+    expected.push_back(strprintf("[net] %s: %5s|%-4d|%c|%x|%s\n", peer, "ab", -i, 'q', (short)-i, i % 2 == 0));
+    LogPrintf("no encoding %s\n", (long double)i);
+    expected.push_back(strprintf("no encoding %s\n", (long double)i));
+  }
+  // Sent as text since long double has no encoding, so formatted here
+  LogPrintf("no encoding %s %s\n", (long double)1);
+  logger.Flush();
+  logger.Stop();
+  {
+    std::ifstream f(bin_path.c_str(), std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    NiuLog::BinaryLogReader reader(data.data(), data.size());
+    std::string line;
+    size_t n = 0;
+    for (; reader.Next(line); line.clear(), n++) {
+      // "YYYY-MM-DDTHH:MM:SS.uuuuuuZ " then the message
+      assert(line.size() > 28 && line[27] == ' ');
+      if (n < expected.size())
+        assert(line.compare(28, std::string::npos, expected[n]) == 0);
+      else
+        assert(line.compare(28, 15, "[format error: ") == 0 && line.find("] no encoding %s %s\n") != std::string::npos);
+    }
+    assert(!reader.Failed() && n == expected.size() + 1);
+    // A truncated file decodes up to the cut and reports it
+    NiuLog::BinaryLogReader cut(data.data(), data.size() - 3);
+    while (cut.Next(line))
+      line.clear();
+    assert(cut.Failed());
+
+    // A record whose format string wants more arguments than its signature
+    // has fails at that record
+    std::string bad(1, NiuLog::BINLOG_SESSION);
+    bad.append(NiuLog::BINLOG_MAGIC, sizeof(NiuLog::BINLOG_MAGIC) - 1);
+    bad += std::string("\x01\x00\x01i\x05%d %s", 10);    // define 0: "i", "%d %s"
+    const size_t offset = bad.size();
+    bad += std::string("\x02\x00\x00\x00\x0a", 5);      // message 0
+    NiuLog::BinaryLogReader corrupt(bad.data(), bad.size());
+    line.clear();
+    const bool decoded = corrupt.Next(line);
+    assert(!decoded && corrupt.Failed());
+    assert(corrupt.ErrorOffset() == offset && corrupt.Error().find("format error: ") == 0);
+  }
+
+  // A logger destroyed while a thread that logged to it lives on; a new
+  // logger, perhaps at the same address, must give that thread a new ring
+  {
+    const std::string other_path = std::string(dir) + "/other.log";
+    std::atomic<int> step(0);
+    NiuLog::Logger* other = new NiuLog::Logger();
+    std::thread worker([&] {
+      other->Log(NiuLog::NONE, "first logger %d\n", 1);
+      step = 1;
+      while (step != 2)
+        std::this_thread::yield();
+      other->Log(NiuLog::NONE, "second logger %d\n", 2);
+    });
+    while (step != 1)
+      std::this_thread::yield();
+    delete other;
+    other = new NiuLog::Logger();
+    options = NiuLog::LogOptions();
+    options.file_path = other_path;
+    started = other->Start(options);
+    assert(started);
+    step = 2;
+    worker.join();
+    other->Flush();
+    delete other;
+    std::ifstream f(other_path.c_str());
+    std::string line;
+    bool more = (bool)std::getline(f, line);
+    assert(more && line.find("second logger 2") != std::string::npos);
+    more = (bool)std::getline(f, line);
+    assert(!more);
+  }
+  std::cout << "logging: ok" << std::endl;
+}
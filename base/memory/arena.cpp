@@ -0,0 +1,107 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "arena.h"
+
+namespace NiuMem {
+
+/** Chunks grow by doubling up to this size; larger requests get their own */
+static const size_t MAX_CHUNK_GROWTH = 1 << 20;
+
+Arena::Arena(MemTag tag, size_t first_chunk)
+    : m_tag(tag),
+      m_next_size(first_chunk),
+      m_chunks(nullptr),
+      m_pos(nullptr),
+      m_end(nullptr),
+      m_capacity(0),
+      m_used_before(0)
+{
+}
+
+Arena::~Arena()
+{
+    while (m_chunks) {
+        Chunk* next = m_chunks->next;
+        Release(m_chunks);
+        m_chunks = next;
+    }
+}
+
+void Arena::Release(Chunk* chunk)
+{
+    m_capacity -= chunk->size;
+    Deallocate(m_tag, chunk, chunk->size);
+}
+
+void* Arena::AllocateSlow(size_t size, size_t align)
+{
+    if (size > SIZE_MAX / 2)
+        throw std::bad_alloc();
+    size_t chunk_size = sizeof(Chunk) + size + align;
+    if (chunk_size < m_next_size)
+        chunk_size = m_next_size;
+    Chunk* chunk = static_cast<Chunk*>(NiuMem::Allocate(m_tag, chunk_size));
+    if (!chunk)
+        throw std::bad_alloc();
+    if (m_chunks)
+        m_used_before += m_pos - (unsigned char*)(m_chunks + 1);
+    chunk->next = m_chunks;
+    chunk->size = chunk_size;
+    m_chunks = chunk;
+    m_capacity += chunk_size;
+    m_pos = (unsigned char*)(chunk + 1);
+    m_end = (unsigned char*)chunk + chunk_size;
+    if (m_next_size < MAX_CHUNK_GROWTH)
+        m_next_size *= 2;
+    return Allocate(size, align);
+}
+
+void Arena::Reset()
+{
+    m_used_before = 0;
+    if (!m_chunks)
+        return;
+    if (m_chunks->next) {
+        // The last round needed several chunks; one chunk the size of all of
+        // them holds the same again without growing on every round
+        const size_t total = m_capacity;
+        Chunk* merged = static_cast<Chunk*>(NiuMem::Allocate(m_tag, total));
+        if (merged) {
+            while (m_chunks) {
+                Chunk* next = m_chunks->next;
+                Release(m_chunks);
+                m_chunks = next;
+            }
+            merged->next = nullptr;
+            merged->size = total;
+            m_chunks = merged;
+            m_capacity = total;
+        } else {
+            // Out of memory: settle for the largest chunk
+            Chunk* largest = m_chunks;
+            for (Chunk* c = m_chunks; c; c = c->next) {
+                if (c->size > largest->size)
+                    largest = c;
+            }
+            while (m_chunks) {
+                Chunk* next = m_chunks->next;
+                if (m_chunks != largest)
+                    Release(m_chunks);
+                m_chunks = next;
+            }
+            m_chunks = largest;
+            largest->next = nullptr;
+        }
+    }
+    m_pos = (unsigned char*)(m_chunks + 1);
+    m_end = (unsigned char*)m_chunks + m_chunks->size;
+}
+
+size_t Arena::Used() const
+{
+    return m_chunks ? m_used_before + (m_pos - (unsigned char*)(m_chunks + 1)) : 0;
+}
+
+} // namespace NiuMem
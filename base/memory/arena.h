@@ -0,0 +1,86 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_ARENA_H
+#define NIUBLOCK_ARENA_H
+
+#include "memaccount.h"
+
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+namespace NiuMem {
+
+/**
+ * Bump allocator for objects that die together, such as everything parsed
+ * out of one block.  Allocation moves a pointer; nothing is freed one by
+ * one.  Reset() drops every object at once and merges the chunks into one
+ * of their total size, so an arena reused for block after block stops
+ * calling malloc() once it has seen the largest block.  Chunks are
+ * accounted under the arena's tag.
+ *
+ * Only trivially destructible types go in, since no destructor ever runs.
+ */
+class Arena
+{
+public:
+    explicit Arena(MemTag tag = MEM_CHAIN, size_t first_chunk = 16 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /** align must be a power of two; throws std::bad_alloc like new */
+    void* Allocate(size_t size, size_t align = alignof(max_align_t))
+    {
+        const uintptr_t p = ((uintptr_t)m_pos + align - 1) & ~(uintptr_t)(align - 1);
+        if (p <= (uintptr_t)m_end && size <= (uintptr_t)m_end - p) {
+            m_pos = (unsigned char*)(p + size);
+            return (void*)p;
+        }
+        return AllocateSlow(size, align);
+    }
+
+    /** Uninitialised room for count objects of type T */
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        if (count > SIZE_MAX / sizeof(T))
+            throw std::bad_alloc();
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /** Forget every allocation, keep one chunk of Capacity() bytes */
+    void Reset();
+
+    /** Bytes handed out since the last Reset(), including alignment */
+    size_t Used() const;
+    /** Bytes held in chunks */
+    size_t Capacity() const { return m_capacity; }
+
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;    //!< including this header
+    };
+
+    void* AllocateSlow(size_t size, size_t align);
+    void Release(Chunk* chunk);
+
+    const MemTag m_tag;
+    size_t m_next_size;         //!< size of the next chunk, doubling
+    Chunk* m_chunks;            //!< newest first
+    unsigned char* m_pos;
+    unsigned char* m_end;
+    size_t m_capacity;
+    size_t m_used_before;       //!< bytes handed out in chunks other than the newest
+};
+
+} // namespace NiuMem
+
+#endif // NIUBLOCK_ARENA_H
@@ -0,0 +1,187 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "memaccount.h"
+
+#include "tinyformat.h"
+
+#include <atomic>
+#include <stdlib.h>
+
+namespace NiuMem {
+
+thread_local ThreadMemCounters g_thread_mem;
+
+namespace {
+
+struct GlobalUsage
+{
+    std::atomic<int64_t> bytes;
+    std::atomic<int64_t> peak;
+    std::atomic<uint64_t> allocs;
+    std::atomic<uint64_t> frees;
+};
+
+// Zero initialised before any constructor runs, so usable from operator new
+GlobalUsage g_usage[MEM_TAG_COUNT];
+
+const char* const TAG_NAMES[MEM_TAG_COUNT] = {"untagged", "chain", "script", "cache", "net", "log"};
+
+/** Flushes what is left of a thread's counts when the thread exits */
+struct ThreadExitFlush
+{
+    ~ThreadExitFlush()
+    {
+        for (int tag = 0; tag < MEM_TAG_COUNT; tag++)
+            FlushThread(MemTag(tag));
+        // Counts made after this point (by later thread_local destructors)
+        // are flushed right away
+        g_thread_mem.registered = false;
+    }
+};
+
+thread_local ThreadExitFlush g_exit_flush;
+
+} // namespace
+
+const char* MemTagName(MemTag tag)
+{
+    return tag < MEM_TAG_COUNT ? TAG_NAMES[tag] : "";
+}
+
+void RegisterThread()
+{
+    // Using the thread_local constructs it and queues its destructor
+    (void)&g_exit_flush;
+    g_thread_mem.registered = true;
+}
+
+void FlushThread(MemTag tag)
+{
+    ThreadMemCounters& c = g_thread_mem;
+    if (!c.registered) {
+        // First count of the thread.  Registering may allocate itself, and
+        // counts made while the thread exits must not register again, so
+        // both of those are flushed one by one.
+        static thread_local bool attempted = false;
+        if (!attempted) {
+            attempted = true;
+            RegisterThread();
+        }
+    }
+    GlobalUsage& g = g_usage[tag];
+    const int64_t bytes = g.bytes.fetch_add(c.bytes[tag], std::memory_order_relaxed) + c.bytes[tag];
+    int64_t peak = g.peak.load(std::memory_order_relaxed);
+    while (bytes > peak && !g.peak.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {}
+    g.allocs.fetch_add(c.allocs[tag], std::memory_order_relaxed);
+    g.frees.fetch_add(c.frees[tag], std::memory_order_relaxed);
+    c.bytes[tag] = c.allocs[tag] = c.frees[tag] = 0;
+}
+
+void* Allocate(MemTag tag, size_t size)
+{
+    void* p = malloc(size);
+    if (p)
+        RecordAlloc(tag, size);
+    return p;
+}
+
+void Deallocate(MemTag tag, void* p, size_t size)
+{
+    if (!p)
+        return;
+    free(p);
+    RecordFree(tag, size);
+}
+
+int64_t MemReport::TotalBytes() const
+{
+    int64_t total = 0;
+    for (int tag = 0; tag < MEM_TAG_COUNT; tag++)
+        total += tags[tag].bytes;
+    return total;
+}
+
+MemReport GetMemReport()
+{
+    for (int tag = 0; tag < MEM_TAG_COUNT; tag++)
+        FlushThread(MemTag(tag));
+    MemReport report;
+    for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+        const GlobalUsage& g = g_usage[tag];
+        report.tags[tag].bytes = g.bytes.load(std::memory_order_relaxed);
+        report.tags[tag].peak = g.peak.load(std::memory_order_relaxed);
+        report.tags[tag].allocs = g.allocs.load(std::memory_order_relaxed);
+        report.tags[tag].frees = g.frees.load(std::memory_order_relaxed);
+    }
+    return report;
+}
+
+int64_t PeakUsage(MemTag tag)
+{
+    FlushThread(tag);
+    return g_usage[tag].peak.load(std::memory_order_relaxed);
+}
+
+void ResetPeak(MemTag tag)
+{
+    FlushThread(tag);
+    g_usage[tag].peak.store(g_usage[tag].bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+std::string FormatMemReport(const MemReport& report)
+{
+    std::string out = strprintf("%-10s %14s %14s %12s %12s\n", "tag", "bytes", "peak", "allocs", "frees");
+    for (int tag = 0; tag < MEM_TAG_COUNT; tag++) {
+        const MemTagUsage& u = report.tags[tag];
+        out += strprintf("%-10s %14d %14d %12u %12u\n", TAG_NAMES[tag], u.bytes, u.peak, u.allocs, u.frees);
+    }
+    out += strprintf("%-10s %14d\n", "total", report.TotalBytes());
+    return out;
+}
+
+MemReporter::MemReporter()
+    : m_interval(0), m_running(false)
+{
+}
+
+MemReporter::~MemReporter()
+{
+    Stop();
+}
+
+void MemReporter::Start(std::chrono::milliseconds interval, std::function<void(const MemReport&)> sink)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+        return;
+    m_interval = interval;
+    m_sink = sink;
+    m_running = true;
+    m_thread = std::thread(&MemReporter::ThreadMain, this);
+}
+
+void MemReporter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+            return;
+        m_running = false;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+void MemReporter::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_cond.wait_for(lock, m_interval, [&] { return !m_running; })) {
+        lock.unlock();
+        m_sink(GetMemReport());
+        lock.lock();
+    }
+}
+
+} // namespace NiuMem
@@ -0,0 +1,161 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Memory accounting by subsystem.
+ *
+ * Every accounted allocation carries a MemTag.  Memory gets its tag in one
+ * of three ways:
+ *
+ *  - explicitly, through Allocate()/Deallocate() or a container using
+ *    TaggedAllocator (taggedallocator.h);
+ *  - from the innermost MemTagScope of the allocating thread, for code that
+ *    uses plain new, std::string or std::vector (libbitcoin's data_chunk,
+ *    transaction::list, GetHex() results).  This needs the global operator
+ *    new/delete of memhooks.cpp linked into the program;
+ *  - MEM_UNTAGGED for everything else the hooks see.
+ *
+ * Counting happens in plain thread-local counters.  A thread hands its
+ * counts to the global totals once they have moved by FLUSH_BYTES, and
+ * when it exits, so the totals and high-water marks are exact up to
+ * FLUSH_BYTES per thread and tag.  Memory freed on a different thread than
+ * the one that allocated it is accounted correctly: the freeing thread's
+ * counter goes negative.
+ */
+#ifndef NIUBLOCK_MEMACCOUNT_H
+#define NIUBLOCK_MEMACCOUNT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
+
+namespace NiuMem {
+
+enum MemTag : uint8_t {
+    MEM_UNTAGGED,
+    MEM_CHAIN,          //!< blocks, transactions, headers
+    MEM_SCRIPT,         //!< scripts and their operations
+    MEM_CACHE,          //!< UTXO, signature and other caches
+    MEM_NET,            //!< network buffers and messages
+    MEM_LOG,            //!< logging rings and output buffers
+    MEM_TAG_COUNT
+};
+
+/** Lower case name, e.g. "script" */
+const char* MemTagName(MemTag tag);
+
+/** Counts move to the global totals after this much change */
+static const int64_t FLUSH_BYTES = 64 * 1024;
+
+/** Not yet flushed counts of one thread. Plain data, so that it can be used
+ *  from operator new at any time, including during thread exit. */
+struct ThreadMemCounters
+{
+    int64_t bytes[MEM_TAG_COUNT];
+    int64_t allocs[MEM_TAG_COUNT];
+    int64_t frees[MEM_TAG_COUNT];
+    bool registered;
+    MemTag scope_tag;
+};
+
+extern thread_local ThreadMemCounters g_thread_mem;
+
+/** Slow paths of RecordAlloc()/RecordFree() */
+void FlushThread(MemTag tag);
+void RegisterThread();
+
+inline void RecordAlloc(MemTag tag, size_t size)
+{
+    ThreadMemCounters& c = g_thread_mem;
+    c.bytes[tag] += size;
+    c.allocs[tag]++;
+    if (!c.registered || c.bytes[tag] >= FLUSH_BYTES)
+        FlushThread(tag);
+}
+
+inline void RecordFree(MemTag tag, size_t size)
+{
+    ThreadMemCounters& c = g_thread_mem;
+    c.bytes[tag] -= size;
+    c.frees[tag]++;
+    if (!c.registered || c.bytes[tag] <= -FLUSH_BYTES)
+        FlushThread(tag);
+}
+
+/** malloc()/free() with accounting; size must match on both calls */
+void* Allocate(MemTag tag, size_t size);
+void Deallocate(MemTag tag, void* p, size_t size);
+
+/** Tag for untyped allocations of this thread while in scope */
+class MemTagScope
+{
+public:
+    explicit MemTagScope(MemTag tag) : m_prev(g_thread_mem.scope_tag) { g_thread_mem.scope_tag = tag; }
+    ~MemTagScope() { g_thread_mem.scope_tag = m_prev; }
+
+    MemTagScope(const MemTagScope&) = delete;
+    MemTagScope& operator=(const MemTagScope&) = delete;
+
+private:
+    MemTag m_prev;
+};
+
+inline MemTag CurrentMemTag()
+{
+    return g_thread_mem.scope_tag;
+}
+
+struct MemTagUsage
+{
+    int64_t bytes;      //!< currently allocated
+    int64_t peak;       //!< high-water mark of bytes since start or ResetPeak()
+    uint64_t allocs;
+    uint64_t frees;
+};
+
+struct MemReport
+{
+    MemTagUsage tags[MEM_TAG_COUNT];
+
+    int64_t TotalBytes() const;
+};
+
+/** Global totals, after flushing the calling thread */
+MemReport GetMemReport();
+/** High-water mark of one tag */
+int64_t PeakUsage(MemTag tag);
+/** Start a new high-water mark from the current usage */
+void ResetPeak(MemTag tag);
+/** Multi-line table of a report, one tag per line */
+std::string FormatMemReport(const MemReport& report);
+
+/** Calls a function with a fresh report at a fixed interval */
+class MemReporter
+{
+public:
+    MemReporter();
+    ~MemReporter();
+
+    void Start(std::chrono::milliseconds interval, std::function<void(const MemReport&)> sink);
+    void Stop();
+
+private:
+    void ThreadMain();
+
+    std::chrono::milliseconds m_interval;
+    std::function<void(const MemReport&)> m_sink;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_running;
+    std::thread m_thread;
+};
+
+} // namespace NiuMem
+
+#endif // NIUBLOCK_MEMACCOUNT_H
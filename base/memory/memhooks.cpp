@@ -0,0 +1,84 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Global operator new/delete that account every allocation to the
+ * MemTagScope active on the allocating thread.
+ *
+ * Opt-in: only programs that link this file (the niumem_hooks object
+ * library) are affected.  Each allocation carries a 16 byte header with its
+ * size and tag, so that delete can account it to the right tag from any
+ * thread.  The header keeps malloc()'s 16 byte alignment.
+ */
+
+#include "memaccount.h"
+
+#include <new>
+#include <stdlib.h>
+
+namespace {
+
+struct Header
+{
+    size_t size;
+    NiuMem::MemTag tag;
+};
+
+static const size_t HEADER_SIZE = 16;
+static_assert(sizeof(Header) <= HEADER_SIZE, "header does not fit");
+
+void* HookedAlloc(size_t size) noexcept
+{
+    if (size > size_t(-1) - HEADER_SIZE)
+        return nullptr;
+    for (;;) {
+        void* raw = malloc(size + HEADER_SIZE);
+        if (raw) {
+            Header* header = static_cast<Header*>(raw);
+            header->size = size;
+            header->tag = NiuMem::CurrentMemTag();
+            NiuMem::RecordAlloc(header->tag, size);
+            return static_cast<char*>(raw) + HEADER_SIZE;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            return nullptr;
+        try {
+            handler();
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+void* HookedAllocOrThrow(size_t size)
+{
+    void* p = HookedAlloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void HookedFree(void* p) noexcept
+{
+    if (!p)
+        return;
+    Header* header = reinterpret_cast<Header*>(static_cast<char*>(p) - HEADER_SIZE);
+    NiuMem::RecordFree(header->tag, header->size);
+    free(header);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return HookedAllocOrThrow(size); }
+void* operator new[](size_t size) { return HookedAllocOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return HookedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return HookedAlloc(size); }
+
+void operator delete(void* p) noexcept { HookedFree(p); }
+void operator delete[](void* p) noexcept { HookedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { HookedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { HookedFree(p); }
+void operator delete(void* p, size_t) noexcept { HookedFree(p); }
+void operator delete[](void* p, size_t) noexcept { HookedFree(p); }
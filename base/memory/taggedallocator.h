@@ -0,0 +1,77 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_TAGGEDALLOCATOR_H
+#define NIUBLOCK_TAGGEDALLOCATOR_H
+
+#include "memaccount.h"
+
+#include <limits>
+#include <new>
+#include <stddef.h>
+
+namespace NiuMem {
+
+/**
+ * Standard allocator that accounts its memory to a fixed tag, independent
+ * of any MemTagScope and of whether memhooks.cpp is linked in:
+ *
+ *   std::vector<uint8_t, TaggedAllocator<uint8_t, MEM_SCRIPT>> bytes;
+ *   std::unordered_map<K, V, H, std::equal_to<K>,
+ *       TaggedAllocator<std::pair<const K, V>, MEM_CACHE>> cache;
+ */
+template<typename T, MemTag Tag>
+class TaggedAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    // Needed explicitly because of the non-type template parameter
+    template<typename U>
+    struct rebind
+    {
+        typedef TaggedAllocator<U, Tag> other;
+    };
+
+    TaggedAllocator() noexcept {}
+    template<typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_alloc();
+        void* p = Allocate(Tag, n * sizeof(T));
+        if (!p)
+            throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        Deallocate(Tag, p, n * sizeof(T));
+    }
+};
+
+template<typename T, typename U, MemTag Tag>
+bool operator==(const TaggedAllocator<T, Tag>&, const TaggedAllocator<U, Tag>&) noexcept
+{
+    return true;
+}
+
+template<typename T, typename U, MemTag Tag>
+bool operator!=(const TaggedAllocator<T, Tag>&, const TaggedAllocator<U, Tag>&) noexcept
+{
+    return false;
+}
+
+} // namespace NiuMem
+
+#endif // NIUBLOCK_TAGGEDALLOCATOR_H
@@ -0,0 +1,141 @@
+#include "arena.h"
+#include "memaccount.h"
+#include "taggedallocator.h"
+#undef NDEBUG
+#include <assert.h>
+#include <atomic>
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace NiuMem;
+
+static int64_t Bytes(MemTag tag)
+{
+  return GetMemReport().tags[tag].bytes;
+}
+
+int main()
+{
+  // Untyped allocations follow the innermost scope
+  const int64_t script0 = Bytes(MEM_SCRIPT);
+  const int64_t chain0 = Bytes(MEM_CHAIN);
+  std::vector<char>* chunk;
+  std::string* hex;
+  {
+    MemTagScope chain(MEM_CHAIN);
+    chunk = new std::vector<char>(1000);
+    {
+      MemTagScope script(MEM_SCRIPT);
+      hex = new std::string(500, 'a');
+    }
+  }
+  assert(CurrentMemTag() == MEM_UNTAGGED);
+  assert(Bytes(MEM_CHAIN) == chain0 + int64_t(sizeof(std::vector<char>) + 1000));
+  assert(Bytes(MEM_SCRIPT) >= script0 + 500 + int64_t(sizeof(std::string)));
+  // Freed outside any scope, still taken off the tag it was allocated under
+  delete chunk;
+  delete hex;
+  assert(Bytes(MEM_CHAIN) == chain0 && Bytes(MEM_SCRIPT) == script0);
+  std::cout << "scopes: ok" << std::endl;
+
+  // Explicitly tagged containers ignore the scope
+  const MemReport before = GetMemReport();
+  {
+    MemTagScope net(MEM_NET);
+    std::vector<uint64_t, TaggedAllocator<uint64_t, MEM_CACHE>> cache;
+    cache.reserve(1000);
+    assert(Bytes(MEM_CACHE) == before.tags[MEM_CACHE].bytes + 8000);
+    assert(Bytes(MEM_NET) == before.tags[MEM_NET].bytes);
+  }
+  const MemReport after = GetMemReport();
+  assert(after.tags[MEM_CACHE].bytes == before.tags[MEM_CACHE].bytes);
+  assert(after.tags[MEM_CACHE].allocs == before.tags[MEM_CACHE].allocs + 1);
+  assert(after.tags[MEM_CACHE].frees == before.tags[MEM_CACHE].frees + 1);
+  std::cout << "tagged allocator: ok" << std::endl;
+
+  // Allocated on worker threads, freed here; flushed when the workers exit
+  const int64_t net0 = Bytes(MEM_NET);
+  std::vector<char*> buffers(4);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; t++) {
+    workers.emplace_back([&buffers, t] {
+      MemTagScope net(MEM_NET);
+      buffers[t] = new char[10000];
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  assert(Bytes(MEM_NET) == net0 + 40000);
+  for (char* b : buffers)
+    delete[] b;
+  assert(Bytes(MEM_NET) == net0);
+  std::cout << "threads: ok" << std::endl;
+
+  // High-water mark
+  ResetPeak(MEM_CHAIN);
+  const int64_t base = PeakUsage(MEM_CHAIN);
+  {
+    MemTagScope chain(MEM_CHAIN);
+    std::vector<char> a(1 << 20), b(1 << 19);
+  }
+  assert(PeakUsage(MEM_CHAIN) >= base + (1 << 20) + (1 << 19));
+  ResetPeak(MEM_CHAIN);
+  assert(PeakUsage(MEM_CHAIN) == Bytes(MEM_CHAIN));
+  std::cout << "peak: ok" << std::endl;
+
+  // An arena hands out aligned memory from few chunks and merges them on Reset()
+  {
+    const int64_t cache0 = Bytes(MEM_CACHE);
+    Arena arena(MEM_CACHE, 1024);
+    assert(arena.Used() == 0 && arena.Capacity() == 0);
+    char* c = arena.AllocateArray<char>(3);
+    uint64_t* u = arena.AllocateArray<uint64_t>(10);
+    assert((uintptr_t)u % alignof(uint64_t) == 0 && (char*)u >= c + 3);
+    assert(arena.Used() >= 83 && arena.Capacity() == 1024);
+    for (int i = 0; i < 100; i++)
+      memset(arena.AllocateArray<char>(100), i, 100);
+    char* big = arena.AllocateArray<char>(100000);
+    memset(big, 1, 100000);
+    assert(arena.Used() >= 110083);
+    assert(Bytes(MEM_CACHE) == cache0 + (int64_t)arena.Capacity());
+    const size_t largest = arena.Capacity();
+    arena.Reset();
+    assert(arena.Used() == 0 && arena.Capacity() == largest);
+    assert(Bytes(MEM_CACHE) == cache0 + (int64_t)largest);
+    // the same allocations again fit the merged chunk
+    arena.AllocateArray<char>(3);
+    arena.AllocateArray<uint64_t>(10);
+    for (int i = 0; i < 100; i++)
+      arena.AllocateArray<char>(100);
+    arena.AllocateArray<char>(100000);
+    assert(arena.Capacity() == largest);
+    arena.Reset();
+    assert(arena.Capacity() == largest);
+    bool threw = false;
+    try {
+      arena.AllocateArray<uint64_t>(SIZE_MAX / 4);
+    } catch (const std::bad_alloc&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+  std::cout << "arena: ok" << std::endl;
+
+  // Periodic reports
+  std::atomic<int> reports(0);
+  MemReporter reporter;
+  reporter.Start(std::chrono::milliseconds(5), [&reports](const MemReport& report) {
+    assert(report.tags[MEM_CHAIN].peak >= report.tags[MEM_CHAIN].bytes);
+    reports++;
+  });
+  while (reports < 3)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  reporter.Stop();
+  const std::string table = FormatMemReport(GetMemReport());
+  assert(table.find("\nscript ") != std::string::npos && table.find("\ntotal ") != std::string::npos);
+  std::cout << table;
+  std::cout << "reporter: ok" << std::endl;
+}
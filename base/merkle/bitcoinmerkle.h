@@ -0,0 +1,47 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * ComputeMerkleRoot() for libbitcoin blocks, in place of
+ *
+ *   block.generate_merkle_root()       -> BlockMerkleRoot(block)
+ *   block.is_valid_merkle_root()       -> CheckMerkleRoot(block)
+ *
+ * libbitcoin hashes one pair at a time and does not detect mutated
+ * transaction lists; CheckMerkleRoot() rejects those as internal_duplicate.
+ */
+#ifndef NIUBLOCK_BITCOINMERKLE_H
+#define NIUBLOCK_BITCOINMERKLE_H
+
+#include "merkle.h"
+
+#include <bitcoin/bitcoin.hpp>
+#include <string.h>
+
+/** hash_digest and uint256 hold the same bytes in the same order */
+inline bc::hash_digest BlockMerkleRoot(const bc::chain::block& block, bool* mutated = nullptr)
+{
+    const bc::chain::transaction::list& txs = block.transactions();
+    std::vector<uint256> hashes(txs.size());
+    for (size_t i = 0; i < txs.size(); i++) {
+        const bc::hash_digest hash = txs[i].hash();
+        memcpy(hashes[i].begin(), hash.data(), hash.size());
+    }
+    const uint256 root = ComputeMerkleRoot(std::move(hashes), mutated);
+    bc::hash_digest out;
+    memcpy(out.data(), root.begin(), out.size());
+    return out;
+}
+
+inline bc::code CheckMerkleRoot(const bc::chain::block& block)
+{
+    bool mutated;
+    if (BlockMerkleRoot(block, &mutated) != block.header().merkle())
+        return bc::error::merkle_mismatch;
+    if (mutated)
+        return bc::error::internal_duplicate;
+    return bc::error::success;
+}
+
+#endif // NIUBLOCK_BITCOINMERKLE_H
@@ -0,0 +1,4 @@
+#!/bin/sh
+
+cd ../crypto && sh build.sh && cd ../merkle
+g++  -std=c++11 -O2  test.cpp merkle.cpp merkletree.cpp ../crypto/sha256*.o ../big_int/uint256.cpp ../big_int/utilstrencodings.cpp  -I ./ -I ../crypto -I ../big_int
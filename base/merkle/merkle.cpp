@@ -0,0 +1,32 @@
+// Copyright (c) 2015-2017 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "merkle.h"
+
+#include "sha256.h"
+
+static_assert(sizeof(uint256) == 32, "levels are hashed in place as packed 32 byte hashes");
+
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated)
+{
+    bool mutation = false;
+    while (hashes.size() > 1) {
+        if (mutated) {
+            for (size_t pos = 0; pos + 1 < hashes.size(); pos += 2) {
+                if (hashes[pos] == hashes[pos + 1])
+                    mutation = true;
+            }
+        }
+        if (hashes.size() & 1)
+            hashes.push_back(hashes.back());
+        SHA256D64(hashes[0].begin(), hashes[0].begin(), hashes.size() / 2);
+        hashes.resize(hashes.size() / 2);
+    }
+    if (mutated)
+        *mutated = mutation;
+    if (hashes.size() == 0)
+        return uint256();
+    return hashes[0];
+}
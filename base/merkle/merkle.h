@@ -0,0 +1,30 @@
+// Copyright (c) 2015-2017 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_MERKLE_H
+#define NIUBLOCK_MERKLE_H
+
+#include "uint256.h"
+
+#include <vector>
+
+/*
+ * The merkle root of a list of hashes (the txids of a block), the way
+ * Bitcoin computes it: each level hashes adjacent pairs with double
+ * SHA256, and a level of odd length pairs its last hash with itself.
+ *
+ * That last rule lets two different transaction lists have the same root
+ * (CVE-2012-2459): repeating the trailing transactions of a block, or of any
+ * subtree, keeps the root.  Such a block must be rejected without marking
+ * the header invalid, since the unmutated block with the same header may be
+ * valid.  *mutated reports whether any level contains two identical
+ * adjacent hashes, which is exactly when a list is such a repetition.
+ *
+ * All pairs of a level are hashed in one SHA256D64() call, so they run
+ * through the widest SIMD kernel the CPU has, see sha256.h.
+ */
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated = nullptr);
+
+#endif // NIUBLOCK_MERKLE_H
@@ -0,0 +1,134 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "merkletree.h"
+
+#include "sha256.h"
+
+#include <assert.h>
+#include <string.h>
+
+static_assert(sizeof(uint256) == 32, "levels are hashed as packed 32 byte hashes");
+
+/** Double SHA256 of left || right */
+static uint256 HashPair(const uint256& left, const uint256& right)
+{
+    unsigned char pair[64];
+    memcpy(pair, left.begin(), 32);
+    memcpy(pair + 32, right.begin(), 32);
+    uint256 out;
+    SHA256D64(out.begin(), pair, 1);
+    return out;
+}
+
+MerkleTree::MerkleTree()
+    : m_levels(1)
+{
+}
+
+MerkleTree::MerkleTree(std::vector<uint256> leaves)
+    : m_levels(1)
+{
+    Assign(std::move(leaves));
+}
+
+void MerkleTree::Assign(std::vector<uint256> leaves)
+{
+    m_levels.resize(1);
+    m_levels[0] = std::move(leaves);
+    Rehash(0, Size());
+}
+
+void MerkleTree::Update(size_t index, const uint256& leaf)
+{
+    assert(index < Size());
+    m_levels[0][index] = leaf;
+    Rehash(index, index + 1);
+}
+
+void MerkleTree::Append(const uint256& leaf)
+{
+    m_levels[0].push_back(leaf);
+    Rehash(Size() - 1, Size());
+}
+
+void MerkleTree::Append(const std::vector<uint256>& leaves)
+{
+    const size_t begin = Size();
+    m_levels[0].insert(m_levels[0].end(), leaves.begin(), leaves.end());
+    Rehash(begin, Size());
+}
+
+void MerkleTree::Truncate(size_t count)
+{
+    assert(count <= Size());
+    m_levels[0].resize(count);
+    // The new last leaf may have lost its sibling
+    Rehash(count ? count - 1 : 0, count);
+}
+
+uint256 MerkleTree::Root() const
+{
+    if (m_levels[0].empty())
+        return uint256();
+    return m_levels.back()[0];
+}
+
+void MerkleTree::Rehash(size_t begin, size_t end)
+{
+    size_t level = 1;
+    for (; m_levels[level - 1].size() > 1; level++) {
+        if (m_levels.size() == level)
+            m_levels.emplace_back();
+        const std::vector<uint256>& below = m_levels[level - 1];
+        std::vector<uint256>& nodes = m_levels[level];
+        nodes.resize((below.size() + 1) / 2);
+
+        // Parents of [begin, end)
+        begin /= 2;
+        end = (end + 1) / 2;
+        if (end > nodes.size())
+            end = nodes.size();
+        // Full pairs are adjacent in memory, so a range is one call
+        const size_t pairs = below.size() / 2;
+        const size_t full_end = end < pairs ? end : pairs;
+        if (begin < full_end)
+            SHA256D64(nodes[begin].begin(), below[2 * begin].begin(), full_end - begin);
+        // An odd level pairs its last node with itself
+        if (end > pairs)
+            nodes[pairs] = HashPair(below.back(), below.back());
+    }
+    m_levels.resize(level);
+}
+
+std::vector<uint256> MerkleTree::Branch(size_t index) const
+{
+    assert(index < Size());
+    std::vector<uint256> branch;
+    for (size_t level = 0; level + 1 < m_levels.size(); level++, index /= 2) {
+        const std::vector<uint256>& nodes = m_levels[level];
+        branch.push_back(nodes[(index ^ 1) < nodes.size() ? index ^ 1 : index]);
+    }
+    return branch;
+}
+
+uint256 MerkleTree::RootFromBranch(uint256 leaf, const std::vector<uint256>& branch, size_t index)
+{
+    for (const uint256& sibling : branch) {
+        leaf = (index & 1) ? HashPair(sibling, leaf) : HashPair(leaf, sibling);
+        index >>= 1;
+    }
+    return leaf;
+}
+
+bool MerkleTree::Mutated() const
+{
+    for (const std::vector<uint256>& nodes : m_levels) {
+        for (size_t pos = 0; pos + 1 < nodes.size(); pos += 2) {
+            if (nodes[pos] == nodes[pos + 1])
+                return true;
+        }
+    }
+    return false;
+}
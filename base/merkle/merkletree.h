@@ -0,0 +1,77 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_MERKLETREE_H
+#define NIUBLOCK_MERKLETREE_H
+
+#include "uint256.h"
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * A merkle tree that keeps every interior level, for lists that change a
+ * little at a time: a block template whose coinbase is rewritten with each
+ * extra nonce, and whose tail grows and shrinks as the mempool changes.
+ *
+ * Changing or appending k leaves at position p rehashes only the nodes
+ * above [p, p + k), about k + log2(n) hashes instead of the n of
+ * ComputeMerkleRoot(); a coinbase update of a 10,000 transaction template
+ * is 14 hashes.  The tree is laid out level by level, so each level's
+ * dirty range is hashed with one SHA256D64() call.
+ *
+ * The roots agree with ComputeMerkleRoot(), including the duplication of
+ * the last node of odd levels.
+ */
+class MerkleTree
+{
+public:
+    MerkleTree();
+    explicit MerkleTree(std::vector<uint256> leaves);
+
+    /** Replace all leaves */
+    void Assign(std::vector<uint256> leaves);
+    /** Replace one leaf, e.g. the coinbase at 0 */
+    void Update(size_t index, const uint256& leaf);
+    void Append(const uint256& leaf);
+    void Append(const std::vector<uint256>& leaves);
+    /** Drop leaves from the end until size() is count */
+    void Truncate(size_t count);
+    /** Drop the last leaf; false, and nothing done, if there is none */
+    bool RemoveLast()
+    {
+        if (Size() == 0)
+            return false;
+        Truncate(Size() - 1);
+        return true;
+    }
+
+    size_t Size() const { return m_levels[0].size(); }
+    const uint256& Leaf(size_t index) const { return m_levels[0][index]; }
+    /** Null for an empty tree */
+    uint256 Root() const;
+
+    /** Levels including the leaves (level 0) and the root */
+    size_t Height() const { return m_levels.size(); }
+    size_t Width(size_t level) const { return m_levels[level].size(); }
+    /** Interior node, e.g. for BIP37 partial merkle trees */
+    const uint256& Node(size_t level, size_t index) const { return m_levels[level][index]; }
+
+    /** Siblings on the path from a leaf to the root, lowest first */
+    std::vector<uint256> Branch(size_t index) const;
+    /** The root a branch from Branch() leads to */
+    static uint256 RootFromBranch(uint256 leaf, const std::vector<uint256>& branch, size_t index);
+
+    /** Whether any level has two identical siblings, see ComputeMerkleRoot() */
+    bool Mutated() const;
+
+private:
+    /** Recompute the nodes above leaves [begin, end) and fit the levels to
+     *  the number of leaves */
+    void Rehash(size_t begin, size_t end);
+
+    std::vector<std::vector<uint256>> m_levels;
+};
+
+#endif // NIUBLOCK_MERKLETREE_H
@@ -0,0 +1,149 @@
+#include "merkle.h"
+#include "merkletree.h"
+#include "sha256.h"
+#include <algorithm>
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <vector>
+
+/** One pair at a time with the plain hasher, as libbitcoin does */
+static uint256 ReferenceRoot(std::vector<uint256> hashes)
+{
+  if (hashes.empty())
+    return uint256();
+  while (hashes.size() > 1) {
+    if (hashes.size() & 1)
+      hashes.push_back(hashes.back());
+    std::vector<uint256> next(hashes.size() / 2);
+    for (size_t i = 0; i < next.size(); i++) {
+      uint256 once;
+      CSHA256().Write(hashes[2 * i].begin(), 32).Write(hashes[2 * i + 1].begin(), 32).Finalize(once.begin());
+      CSHA256().Write(once.begin(), 32).Finalize(next[i].begin());
+    }
+    hashes.swap(next);
+  }
+  return hashes[0];
+}
+
+static std::vector<uint256> Leaves(size_t count)
+{
+  std::vector<uint256> leaves(count);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t seed = uint32_t(i * 2654435761u + 1);
+    for (unsigned char* p = leaves[i].begin(); p != leaves[i].end(); p++) {
+      seed = seed * 1103515245 + 12345;
+      *p = seed >> 24;
+    }
+  }
+  return leaves;
+}
+
+int main()
+{
+  // Block 100000
+  const std::vector<uint256> block100000 = {
+    uint256S("8c14f0db3df150123e6f3dbbf30f8b955a8249b62ac1d1ff16284aefa3d06d87"),
+    uint256S("fff2525b8931402dd09222c50775608f75787bd2b87e56995a7bdd30f79702c4"),
+    uint256S("6359f0868171b1d194cbee1af2f16ea598ae8fad666d9b012c8ed2b79a236ec4"),
+    uint256S("e9a66845e05d5abc0ad04ec80f774a7e585c6e8db975962d069a522137b80c1d"),
+  };
+  bool mutated = true;
+  uint256 root = ComputeMerkleRoot(block100000, &mutated);
+  assert(root.GetHex() == "f3e94742aca4b5ef85488dc37c06c3282295ffec960994b2c0d5ac2a25a95766");
+  assert(!mutated);
+  assert(ComputeMerkleRoot(std::vector<uint256>()).IsNull());
+  assert(ComputeMerkleRoot(Leaves(1)) == Leaves(1)[0]);
+
+  const sha256_implementation::UseImplementation uses[] = {
+    sha256_implementation::STANDARD, sha256_implementation::USE_ALL,
+  };
+  for (sha256_implementation::UseImplementation use : uses) {
+    const std::string name = SHA256AutoDetect(use);
+    for (size_t count = 0; count <= 70; count++) {
+      root = ComputeMerkleRoot(Leaves(count), &mutated);
+      assert(root == ReferenceRoot(Leaves(count)) && !mutated);
+    }
+    assert(ComputeMerkleRoot(Leaves(2000)) == ReferenceRoot(Leaves(2000)));
+    assert(ComputeMerkleRoot(Leaves(10000)) == ReferenceRoot(Leaves(10000)));
+    std::cout << "merkle " << name << ": ok" << std::endl;
+  }
+
+  // CVE-2012-2459: repeating trailing hashes keeps the root but is flagged
+  std::vector<uint256> three = Leaves(3);
+  std::vector<uint256> four = three;
+  four.push_back(three[2]);
+  root = ComputeMerkleRoot(three, &mutated);
+  assert(root == ComputeMerkleRoot(four) && !mutated);
+  ComputeMerkleRoot(four, &mutated);
+  assert(mutated);
+
+  // Repeating a whole subtree, found on the level above the leaves
+  std::vector<uint256> six = Leaves(6);
+  std::vector<uint256> eight = six;
+  eight.push_back(six[4]);
+  eight.push_back(six[5]);
+  root = ComputeMerkleRoot(six, &mutated);
+  assert(root == ComputeMerkleRoot(eight) && !mutated);
+  ComputeMerkleRoot(eight, &mutated);
+  assert(mutated);
+
+  // Equal hashes that are not siblings are no mutation
+  std::vector<uint256> apart = Leaves(4);
+  apart[2] = apart[1];
+  ComputeMerkleRoot(apart, &mutated);
+  assert(!mutated);
+  apart[3] = apart[2];
+  ComputeMerkleRoot(apart, &mutated);
+  assert(mutated);
+  std::cout << "mutation: ok" << std::endl;
+
+  // The incremental tree agrees with a full recomputation after every edit
+  MerkleTree tree;
+  std::vector<uint256> leaves;
+  assert(tree.Root().IsNull() && tree.Size() == 0);
+  const std::vector<uint256> pool = Leaves(300);
+  uint32_t rng = 1;
+  for (int step = 0; step < 600; step++) {
+    rng = rng * 1103515245 + 12345;
+    const uint32_t r = rng >> 16;
+    const uint256& leaf = pool[r % pool.size()];
+    if (r % 5 < 2 || leaves.empty()) {
+      tree.Append(leaf);
+      leaves.push_back(leaf);
+    } else if (r % 5 == 2) {
+      const std::vector<uint256> more(pool.begin() + r % 50, pool.begin() + r % 50 + r % 7);
+      tree.Append(more);
+      leaves.insert(leaves.end(), more.begin(), more.end());
+    } else if (r % 5 == 3) {
+      const size_t index = r % leaves.size();
+      tree.Update(index, leaf);
+      leaves[index] = leaf;
+    } else {
+      const size_t count = leaves.size() - (r % 3 == 0 ? 1 : r % std::min<size_t>(leaves.size() + 1, 9));
+      tree.Truncate(count);
+      leaves.resize(count);
+    }
+    bool expect_mutated;
+    const uint256 expect = ComputeMerkleRoot(leaves, &expect_mutated);
+    assert(tree.Size() == leaves.size());
+    assert(tree.Root() == expect && tree.Mutated() == expect_mutated);
+  }
+  tree.Assign(Leaves(1000));
+  assert(tree.Root() == ComputeMerkleRoot(Leaves(1000)) && tree.Height() == 11);
+  for (size_t index : {0, 1, 511, 998, 999}) {
+    const std::vector<uint256> branch = tree.Branch(index);
+    assert(branch.size() == 10);
+    assert(MerkleTree::RootFromBranch(tree.Leaf(index), branch, index) == tree.Root());
+    assert(MerkleTree::RootFromBranch(tree.Leaf(index), branch, index ^ 1) != tree.Root());
+  }
+  tree.Truncate(1);
+  assert(tree.Root() == tree.Leaf(0) && tree.Height() == 1 && tree.Branch(0).empty());
+  bool removed = tree.RemoveLast();
+  assert(removed && tree.Size() == 0 && tree.Root().IsNull());
+  removed = tree.RemoveLast();
+  assert(!removed && tree.Size() == 0 && tree.Root().IsNull());
+  tree.Append(Leaves(3));
+  assert(tree.Root() == ComputeMerkleRoot(Leaves(3)));
+  std::cout << "incremental tree: ok" << std::endl;
+}
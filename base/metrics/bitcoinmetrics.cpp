@@ -0,0 +1,126 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bitcoinmetrics.h"
+
+#include <bitcoin/bitcoin/log/statsd_sink.hpp>
+#include <bitcoin/bitcoin/log/statsd_source.hpp>
+
+#include <math.h>
+#include <vector>
+
+namespace NiuMetrics {
+
+/** Microseconds from start to end, or -1 if either was never set */
+static int64_t Elapsed(const bc::asio::time_point& start, const bc::asio::time_point& end)
+{
+    const bc::asio::time_point unset;
+    if (start == unset || end == unset || end < start)
+        return -1;
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+BlockTimings TimingsFromBlock(const bc::chain::block& block, bool bip16_active)
+{
+    const auto& v = block.validation;
+    const bc::asio::time_point unset;
+    BlockTimings timings;
+    timings.micros[PHASE_DESERIALIZE] = Elapsed(v.start_deserialize, v.end_deserialize);
+    timings.micros[PHASE_CHECK] = Elapsed(v.start_check, v.start_populate);
+    timings.micros[PHASE_POPULATE] = Elapsed(v.start_populate, v.start_accept);
+    timings.micros[PHASE_ACCEPT] = Elapsed(v.start_accept, v.start_connect);
+    timings.micros[PHASE_CONNECT] = Elapsed(v.start_connect, v.start_notify);
+    // Notify runs until the old branch is popped, or straight into push
+    timings.micros[PHASE_NOTIFY] = Elapsed(v.start_notify, v.start_pop != unset ? v.start_pop : v.start_push);
+    timings.micros[PHASE_POP] = Elapsed(v.start_pop, v.start_push);
+    timings.micros[PHASE_PUSH] = Elapsed(v.start_push, v.end_push);
+    timings.inputs = block.total_inputs();
+    timings.sigops = block.signature_operations(bip16_active);
+    timings.cache_efficiency = v.cache_efficiency;
+    return timings;
+}
+
+StatsdExporter::StatsdExporter(MetricsRegistry& registry, std::chrono::milliseconds interval)
+    : m_registry(registry), m_interval(interval), m_running(false)
+{
+}
+
+StatsdExporter::~StatsdExporter()
+{
+    Stop();
+}
+
+void StatsdExporter::Start(bc::threadpool& pool, const bc::config::authority& server)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+        return;
+    bc::log::initialize_statsd(pool, server);
+    m_running = true;
+    m_thread = std::thread(&StatsdExporter::ThreadMain, this);
+}
+
+void StatsdExporter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+            return;
+        m_running = false;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+    Push();
+}
+
+void StatsdExporter::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        if (m_cond.wait_for(lock, m_interval, [&] { return !m_running; }))
+            break;
+        lock.unlock();
+        Push();
+        lock.lock();
+    }
+}
+
+/** name.value1.value2 from name and a label set such as a="x",b="0.5" */
+static std::string StatsdKey(const MetricSample& sample)
+{
+    std::string key = sample.name;
+    bool quoted = false;
+    for (char c : sample.labels) {
+        if (c == '"') {
+            quoted = !quoted;
+            if (quoted)
+                key += '.';
+        } else if (quoted) {
+            key += c == '.' ? '_' : c;
+        }
+    }
+    return key;
+}
+
+void StatsdExporter::Push()
+{
+    std::lock_guard<std::mutex> lock(m_push_mutex);
+    std::vector<MetricSample> samples;
+    m_registry.Collect(samples);
+    for (const MetricSample& s : samples) {
+        const std::string key = StatsdKey(s);
+        if (s.type == COUNTER) {
+            double& last = m_last_counters[key];
+            const int64_t delta = llround((s.value - last) / s.unit_scale);
+            last = s.value;
+            if (delta > 0)
+                BC_STATS_COUNTER(key, delta);
+        } else {
+            const double value = s.unit_scale > 0 ? s.value / s.unit_scale : s.value * 1000;
+            BC_STATS_GAUGE(key, uint64_t(std::max(0.0, value) + 0.5));
+        }
+    }
+}
+
+} // namespace NiuMetrics
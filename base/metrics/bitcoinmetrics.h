@@ -0,0 +1,75 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * libbitcoin glue for the metrics: block timings from the timestamps the
+ * validator leaves in chain::block::validation, and a statsd exporter on
+ * top of libbitcoin's log/statsd_sink.  Built only together with libbitcoin.
+ */
+#ifndef NIUBLOCK_BITCOINMETRICS_H
+#define NIUBLOCK_BITCOINMETRICS_H
+
+#include "blockmetrics.h"
+#include "metrics.h"
+
+#include <bitcoin/bitcoin.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace NiuMetrics {
+
+/**
+ * Timings of a block that went through libbitcoin's validator.  A phase is
+ * left at -1 when one of its timestamps was never set (e.g. pop without a
+ * reorganisation) or the clock went backwards.
+ */
+BlockTimings TimingsFromBlock(const bc::chain::block& block, bool bip16_active = true);
+
+/**
+ * Pushes the registry to a statsd server every interval, through libbitcoin's
+ * statsd sink.  statsd carries integers only, so:
+ *   - counters go out as counts of the increase since the last push,
+ *   - histogram quantiles as gauges in the unit they were recorded in
+ *     (microseconds for the phase timers),
+ *   - other gauges as gauges in thousandths.
+ * The statsd key is the metric name followed by its label values joined
+ * with '.', with any '.' inside a value replaced by '_', e.g.
+ * niublock_block_phase_seconds.connect.0_99.
+ */
+class StatsdExporter
+{
+public:
+    StatsdExporter(MetricsRegistry& registry, std::chrono::milliseconds interval);
+    ~StatsdExporter();
+
+    /** Point libbitcoin's statsd sink at server (e.g. 127.0.0.1:8125) and
+     *  start pushing; the sink's socket runs on pool */
+    void Start(bc::threadpool& pool, const bc::config::authority& server);
+    void Stop();
+
+    /** Send the current values once */
+    void Push();
+
+private:
+    void ThreadMain();
+
+    MetricsRegistry& m_registry;
+    const std::chrono::milliseconds m_interval;
+    std::mutex m_push_mutex;
+    std::map<std::string, double> m_last_counters;     //!< guarded by m_push_mutex
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_running;
+    std::thread m_thread;
+};
+
+} // namespace NiuMetrics
+
+#endif // NIUBLOCK_BITCOINMETRICS_H
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockmetrics.h"
+
+#include "tinyformat.h"
+
+namespace NiuMetrics {
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "deserialize", "check", "populate", "accept", "connect", "notify", "pop", "push",
+};
+
+const char* BlockPhaseName(BlockPhase phase)
+{
+    return phase >= 0 && phase < PHASE_COUNT ? PHASE_NAMES[phase] : "";
+}
+
+BlockTimings::BlockTimings()
+    : inputs(0), sigops(0), cache_efficiency(-1)
+{
+    for (int i = 0; i < PHASE_COUNT; i++)
+        micros[i] = -1;
+}
+
+/** Counts per block are plain numbers, exported unscaled */
+static HistogramOptions CountOptions()
+{
+    HistogramOptions options;
+    options.highest = 1000 * 1000;
+    options.unit_scale = 1;
+    return options;
+}
+
+BlockMetrics::BlockMetrics(MetricsRegistry& registry)
+    : m_inputs(registry.GetHistogram("niublock_block_inputs", "Transaction inputs per block", "", CountOptions())),
+      m_sigops(registry.GetHistogram("niublock_block_sigops", "Signature operations per block", "", CountOptions())),
+      m_blocks(registry.GetCounter("niublock_blocks_total", "Blocks validated")),
+      m_inputs_total(registry.GetCounter("niublock_block_inputs_total", "Transaction inputs in validated blocks")),
+      m_sigops_total(registry.GetCounter("niublock_block_sigops_total", "Signature operations in validated blocks")),
+      m_cache_efficiency(registry.GetGauge("niublock_block_cache_efficiency",
+                                           "Fraction of the last block's prevouts found in the cache"))
+{
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        m_phases[i] = &registry.GetHistogram("niublock_block_phase_seconds", "Time spent in each block validation phase",
+                                             strprintf("phase=\"%s\"", PHASE_NAMES[i]));
+    }
+}
+
+void BlockMetrics::Record(const BlockTimings& timings)
+{
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        if (timings.micros[i] >= 0)
+            m_phases[i]->Observe(timings.micros[i]);
+    }
+    m_inputs.Observe(timings.inputs);
+    m_sigops.Observe(timings.sigops);
+    m_blocks.Inc();
+    m_inputs_total.Inc(timings.inputs);
+    m_sigops_total.Inc(timings.sigops);
+    if (timings.cache_efficiency >= 0)
+        m_cache_efficiency.Set(timings.cache_efficiency);
+}
+
+} // namespace NiuMetrics
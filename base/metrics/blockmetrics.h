@@ -0,0 +1,70 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_BLOCKMETRICS_H
+#define NIUBLOCK_BLOCKMETRICS_H
+
+#include "metrics.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NiuMetrics {
+
+/** Stages of block validation, in the order a block passes through them */
+enum BlockPhase {
+    PHASE_DESERIALIZE,
+    PHASE_CHECK,
+    PHASE_POPULATE,
+    PHASE_ACCEPT,
+    PHASE_CONNECT,
+    PHASE_NOTIFY,
+    PHASE_POP,          //!< only when the block causes a reorganisation
+    PHASE_PUSH,
+    PHASE_COUNT
+};
+
+/** Lower case name used as the phase label, e.g. "connect" */
+const char* BlockPhaseName(BlockPhase phase);
+
+/** What one block cost; see bitcoinmetrics.h for filling it from libbitcoin */
+struct BlockTimings
+{
+    BlockTimings();
+
+    int64_t micros[PHASE_COUNT];    //!< -1 for phases the block did not go through
+    uint64_t inputs;
+    uint64_t sigops;
+    double cache_efficiency;        //!< 0..1, negative when unknown
+};
+
+/**
+ * Per-phase validation timers and per-block counters:
+ *
+ *   niublock_block_phase_seconds{phase="..."}  summary per BlockPhase
+ *   niublock_block_inputs, niublock_block_sigops  summaries per block
+ *   niublock_blocks_total, niublock_block_inputs_total,
+ *   niublock_block_sigops_total                   counters
+ *   niublock_block_cache_efficiency               gauge, last block
+ */
+class BlockMetrics
+{
+public:
+    explicit BlockMetrics(MetricsRegistry& registry);
+
+    void Record(const BlockTimings& timings);
+
+private:
+    Histogram* m_phases[PHASE_COUNT];
+    Histogram& m_inputs;
+    Histogram& m_sigops;
+    Counter& m_blocks;
+    Counter& m_inputs_total;
+    Counter& m_sigops_total;
+    Gauge& m_cache_efficiency;
+};
+
+} // namespace NiuMetrics
+
+#endif // NIUBLOCK_BLOCKMETRICS_H
@@ -0,0 +1,3 @@
+#!/bin/sh
+
+g++  -std=c++11 -O2  test.cpp hdrhistogram.cpp metrics.cpp blockmetrics.cpp ../big_int/utilstrencodings.cpp  -I ./ -I ../big_int -lpthread
@@ -0,0 +1,140 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "hdrhistogram.h"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+namespace NiuMetrics {
+
+HdrHistogram::HdrHistogram(int64_t highest, int significant_figures)
+    : m_highest(std::max<int64_t>(highest, 2)),
+      m_total(0), m_sum(0),
+      m_min(std::numeric_limits<int64_t>::max()), m_max(0)
+{
+    significant_figures = std::min(5, std::max(1, significant_figures));
+    int64_t largest_single_unit = 2;
+    for (int i = 0; i < significant_figures; i++)
+        largest_single_unit *= 10;
+    int sub_bucket_count_magnitude = 0;
+    while ((int64_t(1) << sub_bucket_count_magnitude) < largest_single_unit)
+        sub_bucket_count_magnitude++;
+    m_sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+    const int64_t sub_bucket_count = int64_t(1) << sub_bucket_count_magnitude;
+    m_sub_bucket_half_count = sub_bucket_count / 2;
+    m_sub_bucket_mask = sub_bucket_count - 1;
+
+    // Each bucket doubles the range covered by the one before
+    int bucket_count = 1;
+    for (int64_t untrackable = sub_bucket_count; untrackable <= m_highest; bucket_count++) {
+        if (untrackable > std::numeric_limits<int64_t>::max() / 2) {
+            bucket_count++;
+            break;
+        }
+        untrackable <<= 1;
+    }
+    m_counts_len = (bucket_count + 1) * m_sub_bucket_half_count;
+    m_counts = new std::atomic<uint64_t>[m_counts_len];
+    for (size_t i = 0; i < m_counts_len; i++)
+        m_counts[i].store(0, std::memory_order_relaxed);
+}
+
+HdrHistogram::~HdrHistogram()
+{
+    delete[] m_counts;
+}
+
+int HdrHistogram::BucketIndex(int64_t value) const
+{
+    // Position of the highest bit, with everything below the first bucket's
+    // top folded into bucket 0
+    const int pow2ceiling = 64 - __builtin_clzll(uint64_t(value | m_sub_bucket_mask));
+    return pow2ceiling - (m_sub_bucket_half_count_magnitude + 1);
+}
+
+size_t HdrHistogram::CountsIndex(int64_t value) const
+{
+    const int bucket = BucketIndex(value);
+    const int64_t sub_bucket = value >> bucket;
+    return (size_t(bucket + 1) << m_sub_bucket_half_count_magnitude) + (sub_bucket - m_sub_bucket_half_count);
+}
+
+int64_t HdrHistogram::ValueFromIndex(size_t index) const
+{
+    int bucket = int(index >> m_sub_bucket_half_count_magnitude) - 1;
+    int64_t sub_bucket = (index & (m_sub_bucket_half_count - 1)) + m_sub_bucket_half_count;
+    if (bucket < 0) {
+        sub_bucket -= m_sub_bucket_half_count;
+        bucket = 0;
+    }
+    return sub_bucket << bucket;
+}
+
+int64_t HdrHistogram::EquivalentRange(int64_t value) const
+{
+    return int64_t(1) << BucketIndex(std::min(std::max<int64_t>(value, 0), m_highest));
+}
+
+void HdrHistogram::Record(int64_t value, uint64_t count)
+{
+    value = std::min(std::max<int64_t>(value, 0), m_highest);
+    m_counts[CountsIndex(value)].fetch_add(count, std::memory_order_relaxed);
+    m_total.fetch_add(count, std::memory_order_relaxed);
+    m_sum.fetch_add(value * int64_t(count), std::memory_order_relaxed);
+
+    int64_t seen = m_min.load(std::memory_order_relaxed);
+    while (value < seen && !m_min.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    seen = m_max.load(std::memory_order_relaxed);
+    while (value > seen && !m_max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+int64_t HdrHistogram::Min() const
+{
+    return TotalCount() ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t HdrHistogram::Max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+double HdrHistogram::Mean() const
+{
+    const uint64_t total = TotalCount();
+    return total ? double(Sum()) / total : 0;
+}
+
+int64_t HdrHistogram::ValueAtPercentile(double percentile) const
+{
+    const uint64_t total = TotalCount();
+    if (total == 0)
+        return 0;
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t wanted = std::max<uint64_t>(1, uint64_t(ceil(percentile / 100 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts_len; i++) {
+        seen += m_counts[i].load(std::memory_order_relaxed);
+        if (seen >= wanted) {
+            const int64_t lowest = ValueFromIndex(i);
+            // Report the top of the bucket, but never beyond what was seen
+            const int64_t value = lowest + EquivalentRange(lowest) - 1;
+            return std::min(std::max(value, Min()), Max());
+        }
+    }
+    return Max();
+}
+
+void HdrHistogram::Reset()
+{
+    for (size_t i = 0; i < m_counts_len; i++)
+        m_counts[i].store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+} // namespace NiuMetrics
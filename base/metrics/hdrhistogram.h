@@ -0,0 +1,79 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_HDRHISTOGRAM_H
+#define NIUBLOCK_HDRHISTOGRAM_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NiuMetrics {
+
+/**
+ * High dynamic range histogram after Gil Tene's HdrHistogram.
+ *
+ * Values from 0 to a fixed highest value are counted in buckets that keep a
+ * given number of significant decimal digits: with 2 digits every value is
+ * reported within 1% of what was recorded, whether it is 3 or 3 billion.
+ * Values below S, the power of two just above 2 * 10^digits, are counted
+ * exactly; above that every doubling of the range is split into S/2 buckets
+ * of equal width.
+ *
+ * Record() is lock-free and may be called from any number of threads.
+ * Readers see each count exactly, but a percentile computed while values
+ * are being recorded may mix counts from before and after a record.
+ */
+class HdrHistogram
+{
+public:
+    /** Values above highest are recorded as highest. significant_figures is
+     *  clamped to 1..5. */
+    HdrHistogram(int64_t highest, int significant_figures);
+    ~HdrHistogram();
+
+    HdrHistogram(const HdrHistogram&) = delete;
+    HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+    /** Record count occurrences of value; negative values count as 0 */
+    void Record(int64_t value, uint64_t count = 1);
+
+    uint64_t TotalCount() const { return m_total.load(std::memory_order_relaxed); }
+    /** Exact sum, minimum and maximum of the recorded values */
+    int64_t Sum() const { return m_sum.load(std::memory_order_relaxed); }
+    int64_t Min() const;
+    int64_t Max() const;
+    double Mean() const;
+
+    /** Smallest recorded value v (up to the bucket precision) such that
+     *  percentile percent of all values are <= v; 0 when empty */
+    int64_t ValueAtPercentile(double percentile) const;
+
+    int64_t Highest() const { return m_highest; }
+    /** Values in [v, v + EquivalentRange(v)) share a bucket */
+    int64_t EquivalentRange(int64_t value) const;
+
+    /** Forget all values. Not atomic with respect to concurrent Record()s. */
+    void Reset();
+
+private:
+    int BucketIndex(int64_t value) const;
+    size_t CountsIndex(int64_t value) const;
+    int64_t ValueFromIndex(size_t index) const;
+
+    int64_t m_highest;
+    int m_sub_bucket_half_count_magnitude;
+    int64_t m_sub_bucket_half_count;
+    int64_t m_sub_bucket_mask;
+    size_t m_counts_len;
+    std::atomic<uint64_t>* m_counts;
+    std::atomic<uint64_t> m_total;
+    std::atomic<int64_t> m_sum;
+    std::atomic<int64_t> m_min;
+    std::atomic<int64_t> m_max;
+};
+
+} // namespace NiuMetrics
+
+#endif // NIUBLOCK_HDRHISTOGRAM_H
@@ -0,0 +1,300 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "metrics.h"
+
+#include "tinyformat.h"
+#include "utilstrencodings.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace NiuMetrics {
+
+const double MetricsRegistry::QUANTILES[] = {0.5, 0.9, 0.99, 0.999, 1.0};
+const size_t MetricsRegistry::QUANTILE_COUNT = sizeof(QUANTILES) / sizeof(QUANTILES[0]);
+
+MetricsRegistry::Family* MetricsRegistry::GetFamily(const std::string& name, const std::string& help, MetricType type)
+{
+    std::map<std::string, Family>::iterator it = m_families.find(name);
+    if (it == m_families.end()) {
+        Family& family = m_families[name];
+        family.help = help;
+        family.type = type;
+        return &family;
+    }
+    return it->second.type == type ? &it->second : nullptr;
+}
+
+Counter& MetricsRegistry::GetCounter(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Family* family = GetFamily(name, help, COUNTER);
+    if (!family) {
+        m_detached_counters.emplace_back(new Counter());
+        return *m_detached_counters.back();
+    }
+    std::unique_ptr<Counter>& metric = family->counters[labels];
+    if (!metric)
+        metric.reset(new Counter());
+    return *metric;
+}
+
+Gauge& MetricsRegistry::GetGauge(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Family* family = GetFamily(name, help, GAUGE);
+    if (!family) {
+        m_detached_gauges.emplace_back(new Gauge());
+        return *m_detached_gauges.back();
+    }
+    std::unique_ptr<Gauge>& metric = family->gauges[labels];
+    if (!metric)
+        metric.reset(new Gauge());
+    return *metric;
+}
+
+Histogram& MetricsRegistry::GetHistogram(const std::string& name, const std::string& help, const std::string& labels,
+                                         const HistogramOptions& options)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Family* family = GetFamily(name, help, SUMMARY);
+    Histogram* created = new Histogram(options.highest, options.significant_figures, options.unit_scale);
+    if (!family) {
+        m_detached_histograms.emplace_back(created);
+        return *created;
+    }
+    std::unique_ptr<Histogram>& metric = family->histograms[labels];
+    if (metric)
+        delete created;
+    else
+        metric.reset(created);
+    return *metric;
+}
+
+/** Join a label set and one more label */
+static std::string AddLabel(const std::string& labels, const std::string& extra)
+{
+    return labels.empty() ? extra : labels + "," + extra;
+}
+
+void MetricsRegistry::CollectFamily(const std::string& name, const Family& family, std::vector<MetricSample>& out)
+{
+    for (const auto& m : family.counters) {
+        const MetricSample s = {name, m.first, COUNTER, double(m.second->Value()), 1};
+        out.push_back(s);
+    }
+    for (const auto& m : family.gauges) {
+        const MetricSample s = {name, m.first, GAUGE, m.second->Value(), 0};
+        out.push_back(s);
+    }
+    for (const auto& m : family.histograms) {
+        const HdrHistogram& hdr = m.second->Hdr();
+        const double scale = m.second->UnitScale();
+        for (size_t q = 0; q < QUANTILE_COUNT; q++) {
+            const MetricSample s = {name, AddLabel(m.first, strprintf("quantile=\"%g\"", QUANTILES[q])),
+                                    GAUGE, hdr.ValueAtPercentile(QUANTILES[q] * 100) * scale, scale};
+            out.push_back(s);
+        }
+        const MetricSample sum = {name + "_sum", m.first, COUNTER, hdr.Sum() * scale, scale};
+        const MetricSample count = {name + "_count", m.first, COUNTER, double(hdr.TotalCount()), 1};
+        out.push_back(sum);
+        out.push_back(count);
+    }
+}
+
+void MetricsRegistry::Collect(std::vector<MetricSample>& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& f : m_families)
+        CollectFamily(f.first, f.second, out);
+}
+
+void MetricsRegistry::RenderPrometheus(std::string& out) const
+{
+    static const char* const TYPE_NAMES[] = {"counter", "gauge", "summary"};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<MetricSample> samples;
+    for (const auto& f : m_families) {
+        // HELP text may not contain raw newlines or backslashes
+        std::string help;
+        for (char c : f.second.help) {
+            if (c == '\\')
+                help += "\\\\";
+            else if (c == '\n')
+                help += "\\n";
+            else
+                help += c;
+        }
+        out += strprintf("# HELP %s %s\n# TYPE %s %s\n", f.first, help, f.first, TYPE_NAMES[f.second.type]);
+        samples.clear();
+        CollectFamily(f.first, f.second, samples);
+        for (const MetricSample& s : samples) {
+            if (s.labels.empty())
+                out += strprintf("%s %.9g\n", s.name, s.value);
+            else
+                out += strprintf("%s{%s} %.9g\n", s.name, s.labels, s.value);
+        }
+    }
+}
+
+MetricsRegistry& MetricsInstance()
+{
+    // Leaked so that metrics held by static objects stay valid at exit
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+PrometheusServer::PrometheusServer(MetricsRegistry& registry)
+    : m_registry(registry), m_listen_fd(-1), m_port(0)
+{
+    m_wake_fds[0] = m_wake_fds[1] = -1;
+}
+
+PrometheusServer::~PrometheusServer()
+{
+    Stop();
+}
+
+bool PrometheusServer::Start(const std::string& bind, std::string& error)
+{
+    if (m_listen_fd >= 0) {
+        error = "already running";
+        return false;
+    }
+    // ParseEndpoint() refuses port 0, so leave it out and let it default
+    size_t len = bind.size();
+    if (len > 2 && bind.compare(len - 2, 2, ":0") == 0 && bind[len - 3] != ':')
+        len -= 2;
+    Endpoint ep;
+    if (!ParseEndpoint(bind.data(), len, ep) || ep.type == Endpoint::HOST_NAME) {
+        error = "bind address must be an IP literal and port, e.g. 127.0.0.1:9332";
+        return false;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    memset(&addr, 0, sizeof(addr));
+    const std::string host = ep.Host();
+    if (ep.type == Endpoint::HOST_IPV4) {
+        struct sockaddr_in* in4 = reinterpret_cast<struct sockaddr_in*>(&addr);
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons(ep.port);
+        inet_pton(AF_INET, host.c_str(), &in4->sin_addr);
+        addr_len = sizeof(*in4);
+    } else {
+        struct sockaddr_in6* in6 = reinterpret_cast<struct sockaddr_in6*>(&addr);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(ep.port);
+        inet_pton(AF_INET6, host.c_str(), &in6->sin6_addr);
+        addr_len = sizeof(*in6);
+    }
+
+    const int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = strprintf("socket: %s", strerror(errno));
+        return false;
+    }
+    const int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), addr_len) != 0 || listen(fd, 16) != 0 ||
+        pipe2(m_wake_fds, O_CLOEXEC) != 0) {
+        error = strprintf("cannot listen on %s: %s", bind, strerror(errno));
+        close(fd);
+        return false;
+    }
+    addr_len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len);
+    m_port = ntohs(addr.ss_family == AF_INET ? reinterpret_cast<struct sockaddr_in*>(&addr)->sin_port
+                                             : reinterpret_cast<struct sockaddr_in6*>(&addr)->sin6_port);
+    m_listen_fd = fd;
+    m_thread = std::thread(&PrometheusServer::ThreadMain, this);
+    return true;
+}
+
+void PrometheusServer::Stop()
+{
+    if (m_listen_fd < 0)
+        return;
+    const char c = 0;
+    while (write(m_wake_fds[1], &c, 1) < 0 && errno == EINTR) {}
+    m_thread.join();
+    close(m_listen_fd);
+    close(m_wake_fds[0]);
+    close(m_wake_fds[1]);
+    m_listen_fd = -1;
+    m_wake_fds[0] = m_wake_fds[1] = -1;
+}
+
+void PrometheusServer::ThreadMain()
+{
+    for (;;) {
+        struct pollfd fds[2] = {{m_listen_fd, POLLIN, 0}, {m_wake_fds[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        if (fds[1].revents)
+            return;
+        const int fd = accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            Serve(fd);
+            close(fd);
+        }
+    }
+}
+
+/** Send everything, giving up on errors; the client may have gone */
+static void SendAll(int fd, const std::string& data)
+{
+    size_t done = 0;
+    while (done < data.size()) {
+        const ssize_t n = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        done += n;
+    }
+}
+
+void PrometheusServer::Serve(int fd)
+{
+    // Read the request head; a client that stalls for a second is dropped
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        struct pollfd p = {fd, POLLIN, 0};
+        if (poll(&p, 1, 1000) <= 0)
+            return;
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        request.append(buf, n);
+    }
+
+    std::string status = "200 OK", body;
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0)
+        m_registry.RenderPrometheus(body);
+    else if (request.compare(0, 4, "GET ") == 0)
+        status = "404 Not Found";
+    else
+        status = "405 Method Not Allowed";
+    SendAll(fd, strprintf("HTTP/1.0 %s\r\n"
+                          "Content-Type: text/plain; version=0.0.4\r\n"
+                          "Content-Length: %u\r\n"
+                          "Connection: close\r\n\r\n", status, body.size()) + body);
+}
+
+} // namespace NiuMetrics
@@ -0,0 +1,178 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Process metrics.
+ *
+ * Counters, gauges and HDR histograms live in a MetricsRegistry under a
+ * Prometheus style name plus an optional label set.  Getting a metric takes
+ * the registry lock, so hot paths look theirs up once and keep the
+ * reference; updating it afterwards is a relaxed atomic operation.
+ *
+ * The registry renders itself in the Prometheus text exposition format,
+ * which PrometheusServer serves over HTTP, and flattens itself into samples
+ * for pushing to other backends such as statsd.
+ */
+#ifndef NIUBLOCK_METRICS_H
+#define NIUBLOCK_METRICS_H
+
+#include "hdrhistogram.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace NiuMetrics {
+
+enum MetricType {
+    COUNTER,
+    GAUGE,
+    SUMMARY,
+};
+
+class Counter
+{
+public:
+    Counter() : m_value(0) {}
+    void Inc(uint64_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> m_value;
+};
+
+class Gauge
+{
+public:
+    Gauge() : m_value(0) {}
+    void Set(double value) { m_value.store(value, std::memory_order_relaxed); }
+    double Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value;
+};
+
+/** Distribution of integer observations, exported as a Prometheus summary */
+class Histogram
+{
+public:
+    /** Observations are in units of unit_scale, e.g. 1e-6 for microseconds
+     *  exported as seconds, and range from 0 to highest */
+    Histogram(int64_t highest, int significant_figures, double unit_scale)
+        : m_hdr(highest, significant_figures), m_unit_scale(unit_scale) {}
+
+    void Observe(int64_t value) { m_hdr.Record(value); }
+
+    const HdrHistogram& Hdr() const { return m_hdr; }
+    double UnitScale() const { return m_unit_scale; }
+    void Reset() { m_hdr.Reset(); }
+
+private:
+    HdrHistogram m_hdr;
+    double m_unit_scale;
+};
+
+struct HistogramOptions
+{
+    int64_t highest = 3600LL * 1000 * 1000;  //!< an hour in microseconds
+    int significant_figures = 2;
+    double unit_scale = 1e-6;
+};
+
+/** One exported value, see MetricsRegistry::Collect() */
+struct MetricSample
+{
+    std::string name;       //!< metric name plus suffix such as "_count"
+    std::string labels;     //!< label set without braces, may be empty
+    MetricType type;        //!< COUNTER for monotonic values, else GAUGE
+    double value;
+    /** value / unit_scale is the integer the metric was recorded in (e.g.
+     *  microseconds), 0 for gauges which have no integer unit */
+    double unit_scale;
+};
+
+class MetricsRegistry
+{
+public:
+    /** Quantiles reported for every histogram */
+    static const double QUANTILES[];
+    static const size_t QUANTILE_COUNT;
+
+    /**
+     * Get or create a metric.  labels is a Prometheus label set without the
+     * braces, e.g. phase="connect", or empty.  All metrics under one name
+     * must have the same type; a mismatch returns a detached metric that is
+     * never exported.  The reference stays valid for the registry's life.
+     */
+    Counter& GetCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& GetGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& GetHistogram(const std::string& name, const std::string& help, const std::string& labels = "",
+                            const HistogramOptions& options = HistogramOptions());
+
+    /** Append all metrics in the Prometheus text format (version 0.0.4) */
+    void RenderPrometheus(std::string& out) const;
+    /** Append the current value of every metric; a histogram gives its
+     *  _count, _sum and one quantile sample per QUANTILES entry */
+    void Collect(std::vector<MetricSample>& out) const;
+
+private:
+    struct Family
+    {
+        std::string help;
+        MetricType type;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family* GetFamily(const std::string& name, const std::string& help, MetricType type);
+    static void CollectFamily(const std::string& name, const Family& family, std::vector<MetricSample>& out);
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Family> m_families;
+    std::vector<std::unique_ptr<Counter>> m_detached_counters;
+    std::vector<std::unique_ptr<Gauge>> m_detached_gauges;
+    std::vector<std::unique_ptr<Histogram>> m_detached_histograms;
+};
+
+/** The process wide registry */
+MetricsRegistry& MetricsInstance();
+
+/**
+ * Minimal HTTP server answering GET /metrics with the registry in the
+ * Prometheus text format.  Meant for a local scraper: one background
+ * thread, one connection at a time, no keep-alive.
+ */
+class PrometheusServer
+{
+public:
+    explicit PrometheusServer(MetricsRegistry& registry);
+    ~PrometheusServer();
+
+    /** Listen on an IP literal and port such as "127.0.0.1:9332"; port 0
+     *  picks a free one, see Port() */
+    bool Start(const std::string& bind, std::string& error);
+    void Stop();
+
+    uint16_t Port() const { return m_port; }
+
+private:
+    void ThreadMain();
+    void Serve(int fd);
+
+    MetricsRegistry& m_registry;
+    int m_listen_fd;
+    int m_wake_fds[2];
+    uint16_t m_port;
+    std::thread m_thread;
+};
+
+} // namespace NiuMetrics
+
+#endif // NIUBLOCK_METRICS_H
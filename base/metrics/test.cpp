@@ -0,0 +1,133 @@
+#include "blockmetrics.h"
+#include "hdrhistogram.h"
+#include "metrics.h"
+#include <arpa/inet.h>
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static std::string HttpGet(uint16_t port, const std::string& path)
+{
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  assert(fd >= 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  const int ret = connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+  assert(ret == 0);
+  const std::string request = "GET " + path + " HTTP/1.0\r\nHost: localhost\r\n\r\n";
+  const ssize_t sent = send(fd, request.data(), request.size(), 0);
+  assert(sent == ssize_t(request.size()));
+  std::string response;
+  char buf[4096];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+    response.append(buf, n);
+  close(fd);
+  return response;
+}
+
+static bool Contains(const std::string& text, const std::string& part)
+{
+  return text.find(part) != std::string::npos;
+}
+
+int main()
+{
+  // Every percentile within the promised precision over a wide range
+  NiuMetrics::HdrHistogram hdr(3600LL * 1000 * 1000, 2);
+  for (int64_t v = 1; v <= 1000000; v++)
+    hdr.Record(v);
+  assert(hdr.TotalCount() == 1000000 && hdr.Min() == 1 && hdr.Max() == 1000000);
+  assert(hdr.Sum() == 500000500000LL);
+  for (double p : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9}) {
+    const double exact = p / 100 * 1000000;
+    const double got = hdr.ValueAtPercentile(p);
+    assert(got >= exact && got <= exact * 1.01);
+  }
+  assert(hdr.ValueAtPercentile(100) == 1000000);
+  assert(hdr.ValueAtPercentile(0) == 1);
+  // Small values are exact, huge ones are clamped
+  NiuMetrics::HdrHistogram small(1000, 2);
+  small.Record(7);
+  small.Record(-5);
+  small.Record(5000);
+  assert(small.ValueAtPercentile(50) == 7 && small.Min() == 0 && small.Max() == 1000);
+  small.Reset();
+  assert(small.TotalCount() == 0 && small.ValueAtPercentile(50) == 0);
+
+  // Concurrent recording loses nothing
+  NiuMetrics::HdrHistogram shared(1000000, 3);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; t++) {
+    workers.emplace_back([&shared, t] {
+      for (int i = 0; i < 100000; i++)
+        shared.Record(i % 1000 + t);
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  assert(shared.TotalCount() == 400000 && shared.Min() == 0 && shared.Max() == 1002);
+  std::cout << "hdr histogram: ok" << std::endl;
+
+  NiuMetrics::MetricsRegistry registry;
+  NiuMetrics::Counter& requests = registry.GetCounter("test_requests_total", "Requests\nserved");
+  requests.Inc(3);
+  NiuMetrics::Counter& again = registry.GetCounter("test_requests_total", "Requests");
+  assert(&again == &requests);
+  // A type mismatch gets a metric that is never exported
+  NiuMetrics::Gauge& wrong = registry.GetGauge("test_requests_total", "oops");
+  wrong.Set(99);
+  registry.GetGauge("test_temperature", "Degrees", "room=\"a\"").Set(21.5);
+
+  NiuMetrics::BlockMetrics blocks(registry);
+  NiuMetrics::BlockTimings timings;
+  timings.micros[NiuMetrics::PHASE_CHECK] = 1500;
+  timings.micros[NiuMetrics::PHASE_CONNECT] = 250000;
+  timings.inputs = 4000;
+  timings.sigops = 9000;
+  timings.cache_efficiency = 0.75;
+  blocks.Record(timings);
+  blocks.Record(timings);
+
+  std::string text;
+  registry.RenderPrometheus(text);
+  assert(Contains(text, "# HELP test_requests_total Requests\\nserved\n# TYPE test_requests_total counter\n"
+                        "test_requests_total 3\n"));
+  assert(!Contains(text, " 99\n") && !Contains(text, "TYPE test_requests_total gauge"));
+  assert(Contains(text, "test_temperature{room=\"a\"} 21.5\n"));
+  assert(Contains(text, "# TYPE niublock_block_phase_seconds summary\n"));
+  assert(Contains(text, "niublock_block_phase_seconds{phase=\"connect\",quantile=\"0.99\"} 0.25"));
+  assert(Contains(text, "niublock_block_phase_seconds_count{phase=\"connect\"} 2\n"));
+  assert(Contains(text, "niublock_block_phase_seconds_count{phase=\"pop\"} 0\n"));
+  assert(Contains(text, "niublock_block_phase_seconds_sum{phase=\"check\"} 0.003\n"));
+  assert(Contains(text, "niublock_block_sigops_total 18000\n"));
+  assert(Contains(text, "niublock_block_inputs{quantile=\"0.5\"} 4000\n"));
+  assert(Contains(text, "niublock_block_cache_efficiency 0.75\n"));
+  std::cout << "prometheus text: ok" << std::endl;
+
+  NiuMetrics::PrometheusServer server(registry);
+  std::string error;
+  bool started = server.Start("localhost:0", error);
+  assert(!started && !error.empty());
+  started = server.Start("127.0.0.1:0", error);
+  assert(started);
+  assert(server.Port() != 0);
+  std::string response = HttpGet(server.Port(), "/metrics");
+  assert(response.compare(0, 15, "HTTP/1.0 200 OK") == 0);
+  assert(Contains(response, "Content-Type: text/plain; version=0.0.4\r\n"));
+  assert(Contains(response, "\r\n\r\n# HELP "));
+  assert(Contains(response, "test_requests_total 3\n"));
+  response = HttpGet(server.Port(), "/other");
+  assert(response.compare(0, 22, "HTTP/1.0 404 Not Found") == 0);
+  server.Stop();
+  std::cout << "prometheus endpoint: ok" << std::endl;
+}
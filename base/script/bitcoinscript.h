@@ -0,0 +1,65 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Raw scripts for libbitcoin code, in place of
+ *
+ *   script.from_data(source, true)     -> ReadScript(source)
+ *   script.pattern()                   -> OutputPattern(View(chunk))
+ *   script::is_pay_key_hash_pattern(ops)
+ *                                      -> View(chunk).IsPayToPubkeyHash()
+ *   script::is_pay_script_hash_pattern(ops)
+ *                                      -> View(chunk).IsPayToScriptHash()
+ *   script::is_null_data_pattern(ops)  -> View(chunk).IsNullData()
+ *   output.script() in the interpreter -> ToBitcoinScript(script)
+ *
+ * from_data() decodes every script to an operation::list on the way in;
+ * here a script stays bytes until ToBitcoinScript() hands it to
+ * machine::interpreter.
+ */
+#ifndef NIUBLOCK_BITCOINSCRIPT_H
+#define NIUBLOCK_BITCOINSCRIPT_H
+
+#include "script.h"
+
+#include <bitcoin/bitcoin.hpp>
+
+inline ScriptView View(const bc::data_chunk& chunk)
+{
+    return ScriptView(chunk.data(), chunk.size());
+}
+
+/** A CompactSize prefixed script, false on a short read */
+inline bool ReadScript(bc::reader& source, Script& script)
+{
+    const size_t size = source.read_size_little_endian();
+    if (!source || size > bc::max_block_size)
+        return false;
+    const bc::data_chunk bytes = source.read_bytes(size);
+    if (!source)
+        return false;
+    script.Assign(bytes.data(), bytes.size());
+    return true;
+}
+
+/** libbitcoin's pattern of an output script, see ScriptView::MatchPattern() */
+inline bc::machine::script_pattern OutputPattern(const ScriptView& script)
+{
+    switch (script.MatchPattern()) {
+    case TX_NULL_DATA: return bc::machine::script_pattern::null_data;
+    case TX_MULTISIG: return bc::machine::script_pattern::pay_multisig;
+    case TX_PUBKEY: return bc::machine::script_pattern::pay_public_key;
+    case TX_PUBKEYHASH: return bc::machine::script_pattern::pay_key_hash;
+    case TX_SCRIPTHASH: return bc::machine::script_pattern::pay_script_hash;
+    default: return bc::machine::script_pattern::non_standard;
+    }
+}
+
+/** The decoded script, for the interpreter only */
+inline bc::chain::script ToBitcoinScript(const ScriptView& script)
+{
+    return bc::chain::script(bc::data_chunk(script.begin(), script.end()), false);
+}
+
+#endif // NIUBLOCK_BITCOINSCRIPT_H
@@ -0,0 +1,321 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "script.h"
+
+#include <new>
+#include <string.h>
+
+const char* GetTxnOutputType(txnouttype type)
+{
+    switch (type) {
+    case TX_NONSTANDARD: return "nonstandard";
+    case TX_PUBKEYHASH: return "pubkeyhash";
+    case TX_SCRIPTHASH: return "scripthash";
+    case TX_WITNESS_V0_KEYHASH: return "witness_v0_keyhash";
+    case TX_WITNESS_V0_SCRIPTHASH: return "witness_v0_scripthash";
+    case TX_NULL_DATA: return "nulldata";
+    case TX_PUBKEY: return "pubkey";
+    case TX_MULTISIG: return "multisig";
+    case TX_WITNESS_V1_TAPROOT: return "witness_v1_taproot";
+    case TX_WITNESS_UNKNOWN: return "witness_unknown";
+    }
+    return "nonstandard";
+}
+
+/** The length a public key starting with header has, or 0, as CPubKey::GetLen() */
+static size_t PubkeySize(unsigned char header)
+{
+    if (header == 2 || header == 3)
+        return 33;
+    if (header == 4 || header == 6 || header == 7)
+        return 65;
+    return 0;
+}
+
+static bool IsPubkey(const unsigned char* data, size_t size)
+{
+    return size > 0 && PubkeySize(data[0]) == size;
+}
+
+bool GetScriptOp(const unsigned char*& pc, const unsigned char* end, opcodetype& opcode,
+                 const unsigned char** push, size_t* push_size)
+{
+    opcode = OP_INVALIDOPCODE;
+    if (push) {
+        *push = nullptr;
+        *push_size = 0;
+    }
+    if (pc >= end)
+        return false;
+
+    unsigned int op = *pc++;
+    if (op <= OP_PUSHDATA4) {
+        size_t size;
+        if (op < OP_PUSHDATA1) {
+            size = op;
+        } else if (op == OP_PUSHDATA1) {
+            if (end - pc < 1)
+                return false;
+            size = *pc++;
+        } else if (op == OP_PUSHDATA2) {
+            if (end - pc < 2)
+                return false;
+            size = (size_t)pc[0] | (size_t)pc[1] << 8;
+            pc += 2;
+        } else {
+            if (end - pc < 4)
+                return false;
+            size = (size_t)pc[0] | (size_t)pc[1] << 8 | (size_t)pc[2] << 16 | (size_t)pc[3] << 24;
+            pc += 4;
+        }
+        if ((size_t)(end - pc) < size)
+            return false;
+        if (push) {
+            *push = pc;
+            *push_size = size;
+        }
+        pc += size;
+    }
+    opcode = (opcodetype)op;
+    return true;
+}
+
+bool ScriptView::Decode(std::vector<ScriptOp>& ops) const
+{
+    ops.clear();
+    const_iterator pc = begin();
+    ScriptOp op;
+    while (pc < end()) {
+        if (!GetOp(pc, op.opcode, op.push))
+            return false;
+        ops.push_back(op);
+    }
+    return true;
+}
+
+bool ScriptView::IsWitnessProgram(int* version, ScriptView* program) const
+{
+    if (m_size < 4 || m_size > 42)
+        return false;
+    if (m_data[0] != OP_0 && (m_data[0] < OP_1 || m_data[0] > OP_16))
+        return false;
+    if ((size_t)m_data[1] + 2 != m_size)
+        return false;
+    if (version)
+        *version = DecodeOP_N((opcodetype)m_data[0]);
+    if (program)
+        *program = ScriptView(m_data + 2, m_size - 2);
+    return true;
+}
+
+bool ScriptView::IsPayToPubkey(ScriptView* pubkey) const
+{
+    if ((m_size != 35 && m_size != 67) || m_data[0] != m_size - 2 || m_data[m_size - 1] != OP_CHECKSIG)
+        return false;
+    if (!IsPubkey(m_data + 1, m_size - 2))
+        return false;
+    if (pubkey)
+        *pubkey = ScriptView(m_data + 1, m_size - 2);
+    return true;
+}
+
+bool ScriptView::IsMultisig(int* required, int* keys) const
+{
+    if (m_size < 1 || m_data[m_size - 1] != OP_CHECKMULTISIG)
+        return false;
+    const_iterator pc = begin();
+    opcodetype opcode;
+    ScriptView push;
+    if (!GetOp(pc, opcode) || opcode < OP_1 || opcode > OP_16)
+        return false;
+    const int m = DecodeOP_N(opcode);
+    int n = 0;
+    while (GetOp(pc, opcode, push) && IsPubkey(push.data(), push.size()))
+        n++;
+    if (opcode < OP_1 || opcode > OP_16 || DecodeOP_N(opcode) != n || n < m)
+        return false;
+    // Only the OP_CHECKMULTISIG is left
+    if (pc + 1 != end())
+        return false;
+    if (required)
+        *required = m;
+    if (keys)
+        *keys = n;
+    return true;
+}
+
+txnouttype ScriptView::Match(ScriptView* hash) const
+{
+    if (IsPayToPubkeyHash()) {
+        if (hash)
+            *hash = ScriptView(m_data + 3, 20);
+        return TX_PUBKEYHASH;
+    }
+    if (IsPayToScriptHash()) {
+        if (hash)
+            *hash = ScriptView(m_data + 2, 20);
+        return TX_SCRIPTHASH;
+    }
+    if (IsPayToWitnessPubkeyHash()) {
+        if (hash)
+            *hash = ScriptView(m_data + 2, 20);
+        return TX_WITNESS_V0_KEYHASH;
+    }
+    if (IsPayToWitnessScriptHash()) {
+        if (hash)
+            *hash = ScriptView(m_data + 2, 32);
+        return TX_WITNESS_V0_SCRIPTHASH;
+    }
+    int version;
+    ScriptView program;
+    if (IsWitnessProgram(&version, &program)) {
+        // Version 0 of another length is nonstandard, as Core's Solver()
+        if (version == 0)
+            return TX_NONSTANDARD;
+        if (hash)
+            *hash = program;
+        return version == 1 && program.size() == 32 ? TX_WITNESS_V1_TAPROOT : TX_WITNESS_UNKNOWN;
+    }
+    // OP_RETURN and pushes only, whatever their length, as Core's Solver()
+    if (m_size > 0 && m_data[0] == OP_RETURN && ScriptView(m_data + 1, m_size - 1).IsPushOnly()) {
+        if (hash)
+            *hash = ScriptView();
+        return TX_NULL_DATA;
+    }
+    if (IsPayToPubkey(hash))
+        return TX_PUBKEY;
+    if (IsMultisig()) {
+        if (hash)
+            *hash = ScriptView();
+        return TX_MULTISIG;
+    }
+    return TX_NONSTANDARD;
+}
+
+txnouttype ScriptView::MatchPattern() const
+{
+    if (IsNullData())
+        return TX_NULL_DATA;
+    if (IsMultisig())
+        return TX_MULTISIG;
+    if (IsPayToPubkey())
+        return TX_PUBKEY;
+    if (IsPayToPubkeyHash())
+        return TX_PUBKEYHASH;
+    if (IsPayToScriptHash())
+        return TX_SCRIPTHASH;
+    return TX_NONSTANDARD;
+}
+
+bool ScriptView::IsNullData() const
+{
+    if (m_size < 2 || m_data[0] != OP_RETURN)
+        return false;
+    const_iterator pc = begin() + 1;
+    opcodetype opcode;
+    ScriptView push;
+    // OP_1NEGATE and OP_1 .. OP_16 count as pushes, OP_RESERVED does not
+    if (!GetOp(pc, opcode, push) || opcode > OP_16 || opcode == OP_RESERVED)
+        return false;
+    return pc == end() && push.size() <= MAX_NULL_DATA_SIZE;
+}
+
+unsigned int ScriptView::GetSigOpCount(bool accurate) const
+{
+    unsigned int n = 0;
+    const_iterator pc = begin();
+    opcodetype last = OP_INVALIDOPCODE;
+    opcodetype opcode;
+    while (pc < end()) {
+        if (!GetOp(pc, opcode))
+            break;
+        if (opcode == OP_CHECKSIG || opcode == OP_CHECKSIGVERIFY) {
+            n++;
+        } else if (opcode == OP_CHECKMULTISIG || opcode == OP_CHECKMULTISIGVERIFY) {
+            if (accurate && last >= OP_1 && last <= OP_16)
+                n += DecodeOP_N(last);
+            else
+                n += MAX_PUBKEYS_PER_MULTISIG;
+        }
+        last = opcode;
+    }
+    return n;
+}
+
+bool ScriptView::IsPushOnly() const
+{
+    const_iterator pc = begin();
+    opcodetype opcode;
+    while (pc < end()) {
+        if (!GetOp(pc, opcode))
+            return false;
+        // OP_RESERVED is not a push but counts as one here, as in Core
+        if (opcode > OP_16)
+            return false;
+    }
+    return true;
+}
+
+bool ScriptView::operator==(const ScriptView& other) const
+{
+    return m_size == other.m_size && (m_size == 0 || memcmp(m_data, other.m_data, m_size) == 0);
+}
+
+Script::Script(Script&& other) noexcept
+    : m_size(other.m_size)
+{
+    memcpy(m_inline, other.m_inline, IsInline() ? m_size : sizeof(unsigned char*));
+    other.m_size = 0;
+}
+
+Script& Script::operator=(const Script& other)
+{
+    if (this != &other)
+        Assign(other.data(), other.size());
+    return *this;
+}
+
+Script& Script::operator=(Script&& other) noexcept
+{
+    if (this != &other) {
+        Free();
+        m_size = other.m_size;
+        memcpy(m_inline, other.m_inline, IsInline() ? m_size : sizeof(unsigned char*));
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+void Script::Assign(const unsigned char* data, size_t size)
+{
+    if (size > UINT32_MAX)
+        throw std::bad_alloc();
+    if (size <= INLINE_SIZE) {
+        // data may point into this script, whose heap pointer is in m_inline
+        unsigned char bytes[INLINE_SIZE];
+        // An empty script may come with a null data pointer
+        if (size)
+            memcpy(bytes, data, size);
+        Free();
+        if (size)
+            memcpy(m_inline, bytes, size);
+        m_size = (uint32_t)size;
+        return;
+    }
+    unsigned char* heap = new unsigned char[size];
+    memcpy(heap, data, size);
+    Free();
+    SetHeap(heap);
+    m_size = (uint32_t)size;
+}
+
+void Script::Free()
+{
+    if (!IsInline())
+        delete[] Heap();
+    m_size = 0;
+}
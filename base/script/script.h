@@ -0,0 +1,359 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_SCRIPT_H
+#define NIUBLOCK_SCRIPT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+/** Script opcodes */
+enum opcodetype
+{
+    // push value
+    OP_0 = 0x00,
+    OP_FALSE = OP_0,
+    OP_PUSHDATA1 = 0x4c,
+    OP_PUSHDATA2 = 0x4d,
+    OP_PUSHDATA4 = 0x4e,
+    OP_1NEGATE = 0x4f,
+    OP_RESERVED = 0x50,
+    OP_1 = 0x51,
+    OP_TRUE = OP_1,
+    OP_2 = 0x52,
+    OP_3 = 0x53,
+    OP_4 = 0x54,
+    OP_5 = 0x55,
+    OP_6 = 0x56,
+    OP_7 = 0x57,
+    OP_8 = 0x58,
+    OP_9 = 0x59,
+    OP_10 = 0x5a,
+    OP_11 = 0x5b,
+    OP_12 = 0x5c,
+    OP_13 = 0x5d,
+    OP_14 = 0x5e,
+    OP_15 = 0x5f,
+    OP_16 = 0x60,
+
+    // control
+    OP_NOP = 0x61,
+    OP_VER = 0x62,
+    OP_IF = 0x63,
+    OP_NOTIF = 0x64,
+    OP_VERIF = 0x65,
+    OP_VERNOTIF = 0x66,
+    OP_ELSE = 0x67,
+    OP_ENDIF = 0x68,
+    OP_VERIFY = 0x69,
+    OP_RETURN = 0x6a,
+
+    // stack ops
+    OP_TOALTSTACK = 0x6b,
+    OP_FROMALTSTACK = 0x6c,
+    OP_2DROP = 0x6d,
+    OP_2DUP = 0x6e,
+    OP_3DUP = 0x6f,
+    OP_2OVER = 0x70,
+    OP_2ROT = 0x71,
+    OP_2SWAP = 0x72,
+    OP_IFDUP = 0x73,
+    OP_DEPTH = 0x74,
+    OP_DROP = 0x75,
+    OP_DUP = 0x76,
+    OP_NIP = 0x77,
+    OP_OVER = 0x78,
+    OP_PICK = 0x79,
+    OP_ROLL = 0x7a,
+    OP_ROT = 0x7b,
+    OP_SWAP = 0x7c,
+    OP_TUCK = 0x7d,
+
+    // splice ops
+    OP_CAT = 0x7e,
+    OP_SUBSTR = 0x7f,
+    OP_LEFT = 0x80,
+    OP_RIGHT = 0x81,
+    OP_SIZE = 0x82,
+
+    // bit logic
+    OP_INVERT = 0x83,
+    OP_AND = 0x84,
+    OP_OR = 0x85,
+    OP_XOR = 0x86,
+    OP_EQUAL = 0x87,
+    OP_EQUALVERIFY = 0x88,
+    OP_RESERVED1 = 0x89,
+    OP_RESERVED2 = 0x8a,
+
+    // numeric
+    OP_1ADD = 0x8b,
+    OP_1SUB = 0x8c,
+    OP_2MUL = 0x8d,
+    OP_2DIV = 0x8e,
+    OP_NEGATE = 0x8f,
+    OP_ABS = 0x90,
+    OP_NOT = 0x91,
+    OP_0NOTEQUAL = 0x92,
+
+    OP_ADD = 0x93,
+    OP_SUB = 0x94,
+    OP_MUL = 0x95,
+    OP_DIV = 0x96,
+    OP_MOD = 0x97,
+    OP_LSHIFT = 0x98,
+    OP_RSHIFT = 0x99,
+
+    OP_BOOLAND = 0x9a,
+    OP_BOOLOR = 0x9b,
+    OP_NUMEQUAL = 0x9c,
+    OP_NUMEQUALVERIFY = 0x9d,
+    OP_NUMNOTEQUAL = 0x9e,
+    OP_LESSTHAN = 0x9f,
+    OP_GREATERTHAN = 0xa0,
+    OP_LESSTHANOREQUAL = 0xa1,
+    OP_GREATERTHANOREQUAL = 0xa2,
+    OP_MIN = 0xa3,
+    OP_MAX = 0xa4,
+
+    OP_WITHIN = 0xa5,
+
+    // crypto
+    OP_RIPEMD160 = 0xa6,
+    OP_SHA1 = 0xa7,
+    OP_SHA256 = 0xa8,
+    OP_HASH160 = 0xa9,
+    OP_HASH256 = 0xaa,
+    OP_CODESEPARATOR = 0xab,
+    OP_CHECKSIG = 0xac,
+    OP_CHECKSIGVERIFY = 0xad,
+    OP_CHECKMULTISIG = 0xae,
+    OP_CHECKMULTISIGVERIFY = 0xaf,
+
+    // expansion
+    OP_NOP1 = 0xb0,
+    OP_CHECKLOCKTIMEVERIFY = 0xb1,
+    OP_NOP2 = OP_CHECKLOCKTIMEVERIFY,
+    OP_CHECKSEQUENCEVERIFY = 0xb2,
+    OP_NOP3 = OP_CHECKSEQUENCEVERIFY,
+    OP_NOP4 = 0xb3,
+    OP_NOP5 = 0xb4,
+    OP_NOP6 = 0xb5,
+    OP_NOP7 = 0xb6,
+    OP_NOP8 = 0xb7,
+    OP_NOP9 = 0xb8,
+    OP_NOP10 = 0xb9,
+
+    OP_INVALIDOPCODE = 0xff,
+};
+
+/** Pubkeys an OP_CHECKMULTISIG is counted as when its key count is unknown */
+static const int MAX_PUBKEYS_PER_MULTISIG = 20;
+
+/** Longer scripts fail to execute, so outputs paying to them are unspendable */
+static const size_t MAX_SCRIPT_SIZE = 10000;
+
+/** Largest push of a null data output, as libbitcoin's max_null_data_size */
+static const size_t MAX_NULL_DATA_SIZE = 80;
+
+/** Output templates the matchers recognise, as Bitcoin Core's Solver() */
+enum txnouttype
+{
+    TX_NONSTANDARD,
+    TX_PUBKEYHASH,
+    TX_SCRIPTHASH,
+    TX_WITNESS_V0_KEYHASH,
+    TX_WITNESS_V0_SCRIPTHASH,
+    TX_NULL_DATA,
+    TX_PUBKEY,
+    TX_MULTISIG,
+    TX_WITNESS_V1_TAPROOT,
+    TX_WITNESS_UNKNOWN, //!< Any other witness version, reserved for upgrades
+};
+
+const char* GetTxnOutputType(txnouttype type);
+
+/** Decode the opcode at pc and advance pc past it and its push data.
+ *  Returns false at the end of the script, or for a push running past
+ *  end, which leaves opcode OP_INVALIDOPCODE. */
+bool GetScriptOp(const unsigned char*& pc, const unsigned char* end, opcodetype& opcode,
+                 const unsigned char** push, size_t* push_size);
+
+/** Small integer of OP_0, OP_1 .. OP_16 */
+inline int DecodeOP_N(opcodetype opcode)
+{
+    return opcode == OP_0 ? 0 : (int)opcode - (int)(OP_1 - 1);
+}
+
+struct ScriptOp;
+
+/**
+ * A serialized script that somebody else owns, such as a script inside a
+ * block buffer.  Nothing is decoded up front: the template matchers compare
+ * bytes, and GetOp() or Decode() walk the operations when something
+ * actually needs them.
+ */
+class ScriptView
+{
+public:
+    typedef const unsigned char* const_iterator;
+
+    ScriptView() : m_data(nullptr), m_size(0) {}
+    ScriptView(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+    unsigned char operator[](size_t i) const { return m_data[i]; }
+
+    /** The next operation, as in Bitcoin Core's CScript::GetOp() */
+    bool GetOp(const_iterator& pc, opcodetype& opcode) const
+    {
+        return GetScriptOp(pc, end(), opcode, nullptr, nullptr);
+    }
+    bool GetOp(const_iterator& pc, opcodetype& opcode, ScriptView& push) const
+    {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        const bool ok = GetScriptOp(pc, end(), opcode, &data, &size);
+        push = ScriptView(data, size);
+        return ok;
+    }
+
+    /** Every operation, for the interpreter; false if a push runs past
+     *  the end, leaving the operations before it */
+    bool Decode(std::vector<ScriptOp>& ops) const;
+
+    // Template matchers look at bytes only, no operation is decoded
+
+    /** OP_DUP OP_HASH160 <20> OP_EQUALVERIFY OP_CHECKSIG */
+    bool IsPayToPubkeyHash() const
+    {
+        return m_size == 25 && m_data[0] == OP_DUP && m_data[1] == OP_HASH160 && m_data[2] == 20 &&
+               m_data[23] == OP_EQUALVERIFY && m_data[24] == OP_CHECKSIG;
+    }
+    /** OP_HASH160 <20> OP_EQUAL */
+    bool IsPayToScriptHash() const
+    {
+        return m_size == 23 && m_data[0] == OP_HASH160 && m_data[1] == 20 && m_data[22] == OP_EQUAL;
+    }
+    /** OP_0 <20> */
+    bool IsPayToWitnessPubkeyHash() const
+    {
+        return m_size == 22 && m_data[0] == OP_0 && m_data[1] == 20;
+    }
+    /** OP_0 <32> */
+    bool IsPayToWitnessScriptHash() const
+    {
+        return m_size == 34 && m_data[0] == OP_0 && m_data[1] == 32;
+    }
+    /** <33 or 65 byte key> OP_CHECKSIG, the key's length matching its prefix */
+    bool IsPayToPubkey(ScriptView* pubkey = nullptr) const;
+    /** OP_m <key> .. <key> OP_n OP_CHECKMULTISIG, 1 <= m <= n <= 16; the
+     *  one matcher that has to walk the pushes */
+    bool IsMultisig(int* required = nullptr, int* keys = nullptr) const;
+    /** A version byte and one 2 to 40 byte push, as BIP141 */
+    bool IsWitnessProgram(int* version = nullptr, ScriptView* program = nullptr) const;
+    /** OP_RETURN and exactly one push of at most MAX_NULL_DATA_SIZE bytes,
+     *  as libbitcoin's is_null_data_pattern(); narrower than TX_NULL_DATA */
+    bool IsNullData() const;
+    /** Provably unspendable: OP_RETURN first, or too long to run */
+    bool IsUnspendable() const
+    {
+        return (m_size > 0 && m_data[0] == OP_RETURN) || m_size > MAX_SCRIPT_SIZE;
+    }
+
+    /** The template of an output script, and what it pays to: the hash,
+     *  the key of a P2PK or the program of a witness output; empty for
+     *  multisig and null data */
+    txnouttype Match(ScriptView* hash = nullptr) const;
+    /** The template as libbitcoin's script::pattern() sees it: one of
+     *  TX_NULL_DATA (under IsNullData()'s rule), TX_MULTISIG, TX_PUBKEY,
+     *  TX_PUBKEYHASH, TX_SCRIPTHASH or TX_NONSTANDARD.  Witness outputs
+     *  are nonstandard there. */
+    txnouttype MatchPattern() const;
+
+    /** Signature operations, counting a multisig as 20 keys unless accurate
+     *  and preceded by OP_1 .. OP_16 */
+    unsigned int GetSigOpCount(bool accurate) const;
+
+    /** Only push operations, as a scriptSig must be under BIP62/P2SH */
+    bool IsPushOnly() const;
+
+    bool operator==(const ScriptView& other) const;
+    bool operator!=(const ScriptView& other) const { return !(*this == other); }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+};
+
+/** One decoded operation; push points into the script */
+struct ScriptOp
+{
+    opcodetype opcode;
+    ScriptView push;
+};
+
+/**
+ * A serialized script that owns its bytes.  Scripts are kept as they were
+ * serialized rather than as operations: most are only matched against a
+ * template or hashed, and Decode() costs a vector per script for the few
+ * the interpreter runs.  Scripts up to INLINE_SIZE bytes, which covers
+ * every standard output template, live inside the object, so a UTXO entry
+ * holding one needs no second allocation.
+ */
+class Script
+{
+public:
+    static const size_t INLINE_SIZE = 36;
+
+    Script() : m_size(0) {}
+    Script(const unsigned char* data, size_t size) : m_size(0) { Assign(data, size); }
+    explicit Script(const ScriptView& view) : m_size(0) { Assign(view.data(), view.size()); }
+    Script(const Script& other) : m_size(0) { Assign(other.data(), other.size()); }
+    Script(Script&& other) noexcept;
+    ~Script() { Free(); }
+
+    Script& operator=(const Script& other);
+    Script& operator=(Script&& other) noexcept;
+
+    void Assign(const unsigned char* data, size_t size);
+    void clear() { Free(); }
+
+    const unsigned char* data() const { return IsInline() ? m_inline : Heap(); }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    /** The bytes are inside the object, not on the heap */
+    bool IsInline() const { return m_size <= INLINE_SIZE; }
+
+    ScriptView View() const { return ScriptView(data(), m_size); }
+    operator ScriptView() const { return View(); }
+
+    bool operator==(const Script& other) const { return View() == other.View(); }
+    bool operator!=(const Script& other) const { return View() != other.View(); }
+
+private:
+    /** The heap pointer of a long script, kept in the inline bytes so the
+     *  object stays 4-byte aligned at 40 bytes */
+    unsigned char* Heap() const
+    {
+        unsigned char* heap;
+        memcpy(&heap, m_inline, sizeof(heap));
+        return heap;
+    }
+    void SetHeap(unsigned char* heap) { memcpy(m_inline, &heap, sizeof(heap)); }
+    void Free();
+
+    uint32_t m_size;
+    unsigned char m_inline[INLINE_SIZE];
+};
+
+#endif // NIUBLOCK_SCRIPT_H
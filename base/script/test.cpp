@@ -0,0 +1,212 @@
+#include "script.h"
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+int main()
+{
+  // OP_DUP OP_HASH160 <20> OP_EQUALVERIFY OP_CHECKSIG
+  std::vector<unsigned char> p2pkh = {OP_DUP, OP_HASH160, 20};
+  p2pkh.resize(p2pkh.size() + 20, 0xab);
+  p2pkh.push_back(OP_EQUALVERIFY);
+  p2pkh.push_back(OP_CHECKSIG);
+  ScriptView script(p2pkh.data(), p2pkh.size());
+  ScriptView::const_iterator pc = script.begin();
+  opcodetype opcode;
+  ScriptView push;
+  bool ok = script.GetOp(pc, opcode);
+  assert(ok && opcode == OP_DUP);
+  ok = script.GetOp(pc, opcode);
+  assert(ok && opcode == OP_HASH160);
+  ok = script.GetOp(pc, opcode, push);
+  assert(ok && opcode == 20 && push.size() == 20 && push[0] == 0xab);
+  assert(push.data() == p2pkh.data() + 3);
+  ok = script.GetOp(pc, opcode);
+  assert(ok && opcode == OP_EQUALVERIFY);
+  ok = script.GetOp(pc, opcode);
+  assert(ok && opcode == OP_CHECKSIG);
+  ok = script.GetOp(pc, opcode);
+  assert(!ok && pc == script.end());
+  assert(script.GetSigOpCount(true) == 1 && !script.IsPushOnly());
+  std::cout << "getop: ok" << std::endl;
+
+  // Every PUSHDATA width, and pushes running past the end
+  std::vector<unsigned char> pushes = {OP_PUSHDATA1, 2, 1, 2, OP_PUSHDATA2, 1, 0, 3, OP_PUSHDATA4, 1, 0, 0, 0, 4, OP_0, OP_16};
+  ScriptView all(pushes.data(), pushes.size());
+  assert(all.IsPushOnly());
+  pc = all.begin();
+  ok = all.GetOp(pc, opcode, push);
+  assert(ok && opcode == OP_PUSHDATA1 && push.size() == 2 && push[1] == 2);
+  ok = all.GetOp(pc, opcode, push);
+  assert(ok && opcode == OP_PUSHDATA2 && push.size() == 1 && push[0] == 3);
+  ok = all.GetOp(pc, opcode, push);
+  assert(ok && opcode == OP_PUSHDATA4 && push.size() == 1 && push[0] == 4);
+  ok = all.GetOp(pc, opcode);
+  assert(ok && DecodeOP_N(opcode) == 0);
+  ok = all.GetOp(pc, opcode);
+  assert(ok && DecodeOP_N(opcode) == 16);
+  for (size_t cut : {1, 3, 5, 6, 9, 13}) {
+    ScriptView truncated(pushes.data(), cut);
+    pc = truncated.begin();
+    while (truncated.GetOp(pc, opcode)) {
+    }
+    assert(opcode == OP_INVALIDOPCODE && pc <= truncated.end());
+    assert(!truncated.IsPushOnly());
+  }
+  std::cout << "pushdata: ok" << std::endl;
+
+  // Multisig counts 20 keys unless accurate
+  ScriptView bare(pushes.data(), 4);
+  assert(bare.GetSigOpCount(false) == 0);
+  std::vector<unsigned char> ms = {OP_2};
+  for (int k = 0; k < 3; k++) {
+    ms.push_back(33);
+    ms.resize(ms.size() + 33, 0x02);
+  }
+  ms.push_back(OP_3);
+  ms.push_back(OP_CHECKMULTISIG);
+  ms.push_back(OP_CHECKSIGVERIFY);
+  ScriptView m(ms.data(), ms.size());
+  assert(m.GetSigOpCount(false) == 21 && m.GetSigOpCount(true) == 4);
+  assert(m == ScriptView(ms.data(), ms.size()) && m != bare);
+  std::cout << "sigops: ok" << std::endl;
+
+  // Templates by bytes, with the hash they pay to
+  std::vector<unsigned char> p2sh = {OP_HASH160, 20};
+  p2sh.resize(22, 0xcd);
+  p2sh.push_back(OP_EQUAL);
+  std::vector<unsigned char> p2wpkh = {OP_0, 20};
+  p2wpkh.resize(22, 0xef);
+  std::vector<unsigned char> p2wsh = {OP_0, 32};
+  p2wsh.resize(34, 0x12);
+  std::vector<unsigned char> taproot = {OP_1, 32};
+  taproot.resize(34, 0x34);
+  const std::vector<unsigned char> nulldata = {OP_RETURN, 4, 'n', 'i', 'u', '!'};
+  const std::vector<unsigned char> bare_return = {OP_RETURN};
+  const std::vector<unsigned char> return_op = {OP_RETURN, OP_DUP};
+  ScriptView hash;
+  txnouttype type = script.Match(&hash);
+  assert(type == TX_PUBKEYHASH && hash.data() == p2pkh.data() + 3 && hash.size() == 20);
+  type = ScriptView(p2sh.data(), p2sh.size()).Match(&hash);
+  assert(type == TX_SCRIPTHASH && hash[0] == 0xcd);
+  type = ScriptView(p2wpkh.data(), p2wpkh.size()).Match(&hash);
+  assert(type == TX_WITNESS_V0_KEYHASH && hash[19] == 0xef);
+  type = ScriptView(p2wsh.data(), p2wsh.size()).Match(&hash);
+  assert(type == TX_WITNESS_V0_SCRIPTHASH && hash.size() == 32);
+  type = ScriptView(taproot.data(), taproot.size()).Match(&hash);
+  assert(type == TX_WITNESS_V1_TAPROOT && hash[31] == 0x34);
+  assert(ScriptView(nulldata.data(), nulldata.size()).Match() == TX_NULL_DATA);
+  assert(ScriptView(bare_return.data(), 1).Match() == TX_NULL_DATA);
+  assert(ScriptView(return_op.data(), 2).Match() == TX_NONSTANDARD && ScriptView(return_op.data(), 2).IsUnspendable());
+  assert(ScriptView(p2sh.data(), p2sh.size() - 1).Match() == TX_NONSTANDARD);
+  assert(ScriptView().Match() == TX_NONSTANDARD && !ScriptView().IsUnspendable());
+  int version;
+  ScriptView program;
+  ok = ScriptView(taproot.data(), taproot.size()).IsWitnessProgram(&version, &program);
+  assert(ok);
+  assert(version == 1 && program.size() == 32 && !script.IsWitnessProgram());
+  assert(std::string(GetTxnOutputType(TX_WITNESS_V0_SCRIPTHASH)) == "witness_v0_scripthash");
+  assert(std::string(GetTxnOutputType((txnouttype)99)) == "nonstandard");
+
+  // The templates Solver() needs more than a length and a few bytes for
+  std::vector<unsigned char> p2pk = {33, 0x03};
+  p2pk.resize(34, 0x56);
+  p2pk.push_back(OP_CHECKSIG);
+  type = ScriptView(p2pk.data(), p2pk.size()).Match(&hash);
+  assert(type == TX_PUBKEY && hash.data() == p2pk.data() + 1 && hash.size() == 33);
+  p2pk[1] = 0x04;
+  assert(ScriptView(p2pk.data(), p2pk.size()).Match() == TX_NONSTANDARD);
+  std::vector<unsigned char> p2pk_full = {65, 0x04};
+  p2pk_full.resize(66, 0x78);
+  p2pk_full.push_back(OP_CHECKSIG);
+  type = ScriptView(p2pk_full.data(), p2pk_full.size()).Match(&hash);
+  assert(type == TX_PUBKEY && hash.size() == 65);
+  int required, keys;
+  assert(ScriptView(ms.data(), ms.size() - 1).Match() == TX_MULTISIG);
+  ok = ScriptView(ms.data(), ms.size() - 1).IsMultisig(&required, &keys);
+  assert(ok && required == 2 && keys == 3);
+  assert(!m.IsMultisig());
+  ms[ms.size() - 3] = OP_2;
+  assert(ScriptView(ms.data(), ms.size() - 1).Match() == TX_NONSTANDARD);
+  ms[ms.size() - 3] = OP_3;
+  ms[0] = OP_4;
+  assert(ScriptView(ms.data(), ms.size() - 1).Match() == TX_NONSTANDARD);
+  ms[0] = OP_2;
+  ms[36] = 0x05;
+  assert(ScriptView(ms.data(), ms.size() - 1).Match() == TX_NONSTANDARD);
+  std::vector<unsigned char> future = {OP_16, 2, 0x9a, 0xbc};
+  type = ScriptView(future.data(), future.size()).Match(&hash);
+  assert(type == TX_WITNESS_UNKNOWN && hash.size() == 2);
+  taproot[0] = OP_2;
+  assert(ScriptView(taproot.data(), taproot.size()).Match() == TX_WITNESS_UNKNOWN);
+  std::vector<unsigned char> v0_other = {OP_0, 24};
+  v0_other.resize(26, 0x11);
+  assert(ScriptView(v0_other.data(), v0_other.size()).Match() == TX_NONSTANDARD);
+  std::cout << "templates: ok" << std::endl;
+
+  // libbitcoin's script::pattern(): null data is OP_RETURN and one push of
+  // up to 80 bytes, and witness outputs have no pattern of their own
+  std::vector<unsigned char> data80 = {OP_RETURN, OP_PUSHDATA1, 80};
+  data80.resize(83, 0x2a);
+  std::vector<unsigned char> data81 = {OP_RETURN, OP_PUSHDATA1, 81};
+  data81.resize(84, 0x2a);
+  const std::vector<unsigned char> two_pushes = {OP_RETURN, 1, 0xaa, 1, 0xbb};
+  const std::vector<unsigned char> small_int = {OP_RETURN, OP_16};
+  const std::vector<unsigned char> negate = {OP_RETURN, OP_1NEGATE};
+  const std::vector<unsigned char> reserved = {OP_RETURN, OP_RESERVED};
+  const std::vector<unsigned char> short_push = {OP_RETURN, 4, 'n', 'i'};
+  assert(ScriptView(nulldata.data(), nulldata.size()).MatchPattern() == TX_NULL_DATA);
+  assert(ScriptView(data80.data(), data80.size()).MatchPattern() == TX_NULL_DATA);
+  assert(ScriptView(small_int.data(), small_int.size()).MatchPattern() == TX_NULL_DATA);
+  assert(ScriptView(negate.data(), negate.size()).MatchPattern() == TX_NULL_DATA);
+  assert(ScriptView(data81.data(), data81.size()).Match() == TX_NULL_DATA);
+  assert(ScriptView(data81.data(), data81.size()).MatchPattern() == TX_NONSTANDARD);
+  assert(ScriptView(bare_return.data(), 1).MatchPattern() == TX_NONSTANDARD);
+  assert(ScriptView(two_pushes.data(), two_pushes.size()).Match() == TX_NULL_DATA);
+  assert(ScriptView(two_pushes.data(), two_pushes.size()).MatchPattern() == TX_NONSTANDARD);
+  assert(ScriptView(reserved.data(), reserved.size()).MatchPattern() == TX_NONSTANDARD);
+  assert(ScriptView(short_push.data(), short_push.size()).MatchPattern() == TX_NONSTANDARD);
+  assert(ScriptView(p2pk_full.data(), p2pk_full.size()).MatchPattern() == TX_PUBKEY);
+  ms[36] = 0x02;
+  assert(ScriptView(ms.data(), ms.size() - 1).MatchPattern() == TX_MULTISIG);
+  assert(script.MatchPattern() == TX_PUBKEYHASH);
+  assert(ScriptView(p2sh.data(), p2sh.size()).MatchPattern() == TX_SCRIPTHASH);
+  assert(ScriptView(p2wpkh.data(), p2wpkh.size()).MatchPattern() == TX_NONSTANDARD);
+  assert(ScriptView(future.data(), future.size()).MatchPattern() == TX_NONSTANDARD);
+  std::cout << "patterns: ok" << std::endl;
+
+  // Operations only on demand
+  std::vector<ScriptOp> ops;
+  ok = script.Decode(ops);
+  assert(ok && ops.size() == 5 && ops[2].push.size() == 20 && ops[4].opcode == OP_CHECKSIG);
+  ok = ScriptView(pushes.data(), 6).Decode(ops);
+  assert(!ok && ops.size() == 1);
+  std::cout << "decode: ok" << std::endl;
+
+  // Standard templates stay inline, longer scripts go to the heap
+  Script small(p2wsh.data(), p2wsh.size());
+  Script large(ms.data(), ms.size());
+  assert(small.IsInline() && !large.IsInline() && sizeof(Script) == 40);
+  assert(small.View().Match() == TX_WITNESS_V0_SCRIPTHASH && small.data() != p2wsh.data());
+  Script copy = large;
+  assert(copy == large && copy.data() != large.data());
+  Script moved = std::move(copy);
+  assert(moved == large && copy.empty());
+  moved = small;
+  assert(moved == small && moved.IsInline());
+  moved.Assign(moved.data() + 2, 32);
+  assert(moved.size() == 32 && moved.data()[0] == 0x12);
+  large.Assign(large.data() + 1, large.size() - 1);
+  assert(large.size() == ms.size() - 1 && memcmp(large.data(), ms.data() + 1, large.size()) == 0);
+  large = std::move(small);
+  assert(large.View().IsPayToWitnessScriptHash() && small.empty());
+  // Empty scripts, e.g. from an empty std::vector whose data() is null
+  const Script none(nullptr, 0);
+  assert(none.empty() && none.IsInline() && Script(none).empty());
+  large.Assign(nullptr, 0);
+  assert(large.empty() && large == none);
+  std::cout << "script: ok" << std::endl;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * SignatureBatch for libbitcoin types, in place of
+ *
+ *   bc::verify_signature(key, hash, sig)
+ *                                      -> AddSignature(batch, key, hash, sig)
+ *   script::check_signature(sig, type, key, code, tx, index)
+ *                                      -> AddInputSignature(batch, txdata, sig, type, key, code, index)
+ *
+ * followed by one batch.Verify(&queue) for the whole block.  libbitcoin's
+ * ec_signature holds the bytes of a parsed secp256k1_ecdsa_signature, so
+ * signatures go in without another DER round trip.
+ */
+#ifndef NIUBLOCK_BITCOINSIGBATCH_H
+#define NIUBLOCK_BITCOINSIGBATCH_H
+
+#include "bitcoinsighash.h"
+#include "sigbatch.h"
+
+#include <bitcoin/bitcoin.hpp>
+#include <string.h>
+
+namespace NiuSig {
+
+inline size_t AddSignature(SignatureBatch& batch, const bc::data_chunk& public_key, const bc::hash_digest& hash,
+                           const bc::ec_signature& signature)
+{
+    static_assert(sizeof(secp256k1_ecdsa_signature) == bc::ec_signature_size, "ec_signature is a parsed signature");
+    secp256k1_ecdsa_signature sig;
+    memcpy(sig.data, signature.data(), sizeof(sig.data));
+    return batch.AddEcdsa(public_key.data(), public_key.size(), hash.data(), sig);
+}
+
+/** The signature of input_index with its digest from the transaction's
+ *  precomputed data, see bitcoinsighash.h */
+inline size_t AddInputSignature(SignatureBatch& batch, const PrecomputedTransactionData& txdata,
+                                const bc::ec_signature& signature, uint8_t sighash_type,
+                                const bc::data_chunk& public_key, const bc::chain::script& script_code,
+                                uint32_t input_index)
+{
+    const bc::hash_digest sighash = SignatureHash(txdata, input_index, script_code, sighash_type);
+    return AddSignature(batch, public_key, sighash, signature);
+}
+
+} // namespace NiuSig
+
+#endif // NIUBLOCK_BITCOINSIGBATCH_H
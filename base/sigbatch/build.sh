@@ -0,0 +1,4 @@
+#!/bin/sh
+
+cd ../crypto && sh build.sh && cd ../sigbatch
+g++  -std=c++11 -O2  test.cpp sigbatch.cpp ../checkqueue/checkqueue.cpp ../crypto/sha256*.o ../big_int/uint256.cpp ../big_int/utilstrencodings.cpp ../../3rdparty/prebuild/secp256k1/lib/libsecp256k1.a  -I ./ -I ../checkqueue -I ../crypto -I ../big_int -I ../../3rdparty/prebuild/secp256k1/include -lpthread
@@ -0,0 +1,405 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sigbatch.h"
+
+#include <random>
+#include <string.h>
+#include <unordered_map>
+
+namespace NiuSig {
+
+const secp256k1_context* VerifyContext()
+{
+    static const secp256k1_context* const ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    return ctx;
+}
+
+/** SHA256 state after the per-process salt */
+static const CSHA256& SaltedHasher()
+{
+    static const CSHA256 salted = [] {
+        std::random_device random;
+        unsigned char salt[32];
+        for (size_t i = 0; i < sizeof(salt); i += 4) {
+            const uint32_t r = random();
+            memcpy(salt + i, &r, 4);
+        }
+        CSHA256 hasher;
+        hasher.Write(salt, sizeof(salt));
+        return hasher;
+    }();
+    return salted;
+}
+
+uint256 SignatureKey(SigType type, const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                     const unsigned char* sig, size_t sig_size)
+{
+    // Sizes keep key || signature from matching another split of the same bytes
+    unsigned char header[9] = {(unsigned char)type};
+    for (int b = 0; b < 4; b++) {
+        header[1 + b] = (unsigned char)(pubkey_size >> (8 * b));
+        header[5 + b] = (unsigned char)(sig_size >> (8 * b));
+    }
+    uint256 key;
+    CSHA256(SaltedHasher())
+        .Write(header, sizeof(header))
+        .Write(hash, 32)
+        .Write(pubkey, pubkey_size)
+        .Write(sig, sig_size)
+        .Finalize(key.begin());
+    return key;
+}
+
+SignatureCache::SignatureCache(size_t max_entries)
+    : m_shard_capacity(max_entries / SHARDS + 1)
+{
+}
+
+bool SignatureCache::Contains(const uint256& key) const
+{
+    const Shard& shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.keys.count(key) != 0;
+}
+
+void SignatureCache::Insert(const uint256& key)
+{
+    Shard& shard = ShardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.keys.size() >= m_shard_capacity)
+        shard.keys.erase(shard.keys.begin());
+    shard.keys.insert(key);
+}
+
+size_t SignatureCache::Size() const
+{
+    size_t size = 0;
+    for (const Shard& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size += shard.keys.size();
+    }
+    return size;
+}
+
+/**
+ * Parse a DER signature the way Bitcoin Core's ecdsa_signature_parse_der_lax()
+ * does (libbitcoin's parse_signature() with strict unset is the same code).
+ * Signatures in blocks before BIP66 may use any BER the old OpenSSL
+ * verifier took: long form or wrong lengths, padded integers.  Whether a
+ * script demands strict DER is the interpreter's business; here the bytes
+ * only have to yield R and S.  R or S over 32 bytes gives a signature that
+ * never verifies rather than a parse error, as in Core.
+ */
+static int ParseDerLax(const secp256k1_context* ctx, secp256k1_ecdsa_signature* sig, const unsigned char* input,
+                       size_t inputlen)
+{
+    size_t rpos, rlen, spos, slen;
+    size_t pos = 0;
+    size_t lenbyte;
+    unsigned char tmpsig[64] = {0};
+    int overflow = 0;
+
+    // Initialise sig with a correctly parsed but invalid signature
+    secp256k1_ecdsa_signature_parse_compact(ctx, sig, tmpsig);
+
+    // Sequence tag byte
+    if (pos == inputlen || input[pos] != 0x30)
+        return 0;
+    pos++;
+
+    // Sequence length bytes, ignored
+    if (pos == inputlen)
+        return 0;
+    lenbyte = input[pos++];
+    if (lenbyte & 0x80) {
+        lenbyte -= 0x80;
+        if (lenbyte > inputlen - pos)
+            return 0;
+        pos += lenbyte;
+    }
+
+    // Integer tag byte for R
+    if (pos == inputlen || input[pos] != 0x02)
+        return 0;
+    pos++;
+
+    // Integer length for R
+    if (pos == inputlen)
+        return 0;
+    lenbyte = input[pos++];
+    if (lenbyte & 0x80) {
+        lenbyte -= 0x80;
+        if (lenbyte > inputlen - pos)
+            return 0;
+        while (lenbyte > 0 && input[pos] == 0) {
+            pos++;
+            lenbyte--;
+        }
+        static_assert(sizeof(size_t) >= 4, "size_t too small");
+        if (lenbyte >= 4)
+            return 0;
+        rlen = 0;
+        while (lenbyte > 0) {
+            rlen = (rlen << 8) + input[pos];
+            pos++;
+            lenbyte--;
+        }
+    } else {
+        rlen = lenbyte;
+    }
+    if (rlen > inputlen - pos)
+        return 0;
+    rpos = pos;
+    pos += rlen;
+
+    // Integer tag byte for S
+    if (pos == inputlen || input[pos] != 0x02)
+        return 0;
+    pos++;
+
+    // Integer length for S
+    if (pos == inputlen)
+        return 0;
+    lenbyte = input[pos++];
+    if (lenbyte & 0x80) {
+        lenbyte -= 0x80;
+        if (lenbyte > inputlen - pos)
+            return 0;
+        while (lenbyte > 0 && input[pos] == 0) {
+            pos++;
+            lenbyte--;
+        }
+        if (lenbyte >= 4)
+            return 0;
+        slen = 0;
+        while (lenbyte > 0) {
+            slen = (slen << 8) + input[pos];
+            pos++;
+            lenbyte--;
+        }
+    } else {
+        slen = lenbyte;
+    }
+    if (slen > inputlen - pos)
+        return 0;
+    spos = pos;
+
+    // Ignore leading zeroes in R, then copy it
+    while (rlen > 0 && input[rpos] == 0) {
+        rlen--;
+        rpos++;
+    }
+    if (rlen > 32)
+        overflow = 1;
+    else
+        memcpy(tmpsig + 32 - rlen, input + rpos, rlen);
+
+    // Ignore leading zeroes in S, then copy it
+    while (slen > 0 && input[spos] == 0) {
+        slen--;
+        spos++;
+    }
+    if (slen > 32)
+        overflow = 1;
+    else
+        memcpy(tmpsig + 64 - slen, input + spos, slen);
+
+    if (!overflow)
+        overflow = !secp256k1_ecdsa_signature_parse_compact(ctx, sig, tmpsig);
+    if (overflow) {
+        // Overwrite the result again with a correctly parsed but invalid signature
+        memset(tmpsig, 0, 64);
+        secp256k1_ecdsa_signature_parse_compact(ctx, sig, tmpsig);
+    }
+    return 1;
+}
+
+bool SignatureCheck::operator()()
+{
+    int ok;
+    switch (type) {
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+    case SIG_SCHNORR:
+        ok = secp256k1_schnorrsig_verify(VerifyContext(), schnorr, hash, 32, &xonly);
+        break;
+#endif
+    default:
+        ok = secp256k1_ecdsa_verify(VerifyContext(), &sig, hash, &pubkey);
+        break;
+    }
+    result = ok == 1 ? 1 : 0;
+    return ok == 1;
+}
+
+SignatureBatch::SignatureBatch(SignatureCache* cache)
+    : m_cache(cache),
+      m_first_invalid(0)
+{
+}
+
+size_t SignatureBatch::Add(SigType type, const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                           const unsigned char* sig, size_t sig_size)
+{
+    Entry entry;
+    entry.type = type;
+    entry.pubkey_offset = m_bytes.size();
+    entry.pubkey_size = (uint32_t)pubkey_size;
+    entry.sig_size = (uint32_t)sig_size;
+    memcpy(entry.hash, hash, 32);
+    m_bytes.insert(m_bytes.end(), pubkey, pubkey + pubkey_size);
+    m_bytes.insert(m_bytes.end(), sig, sig + sig_size);
+    m_entries.push_back(entry);
+    m_stats.added++;
+    return m_entries.size() - 1;
+}
+
+size_t SignatureBatch::AddEcdsa(const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                                const unsigned char* der, size_t der_size)
+{
+    return Add(SIG_ECDSA_DER, pubkey, pubkey_size, hash, der, der_size);
+}
+
+size_t SignatureBatch::AddEcdsa(const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                                const secp256k1_ecdsa_signature& sig)
+{
+    return Add(SIG_ECDSA_PARSED, pubkey, pubkey_size, hash, sig.data, sizeof(sig.data));
+}
+
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+size_t SignatureBatch::AddSchnorr(const unsigned char* xonly_pubkey, const unsigned char* hash,
+                                  const unsigned char* sig)
+{
+    return Add(SIG_SCHNORR, xonly_pubkey, 32, hash, sig, 64);
+}
+#endif
+
+bool SignatureBatch::Parse(const Entry& entry, SignatureCheck& check) const
+{
+    const secp256k1_context* ctx = VerifyContext();
+    const unsigned char* pubkey = m_bytes.data() + entry.pubkey_offset;
+    const unsigned char* sig = pubkey + entry.pubkey_size;
+    check.type = entry.type;
+    memcpy(check.hash, entry.hash, 32);
+    check.result = -1;
+    switch (entry.type) {
+    case SIG_ECDSA_DER:
+        if (!ParseDerLax(ctx, &check.sig, sig, entry.sig_size))
+            return false;
+        break;
+    case SIG_ECDSA_PARSED:
+        if (entry.sig_size != sizeof(check.sig.data))
+            return false;
+        memcpy(check.sig.data, sig, sizeof(check.sig.data));
+        break;
+    case SIG_SCHNORR:
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+        if (entry.pubkey_size != 32 || entry.sig_size != 64)
+            return false;
+        memcpy(check.schnorr, sig, 64);
+        return secp256k1_xonly_pubkey_parse(ctx, &check.xonly, pubkey) == 1;
+#else
+        return false;
+#endif
+    }
+    if (!secp256k1_ec_pubkey_parse(ctx, &check.pubkey, pubkey, entry.pubkey_size))
+        return false;
+    // secp256k1_ecdsa_verify() only takes low S, consensus takes both
+    secp256k1_ecdsa_signature_normalize(ctx, &check.sig, &check.sig);
+    return true;
+}
+
+bool SignatureBatch::Verify(SignatureCheckQueue* queue, bool store)
+{
+    const size_t count = m_entries.size();
+    const size_t added = m_stats.added;
+    m_stats = SignatureBatchStats();
+    m_stats.added = added;
+    m_state.assign(count, UNKNOWN);
+    m_checks.clear();
+    m_checks.reserve(count);
+
+    // 1. and 2.: the cache, repeats within the batch, parsing
+    std::vector<uint256> keys(count);
+    std::vector<size_t> repeat_of(count, count);
+    std::unordered_map<uint256, size_t, SignatureKeyHasher> first_seen;
+    first_seen.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const Entry& entry = m_entries[i];
+        const unsigned char* pubkey = m_bytes.data() + entry.pubkey_offset;
+        keys[i] = SignatureKey(entry.type, pubkey, entry.pubkey_size, entry.hash,
+                               pubkey + entry.pubkey_size, entry.sig_size);
+        if (m_cache && m_cache->Contains(keys[i])) {
+            m_state[i] = VALID;
+            m_stats.cache_hits++;
+            continue;
+        }
+        const auto seen = first_seen.emplace(keys[i], i);
+        if (!seen.second) {
+            repeat_of[i] = seen.first->second;
+            m_stats.duplicates++;
+            continue;
+        }
+        SignatureCheck check;
+        check.index = i;
+        if (!Parse(entry, check)) {
+            // Nothing after the first bad signature matters
+            m_state[i] = INVALID;
+            m_stats.parse_failures++;
+            break;
+        }
+        m_checks.push_back(check);
+    }
+
+    // 3.: everything else, in parallel
+    size_t failed = m_checks.size();
+    if (queue) {
+        queue->Run(m_checks, &failed);
+        m_stats.queue = queue->LastStats();
+    } else {
+        for (size_t c = 0; c < m_checks.size(); c++) {
+            if (!m_checks[c]()) {
+                failed = c;
+                break;
+            }
+        }
+    }
+
+    // 4.: checks before the failure that the queue skipped
+    for (size_t c = 0; c < failed; c++) {
+        if (m_checks[c].result == -1 && !m_checks[c]()) {
+            failed = c;
+            break;
+        }
+    }
+
+    for (const SignatureCheck& check : m_checks) {
+        if (check.result != -1) {
+            m_state[check.index] = check.result ? VALID : INVALID;
+            m_stats.verified++;
+            if (check.result && store && m_cache)
+                m_cache->Insert(keys[check.index]);
+        }
+    }
+    m_first_invalid = count;
+    for (size_t i = 0; i < count; i++) {
+        if (repeat_of[i] < count)
+            m_state[i] = m_state[repeat_of[i]];
+        if (m_state[i] == INVALID && m_first_invalid == count)
+            m_first_invalid = i;
+    }
+    return m_first_invalid == count;
+}
+
+void SignatureBatch::Clear()
+{
+    m_entries.clear();
+    m_bytes.clear();
+    m_state.clear();
+    m_checks.clear();
+    m_first_invalid = 0;
+    m_stats = SignatureBatchStats();
+}
+
+} // namespace NiuSig
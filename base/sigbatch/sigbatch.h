@@ -0,0 +1,192 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Signature verification in bulk.
+ *
+ * Block validation adds every (public key, message hash, signature) it
+ * meets to a SignatureBatch and calls Verify() once.  Verify() then
+ *
+ *  1. drops the signatures a SignatureCache already knows to be valid, and
+ *     repeats of a signature earlier in the batch;
+ *  2. parses the keys and signatures and normalises the ECDSA signatures to
+ *     low S, as libbitcoin's verify_signature() and Bitcoin consensus do;
+ *  3. verifies the rest on a CheckQueue, across cores, stopping at the
+ *     first invalid signature;
+ *  4. after a failure, verifies the signatures before it that were not
+ *     reached one by one, so FirstInvalid() is the first invalid signature
+ *     in the order they were added, as a sequential check would report.
+ *
+ * libsecp256k1 verifies ECDSA one signature at a time; there is no batch
+ * equation for ECDSA, so the speedup comes from the cache, the cores and
+ * from parsing outside the hot loop.  BIP340 Schnorr signatures are
+ * accepted when the library was built with the schnorrsig module (see
+ * 3rdparty/opensource/secp256k1/build.sh), which defines
+ * HAVE_SECP256K1_SCHNORRSIG.
+ */
+#ifndef NIUBLOCK_SIGBATCH_H
+#define NIUBLOCK_SIGBATCH_H
+
+#include "checkqueue.h"
+#include "sha256.h"
+#include "uint256.h"
+
+#include <secp256k1.h>
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+#include <secp256k1_extrakeys.h>
+#include <secp256k1_schnorrsig.h>
+#endif
+
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_set>
+#include <vector>
+
+namespace NiuSig {
+
+enum SigType : uint8_t {
+    SIG_ECDSA_DER,      //!< DER encoded ECDSA signature, parsed laxly as before BIP66
+    SIG_ECDSA_PARSED,   //!< secp256k1_ecdsa_signature, as libbitcoin's ec_signature
+    SIG_SCHNORR,        //!< BIP340, 64 bytes with a 32 byte x-only key
+};
+
+/** The verify context shared by all batches */
+const secp256k1_context* VerifyContext();
+
+/**
+ * Identifies a signature check in caches and within a batch: SHA256 over a
+ * random per-process salt, the type, hash, key and signature.  With the
+ * salt secret, nobody can make entries collide on purpose.
+ */
+uint256 SignatureKey(SigType type, const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                     const unsigned char* sig, size_t sig_size);
+
+struct SignatureKeyHasher
+{
+    size_t operator()(const uint256& key) const { return key.GetCheapHash(); }
+};
+
+/**
+ * Set of signatures known to be valid, like Bitcoin Core's signature cache,
+ * keyed by SignatureKey().  When a shard is full an arbitrary entry makes
+ * room.
+ */
+class SignatureCache
+{
+public:
+    explicit SignatureCache(size_t max_entries = 1 << 20);
+
+    bool Contains(const uint256& key) const;
+    void Insert(const uint256& key);
+    size_t Size() const;
+
+private:
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_set<uint256, SignatureKeyHasher> keys;
+    };
+    static const size_t SHARDS = 16;
+
+    Shard& ShardOf(const uint256& key) const { return m_shards[key.begin()[31] % SHARDS]; }
+
+    size_t m_shard_capacity;
+    mutable Shard m_shards[SHARDS];
+};
+
+/** One parsed signature, run by the CheckQueue */
+struct SignatureCheck
+{
+    SigType type;
+    size_t index;               //!< in the batch
+    unsigned char hash[32];
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+    secp256k1_xonly_pubkey xonly;
+    unsigned char schnorr[64];
+#endif
+    int8_t result;              //!< -1 not run yet, 0 invalid, 1 valid
+
+    bool operator()();
+};
+
+typedef NiuCheck::CheckQueue<SignatureCheck> SignatureCheckQueue;
+
+struct SignatureBatchStats
+{
+    size_t added = 0;
+    size_t cache_hits = 0;
+    size_t duplicates = 0;      //!< repeats of a signature earlier in the batch
+    size_t parse_failures = 0;
+    size_t verified = 0;        //!< signatures actually verified
+    NiuCheck::CheckQueueStats queue;
+};
+
+class SignatureBatch
+{
+public:
+    /** cache may be null */
+    explicit SignatureBatch(SignatureCache* cache = nullptr);
+
+    /** pubkey: serialized, 33 or 65 bytes; hash: 32 bytes.  Returns the
+     *  index of the signature in the batch.  der need not be strict DER,
+     *  as Bitcoin Core's CPubKey::Verify(): BIP66 is enforced by the
+     *  script interpreter, and older blocks carry signatures that
+     *  secp256k1_ecdsa_signature_parse_der() refuses. */
+    size_t AddEcdsa(const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                    const unsigned char* der, size_t der_size);
+    size_t AddEcdsa(const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+                    const secp256k1_ecdsa_signature& sig);
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+    size_t AddSchnorr(const unsigned char* xonly_pubkey, const unsigned char* hash, const unsigned char* sig);
+#endif
+
+    /**
+     * Verify everything added since the last Clear().  Verified signatures
+     * go into the cache when store is set, which should be the case for
+     * blocks and the mempool alike.  queue may be null to verify on the
+     * calling thread only.
+     */
+    bool Verify(SignatureCheckQueue* queue = nullptr, bool store = true);
+
+    size_t Size() const { return m_entries.size(); }
+    /** After Verify(): whether signature index was checked and valid */
+    bool Valid(size_t index) const { return m_state[index] == VALID; }
+    /** After a failed Verify(): the first invalid signature */
+    size_t FirstInvalid() const { return m_first_invalid; }
+    const SignatureBatchStats& Stats() const { return m_stats; }
+
+    /** Forget the signatures, keep the memory */
+    void Clear();
+
+private:
+    struct Entry
+    {
+        SigType type;
+        size_t pubkey_offset;       //!< in m_bytes; the signature follows the key
+        uint32_t pubkey_size;
+        uint32_t sig_size;
+        unsigned char hash[32];
+    };
+    enum State : uint8_t { UNKNOWN, VALID, INVALID };
+
+    size_t Add(SigType type, const unsigned char* pubkey, size_t pubkey_size, const unsigned char* hash,
+               const unsigned char* sig, size_t sig_size);
+    /** Parse entry into check; false if the key or signature is malformed */
+    bool Parse(const Entry& entry, SignatureCheck& check) const;
+
+    SignatureCache* m_cache;
+    std::vector<Entry> m_entries;
+    std::vector<unsigned char> m_bytes;         //!< keys and signatures back to back
+    std::vector<State> m_state;
+    std::vector<SignatureCheck> m_checks;
+    size_t m_first_invalid;
+    SignatureBatchStats m_stats;
+};
+
+} // namespace NiuSig
+
+#endif // NIUBLOCK_SIGBATCH_H
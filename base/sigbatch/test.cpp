@@ -0,0 +1,183 @@
+#include "sigbatch.h"
+#include "utilstrencodings.h"
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+struct Signed
+{
+  unsigned char pubkey[33];
+  unsigned char hash[32];
+  unsigned char der[72];
+  size_t der_size;
+  secp256k1_ecdsa_signature sig;
+};
+
+static std::vector<Signed> Sign(secp256k1_context* ctx, size_t count)
+{
+  std::vector<Signed> out(count);
+  for (size_t i = 0; i < count; i++) {
+    unsigned char seckey[32];
+    for (int j = 0; j < 32; j++) {
+      seckey[j] = (unsigned char)(i * 37 + j * 3 + 1);
+      out[i].hash[j] = (unsigned char)(i * 11 + j * 101);
+    }
+    secp256k1_pubkey pubkey;
+    int ret = secp256k1_ec_pubkey_create(ctx, &pubkey, seckey);
+    assert(ret);
+    size_t size = sizeof(out[i].pubkey);
+    secp256k1_ec_pubkey_serialize(ctx, out[i].pubkey, &size, &pubkey, SECP256K1_EC_COMPRESSED);
+    ret = secp256k1_ecdsa_sign(ctx, &out[i].sig, out[i].hash, seckey, NULL, NULL);
+    assert(ret);
+    out[i].der_size = sizeof(out[i].der);
+    secp256k1_ecdsa_signature_serialize_der(ctx, out[i].der, &out[i].der_size, &out[i].sig);
+  }
+  return out;
+}
+
+/** The same signature with S replaced by n - S */
+static secp256k1_ecdsa_signature HighS(secp256k1_context* ctx, const secp256k1_ecdsa_signature& sig)
+{
+  static const unsigned char order[32] = {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+      0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
+  unsigned char compact[64];
+  secp256k1_ecdsa_signature_serialize_compact(ctx, compact, &sig);
+  int borrow = 0;
+  for (int i = 31; i >= 0; i--) {
+    const int d = order[i] - compact[32 + i] - borrow;
+    compact[32 + i] = (unsigned char)d;
+    borrow = d < 0;
+  }
+  secp256k1_ecdsa_signature high;
+  const int ret = secp256k1_ecdsa_signature_parse_compact(ctx, &high, compact);
+  assert(ret);
+  return high;
+}
+
+int main()
+{
+  secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+  const std::vector<Signed> sigs = Sign(ctx, 200);
+  NiuSig::SignatureCheckQueue queue(3, 4);
+
+  // All valid, in either form, then all from the cache
+  NiuSig::SignatureCache cache;
+  NiuSig::SignatureBatch batch(&cache);
+  for (size_t i = 0; i < sigs.size(); i++) {
+    if (i % 2)
+      batch.AddEcdsa(sigs[i].pubkey, 33, sigs[i].hash, sigs[i].der, sigs[i].der_size);
+    else
+      batch.AddEcdsa(sigs[i].pubkey, 33, sigs[i].hash, sigs[i].sig);
+  }
+  batch.AddEcdsa(sigs[5].pubkey, 33, sigs[5].hash, sigs[5].der, sigs[5].der_size);
+  bool ok = batch.Verify(&queue);
+  assert(ok);
+  assert(batch.Stats().verified == 200 && batch.Stats().duplicates == 1 && batch.Stats().cache_hits == 0);
+  assert(batch.Valid(0) && batch.Valid(200) && cache.Size() == 200);
+  ok = batch.Verify();
+  assert(ok);
+  assert(batch.Stats().verified == 0 && batch.Stats().cache_hits == 201);
+  std::cout << "valid: ok" << std::endl;
+
+  // High S is accepted, as consensus demands
+  batch.Clear();
+  batch.AddEcdsa(sigs[0].pubkey, 33, sigs[0].hash, HighS(ctx, sigs[0].sig));
+  ok = batch.Verify(&queue);
+  assert(ok && batch.Stats().verified == 1);
+
+  // The first invalid signature is found, whatever thread saw which failure
+  for (int round = 0; round < 20; round++) {
+    NiuSig::SignatureBatch bad;
+    unsigned char wrong[32];
+    memset(wrong, round, sizeof(wrong));
+    const size_t first = 20 + round * 7;
+    for (size_t i = 0; i < sigs.size(); i++) {
+      const bool invalid = i == first || i == first + 50 || i == 190;
+      bad.AddEcdsa(sigs[i].pubkey, 33, invalid ? wrong : sigs[i].hash, sigs[i].sig);
+    }
+    ok = bad.Verify(round % 2 ? &queue : nullptr);
+    assert(!ok);
+    assert(bad.FirstInvalid() == first);
+    assert(bad.Valid(first - 1) && !bad.Valid(first));
+  }
+
+  // A malformed key or signature is invalid without being verified
+  NiuSig::SignatureBatch malformed(&cache);
+  const unsigned char junk[3] = {0x30, 0x01, 0x02};
+  malformed.AddEcdsa(sigs[1].pubkey, 33, sigs[1].hash, sigs[1].sig);
+  malformed.AddEcdsa(sigs[2].pubkey, 33, sigs[2].hash, junk, sizeof(junk));
+  malformed.AddEcdsa(sigs[3].pubkey, 33, sigs[3].hash, sigs[3].sig);
+  ok = malformed.Verify(&queue);
+  assert(!ok);
+  assert(malformed.FirstInvalid() == 1 && malformed.Stats().parse_failures == 1);
+  assert(!malformed.Valid(2));
+  std::cout << "invalid: ok" << std::endl;
+
+  // BER the strict parser refuses, as blocks before BIP66 may hold
+  const Signed& s4 = sigs[4];
+  const size_t rlen = s4.der[3];
+  std::vector<unsigned char> long_form = {0x30, 0x81};
+  long_form.insert(long_form.end(), s4.der + 1, s4.der + s4.der_size);
+  std::vector<unsigned char> padded_r = {0x30, (unsigned char)(s4.der[1] + 1), 0x02, (unsigned char)(rlen + 1), 0x00};
+  padded_r.insert(padded_r.end(), s4.der + 4, s4.der + s4.der_size);
+  secp256k1_ecdsa_signature parsed;
+  int ret = secp256k1_ecdsa_signature_parse_der(ctx, &parsed, long_form.data(), long_form.size());
+  assert(!ret);
+  ret = secp256k1_ecdsa_signature_parse_der(ctx, &parsed, padded_r.data(), padded_r.size());
+  assert(!ret);
+  NiuSig::SignatureBatch lax;
+  lax.AddEcdsa(s4.pubkey, 33, s4.hash, long_form.data(), long_form.size());
+  lax.AddEcdsa(s4.pubkey, 33, s4.hash, padded_r.data(), padded_r.size());
+  ok = lax.Verify(&queue);
+  assert(ok && lax.Stats().verified == 2 && lax.Stats().parse_failures == 0);
+  lax.Clear();
+  lax.AddEcdsa(s4.pubkey, 33, sigs[5].hash, padded_r.data(), padded_r.size());
+  ok = lax.Verify();
+  assert(!ok && lax.Stats().parse_failures == 0);
+  std::cout << "lax der: ok" << std::endl;
+
+#ifdef HAVE_SECP256K1_SCHNORRSIG
+  // BIP340 test vectors 0 and 1, next to ECDSA in one batch
+  const std::vector<unsigned char> xonly0 = ParseHex("f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9");
+  const std::vector<unsigned char> msg0(32, 0);
+  const std::vector<unsigned char> sig0 = ParseHex(
+      "e907831f80848d1069a5371b402410364bdf1c5f8307b0084c55f1ce2dca8215"
+      "25f66a4a85ea8b71e482a74f382d2ce5ebeee8fdb2172f477df4900d310536c0");
+  const std::vector<unsigned char> xonly1 = ParseHex("dff1d77f2a671c5f36183726db2341be58feae1da2deced843240f7b502ba659");
+  const std::vector<unsigned char> msg1 = ParseHex("243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c89");
+  std::vector<unsigned char> sig1 = ParseHex(
+      "6896bd60eeae296db48a229ff71dfe071bde413e6d43f917dc8dcf8c78de3341"
+      "8906d11ac976abccb20b091292bff4ea897efcb639ea871cfa95f6de339e4b0a");
+  NiuSig::SignatureBatch schnorr(&cache);
+  schnorr.AddSchnorr(xonly0.data(), msg0.data(), sig0.data());
+  schnorr.AddEcdsa(sigs[6].pubkey, 33, sigs[6].hash, sigs[6].sig);
+  schnorr.AddSchnorr(xonly1.data(), msg1.data(), sig1.data());
+  ok = schnorr.Verify(&queue);
+  assert(ok && schnorr.Stats().verified == 2 && schnorr.Stats().cache_hits == 1);
+  assert(schnorr.Valid(0) && schnorr.Valid(2));
+  sig1[63] ^= 1;
+  schnorr.Clear();
+  schnorr.AddSchnorr(xonly0.data(), msg0.data(), sig0.data());
+  schnorr.AddSchnorr(xonly1.data(), msg1.data(), sig1.data());
+  ok = schnorr.Verify(&queue);
+  assert(!ok && schnorr.FirstInvalid() == 1 && schnorr.Stats().cache_hits == 1);
+  std::cout << "schnorr: ok" << std::endl;
+#else
+  std::cout << "schnorr: skipped, libsecp256k1 has no schnorrsig module" << std::endl;
+#endif
+
+  // A bounded cache keeps working when full
+  NiuSig::SignatureCache small(32);
+  NiuSig::SignatureBatch evicting(&small);
+  for (const Signed& s : sigs)
+    evicting.AddEcdsa(s.pubkey, 33, s.hash, s.sig);
+  ok = evicting.Verify(&queue);
+  assert(ok);
+  assert(small.Size() <= 32 + 16);
+  std::cout << "cache: ok" << std::endl;
+
+  secp256k1_context_destroy(ctx);
+}
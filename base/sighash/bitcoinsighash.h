@@ -0,0 +1,73 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * PrecomputedTransactionData for libbitcoin transactions, in place of
+ *
+ *   script::generate_signature_hash(tx, index, code, type)
+ *                                      -> SignatureHash(txdata, index, code, type)
+ *   script::check_signature(sig, type, key, code, tx, index)
+ *                                      -> CheckSignature(txdata, sig, type, key, code, index)
+ *
+ * with txdata = PrecomputeTransaction(tx) made once per transaction.  The
+ * prebuilt interpreter still computes its own digests; these are for the
+ * callers that sign or verify outside of it.
+ */
+#ifndef NIUBLOCK_BITCOINSIGHASH_H
+#define NIUBLOCK_BITCOINSIGHASH_H
+
+#include "sighash.h"
+
+#include <bitcoin/bitcoin.hpp>
+#include <string.h>
+
+inline PrecomputedTransactionData PrecomputeTransaction(const bc::chain::transaction& tx)
+{
+    std::vector<SighashInput> inputs(tx.inputs().size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const bc::chain::input& in = tx.inputs()[i];
+        const bc::data_chunk prevout = in.previous_output().to_data();
+        memcpy(inputs[i].prevout, prevout.data(), sizeof(inputs[i].prevout));
+        inputs[i].sequence = in.sequence();
+    }
+    bc::data_chunk outputs;
+    for (const bc::chain::output& out : tx.outputs()) {
+        const bc::data_chunk data = out.to_data();
+        outputs.insert(outputs.end(), data.begin(), data.end());
+    }
+    return PrecomputedTransactionData(tx.version(), tx.locktime(), std::move(inputs),
+                                      std::move(outputs), tx.outputs().size());
+}
+
+/** Same as script::generate_signature_hash(), which also drops the
+ *  OP_CODESEPARATORs of script_code */
+inline bc::hash_digest SignatureHash(const PrecomputedTransactionData& txdata, uint32_t input_index,
+                                     const bc::chain::script& script_code, uint8_t sighash_type)
+{
+    bc::data_chunk code;
+    for (const bc::machine::operation& op : script_code.operations()) {
+        if (op.code() != bc::machine::opcode::codeseparator) {
+            const bc::data_chunk data = op.to_data();
+            code.insert(code.end(), data.begin(), data.end());
+        }
+    }
+    const uint256 hash = SignatureHash(txdata, input_index, code.data(), code.size(), sighash_type, 0,
+                                       SigVersion::BASE);
+    bc::hash_digest out;
+    memcpy(out.data(), hash.begin(), out.size());
+    return out;
+}
+
+/** Same as script::check_signature() */
+inline bool CheckSignature(const PrecomputedTransactionData& txdata, const bc::ec_signature& signature,
+                           uint8_t sighash_type, const bc::data_chunk& public_key,
+                           const bc::chain::script& script_code, uint32_t input_index)
+{
+    if (public_key.empty())
+        return false;
+    const bc::hash_digest sighash = SignatureHash(txdata, input_index, script_code, sighash_type);
+    return bc::verify_signature(public_key, sighash, signature);
+}
+
+#endif // NIUBLOCK_BITCOINSIGHASH_H
@@ -0,0 +1,4 @@
+#!/bin/sh
+
+cd ../crypto && sh build.sh && cd ../sighash
+g++  -std=c++11 -O2  test.cpp sighash.cpp ../crypto/sha256*.o ../big_int/uint256.cpp ../big_int/utilstrencodings.cpp  -I ./ -I ../crypto -I ../big_int
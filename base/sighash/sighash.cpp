@@ -0,0 +1,234 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sighash.h"
+
+#include <assert.h>
+#include <string.h>
+
+/** Serialized size of an input with an empty script */
+static const size_t BLANK_INPUT_SIZE = 36 + 1 + 4;
+
+static void WriteLE32(CSHA256& hasher, uint32_t x)
+{
+    const unsigned char bytes[4] = {(unsigned char)x, (unsigned char)(x >> 8),
+                                    (unsigned char)(x >> 16), (unsigned char)(x >> 24)};
+    hasher.Write(bytes, 4);
+}
+
+static void WriteLE64(CSHA256& hasher, uint64_t x)
+{
+    WriteLE32(hasher, (uint32_t)x);
+    WriteLE32(hasher, (uint32_t)(x >> 32));
+}
+
+/** CompactSize encoding of size into out, which has room for 9 bytes; returns its length */
+static size_t EncodeCompactSize(unsigned char* out, uint64_t size)
+{
+    if (size < 253) {
+        out[0] = (unsigned char)size;
+        return 1;
+    }
+    size_t bytes;
+    if (size <= 0xffff) {
+        out[0] = 253;
+        bytes = 2;
+    } else if (size <= 0xffffffff) {
+        out[0] = 254;
+        bytes = 4;
+    } else {
+        out[0] = 255;
+        bytes = 8;
+    }
+    for (size_t i = 0; i < bytes; i++)
+        out[1 + i] = (unsigned char)(size >> (8 * i));
+    return 1 + bytes;
+}
+
+static void WriteCompactSize(CSHA256& hasher, uint64_t size)
+{
+    unsigned char bytes[9];
+    hasher.Write(bytes, EncodeCompactSize(bytes, size));
+}
+
+/** Second round of the double SHA256 */
+static uint256 FinalizeDouble(CSHA256& hasher)
+{
+    uint256 out;
+    hasher.Finalize(out.begin());
+    CSHA256().Write(out.begin(), 32).Finalize(out.begin());
+    return out;
+}
+
+void WriteCompactSize(std::vector<unsigned char>& out, uint64_t size)
+{
+    unsigned char bytes[9];
+    out.insert(out.end(), bytes, bytes + EncodeCompactSize(bytes, size));
+}
+
+PrecomputedTransactionData::PrecomputedTransactionData(uint32_t version, uint32_t locktime,
+                                                       std::vector<SighashInput> inputs,
+                                                       std::vector<unsigned char> outputs,
+                                                       size_t output_count)
+    : m_version(version),
+      m_locktime(locktime),
+      m_inputs(std::move(inputs)),
+      m_outputs(std::move(outputs)),
+      m_output_count(output_count)
+{
+    // Where each output starts: an 8 byte amount, then a script with length
+    m_output_offsets.reserve(output_count + 1);
+    size_t pos = 0;
+    for (size_t i = 0; i < output_count; i++) {
+        m_output_offsets.push_back(pos);
+        assert(pos + 9 <= m_outputs.size());
+        uint64_t size = m_outputs[pos + 8];
+        pos += 9;
+        if (size >= 253) {
+            const int bytes = size == 253 ? 2 : size == 254 ? 4 : 8;
+            assert(pos + bytes <= m_outputs.size());
+            size = 0;
+            for (int b = 0; b < bytes; b++)
+                size |= (uint64_t)m_outputs[pos + b] << (8 * b);
+            pos += bytes;
+        }
+        assert(size <= m_outputs.size() - pos);
+        pos += size;
+    }
+    assert(pos == m_outputs.size());
+    m_output_offsets.push_back(pos);
+
+    // SIGHASH_ALL: every input but the signed one has an empty script
+    m_all_inputs.resize(m_inputs.size() * BLANK_INPUT_SIZE);
+    unsigned char* blank = m_all_inputs.data();
+    for (const SighashInput& in : m_inputs) {
+        memcpy(blank, in.prevout, 36);
+        blank[36] = 0;
+        for (int b = 0; b < 4; b++)
+            blank[37 + b] = (unsigned char)(in.sequence >> (8 * b));
+        blank += BLANK_INPUT_SIZE;
+    }
+    CSHA256 prefix;
+    WriteLE32(prefix, m_version);
+    WriteCompactSize(prefix, m_inputs.size());
+    m_all_prefix.reserve(m_inputs.size());
+    for (size_t i = 0; i < m_inputs.size(); i++) {
+        m_all_prefix.push_back(prefix);
+        prefix.Write(m_all_inputs.data() + i * BLANK_INPUT_SIZE, BLANK_INPUT_SIZE);
+    }
+
+    // BIP143
+    CSHA256 prevouts, sequences;
+    for (const SighashInput& in : m_inputs) {
+        prevouts.Write(in.prevout, 36);
+        WriteLE32(sequences, in.sequence);
+    }
+    m_hash_prevouts = FinalizeDouble(prevouts);
+    m_hash_sequence = FinalizeDouble(sequences);
+    CSHA256 all_outputs;
+    all_outputs.Write(m_outputs.data(), m_outputs.size());
+    m_hash_outputs = FinalizeDouble(all_outputs);
+}
+
+uint256 SignatureHash(const PrecomputedTransactionData& txdata, uint32_t input,
+                      const unsigned char* script_code, size_t script_size,
+                      uint32_t hash_type, uint64_t amount, SigVersion sigversion)
+{
+    static const uint256 one = uint256S("0000000000000000000000000000000000000000000000000000000000000001");
+    const std::vector<SighashInput>& inputs = txdata.m_inputs;
+    const std::vector<unsigned char>& outputs = txdata.m_outputs;
+    const std::vector<size_t>& offsets = txdata.m_output_offsets;
+    const bool anyone_can_pay = (hash_type & SIGHASH_ANYONECANPAY) != 0;
+    const uint32_t base_type = hash_type & 0x1f;
+
+    if (sigversion == SigVersion::WITNESS_V0) {
+        assert(input < inputs.size());
+        const SighashInput& self = inputs[input];
+        static const uint256 zero;
+        const uint256* hash_outputs = &zero;
+        uint256 single_output;
+        if (base_type != SIGHASH_SINGLE && base_type != SIGHASH_NONE) {
+            hash_outputs = &txdata.m_hash_outputs;
+        } else if (base_type == SIGHASH_SINGLE && input < txdata.m_output_count) {
+            CSHA256 hasher;
+            hasher.Write(outputs.data() + offsets[input], offsets[input + 1] - offsets[input]);
+            single_output = FinalizeDouble(hasher);
+            hash_outputs = &single_output;
+        }
+        CSHA256 hasher;
+        WriteLE32(hasher, txdata.m_version);
+        hasher.Write((anyone_can_pay ? zero : txdata.m_hash_prevouts).begin(), 32);
+        hasher.Write((anyone_can_pay || base_type == SIGHASH_SINGLE || base_type == SIGHASH_NONE
+                      ? zero : txdata.m_hash_sequence).begin(), 32);
+        hasher.Write(self.prevout, 36);
+        WriteCompactSize(hasher, script_size);
+        hasher.Write(script_code, script_size);
+        WriteLE64(hasher, amount);
+        WriteLE32(hasher, self.sequence);
+        hasher.Write(hash_outputs->begin(), 32);
+        WriteLE32(hasher, txdata.m_locktime);
+        WriteLE32(hasher, hash_type);
+        return FinalizeDouble(hasher);
+    }
+
+    if (input >= inputs.size())
+        return one;
+    if (base_type == SIGHASH_SINGLE && input >= txdata.m_output_count)
+        return one;
+    const SighashInput& self = inputs[input];
+
+    if (base_type != SIGHASH_NONE && base_type != SIGHASH_SINGLE && !anyone_can_pay) {
+        // The common case: resume after the blank inputs before this one
+        CSHA256 hasher = txdata.m_all_prefix[input];
+        hasher.Write(self.prevout, 36);
+        WriteCompactSize(hasher, script_size);
+        hasher.Write(script_code, script_size);
+        WriteLE32(hasher, self.sequence);
+        const size_t rest = (input + 1) * BLANK_INPUT_SIZE;
+        hasher.Write(txdata.m_all_inputs.data() + rest, txdata.m_all_inputs.size() - rest);
+        WriteCompactSize(hasher, txdata.m_output_count);
+        hasher.Write(outputs.data(), outputs.size());
+        WriteLE32(hasher, txdata.m_locktime);
+        WriteLE32(hasher, hash_type);
+        return FinalizeDouble(hasher);
+    }
+
+    CSHA256 hasher;
+    WriteLE32(hasher, txdata.m_version);
+    // ANYONECANPAY signs only its own input; NONE and SINGLE let the other
+    // inputs change their sequence numbers
+    const size_t first = anyone_can_pay ? input : 0;
+    const size_t last = anyone_can_pay ? input + 1 : inputs.size();
+    WriteCompactSize(hasher, last - first);
+    static const unsigned char empty_script = 0;
+    for (size_t i = first; i < last; i++) {
+        hasher.Write(inputs[i].prevout, 36);
+        if (i == input) {
+            WriteCompactSize(hasher, script_size);
+            hasher.Write(script_code, script_size);
+            WriteLE32(hasher, self.sequence);
+        } else {
+            hasher.Write(&empty_script, 1);
+            WriteLE32(hasher, base_type == SIGHASH_NONE || base_type == SIGHASH_SINGLE ? 0 : inputs[i].sequence);
+        }
+    }
+    if (base_type == SIGHASH_NONE) {
+        WriteCompactSize(hasher, 0);
+    } else if (base_type == SIGHASH_SINGLE) {
+        // Outputs before this input's become null: amount -1, no script
+        static const unsigned char null_output[9] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0};
+        WriteCompactSize(hasher, input + 1);
+        for (size_t i = 0; i < input; i++)
+            hasher.Write(null_output, sizeof(null_output));
+        hasher.Write(outputs.data() + offsets[input], offsets[input + 1] - offsets[input]);
+    } else {
+        WriteCompactSize(hasher, txdata.m_output_count);
+        hasher.Write(outputs.data(), outputs.size());
+    }
+    WriteLE32(hasher, txdata.m_locktime);
+    WriteLE32(hasher, hash_type);
+    return FinalizeDouble(hasher);
+}
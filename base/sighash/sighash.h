@@ -0,0 +1,113 @@
+// Copyright (c) 2009-2010 Satoshi Nakamoto
+// Copyright (c) 2009-2018 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_SIGHASH_H
+#define NIUBLOCK_SIGHASH_H
+
+#include "sha256.h"
+#include "uint256.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/** Signature hash types/flags */
+enum {
+    SIGHASH_ALL = 1,
+    SIGHASH_NONE = 2,
+    SIGHASH_SINGLE = 3,
+    SIGHASH_ANYONECANPAY = 0x80,
+};
+
+enum class SigVersion {
+    BASE = 0,           //!< the original transaction digest
+    WITNESS_V0 = 1,     //!< BIP143
+};
+
+/** An input as far as signature hashes see it */
+struct SighashInput
+{
+    unsigned char prevout[36];  //!< serialized outpoint: txid, then index little endian
+    uint32_t sequence;
+};
+
+/**
+ * What the signature hashes of a transaction's inputs have in common,
+ * computed once per transaction and shared by all its input checks.
+ *
+ * The original digest serializes a modified copy of the whole transaction
+ * for every input.  Here the transaction is serialized once: the outputs as
+ * they are, and every input with an empty script, which is how all inputs
+ * but the one being signed appear under SIGHASH_ALL.  A SHA256 midstate is
+ * kept after each of those inputs, so an input's digest starts from the
+ * state before it and hashes only its own script and what follows.  The
+ * consensus rules still make that tail O(n) per input, but nothing is
+ * copied or allocated per input any more.
+ *
+ * The BIP143 digest commits to hashPrevouts, hashSequence and hashOutputs
+ * instead, which are computed here once, and is O(1) per input.
+ *
+ * Inputs and outputs are given serialized, so the class is independent of
+ * any transaction type; see bitcoinsighash.h for libbitcoin transactions.
+ */
+class PrecomputedTransactionData
+{
+public:
+    PrecomputedTransactionData() : m_version(0), m_locktime(0), m_output_count(0) {}
+
+    /** outputs: the serialized outputs (amount, script with length) back to
+     *  back, as in a transaction after its output count */
+    PrecomputedTransactionData(uint32_t version, uint32_t locktime, std::vector<SighashInput> inputs,
+                               std::vector<unsigned char> outputs, size_t output_count);
+
+    size_t InputCount() const { return m_inputs.size(); }
+    size_t OutputCount() const { return m_output_count; }
+
+    /** BIP143 commitments, also usable on their own */
+    const uint256& HashPrevouts() const { return m_hash_prevouts; }
+    const uint256& HashSequence() const { return m_hash_sequence; }
+    const uint256& HashOutputs() const { return m_hash_outputs; }
+
+private:
+    friend uint256 SignatureHash(const PrecomputedTransactionData& txdata, uint32_t input,
+                                 const unsigned char* script_code, size_t script_size,
+                                 uint32_t hash_type, uint64_t amount, SigVersion sigversion);
+
+    uint32_t m_version;
+    uint32_t m_locktime;
+    std::vector<SighashInput> m_inputs;
+    std::vector<unsigned char> m_outputs;       //!< serialized outputs, without the count
+    std::vector<size_t> m_output_offsets;       //!< start of each output in m_outputs, and the end
+    size_t m_output_count;
+
+    /** SIGHASH_ALL: state after version, input count and inputs [0, i) */
+    std::vector<CSHA256> m_all_prefix;
+    /** SIGHASH_ALL: inputs with empty scripts, 41 bytes each */
+    std::vector<unsigned char> m_all_inputs;
+
+    uint256 m_hash_prevouts;
+    uint256 m_hash_sequence;
+    uint256 m_hash_outputs;
+};
+
+/**
+ * The digest a signature of input commits to, the same as Bitcoin Core's
+ * SignatureHash() and, for SigVersion::BASE, libbitcoin's
+ * script::generate_signature_hash().
+ *
+ * For SigVersion::BASE script_code must already be stripped of
+ * OP_CODESEPARATORs and amount is ignored.  The digest of an input out of
+ * range, or of SIGHASH_SINGLE without a matching output, is the constant 1
+ * as consensus demands.
+ */
+uint256 SignatureHash(const PrecomputedTransactionData& txdata, uint32_t input,
+                      const unsigned char* script_code, size_t script_size,
+                      uint32_t hash_type, uint64_t amount, SigVersion sigversion);
+
+/** Append a CompactSize length prefix */
+void WriteCompactSize(std::vector<unsigned char>& out, uint64_t size);
+
+#endif // NIUBLOCK_SIGHASH_H
@@ -0,0 +1,195 @@
+#include "sighash.h"
+#include "utilstrencodings.h"
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+typedef std::vector<unsigned char> Bytes;
+
+struct Output
+{
+  uint64_t amount;
+  Bytes script;
+};
+
+struct Tx
+{
+  uint32_t version;
+  std::vector<SighashInput> inputs;
+  std::vector<Bytes> scripts;
+  std::vector<Output> outputs;
+  uint32_t locktime;
+};
+
+static void PutLE(Bytes& out, uint64_t x, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    out.push_back((unsigned char)(x >> (8 * i)));
+}
+
+static uint64_t GetLE(const Bytes& in, size_t& pos, int bytes)
+{
+  uint64_t x = 0;
+  for (int i = 0; i < bytes; i++)
+    x |= (uint64_t)in[pos++] << (8 * i);
+  return x;
+}
+
+static uint64_t GetCompactSize(const Bytes& in, size_t& pos)
+{
+  const unsigned char first = in[pos++];
+  return first < 253 ? first : GetLE(in, pos, first == 253 ? 2 : first == 254 ? 4 : 8);
+}
+
+static Bytes GetScript(const Bytes& in, size_t& pos)
+{
+  const size_t size = GetCompactSize(in, pos);
+  pos += size;
+  return Bytes(in.begin() + pos - size, in.begin() + pos);
+}
+
+static Tx Parse(const std::string& hex)
+{
+  const Bytes raw = ParseHex(hex);
+  size_t pos = 0;
+  Tx tx;
+  tx.version = GetLE(raw, pos, 4);
+  for (size_t n = GetCompactSize(raw, pos); n > 0; n--) {
+    SighashInput in;
+    memcpy(in.prevout, &raw[pos], 36);
+    pos += 36;
+    tx.scripts.push_back(GetScript(raw, pos));
+    in.sequence = GetLE(raw, pos, 4);
+    tx.inputs.push_back(in);
+  }
+  for (size_t n = GetCompactSize(raw, pos); n > 0; n--) {
+    Output out;
+    out.amount = GetLE(raw, pos, 8);
+    out.script = GetScript(raw, pos);
+    tx.outputs.push_back(out);
+  }
+  tx.locktime = GetLE(raw, pos, 4);
+  assert(pos == raw.size());
+  return tx;
+}
+
+static Bytes SerializeOutput(const Output& out)
+{
+  Bytes bytes;
+  PutLE(bytes, out.amount, 8);
+  WriteCompactSize(bytes, out.script.size());
+  bytes.insert(bytes.end(), out.script.begin(), out.script.end());
+  return bytes;
+}
+
+static PrecomputedTransactionData Precompute(const Tx& tx)
+{
+  Bytes outputs;
+  for (const Output& out : tx.outputs) {
+    const Bytes bytes = SerializeOutput(out);
+    outputs.insert(outputs.end(), bytes.begin(), bytes.end());
+  }
+  return PrecomputedTransactionData(tx.version, tx.locktime, tx.inputs, outputs, tx.outputs.size());
+}
+
+static uint256 Hash(const Bytes& data)
+{
+  uint256 out;
+  CSHA256().Write(data.data(), data.size()).Finalize(out.begin());
+  CSHA256().Write(out.begin(), 32).Finalize(out.begin());
+  return out;
+}
+
+/** The original digest the slow way: modify a copy, serialize, hash */
+static uint256 ReferenceSignatureHash(Tx tx, uint32_t input, const Bytes& script_code, uint32_t hash_type)
+{
+  const uint32_t base = hash_type & 0x1f;
+  if (input >= tx.inputs.size() || (base == SIGHASH_SINGLE && input >= tx.outputs.size()))
+    return uint256S("01");
+  for (size_t i = 0; i < tx.inputs.size(); i++) {
+    tx.scripts[i] = i == input ? script_code : Bytes();
+    if (i != input && (base == SIGHASH_NONE || base == SIGHASH_SINGLE))
+      tx.inputs[i].sequence = 0;
+  }
+  if (hash_type & SIGHASH_ANYONECANPAY) {
+    tx.inputs = {tx.inputs[input]};
+    tx.scripts = {tx.scripts[input]};
+  }
+  if (base == SIGHASH_NONE) {
+    tx.outputs.clear();
+  } else if (base == SIGHASH_SINGLE) {
+    tx.outputs.resize(input + 1);
+    for (size_t i = 0; i < input; i++)
+      tx.outputs[i] = {~(uint64_t)0, Bytes()};
+  }
+  Bytes data;
+  PutLE(data, tx.version, 4);
+  WriteCompactSize(data, tx.inputs.size());
+  for (size_t i = 0; i < tx.inputs.size(); i++) {
+    data.insert(data.end(), tx.inputs[i].prevout, tx.inputs[i].prevout + 36);
+    WriteCompactSize(data, tx.scripts[i].size());
+    data.insert(data.end(), tx.scripts[i].begin(), tx.scripts[i].end());
+    PutLE(data, tx.inputs[i].sequence, 4);
+  }
+  WriteCompactSize(data, tx.outputs.size());
+  for (const Output& out : tx.outputs) {
+    const Bytes bytes = SerializeOutput(out);
+    data.insert(data.end(), bytes.begin(), bytes.end());
+  }
+  PutLE(data, tx.locktime, 4);
+  PutLE(data, hash_type, 4);
+  return Hash(data);
+}
+
+int main()
+{
+  // BIP143 native P2WPKH example
+  const Tx bip143 = Parse(
+      "0100000002fff7f7881a8099afa6940d42d1e7f6362bec38171ea3edf433541db4e4ad969f0000000000eeffffff"
+      "ef51e1b804cc89d182d279655c3aa89e815b1b309fe287d9b2b55d57b90ec68a0100000000ffffffff02202cb206"
+      "000000001976a9148280b37df378db99f66f85c95a783a76ac7a6d5988ac9093510d000000001976a9143bde42db"
+      "ee7e4dbe6a21b2d50ce2f0167faa815988ac11000000");
+  const PrecomputedTransactionData txdata = Precompute(bip143);
+  assert(HexStr(txdata.HashPrevouts()) == "96b827c8483d4e9b96712b6713a7b68d6e8003a781feba36c31143470b4efd37");
+  assert(HexStr(txdata.HashSequence()) == "52b0a642eea2fb7ae638c36f6252b6750293dbe574a806984b8e4d8548339a3b");
+  assert(HexStr(txdata.HashOutputs()) == "863ef3e1a92afbfdb97f31ad0fc7683ee943e9abcf2501590ff8f6551f47e5e5");
+  const Bytes script_code = ParseHex("76a9141d0f172a0ecb48aee1be1f2687d2963ae33f71a188ac");
+  const uint256 sighash = SignatureHash(txdata, 1, script_code.data(), script_code.size(), SIGHASH_ALL,
+                                        600000000, SigVersion::WITNESS_V0);
+  assert(HexStr(sighash) == "c37af31116d1b27caf68aae9e3ac82f1477929014d5b917657d0eb49478cb670");
+  std::cout << "bip143: ok" << std::endl;
+
+  // The original digest agrees with modifying and serializing a copy, for
+  // every input and hash type
+  Tx tx;
+  tx.version = 2;
+  tx.locktime = 500000;
+  uint32_t rng = 7;
+  for (int i = 0; i < 300; i++) {
+    SighashInput in;
+    for (int b = 0; b < 36; b++)
+      in.prevout[b] = (unsigned char)(rng = rng * 1103515245 + 12345) >> 16;
+    in.sequence = rng;
+    tx.inputs.push_back(in);
+    tx.scripts.push_back(Bytes(i % 5 * 30, (unsigned char)i));
+    if (i % 3 == 0)
+      tx.outputs.push_back({(uint64_t)i * 1000, Bytes(i % 7 * 50, (unsigned char)i)});
+  }
+  const PrecomputedTransactionData data = Precompute(tx);
+  assert(data.InputCount() == 300 && data.OutputCount() == 100);
+  for (uint32_t hash_type : {1, 2, 3, 0x81, 0x82, 0x83, 0, 4, 0x41}) {
+    for (uint32_t input : {0, 1, 2, 99, 100, 150, 298, 299, 300}) {
+      const Bytes& code = tx.scripts[input % 300];
+      assert(SignatureHash(data, input, code.data(), code.size(), hash_type, 0, SigVersion::BASE) ==
+             ReferenceSignatureHash(tx, input, code, hash_type));
+    }
+  }
+  // A script longer than 252 bytes has a longer length prefix
+  const Bytes long_code(1000, 0xac);
+  assert(SignatureHash(data, 5, long_code.data(), long_code.size(), SIGHASH_ALL, 0, SigVersion::BASE) ==
+         ReferenceSignatureHash(tx, 5, long_code, SIGHASH_ALL));
+  assert(SignatureHash(data, 300, nullptr, 0, SIGHASH_ALL, 0, SigVersion::BASE) == uint256S("01"));
+  std::cout << "legacy: ok" << std::endl;
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Spans around libbitcoin's validation stages.  The prebuilt library cannot
+ * be instrumented from inside, so callers go through these wrappers
+ * instead of calling the members directly:
+ *
+ *   block.check()                      -> CheckBlock(block)
+ *   block.accept(state)                -> AcceptBlock(block, state)
+ *   block.connect(state)               -> ConnectBlock(block, state)
+ *   tx.connect_input(state, index)     -> ConnectInput(tx, state, index)
+ *
+ * and wrap jobs posted to a bc::dispatcher with Traced() (see trace.h):
+ *
+ *   dispatch.concurrent(NiuTrace::Traced("dispatcher::connect_inputs", handler), args...);
+ *
+ * Span arguments are only computed while tracing: total_inputs() walks
+ * every transaction.
+ */
+#ifndef NIUBLOCK_BITCOINTRACE_H
+#define NIUBLOCK_BITCOINTRACE_H
+
+#include "trace.h"
+
+#include <bitcoin/bitcoin.hpp>
+
+namespace NiuTrace {
+
+inline bc::code CheckBlock(const bc::chain::block& block)
+{
+    TRACE_SPAN_VAR(span, "block::check");
+    if (span.Active())
+        span.SetArg("transactions", block.transactions().size());
+    return block.check();
+}
+
+inline bc::code AcceptBlock(const bc::chain::block& block, const bc::chain::chain_state& state,
+                            bool transactions = true, bool header = true)
+{
+    TRACE_SPAN_VAR(span, "block::accept");
+    if (span.Active())
+        span.SetArg("transactions", block.transactions().size());
+    return block.accept(state, transactions, header);
+}
+
+inline bc::code ConnectBlock(const bc::chain::block& block, const bc::chain::chain_state& state)
+{
+    TRACE_SPAN_VAR(span, "block::connect");
+    if (span.Active())
+        span.SetArg("inputs", block.total_inputs());
+    return block.connect(state);
+}
+
+inline bc::code ConnectInput(const bc::chain::transaction& tx, const bc::chain::chain_state& state,
+                             size_t input_index)
+{
+    TRACE_SPAN("transaction::connect_input");
+    return tx.connect_input(state, input_index);
+}
+
+} // namespace NiuTrace
+
+#endif // NIUBLOCK_BITCOINTRACE_H
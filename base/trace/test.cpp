@@ -0,0 +1,104 @@
+#include "trace.h"
+#undef NDEBUG
+#include <assert.h>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static size_t Count(const std::string& text, const std::string& part)
+{
+  size_t n = 0;
+  for (size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1))
+    n++;
+  return n;
+}
+
+static int Work(int depth)
+{
+  TRACE_SPAN("test::work");
+  return depth ? Work(depth - 1) + 1 : 0;
+}
+
+int main()
+{
+  NiuTrace::Tracer& tracer = NiuTrace::TraceInstance();
+
+  // Nothing is recorded before Start()
+  Work(3);
+  {
+    TRACE_SPAN_VAR(span, "block::connect");
+    assert(!span.Active());
+  }
+  std::string json;
+  tracer.WriteChromeJson(json);
+  assert(Count(json, "\"ph\":\"X\"") == 0);
+
+  tracer.Start();
+  tracer.SetThreadName("main \"thread\"");
+  {
+    TRACE_SPAN_VAR(span, "block::connect");
+    assert(span.Active());
+    span.SetArg("inputs", 1234);
+    Work(2);
+  }
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 3; t++) {
+    workers.emplace_back([&tracer, t] {
+      tracer.SetThreadName("worker " + std::to_string(t));
+      for (int i = 0; i < 100; i++)
+        Work(1);
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  std::function<int(int)> job = NiuTrace::Traced("dispatcher::job", [](int x) { return x * 2; });
+  const int doubled = job(21);
+  assert(doubled == 42);
+  tracer.Stop();
+  Work(5);
+
+  json.clear();
+  tracer.WriteChromeJson(json);
+  assert(json.compare(0, 16, "{\"traceEvents\":[") == 0);
+  assert(Count(json, "\"ph\":\"X\"") == 1 + 3 + 3 * 100 * 2 + 1);
+  assert(Count(json, "\"name\":\"test::work\",\"cat\":\"test\"") == 3 + 600);
+  assert(Count(json, "\"name\":\"block::connect\",\"cat\":\"block\"") == 1);
+  assert(Count(json, "\"args\":{\"inputs\":1234}") == 1);
+  assert(Count(json, "\"name\":\"dispatcher::job\"") == 1 && Count(json, "\"queued_us\":") == 1);
+  assert(Count(json, "\"name\":\"thread_name\"") == 4);
+  assert(Count(json, "\"args\":{\"name\":\"main \\\"thread\\\"\"}") == 1);
+  assert(Count(json, "\"args\":{\"name\":\"worker 2\"}") == 1);
+  assert(json.find("\"dropped_events\":0}") != std::string::npos);
+  std::cout << "chrome json: ok" << std::endl;
+
+  // A new session starts empty; a full buffer drops and counts
+  NiuTrace::TraceOptions options;
+  options.events_per_thread = 10;
+  tracer.Start(options);
+  for (int i = 0; i < 25; i++)
+    Work(0);
+  tracer.Stop();
+  json.clear();
+  tracer.WriteChromeJson(json);
+  assert(Count(json, "\"ph\":\"X\"") == 10);
+  assert(tracer.Dropped() == 15);
+  assert(json.find("\"dropped_events\":15}") != std::string::npos);
+  std::cout << "sessions: ok" << std::endl;
+
+  // Rough cost per span, stopped and recording
+  const int n = 1000000;
+  int64_t start = NiuTrace::Tracer::NowNanos();
+  for (int i = 0; i < n; i++)
+    Work(0);
+  const int64_t off = NiuTrace::Tracer::NowNanos() - start;
+  options.events_per_thread = n;
+  tracer.Start(options);
+  start = NiuTrace::Tracer::NowNanos();
+  for (int i = 0; i < n; i++)
+    Work(0);
+  const int64_t on = NiuTrace::Tracer::NowNanos() - start;
+  tracer.Stop();
+  assert(tracer.Dropped() == 0);
+  std::cout << "span cost: " << double(off) / n << " ns stopped, " << double(on) / n << " ns recording" << std::endl;
+}
@@ -0,0 +1,204 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "trace.h"
+
+#include "tinyformat.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace NiuTrace {
+
+std::atomic<bool> g_trace_enabled(false);
+
+ThreadBuffer::ThreadBuffer(size_t capacity, uint64_t session_in)
+    : session(session_in), tid(0), retired(false), m_events(capacity), m_count(0), m_dropped(0)
+{
+}
+
+namespace {
+
+/** The calling thread's buffer, retired when the thread exits */
+struct ThreadBufferHolder
+{
+    ThreadBuffer* buffer = nullptr;
+    std::string name;
+
+    ~ThreadBufferHolder()
+    {
+        if (buffer)
+            buffer->retired.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadBufferHolder g_thread_buffer;
+
+/** Append str as the body of a JSON string */
+void AppendJsonEscaped(std::string& out, const char* str, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        const unsigned char c = str[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c < 0x20) {
+            out += strprintf("\\u%04x", c);
+        } else {
+            out += c;
+        }
+    }
+}
+
+} // namespace
+
+Tracer::Tracer()
+    : m_session(0), m_start_ns(0)
+{
+}
+
+int64_t Tracer::NowNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void Tracer::Start(const TraceOptions& options)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Buffers of exited threads are no longer referenced; those of live
+    // threads are replaced by the threads themselves on their next span
+    std::vector<ThreadBuffer*> kept;
+    for (ThreadBuffer* buffer : m_buffers) {
+        if (buffer->retired.load(std::memory_order_acquire))
+            delete buffer;
+        else
+            kept.push_back(buffer);
+    }
+    m_buffers.swap(kept);
+    m_options = options;
+    m_start_ns = NowNanos();
+    m_session.fetch_add(1, std::memory_order_relaxed);
+    g_trace_enabled.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop()
+{
+    g_trace_enabled.store(false, std::memory_order_release);
+}
+
+ThreadBuffer* Tracer::CurrentBuffer()
+{
+    ThreadBuffer* buffer = g_thread_buffer.buffer;
+    if (buffer && buffer->session == m_session.load(std::memory_order_relaxed))
+        return buffer;
+    return NewBuffer();
+}
+
+ThreadBuffer* Tracer::NewBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ThreadBuffer* buffer = new ThreadBuffer(m_options.events_per_thread, m_session.load(std::memory_order_relaxed));
+    buffer->tid = syscall(SYS_gettid);
+    buffer->thread_name = g_thread_buffer.name;
+    if (g_thread_buffer.buffer)
+        g_thread_buffer.buffer->retired.store(true, std::memory_order_release);
+    g_thread_buffer.buffer = buffer;
+    m_buffers.push_back(buffer);
+    return buffer;
+}
+
+void Tracer::SetThreadName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    g_thread_buffer.name = name;
+    if (g_thread_buffer.buffer)
+        g_thread_buffer.buffer->thread_name = name;
+}
+
+void Tracer::WriteChromeJson(std::string& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint64_t session = m_session.load(std::memory_order_relaxed);
+    const int pid = getpid();
+    uint64_t dropped = 0;
+    bool first = true;
+    out += "{\"traceEvents\":[\n";
+    for (const ThreadBuffer* buffer : m_buffers) {
+        if (buffer->session != session)
+            continue;
+        dropped += buffer->Dropped();
+        if (!buffer->thread_name.empty()) {
+            out += strprintf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"",
+                             first ? "" : ",\n", pid, buffer->tid);
+            AppendJsonEscaped(out, buffer->thread_name.data(), buffer->thread_name.size());
+            out += "\"}}";
+            first = false;
+        }
+        const size_t count = buffer->Count();
+        for (size_t i = 0; i < count; i++) {
+            const TraceEvent& e = buffer->Event(i);
+            const char* sep = strstr(e.name, "::");
+            const size_t name_len = strlen(e.name);
+            out += first ? "{\"name\":\"" : ",\n{\"name\":\"";
+            first = false;
+            AppendJsonEscaped(out, e.name, name_len);
+            out += "\",\"cat\":\"";
+            AppendJsonEscaped(out, e.name, sep ? size_t(sep - e.name) : name_len);
+            // Timestamps in microseconds from the start of the session
+            out += strprintf("\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                             (e.start_ns - m_start_ns) / 1e3, e.duration_ns / 1e3, pid, buffer->tid);
+            if (e.arg_name) {
+                out += ",\"args\":{\"";
+                AppendJsonEscaped(out, e.arg_name, strlen(e.arg_name));
+                out += strprintf("\":%d}", e.arg);
+            }
+            out += "}";
+        }
+    }
+    out += strprintf("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":%u}}\n", dropped);
+}
+
+bool Tracer::WriteChromeJsonFile(const std::string& path) const
+{
+    std::string json;
+    WriteChromeJson(json);
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    const bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+    return fclose(file) == 0 && ok;
+}
+
+uint64_t Tracer::Dropped() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint64_t session = m_session.load(std::memory_order_relaxed);
+    uint64_t dropped = 0;
+    for (const ThreadBuffer* buffer : m_buffers) {
+        if (buffer->session == session)
+            dropped += buffer->Dropped();
+    }
+    return dropped;
+}
+
+Tracer& TraceInstance()
+{
+    // Leaked so that threads exiting after main() can still retire buffers
+    static Tracer* tracer = new Tracer();
+    return *tracer;
+}
+
+void Span::Finish()
+{
+    const int64_t end = Tracer::NowNanos();
+    const TraceEvent event = {m_name, m_start, end - m_start, m_arg_name, m_arg};
+    TraceInstance().CurrentBuffer()->Append(event);
+}
+
+} // namespace NiuTrace
@@ -0,0 +1,250 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Scoped tracing spans.
+ *
+ * TRACE_SPAN("block::connect") times the enclosing scope.  While tracing
+ * is stopped a span costs one relaxed atomic load and a branch; building
+ * with NIUBLOCK_NO_TRACING removes the spans altogether.  While tracing
+ * runs, each span end appends one fixed-size event to a buffer owned by the
+ * calling thread, without locks or allocation.  A full buffer drops further
+ * events and counts them.
+ *
+ * Only the pointer of a span name is stored, so names must be static
+ * strings; TRACE_SPAN() accepts nothing but a string literal.
+ * The part of a name before "::" becomes the event category, so
+ * "block::check" and "block::connect" can be filtered together.
+ * The collected events are exported in the Chrome trace event format, which
+ * chrome://tracing and https://ui.perfetto.dev open directly.
+ */
+#ifndef NIUBLOCK_TRACE_H
+#define NIUBLOCK_TRACE_H
+
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace NiuTrace {
+
+/** One completed span */
+struct TraceEvent
+{
+    const char* name;
+    int64_t start_ns;
+    int64_t duration_ns;
+    const char* arg_name;   //!< optional integer argument, nullptr if none
+    int64_t arg;
+};
+
+/** Events of one thread: appended by that thread, read by the exporter */
+class ThreadBuffer
+{
+public:
+    ThreadBuffer(size_t capacity, uint64_t session);
+
+    /** Owner thread only */
+    void Append(const TraceEvent& event)
+    {
+        const size_t n = m_count.load(std::memory_order_relaxed);
+        if (n == m_events.size()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_events[n] = event;
+        m_count.store(n + 1, std::memory_order_release);
+    }
+
+    /** Events published so far; safe from any thread */
+    size_t Count() const { return m_count.load(std::memory_order_acquire); }
+    const TraceEvent& Event(size_t i) const { return m_events[i]; }
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    uint64_t session;
+    int tid;
+    std::string thread_name;
+    std::atomic<bool> retired;   //!< set when the owning thread exited
+
+private:
+    std::vector<TraceEvent> m_events;
+    std::atomic<size_t> m_count;
+    std::atomic<uint64_t> m_dropped;
+};
+
+struct TraceOptions
+{
+    size_t events_per_thread = 1 << 16;     //!< 2.5 MB per thread
+};
+
+/** Set while a session records; read by every span */
+extern std::atomic<bool> g_trace_enabled;
+
+class Tracer
+{
+public:
+    /** Start a new session; events of earlier sessions are discarded */
+    void Start(const TraceOptions& options = TraceOptions());
+    /** Stop recording; the events stay available for export */
+    void Stop();
+    bool Enabled() const { return g_trace_enabled.load(std::memory_order_relaxed); }
+
+    /** Buffer of the calling thread for the current session */
+    ThreadBuffer* CurrentBuffer();
+    /** Name the calling thread in the trace, e.g. "validation 3" */
+    void SetThreadName(const std::string& name);
+
+    /** Append the session's events as a Chrome trace event JSON document.
+     *  Spans that are still open are not included. */
+    void WriteChromeJson(std::string& out) const;
+    bool WriteChromeJsonFile(const std::string& path) const;
+
+    /** Events dropped because a thread's buffer was full */
+    uint64_t Dropped() const;
+
+    static int64_t NowNanos();
+
+private:
+    Tracer();
+    friend Tracer& TraceInstance();
+
+    ThreadBuffer* NewBuffer();
+
+    std::atomic<uint64_t> m_session;
+    int64_t m_start_ns;
+    TraceOptions m_options;
+    mutable std::mutex m_mutex;
+    std::vector<ThreadBuffer*> m_buffers;
+};
+
+/** The process wide tracer */
+Tracer& TraceInstance();
+
+/** RAII span, use through TRACE_SPAN() */
+class Span
+{
+public:
+    /** name must stay valid until the trace is exported: a string literal
+     *  or other static string, never a buffer */
+    explicit Span(const char* name)
+        : m_start(-1)
+    {
+        if (g_trace_enabled.load(std::memory_order_relaxed)) {
+            m_name = name;
+            m_arg_name = nullptr;
+            m_arg = 0;
+            m_start = Tracer::NowNanos();
+        }
+    }
+
+    /** For TracedJob: posted is when the job was queued or -1 */
+    Span(const char* name, int64_t posted)
+        : m_start(-1)
+    {
+        if (g_trace_enabled.load(std::memory_order_relaxed)) {
+            m_name = name;
+            m_start = Tracer::NowNanos();
+            m_arg_name = posted >= 0 ? "queued_us" : nullptr;
+            m_arg = posted >= 0 ? (m_start - posted) / 1000 : 0;
+        }
+    }
+
+    ~Span()
+    {
+        if (m_start >= 0)
+            Finish();
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /** Whether the span is being recorded; check it before computing an
+     *  argument that is not free */
+    bool Active() const { return m_start >= 0; }
+
+    /** Attach an integer to the event, e.g. the number of inputs.  arg_name
+     *  must be a string literal. */
+    void SetArg(const char* arg_name, int64_t value)
+    {
+        m_arg_name = arg_name;
+        m_arg = value;
+    }
+
+private:
+    void Finish();
+
+    int64_t m_start;
+    const char* m_name;
+    const char* m_arg_name;
+    int64_t m_arg;
+};
+
+/**
+ * A job that records itself as a span when it runs, with the time it spent
+ * queued as the "queued_us" argument.  Wrap jobs before handing them to a
+ * thread pool or dispatcher, see Traced().
+ */
+template<typename Job>
+class TracedJob
+{
+public:
+    TracedJob(const char* name, Job job)
+        : m_name(name), m_job(std::move(job)),
+          m_posted(g_trace_enabled.load(std::memory_order_relaxed) ? Tracer::NowNanos() : -1) {}
+
+    template<typename... Args>
+    auto operator()(Args&&... args) -> decltype(std::declval<Job&>()(std::forward<Args>(args)...))
+    {
+        Span span(m_name, m_posted);
+        return m_job(std::forward<Args>(args)...);
+    }
+
+private:
+    const char* m_name;
+    Job m_job;
+    int64_t m_posted;
+};
+
+/** name must be a static string, as for Span */
+#ifdef NIUBLOCK_NO_TRACING
+template<typename Job>
+typename std::decay<Job>::type Traced(const char*, Job&& job)
+{
+    return std::forward<Job>(job);
+}
+#else
+template<typename Job>
+TracedJob<typename std::decay<Job>::type> Traced(const char* name, Job&& job)
+{
+    return TracedJob<typename std::decay<Job>::type>(name, std::forward<Job>(job));
+}
+#endif
+
+/** Stands in for a Span when tracing is compiled out */
+struct NullSpan
+{
+    bool Active() const { return false; }
+    void SetArg(const char*, int64_t) {}
+};
+
+} // namespace NiuTrace
+
+#define TRACE_CAT2(a, b) a ## b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+
+#ifdef NIUBLOCK_NO_TRACING
+#define TRACE_SPAN(name)
+#define TRACE_SPAN_VAR(var, name) NiuTrace::NullSpan var
+#else
+/** Time the rest of the enclosing scope; "" name only compiles for a literal */
+#define TRACE_SPAN(name) NiuTrace::Span TRACE_CAT(trace_span_, __LINE__)("" name)
+/** Same, with a named span object for SetArg() */
+#define TRACE_SPAN_VAR(var, name) NiuTrace::Span var("" name)
+#endif
+
+#endif // NIUBLOCK_TRACE_H
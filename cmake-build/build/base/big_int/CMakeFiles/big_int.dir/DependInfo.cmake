@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/base/big_int/arith_uint256.cpp" "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/arith_uint256.cpp.o" "gcc" "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/arith_uint256.cpp.o.d"
+  "/root/repo/base/big_int/uint256.cpp" "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/uint256.cpp.o" "gcc" "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/uint256.cpp.o.d"
+  "/root/repo/base/big_int/utilstrencodings.cpp" "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/utilstrencodings.cpp.o" "gcc" "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/utilstrencodings.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/big_int.dir/arith_uint256.cpp.o"
+  "CMakeFiles/big_int.dir/arith_uint256.cpp.o.d"
+  "CMakeFiles/big_int.dir/uint256.cpp.o"
+  "CMakeFiles/big_int.dir/uint256.cpp.o.d"
+  "CMakeFiles/big_int.dir/utilstrencodings.cpp.o"
+  "CMakeFiles/big_int.dir/utilstrencodings.cpp.o.d"
+  "libbig_int.a"
+  "libbig_int.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/big_int.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/big_int_test.dir/test.cpp.o"
+  "CMakeFiles/big_int_test.dir/test.cpp.o.d"
+  "big_int_test"
+  "big_int_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/big_int_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/big_int
+# Build directory: /root/repo/cmake-build/build/base/big_int
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(big_int_test "/root/repo/cmake-build/build/base/big_int/big_int_test")
+set_tests_properties(big_int_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/big_int/CMakeLists.txt;12;add_test;/root/repo/base/big_int/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niublockstore.dir/blockstore.cpp.o"
+  "CMakeFiles/niublockstore.dir/blockstore.cpp.o.d"
+  "libniublockstore.a"
+  "libniublockstore.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niublockstore.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niublockstore_test.dir/test.cpp.o"
+  "CMakeFiles/niublockstore_test.dir/test.cpp.o.d"
+  "niublockstore_test"
+  "niublockstore_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niublockstore_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/blockstore
+# Build directory: /root/repo/cmake-build/build/base/blockstore
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niublockstore_test "/root/repo/cmake-build/build/base/blockstore/niublockstore_test")
+set_tests_properties(niublockstore_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/blockstore/CMakeLists.txt;11;add_test;/root/repo/base/blockstore/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niublockview.dir/blockview.cpp.o"
+  "CMakeFiles/niublockview.dir/blockview.cpp.o.d"
+  "libniublockview.a"
+  "libniublockview.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niublockview.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
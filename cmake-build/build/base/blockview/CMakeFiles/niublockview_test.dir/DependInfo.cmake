@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/base/blockview/test.cpp" "/root/repo/cmake-build/build/base/blockview/CMakeFiles/niublockview_test.dir/test.cpp.o" "gcc" "/root/repo/cmake-build/build/base/blockview/CMakeFiles/niublockview_test.dir/test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/cmake-build/build/base/blockview/CMakeFiles/niublockview.dir/DependInfo.cmake"
+  "/root/repo/cmake-build/build/base/memory/CMakeFiles/niumem.dir/DependInfo.cmake"
+  "/root/repo/cmake-build/build/base/script/CMakeFiles/niuscript.dir/DependInfo.cmake"
+  "/root/repo/cmake-build/build/base/merkle/CMakeFiles/niumerkle.dir/DependInfo.cmake"
+  "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/DependInfo.cmake"
+  "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
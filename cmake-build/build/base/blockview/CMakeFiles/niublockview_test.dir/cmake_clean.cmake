@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niublockview_test.dir/test.cpp.o"
+  "CMakeFiles/niublockview_test.dir/test.cpp.o.d"
+  "niublockview_test"
+  "niublockview_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niublockview_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
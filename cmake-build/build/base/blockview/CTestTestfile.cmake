@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/blockview
+# Build directory: /root/repo/cmake-build/build/base/blockview
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niublockview_test "/root/repo/cmake-build/build/base/blockview/niublockview_test")
+set_tests_properties(niublockview_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/blockview/CMakeLists.txt;11;add_test;/root/repo/base/blockview/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niuchainindex.dir/chainindex.cpp.o"
+  "CMakeFiles/niuchainindex.dir/chainindex.cpp.o.d"
+  "libniuchainindex.a"
+  "libniuchainindex.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niuchainindex.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niuchainindex_test.dir/test.cpp.o"
+  "CMakeFiles/niuchainindex_test.dir/test.cpp.o.d"
+  "niuchainindex_test"
+  "niuchainindex_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niuchainindex_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/chainindex
+# Build directory: /root/repo/cmake-build/build/base/chainindex
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niuchainindex_test "/root/repo/cmake-build/build/base/chainindex/niuchainindex_test")
+set_tests_properties(niuchainindex_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/chainindex/CMakeLists.txt;11;add_test;/root/repo/base/chainindex/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niucheckqueue.dir/checkqueue.cpp.o"
+  "CMakeFiles/niucheckqueue.dir/checkqueue.cpp.o.d"
+  "libniucheckqueue.a"
+  "libniucheckqueue.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niucheckqueue.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
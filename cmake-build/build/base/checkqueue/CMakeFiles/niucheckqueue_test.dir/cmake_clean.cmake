@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niucheckqueue_test.dir/test.cpp.o"
+  "CMakeFiles/niucheckqueue_test.dir/test.cpp.o.d"
+  "niucheckqueue_test"
+  "niucheckqueue_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niucheckqueue_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/checkqueue
+# Build directory: /root/repo/cmake-build/build/base/checkqueue
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niucheckqueue_test "/root/repo/cmake-build/build/base/checkqueue/niucheckqueue_test")
+set_tests_properties(niucheckqueue_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/checkqueue/CMakeLists.txt;11;add_test;/root/repo/base/checkqueue/CMakeLists.txt;0;")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niucoins.dir/coins.cpp.o"
+  "CMakeFiles/niucoins.dir/coins.cpp.o.d"
+  "CMakeFiles/niucoins.dir/coinscache.cpp.o"
+  "CMakeFiles/niucoins.dir/coinscache.cpp.o.d"
+  "CMakeFiles/niucoins.dir/coinslog.cpp.o"
+  "CMakeFiles/niucoins.dir/coinslog.cpp.o.d"
+  "libniucoins.a"
+  "libniucoins.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niucoins.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niucoins_test.dir/test.cpp.o"
+  "CMakeFiles/niucoins_test.dir/test.cpp.o.d"
+  "niucoins_test"
+  "niucoins_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niucoins_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
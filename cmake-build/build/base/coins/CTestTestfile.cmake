@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/coins
+# Build directory: /root/repo/cmake-build/build/base/coins
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niucoins_test "/root/repo/cmake-build/build/base/coins/niucoins_test")
+set_tests_properties(niucoins_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/coins/CMakeLists.txt;13;add_test;/root/repo/base/coins/CMakeLists.txt;0;")
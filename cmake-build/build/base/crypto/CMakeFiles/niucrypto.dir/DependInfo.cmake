@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/base/crypto/sha256.cpp" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256.cpp.o" "gcc" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256.cpp.o.d"
+  "/root/repo/base/crypto/sha256_avx2.cpp" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_avx2.cpp.o" "gcc" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_avx2.cpp.o.d"
+  "/root/repo/base/crypto/sha256_avx512.cpp" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_avx512.cpp.o" "gcc" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_avx512.cpp.o.d"
+  "/root/repo/base/crypto/sha256_shani.cpp" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_shani.cpp.o" "gcc" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_shani.cpp.o.d"
+  "/root/repo/base/crypto/sha256_sse41.cpp" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_sse41.cpp.o" "gcc" "/root/repo/cmake-build/build/base/crypto/CMakeFiles/niucrypto.dir/sha256_sse41.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niucrypto.dir/sha256.cpp.o"
+  "CMakeFiles/niucrypto.dir/sha256.cpp.o.d"
+  "CMakeFiles/niucrypto.dir/sha256_avx2.cpp.o"
+  "CMakeFiles/niucrypto.dir/sha256_avx2.cpp.o.d"
+  "CMakeFiles/niucrypto.dir/sha256_avx512.cpp.o"
+  "CMakeFiles/niucrypto.dir/sha256_avx512.cpp.o.d"
+  "CMakeFiles/niucrypto.dir/sha256_shani.cpp.o"
+  "CMakeFiles/niucrypto.dir/sha256_shani.cpp.o.d"
+  "CMakeFiles/niucrypto.dir/sha256_sse41.cpp.o"
+  "CMakeFiles/niucrypto.dir/sha256_sse41.cpp.o.d"
+  "libniucrypto.a"
+  "libniucrypto.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niucrypto.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niucrypto_test.dir/test.cpp.o"
+  "CMakeFiles/niucrypto_test.dir/test.cpp.o.d"
+  "niucrypto_test"
+  "niucrypto_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niucrypto_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
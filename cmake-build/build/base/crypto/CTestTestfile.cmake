@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/crypto
+# Build directory: /root/repo/cmake-build/build/base/crypto
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niucrypto_test "/root/repo/cmake-build/build/base/crypto/niucrypto_test")
+set_tests_properties(niucrypto_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/crypto/CMakeLists.txt;42;add_test;/root/repo/base/crypto/CMakeLists.txt;0;")
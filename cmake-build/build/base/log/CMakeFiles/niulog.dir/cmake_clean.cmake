@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niulog.dir/binarylog.cpp.o"
+  "CMakeFiles/niulog.dir/binarylog.cpp.o.d"
+  "CMakeFiles/niulog.dir/logging.cpp.o"
+  "CMakeFiles/niulog.dir/logging.cpp.o.d"
+  "libniulog.a"
+  "libniulog.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niulog.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niulog_test.dir/test.cpp.o"
+  "CMakeFiles/niulog_test.dir/test.cpp.o.d"
+  "niulog_test"
+  "niulog_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niulog_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
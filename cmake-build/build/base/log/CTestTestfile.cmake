@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/log
+# Build directory: /root/repo/cmake-build/build/base/log
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niulog_test "/root/repo/cmake-build/build/base/log/niulog_test")
+set_tests_properties(niulog_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/log/CMakeLists.txt;12;add_test;/root/repo/base/log/CMakeLists.txt;0;")
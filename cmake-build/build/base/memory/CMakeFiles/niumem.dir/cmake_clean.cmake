@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumem.dir/arena.cpp.o"
+  "CMakeFiles/niumem.dir/arena.cpp.o.d"
+  "CMakeFiles/niumem.dir/memaccount.cpp.o"
+  "CMakeFiles/niumem.dir/memaccount.cpp.o.d"
+  "libniumem.a"
+  "libniumem.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumem.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
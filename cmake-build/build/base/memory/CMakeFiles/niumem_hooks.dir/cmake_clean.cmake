@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumem_hooks.dir/memhooks.cpp.o"
+  "CMakeFiles/niumem_hooks.dir/memhooks.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumem_hooks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
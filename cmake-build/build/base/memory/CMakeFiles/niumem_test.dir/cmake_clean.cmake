@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumem_test.dir/test.cpp.o"
+  "CMakeFiles/niumem_test.dir/test.cpp.o.d"
+  "niumem_test"
+  "niumem_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumem_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/memory
+# Build directory: /root/repo/cmake-build/build/base/memory
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niumem_test "/root/repo/cmake-build/build/base/memory/niumem_test")
+set_tests_properties(niumem_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/memory/CMakeLists.txt;19;add_test;/root/repo/base/memory/CMakeLists.txt;0;")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumerkle.dir/merkle.cpp.o"
+  "CMakeFiles/niumerkle.dir/merkle.cpp.o.d"
+  "CMakeFiles/niumerkle.dir/merkletree.cpp.o"
+  "CMakeFiles/niumerkle.dir/merkletree.cpp.o.d"
+  "libniumerkle.a"
+  "libniumerkle.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumerkle.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumerkle_test.dir/test.cpp.o"
+  "CMakeFiles/niumerkle_test.dir/test.cpp.o.d"
+  "niumerkle_test"
+  "niumerkle_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumerkle_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/merkle
+# Build directory: /root/repo/cmake-build/build/base/merkle
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niumerkle_test "/root/repo/cmake-build/build/base/merkle/niumerkle_test")
+set_tests_properties(niumerkle_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/merkle/CMakeLists.txt;12;add_test;/root/repo/base/merkle/CMakeLists.txt;0;")
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/base/metrics/blockmetrics.cpp" "/root/repo/cmake-build/build/base/metrics/CMakeFiles/niumetrics.dir/blockmetrics.cpp.o" "gcc" "/root/repo/cmake-build/build/base/metrics/CMakeFiles/niumetrics.dir/blockmetrics.cpp.o.d"
+  "/root/repo/base/metrics/hdrhistogram.cpp" "/root/repo/cmake-build/build/base/metrics/CMakeFiles/niumetrics.dir/hdrhistogram.cpp.o" "gcc" "/root/repo/cmake-build/build/base/metrics/CMakeFiles/niumetrics.dir/hdrhistogram.cpp.o.d"
+  "/root/repo/base/metrics/metrics.cpp" "/root/repo/cmake-build/build/base/metrics/CMakeFiles/niumetrics.dir/metrics.cpp.o" "gcc" "/root/repo/cmake-build/build/base/metrics/CMakeFiles/niumetrics.dir/metrics.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/cmake-build/build/base/big_int/CMakeFiles/big_int.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
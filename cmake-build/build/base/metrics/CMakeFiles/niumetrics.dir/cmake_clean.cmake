@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumetrics.dir/blockmetrics.cpp.o"
+  "CMakeFiles/niumetrics.dir/blockmetrics.cpp.o.d"
+  "CMakeFiles/niumetrics.dir/hdrhistogram.cpp.o"
+  "CMakeFiles/niumetrics.dir/hdrhistogram.cpp.o.d"
+  "CMakeFiles/niumetrics.dir/metrics.cpp.o"
+  "CMakeFiles/niumetrics.dir/metrics.cpp.o.d"
+  "libniumetrics.a"
+  "libniumetrics.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumetrics.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
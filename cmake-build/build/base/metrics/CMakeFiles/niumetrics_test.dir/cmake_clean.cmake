@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niumetrics_test.dir/test.cpp.o"
+  "CMakeFiles/niumetrics_test.dir/test.cpp.o.d"
+  "niumetrics_test"
+  "niumetrics_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niumetrics_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
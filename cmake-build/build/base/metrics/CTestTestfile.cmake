@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/metrics
+# Build directory: /root/repo/cmake-build/build/base/metrics
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niumetrics_test "/root/repo/cmake-build/build/base/metrics/niumetrics_test")
+set_tests_properties(niumetrics_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/metrics/CMakeLists.txt;25;add_test;/root/repo/base/metrics/CMakeLists.txt;0;")
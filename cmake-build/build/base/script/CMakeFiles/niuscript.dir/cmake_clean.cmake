@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niuscript.dir/script.cpp.o"
+  "CMakeFiles/niuscript.dir/script.cpp.o.d"
+  "libniuscript.a"
+  "libniuscript.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niuscript.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
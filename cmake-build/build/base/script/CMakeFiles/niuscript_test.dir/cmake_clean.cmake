@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niuscript_test.dir/test.cpp.o"
+  "CMakeFiles/niuscript_test.dir/test.cpp.o.d"
+  "niuscript_test"
+  "niuscript_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niuscript_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
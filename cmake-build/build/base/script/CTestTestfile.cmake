@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/script
+# Build directory: /root/repo/cmake-build/build/base/script
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niuscript_test "/root/repo/cmake-build/build/base/script/niuscript_test")
+set_tests_properties(niuscript_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/script/CMakeLists.txt;10;add_test;/root/repo/base/script/CMakeLists.txt;0;")
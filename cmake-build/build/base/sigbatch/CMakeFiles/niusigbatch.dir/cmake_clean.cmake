@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niusigbatch.dir/sigbatch.cpp.o"
+  "CMakeFiles/niusigbatch.dir/sigbatch.cpp.o.d"
+  "libniusigbatch.a"
+  "libniusigbatch.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niusigbatch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
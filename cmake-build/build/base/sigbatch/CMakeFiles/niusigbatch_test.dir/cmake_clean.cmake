@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niusigbatch_test.dir/test.cpp.o"
+  "CMakeFiles/niusigbatch_test.dir/test.cpp.o.d"
+  "niusigbatch_test"
+  "niusigbatch_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niusigbatch_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
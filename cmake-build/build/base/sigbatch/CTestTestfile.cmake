@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/sigbatch
+# Build directory: /root/repo/cmake-build/build/base/sigbatch
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niusigbatch_test "/root/repo/cmake-build/build/base/sigbatch/niusigbatch_test")
+set_tests_properties(niusigbatch_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/sigbatch/CMakeLists.txt;19;add_test;/root/repo/base/sigbatch/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niusighash.dir/sighash.cpp.o"
+  "CMakeFiles/niusighash.dir/sighash.cpp.o.d"
+  "libniusighash.a"
+  "libniusighash.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niusighash.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
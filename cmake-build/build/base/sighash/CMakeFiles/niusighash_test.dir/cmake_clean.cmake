@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niusighash_test.dir/test.cpp.o"
+  "CMakeFiles/niusighash_test.dir/test.cpp.o.d"
+  "niusighash_test"
+  "niusighash_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niusighash_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/sighash
+# Build directory: /root/repo/cmake-build/build/base/sighash
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niusighash_test "/root/repo/cmake-build/build/base/sighash/niusighash_test")
+set_tests_properties(niusighash_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/sighash/CMakeLists.txt;11;add_test;/root/repo/base/sighash/CMakeLists.txt;0;")
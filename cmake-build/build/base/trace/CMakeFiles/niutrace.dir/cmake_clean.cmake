@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niutrace.dir/trace.cpp.o"
+  "CMakeFiles/niutrace.dir/trace.cpp.o.d"
+  "libniutrace.a"
+  "libniutrace.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niutrace.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
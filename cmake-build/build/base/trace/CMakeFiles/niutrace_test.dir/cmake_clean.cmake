@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/niutrace_test.dir/test.cpp.o"
+  "CMakeFiles/niutrace_test.dir/test.cpp.o.d"
+  "niutrace_test"
+  "niutrace_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/niutrace_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/base/trace
+# Build directory: /root/repo/cmake-build/build/base/trace
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(niutrace_test "/root/repo/cmake-build/build/base/trace/niutrace_test")
+set_tests_properties(niutrace_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/base/trace/CMakeLists.txt;11;add_test;/root/repo/base/trace/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/cmake-build/out/example/bench/bench"
+  "/root/repo/cmake-build/out/example/bench/bench.pdb"
+  "CMakeFiles/bench.dir/bench_niublock.cpp.o"
+  "CMakeFiles/bench.dir/bench_niublock.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,31 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/example/bench/arith_uint256.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/arith_uint256.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/arith_uint256.cpp.o.d"
+  "/root/repo/example/bench/bench.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/bench.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/bench.cpp.o.d"
+  "/root/repo/example/bench/blockstore.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/blockstore.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/blockstore.cpp.o.d"
+  "/root/repo/example/bench/blockview.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/blockview.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/blockview.cpp.o.d"
+  "/root/repo/example/bench/chainindex.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/chainindex.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/chainindex.cpp.o.d"
+  "/root/repo/example/bench/coins.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/coins.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/coins.cpp.o.d"
+  "/root/repo/example/bench/ecdsa.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/ecdsa.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/ecdsa.cpp.o.d"
+  "/root/repo/example/bench/format.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/format.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/format.cpp.o.d"
+  "/root/repo/example/bench/logging.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/logging.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/logging.cpp.o.d"
+  "/root/repo/example/bench/merkle.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/merkle.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/merkle.cpp.o.d"
+  "/root/repo/example/bench/script.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/script.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/script.cpp.o.d"
+  "/root/repo/example/bench/sighash.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/sighash.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/sighash.cpp.o.d"
+  "/root/repo/example/bench/strencodings.cpp" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/strencodings.cpp.o" "gcc" "/root/repo/cmake-build/build/example/bench/CMakeFiles/bench_cases.dir/strencodings.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_cases.dir/arith_uint256.cpp.o"
+  "CMakeFiles/bench_cases.dir/arith_uint256.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/bench.cpp.o"
+  "CMakeFiles/bench_cases.dir/bench.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/blockstore.cpp.o"
+  "CMakeFiles/bench_cases.dir/blockstore.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/blockview.cpp.o"
+  "CMakeFiles/bench_cases.dir/blockview.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/chainindex.cpp.o"
+  "CMakeFiles/bench_cases.dir/chainindex.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/coins.cpp.o"
+  "CMakeFiles/bench_cases.dir/coins.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/ecdsa.cpp.o"
+  "CMakeFiles/bench_cases.dir/ecdsa.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/format.cpp.o"
+  "CMakeFiles/bench_cases.dir/format.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/logging.cpp.o"
+  "CMakeFiles/bench_cases.dir/logging.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/merkle.cpp.o"
+  "CMakeFiles/bench_cases.dir/merkle.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/script.cpp.o"
+  "CMakeFiles/bench_cases.dir/script.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/sighash.cpp.o"
+  "CMakeFiles/bench_cases.dir/sighash.cpp.o.d"
+  "CMakeFiles/bench_cases.dir/strencodings.cpp.o"
+  "CMakeFiles/bench_cases.dir/strencodings.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_cases.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
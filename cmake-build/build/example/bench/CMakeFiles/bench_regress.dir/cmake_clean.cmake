@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/cmake-build/out/example/bench/bench_regress"
+  "/root/repo/cmake-build/out/example/bench/bench_regress.pdb"
+  "CMakeFiles/bench_regress.dir/perf_regress.cpp.o"
+  "CMakeFiles/bench_regress.dir/perf_regress.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_regress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/perf_regress"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/perf_regress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/cmake-build/out/example/logdecode/logdecode"
+  "/root/repo/cmake-build/out/example/logdecode/logdecode.pdb"
+  "CMakeFiles/logdecode.dir/logdecode.cpp.o"
+  "CMakeFiles/logdecode.dir/logdecode.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/logdecode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
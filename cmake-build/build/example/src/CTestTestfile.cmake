@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/example/src
+# Build directory: /root/repo/cmake-build/build/example/src
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/example/test
+# Build directory: /root/repo/cmake-build/build/example/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
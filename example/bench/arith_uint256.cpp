@@ -0,0 +1,104 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "arith_uint256.h"
+#include "uint256.h"
+
+static const arith_uint256 A = UintToArith256(uint256S("7d1de5eaf9b156d53208f033b5aa8122d2d2355d5e12292b121156cfdb4a529c"));
+static const arith_uint256 B = UintToArith256(uint256S("00000000000000000004f0e3c92f5bf44bdbbe68ffc67cb4b2d4b3c7b9f0f5a1"));
+
+static void ArithAdd(benchmark::State& state)
+{
+    arith_uint256 x = A;
+    while (state.KeepRunning()) {
+        x += B;
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+static void ArithMultiply(benchmark::State& state)
+{
+    arith_uint256 x = A;
+    while (state.KeepRunning()) {
+        x *= B;
+        x |= 1;
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+static void ArithMultiply32(benchmark::State& state)
+{
+    arith_uint256 x = A;
+    while (state.KeepRunning()) {
+        x *= 0x9e3779b9u;
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+static void ArithDivide(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        arith_uint256 x = A;
+        x /= B;
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+static void ArithShift(benchmark::State& state)
+{
+    arith_uint256 x = A;
+    unsigned int shift = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(x << (shift++ & 255));
+    }
+}
+
+static void ArithCompare(benchmark::State& state)
+{
+    arith_uint256 x = A, y = A;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(x < y);
+        benchmark::DoNotOptimize(x == y);
+    }
+}
+
+// Block header bits <-> target, as in proof of work checks
+static void ArithCompact(benchmark::State& state)
+{
+    arith_uint256 target;
+    uint32_t bits = 0x1803a30c;
+    while (state.KeepRunning()) {
+        target.SetCompact(bits);
+        bits = target.GetCompact();
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+static void ArithGetHex(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(A.GetHex());
+    }
+}
+
+static void Uint256SetHex(benchmark::State& state)
+{
+    uint256 x;
+    while (state.KeepRunning()) {
+        x.SetHex("000000000000000000b2aa11d4c8d9d4ad6f3bd3fd6a5d0fce79aa6df3a16b29");
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+BENCHMARK(ArithAdd);
+BENCHMARK(ArithMultiply);
+BENCHMARK(ArithMultiply32);
+BENCHMARK(ArithDivide);
+BENCHMARK(ArithShift);
+BENCHMARK(ArithCompare);
+BENCHMARK(ArithCompact);
+BENCHMARK(ArithGetHex);
+BENCHMARK(Uint256SetHex);
@@ -0,0 +1,239 @@
+// Copyright (c) 2015-2016 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "tinyformat.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sched.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace benchmark {
+
+static double gettimedouble()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+CycleCounter::CycleCounter()
+    : m_fd(-1), m_source("none")
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (m_fd >= 0) {
+        m_source = "perf";
+        return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    m_source = "tsc";
+#endif
+}
+
+CycleCounter::~CycleCounter()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+uint64_t CycleCounter::Read() const
+{
+    if (m_fd >= 0) {
+        uint64_t count = 0;
+        if (read(m_fd, &count, sizeof(count)) == sizeof(count))
+            return count;
+        return 0;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+State::State(const std::string& name, const Options& options, const CycleCounter& counter)
+    : m_name(name), m_options(options), m_counter(counter),
+      m_countdown(1), m_batch(1), m_warming(true), m_iterations(0),
+      m_start_time(0), m_batch_time(0), m_batch_cycles(0)
+{
+}
+
+bool State::NextBatch()
+{
+    const double now = gettimedouble();
+    const uint64_t cycles = m_counter.Read();
+    // Aim for a few hundred samples per benchmark
+    const double target = m_options.min_time / 200;
+
+    if (m_start_time == 0) {
+        m_start_time = now;
+    } else {
+        const double elapsed = now - m_batch_time;
+        if (m_warming) {
+            // Grow the batch until one takes about target seconds
+            if (elapsed < target)
+                m_batch = std::min(m_batch * 2, std::max<uint64_t>(1, m_batch * target / std::max(elapsed, 1e-9)));
+            if (now - m_start_time >= m_options.warmup_time) {
+                m_warming = false;
+                m_start_time = now;
+            }
+        } else {
+            m_ns.push_back(elapsed * 1e9 / m_batch);
+            m_cycles.push_back(double(cycles - m_batch_cycles) / m_batch);
+            m_iterations += m_batch;
+            if (now - m_start_time >= m_options.min_time || m_ns.size() >= m_options.max_samples)
+                return false;
+        }
+    }
+
+    m_countdown = m_batch;
+    m_batch_cycles = m_counter.Read();
+    m_batch_time = gettimedouble();
+    return true;
+}
+
+static Summary Summarize(std::vector<double> samples)
+{
+    Summary s = {0, 0, 0, 0, 0, 0};
+    if (samples.empty())
+        return s;
+    std::sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+    double sum = 0;
+    for (double v : samples)
+        sum += v;
+    s.min = samples.front();
+    s.max = samples.back();
+    s.mean = sum / n;
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    s.p90 = samples[std::min(n - 1, size_t(0.90 * (n - 1) + 0.5))];
+    s.p99 = samples[std::min(n - 1, size_t(0.99 * (n - 1) + 0.5))];
+    return s;
+}
+
+Result State::GetResult() const
+{
+    Result r;
+    r.name = m_name;
+    r.iterations = m_iterations;
+    r.samples = m_ns.size();
+    r.ns = Summarize(m_ns);
+    r.cycles = Summarize(m_cycles);
+    return r;
+}
+
+BenchRunner::BenchmarkMap& BenchRunner::benchmarks()
+{
+    static std::map<std::string, BenchFunction> benchmarks_map;
+    return benchmarks_map;
+}
+
+BenchRunner::BenchRunner(std::string name, BenchFunction func)
+{
+    benchmarks().insert(std::make_pair(name, func));
+}
+
+std::vector<Result> BenchRunner::RunAll(const std::string& filter, const Options& options,
+                                        const CycleCounter& counter)
+{
+    std::vector<Result> results;
+    const std::regex re(filter);
+    for (const auto& p : benchmarks()) {
+        if (!std::regex_search(p.first, re))
+            continue;
+        State state(p.first, options, counter);
+        p.second(state);
+        results.push_back(state.GetResult());
+    }
+    return results;
+}
+
+std::vector<std::string> BenchRunner::List()
+{
+    std::vector<std::string> names;
+    for (const auto& p : benchmarks())
+        names.push_back(p.first);
+    return names;
+}
+
+void PrintConsole(const std::vector<Result>& results, const CycleCounter& counter)
+{
+    std::cout << strprintf("%-32s %12s %10s %10s %10s %10s %10s\n", "# benchmark", "iterations",
+                           "min(ns)", "median(ns)", "p90(ns)", "p99(ns)",
+                           strprintf("%s/op", counter.Source()));
+    for (const Result& r : results) {
+        std::cout << strprintf("%-32s %12u %10.1f %10.1f %10.1f %10.1f %10.1f\n", r.name, r.iterations,
+                               r.ns.min, r.ns.median, r.ns.p90, r.ns.p99, r.cycles.median);
+    }
+}
+
+static std::string JsonSummary(const Summary& s)
+{
+    return strprintf("{\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+                     s.min, s.median, s.mean, s.p90, s.p99, s.max);
+}
+
+bool WriteJson(const std::string& path, const std::vector<Result>& results, const CycleCounter& counter, int cpu)
+{
+    std::ofstream out(path.c_str());
+    if (!out)
+        return false;
+    out << "{\n  \"cycle_source\": \"" << counter.Source() << "\",\n";
+    out << "  \"cpu\": " << cpu << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        // Benchmark names are C identifiers, nothing to escape
+        out << strprintf("    {\"name\": \"%s\", \"iterations\": %u, \"samples\": %u,\n"
+                         "     \"ns_per_op\": %s,\n     \"cycles_per_op\": %s}%s\n",
+                         r.name, r.iterations, r.samples, JsonSummary(r.ns), JsonSummary(r.cycles),
+                         i + 1 < results.size() ? "," : "");
+    }
+    out << "  ]\n}\n";
+    return bool(out);
+}
+
+bool WriteCsv(const std::string& path, const std::vector<Result>& results)
+{
+    std::ofstream out(path.c_str());
+    if (!out)
+        return false;
+    out << "name,iterations,samples,ns_min,ns_median,ns_mean,ns_p90,ns_p99,ns_max,"
+           "cycles_min,cycles_median,cycles_p90,cycles_p99\n";
+    for (const Result& r : results) {
+        out << strprintf("%s,%u,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f\n",
+                         r.name, r.iterations, r.samples,
+                         r.ns.min, r.ns.median, r.ns.mean, r.ns.p90, r.ns.p99, r.ns.max,
+                         r.cycles.min, r.cycles.median, r.cycles.p90, r.cycles.p99);
+    }
+    return bool(out);
+}
+
+bool PinToCpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2015-2016 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NIUBLOCK_BENCH_BENCH_H
+#define NIUBLOCK_BENCH_BENCH_H
+
+#include <functional>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Simple micro-benchmarking framework; API mostly matches a subset of the Google Benchmark
+// framework (see https://github.com/google/benchmark)
+// Why not use the Google Benchmark framework? Because adding Yet Another Dependency
+// (that uses cmake as its build system and has lots of features we don't need) isn't
+// worth it.
+
+/*
+ * Usage:
+
+static void CODE_TO_TIME(benchmark::State& state)
+{
+    ... do any setup needed...
+    while (state.KeepRunning()) {
+       ... do stuff you want to time...
+    }
+    ... do any cleanup needed...
+}
+
+BENCHMARK(CODE_TO_TIME);
+
+ */
+
+namespace benchmark {
+
+/** Keep the compiler from optimising away a computed value */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Keep the compiler from caching memory across this point */
+inline void ClobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+/** Per-thread cycle counter: perf_event_open() CPU cycles where the kernel
+ *  allows it, otherwise the time stamp counter, otherwise nothing. */
+class CycleCounter
+{
+public:
+    CycleCounter();
+    ~CycleCounter();
+
+    uint64_t Read() const;
+    /** "perf", "tsc" or "none" */
+    const char* Source() const { return m_source; }
+
+private:
+    int m_fd;
+    const char* m_source;
+};
+
+struct Options
+{
+    double min_time = 0.5;      //!< seconds of measurement per benchmark
+    double warmup_time = 0.1;   //!< seconds run before measuring
+    size_t max_samples = 1000;
+};
+
+/** Distribution of per-operation cost over the samples of one benchmark */
+struct Summary
+{
+    double min, median, mean, p90, p99, max;
+};
+
+struct Result
+{
+    std::string name;
+    uint64_t iterations;
+    size_t samples;
+    Summary ns;                 //!< nanoseconds per operation
+    Summary cycles;             //!< cycles per operation, zero without a counter
+};
+
+class State
+{
+public:
+    State(const std::string& name, const Options& options, const CycleCounter& counter);
+
+    bool KeepRunning()
+    {
+        if (--m_countdown != 0)
+            return true;
+        return NextBatch();
+    }
+
+    /** Called by the runner once KeepRunning() returned false */
+    Result GetResult() const;
+
+private:
+    bool NextBatch();
+
+    std::string m_name;
+    const Options& m_options;
+    const CycleCounter& m_counter;
+
+    uint64_t m_countdown;
+    uint64_t m_batch;
+    bool m_warming;
+    uint64_t m_iterations;
+    double m_start_time;
+    double m_batch_time;
+    uint64_t m_batch_cycles;
+    std::vector<double> m_ns;
+    std::vector<double> m_cycles;
+};
+
+typedef std::function<void(State&)> BenchFunction;
+
+class BenchRunner
+{
+    typedef std::map<std::string, BenchFunction> BenchmarkMap;
+    static BenchmarkMap& benchmarks();
+
+public:
+    BenchRunner(std::string name, BenchFunction func);
+
+    /** Run the benchmarks whose name matches filter (a regular expression) */
+    static std::vector<Result> RunAll(const std::string& filter, const Options& options,
+                                      const CycleCounter& counter);
+    static std::vector<std::string> List();
+};
+
+/** Write results as a table, JSON or CSV */
+void PrintConsole(const std::vector<Result>& results, const CycleCounter& counter);
+bool WriteJson(const std::string& path, const std::vector<Result>& results, const CycleCounter& counter, int cpu);
+bool WriteCsv(const std::string& path, const std::vector<Result>& results);
+
+/** Pin the calling thread to one CPU; returns false if not permitted */
+bool PinToCpu(int cpu);
+
+}
+
+// BENCHMARK(foo) expands to:  benchmark::BenchRunner bench_11foo("foo", foo);
+#define BENCHMARK_CAT2(a, b) a ## b
+#define BENCHMARK_CAT(a, b) BENCHMARK_CAT2(a, b)
+#define BENCHMARK(n) \
+    benchmark::BenchRunner BENCHMARK_CAT(bench_, BENCHMARK_CAT(__LINE__, n))(#n, n);
+
+#endif // NIUBLOCK_BENCH_BENCH_H
@@ -0,0 +1,80 @@
+// Copyright (c) 2015-2016 The Bitcoin Core developers
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include <iostream>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void Usage()
+{
+    fprintf(stderr,
+            "Usage: bench [options]\n"
+            "  -list            print the benchmark names and exit\n"
+            "  -filter=<regex>  run only benchmarks matching the regular expression\n"
+            "  -time=<ms>       measurement time per benchmark (default: 500)\n"
+            "  -warmup=<ms>     warmup time per benchmark (default: 100)\n"
+            "  -cpu=<n>         pin to CPU n, -1 to not pin (default: current CPU)\n"
+            "  -json=<file>     write results as JSON\n"
+            "  -csv=<file>      write results as CSV\n");
+}
+
+static bool GetArg(const char* arg, const char* name, std::string& value)
+{
+    const size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0 || arg[len] != '=')
+        return false;
+    value = arg + len + 1;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    benchmark::Options options;
+    std::string filter = ".*", json, csv, value;
+    int cpu = sched_getcpu();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-list") == 0) {
+            for (const std::string& name : benchmark::BenchRunner::List())
+                std::cout << name << "\n";
+            return 0;
+        } else if (GetArg(argv[i], "-filter", value)) {
+            filter = value;
+        } else if (GetArg(argv[i], "-time", value)) {
+            options.min_time = atof(value.c_str()) / 1000;
+        } else if (GetArg(argv[i], "-warmup", value)) {
+            options.warmup_time = atof(value.c_str()) / 1000;
+        } else if (GetArg(argv[i], "-cpu", value)) {
+            cpu = atoi(value.c_str());
+        } else if (GetArg(argv[i], "-json", value)) {
+            json = value;
+        } else if (GetArg(argv[i], "-csv", value)) {
+            csv = value;
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+
+    if (cpu >= 0 && !benchmark::PinToCpu(cpu)) {
+        fprintf(stderr, "bench: cannot pin to CPU %d, running unpinned\n", cpu);
+        cpu = -1;
+    }
+    benchmark::CycleCounter counter;
+    const std::vector<benchmark::Result> results = benchmark::BenchRunner::RunAll(filter, options, counter);
+    benchmark::PrintConsole(results, counter);
+    if (!json.empty() && !benchmark::WriteJson(json, results, counter, cpu)) {
+        fprintf(stderr, "bench: cannot write %s\n", json.c_str());
+        return 1;
+    }
+    if (!csv.empty() && !benchmark::WriteCsv(csv, results)) {
+        fprintf(stderr, "bench: cannot write %s\n", csv.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// libbitcoin hashing and serialisation. Built only when the prebuilt
+// libbitcoin.a is present, see CMakeLists.txt.
+
+#include "bench.h"
+
+#include "bitcoinmerkle.h"
+
+#include <bitcoin/bitcoin.hpp>
+
+static bc::data_chunk Data(size_t size)
+{
+    bc::data_chunk data(size);
+    for (size_t i = 0; i < size; i++)
+        data[i] = (uint8_t)(i * 131 + 7);
+    return data;
+}
+
+static void BitcoinSha256_32(benchmark::State& state)
+{
+    const bc::data_chunk data = Data(32);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(bc::sha256_hash(data));
+    }
+}
+
+static void BitcoinSha256_1M(benchmark::State& state)
+{
+    const bc::data_chunk data = Data(1024 * 1024);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(bc::sha256_hash(data));
+    }
+}
+
+// Double SHA-256 of a block header, the proof of work hash
+static void BitcoinHash80(benchmark::State& state)
+{
+    const bc::data_chunk data = Data(80);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(bc::bitcoin_hash(data));
+    }
+}
+
+static void BitcoinRipemd160_32(benchmark::State& state)
+{
+    const bc::data_chunk data = Data(32);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(bc::ripemd160_hash(data));
+    }
+}
+
+static void BitcoinHeaderSerialize(benchmark::State& state)
+{
+    const bc::chain::header header = bc::chain::block::genesis_mainnet().header();
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(header.to_data());
+    }
+}
+
+static void BitcoinHeaderDeserialize(benchmark::State& state)
+{
+    const bc::data_chunk data = bc::chain::block::genesis_mainnet().header().to_data();
+    bc::chain::header header;
+    while (state.KeepRunning()) {
+        header.from_data(data);
+        benchmark::DoNotOptimize(header);
+    }
+}
+
+static void BitcoinBlockDeserialize(benchmark::State& state)
+{
+    const bc::data_chunk data = bc::chain::block::genesis_mainnet().to_data();
+    while (state.KeepRunning()) {
+        bc::chain::block block;
+        block.from_data(data);
+        benchmark::DoNotOptimize(block);
+    }
+}
+
+static bc::chain::block BlockWithTransactions(size_t count)
+{
+    bc::chain::transaction::list txs(count);
+    for (size_t i = 0; i < count; i++)
+        txs[i].set_locktime(uint32_t(i));
+    bc::chain::block block;
+    block.set_transactions(std::move(txs));
+    // Transaction hashes are cached from here on
+    block.generate_merkle_root();
+    return block;
+}
+
+// One pair at a time, against the batched ComputeMerkleRoot()
+static void BitcoinMerkleRoot2000(benchmark::State& state)
+{
+    const bc::chain::block block = BlockWithTransactions(2000);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(block.generate_merkle_root());
+    }
+}
+
+static void BitcoinBlockMerkleRoot2000(benchmark::State& state)
+{
+    const bc::chain::block block = BlockWithTransactions(2000);
+    bool mutated;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(BlockMerkleRoot(block, &mutated));
+    }
+}
+
+BENCHMARK(BitcoinSha256_32);
+BENCHMARK(BitcoinSha256_1M);
+BENCHMARK(BitcoinHash80);
+BENCHMARK(BitcoinRipemd160_32);
+BENCHMARK(BitcoinHeaderSerialize);
+BENCHMARK(BitcoinHeaderDeserialize);
+BENCHMARK(BitcoinBlockDeserialize);
+BENCHMARK(BitcoinMerkleRoot2000);
+BENCHMARK(BitcoinBlockMerkleRoot2000);
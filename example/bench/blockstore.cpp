@@ -0,0 +1,136 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "blockstore.h"
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+void Put32(std::vector<unsigned char>& out, uint32_t x)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((unsigned char)(x >> (8 * i)));
+}
+
+/** A chain of count blocks of 2000 two-in, two-out transactions, about
+ *  750 kB each */
+std::vector<std::vector<unsigned char>> Chain(size_t count)
+{
+    std::vector<std::vector<unsigned char>> blocks;
+    uint256 prev;
+    for (size_t height = 0; height < count; height++) {
+        std::vector<unsigned char> block(76, 0);
+        memcpy(block.data() + 4, prev.begin(), 32);
+        Put32(block, (uint32_t)height);
+        block.insert(block.end(), {0xfd, 2000 & 0xff, 2000 >> 8});
+        for (size_t t = 0; t < 2000; t++) {
+            Put32(block, 1);
+            block.push_back(2);
+            for (int i = 0; i < 2; i++) {
+                block.insert(block.end(), 32, (unsigned char)t);
+                Put32(block, i);
+                block.push_back(1 + 72 + 1 + 33);
+                block.push_back(72);
+                block.insert(block.end(), 72, 0x30);
+                block.push_back(33);
+                block.insert(block.end(), 33, 0x02);
+                Put32(block, 0xffffffff);
+            }
+            block.push_back(2);
+            for (int i = 0; i < 2; i++) {
+                Put32(block, 50000 + i);
+                Put32(block, 0);
+                block.push_back(25);
+                block.insert(block.end(), {OP_DUP, OP_HASH160, 20});
+                block.insert(block.end(), 20, (unsigned char)i);
+                block.insert(block.end(), {OP_EQUALVERIFY, OP_CHECKSIG});
+            }
+            Put32(block, 0);
+        }
+        prev = NiuChain::HeaderView(block.data()).hash();
+        blocks.push_back(std::move(block));
+    }
+    return blocks;
+}
+
+/** A store in a new directory under /tmp, removed again on destruction */
+class TempStore
+{
+public:
+    TempStore()
+    {
+        char dir[] = "/tmp/niublockbenchXXXXXX";
+        if (!mkdtemp(dir) || !store.Open(dir))
+            abort();
+        m_dir = dir;
+    }
+    ~TempStore()
+    {
+        const size_t segments = store.SegmentCount();
+        store.Close();
+        unlink((m_dir + "/index.dat").c_str());
+        for (size_t i = 0; i < segments; i++) {
+            char name[32];
+            snprintf(name, sizeof(name), "/blk%05u.dat", (unsigned int)i);
+            unlink((m_dir + name).c_str());
+        }
+        rmdir(m_dir.c_str());
+    }
+
+    NiuChain::BlockStore store;
+
+private:
+    std::string m_dir;
+};
+
+} // namespace
+
+/** Read a random stored block and parse it from the mapping, no copy */
+static void BlockStoreReadParse(benchmark::State& state)
+{
+    const std::vector<std::vector<unsigned char>> blocks = Chain(32);
+    TempStore temp;
+    for (const std::vector<unsigned char>& block : blocks) {
+        if (!temp.store.Append(block.data(), block.size()))
+            abort();
+    }
+    if (!temp.store.Commit())
+        abort();
+    std::mt19937 random(42);
+    NiuChain::BlockView view;
+    while (state.KeepRunning()) {
+        if (!temp.store.Read(random() % blocks.size(), view))
+            abort();
+        benchmark::DoNotOptimize(view.total_inputs());
+    }
+}
+
+/** Append a 750 kB block and commit it, one fdatasync each */
+static void BlockStoreAppendCommit(benchmark::State& state)
+{
+    const std::vector<std::vector<unsigned char>> blocks = Chain(32);
+    TempStore temp;
+    size_t height = 0;
+    while (state.KeepRunning()) {
+        if (height == blocks.size()) {
+            if (!temp.store.Rewind(0))
+                abort();
+            height = 0;
+        }
+        if (!temp.store.Append(blocks[height].data(), blocks[height].size()) || !temp.store.Commit())
+            abort();
+        height++;
+    }
+}
+
+BENCHMARK(BlockStoreReadParse);
+BENCHMARK(BlockStoreAppendCommit);
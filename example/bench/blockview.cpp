@@ -0,0 +1,64 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "blockview.h"
+
+#include <stdlib.h>
+#include <vector>
+
+static void Put32(std::vector<unsigned char>& out, uint32_t x)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((unsigned char)(x >> (8 * i)));
+}
+
+/** A block of count two-in, two-out P2PKH transactions, about 370 bytes each */
+static std::vector<unsigned char> Block(size_t count)
+{
+    std::vector<unsigned char> block(80, 0);
+    block.push_back(0xfd);
+    block.push_back((unsigned char)count);
+    block.push_back((unsigned char)(count >> 8));
+    for (size_t t = 0; t < count; t++) {
+        Put32(block, 1);
+        block.push_back(2);
+        for (int i = 0; i < 2; i++) {
+            block.insert(block.end(), 32, (unsigned char)t);
+            Put32(block, i);
+            block.push_back(1 + 72 + 1 + 33);
+            block.push_back(72);
+            block.insert(block.end(), 72, 0x30);
+            block.push_back(33);
+            block.insert(block.end(), 33, 0x02);
+            Put32(block, 0xffffffff);
+        }
+        block.push_back(2);
+        for (int i = 0; i < 2; i++) {
+            Put32(block, 50000 + i);
+            Put32(block, 0);
+            block.push_back(25);
+            block.insert(block.end(), {OP_DUP, OP_HASH160, 20});
+            block.insert(block.end(), 20, (unsigned char)i);
+            block.insert(block.end(), {OP_EQUALVERIFY, OP_CHECKSIG});
+        }
+        Put32(block, 0);
+    }
+    return block;
+}
+
+/** Parse a block of 2000 transactions in place, reusing the arena */
+static void BlockViewParse2000(benchmark::State& state)
+{
+    const std::vector<unsigned char> raw = Block(2000);
+    NiuChain::BlockView block;
+    while (state.KeepRunning()) {
+        if (!block.Parse(raw.data(), raw.size()))
+            abort();
+        benchmark::DoNotOptimize(block.total_inputs());
+    }
+}
+
+BENCHMARK(BlockViewParse2000);
@@ -0,0 +1,92 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chainindex.h"
+
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+using NiuChain::ChainIndex;
+using NiuChain::HeaderId;
+
+namespace {
+
+/** Extend id's chain by count regtest difficulty headers */
+HeaderId Extend(ChainIndex& index, HeaderId id, int count, uint32_t nonce)
+{
+    unsigned char header[NiuChain::HEADER_SIZE] = {1};
+    for (int i = 0; i < count; i++) {
+        const uint256 prev = id == NiuChain::NO_HEADER ? uint256() : index.GetHash(id);
+        memcpy(header + 4, prev.begin(), 32);
+        const uint32_t fields[3] = {1500000000 + 600 * (uint32_t)index.Size(), 0x207fffff, nonce};
+        for (int f = 0; f < 3; f++)
+            for (int b = 0; b < 4; b++)
+                header[68 + 4 * f + b] = (unsigned char)(fields[f] >> (8 * b));
+        id = index.AddHeader(header);
+        if (id == NiuChain::NO_HEADER)
+            abort();
+    }
+    return id;
+}
+
+/** 200,000 headers, and a fork of 50,000 off the most-work chain */
+void Build(ChainIndex& index, HeaderId& fork)
+{
+    const HeaderId genesis = Extend(index, NiuChain::NO_HEADER, 1, 0);
+    Extend(index, genesis, 200000, 1);
+    fork = Extend(index, index[140000], 50000, 2);
+}
+
+} // namespace
+
+/** An ancestor at a random height of a header off the most-work chain,
+ *  through the skip pointers */
+static void ChainIndexAncestorFork(benchmark::State& state)
+{
+    ChainIndex index;
+    HeaderId fork;
+    Build(index, fork);
+    std::mt19937 random(42);
+    while (state.KeepRunning())
+        benchmark::DoNotOptimize(index.GetAncestor(fork, random() % 190000));
+}
+
+/** The tip's block locator, from the height array */
+static void ChainIndexLocator(benchmark::State& state)
+{
+    ChainIndex index;
+    HeaderId fork;
+    Build(index, fork);
+    while (state.KeepRunning())
+        benchmark::DoNotOptimize(index.GetLocator().size());
+}
+
+/** Start up from a snapshot of 250,000 headers */
+static void ChainIndexLoadSnapshot(benchmark::State& state)
+{
+    ChainIndex index;
+    HeaderId fork;
+    Build(index, fork);
+    char dir[] = "/tmp/niuchainbenchXXXXXX";
+    if (!mkdtemp(dir))
+        abort();
+    const std::string path = std::string(dir) + "/headers.dat";
+    if (!index.WriteSnapshot(path))
+        abort();
+    ChainIndex loaded;
+    while (state.KeepRunning()) {
+        if (!loaded.LoadSnapshot(path) || loaded.Tip() != index.Tip())
+            abort();
+    }
+    unlink(path.c_str());
+    rmdir(dir);
+}
+
+BENCHMARK(ChainIndexAncestorFork);
+BENCHMARK(ChainIndexLocator);
+BENCHMARK(ChainIndexLoadSnapshot);
@@ -0,0 +1,148 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "coinscache.h"
+
+#include <memory>
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using NiuChain::OutPoint;
+
+namespace {
+
+void Put32(std::vector<unsigned char>& out, uint32_t x)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((unsigned char)(x >> (8 * i)));
+}
+
+void PutCompactSize(std::vector<unsigned char>& out, size_t n)
+{
+    if (n < 253) {
+        out.push_back((unsigned char)n);
+    } else {
+        out.push_back(0xfd);
+        out.push_back((unsigned char)n);
+        out.push_back((unsigned char)(n >> 8));
+    }
+}
+
+void PutOutput(std::vector<unsigned char>& out, uint64_t amount, unsigned char seed)
+{
+    Put32(out, (uint32_t)amount);
+    Put32(out, (uint32_t)(amount >> 32));
+    if (seed & 1) {
+        out.insert(out.end(), {22, OP_0, 20});
+        out.insert(out.end(), 20, seed);
+    } else {
+        out.insert(out.end(), {25, OP_DUP, OP_HASH160, 20});
+        out.insert(out.end(), 20, seed);
+        out.insert(out.end(), {OP_EQUALVERIFY, OP_CHECKSIG});
+    }
+}
+
+/**
+ * A chain of count blocks of txs transactions, each spending two random
+ * coins of earlier blocks into two new ones.  Coinbases pay to 2 * txs
+ * outputs, so the UTXO set grows by that much per block.
+ */
+std::vector<std::vector<unsigned char>> Chain(size_t count, size_t txs)
+{
+    std::mt19937_64 random(42);
+    std::vector<OutPoint> unspent;
+    std::vector<std::vector<unsigned char>> blocks;
+    NiuChain::BlockView view;
+    for (size_t height = 0; height < count; height++) {
+        // Only the nonce differs between headers
+        std::vector<unsigned char> block(76, 0);
+        Put32(block, (uint32_t)height);
+        const size_t spending = height ? txs : 0;
+        PutCompactSize(block, spending + 1);
+
+        Put32(block, 1);
+        block.push_back(1);
+        block.insert(block.end(), 32, 0);
+        Put32(block, 0xffffffff);
+        block.push_back(4);
+        Put32(block, (uint32_t)height);
+        Put32(block, 0xffffffff);
+        PutCompactSize(block, 2 * txs);
+        for (size_t i = 0; i < 2 * txs; i++)
+            PutOutput(block, 1000000 + random() % 100000000, (unsigned char)random());
+        Put32(block, 0);
+
+        for (size_t t = 0; t < spending; t++) {
+            Put32(block, 2);
+            block.push_back(2);
+            for (int i = 0; i < 2; i++) {
+                const size_t pick = random() % unspent.size();
+                block.insert(block.end(), unspent[pick].hash.begin(), unspent[pick].hash.end());
+                Put32(block, unspent[pick].n);
+                unspent[pick] = unspent.back();
+                unspent.pop_back();
+                block.push_back(0);
+                Put32(block, 0xffffffff);
+            }
+            block.push_back(2);
+            for (int i = 0; i < 2; i++)
+                PutOutput(block, 10000 + random() % 10000000, (unsigned char)random());
+            Put32(block, 0);
+        }
+
+        if (!view.Parse(block.data(), block.size()))
+            abort();
+        for (const NiuChain::TransactionView& tx : view.transactions()) {
+            const uint256 hash = tx.hash();
+            for (size_t i = 0; i < tx.outputs().size(); i++)
+                unspent.push_back(OutPoint(hash, (uint32_t)i));
+        }
+        blocks.push_back(std::move(block));
+    }
+    return blocks;
+}
+
+} // namespace
+
+/** Connect 400-transaction blocks one after another into a cache with a
+ *  4 MB budget over a log; the tail percentiles are the flushes */
+static void CoinsReplayBlock(benchmark::State& state)
+{
+    const std::vector<std::vector<unsigned char>> blocks = Chain(200, 400);
+    char dir[] = "/tmp/niucoinsbenchXXXXXX";
+    if (!mkdtemp(dir))
+        abort();
+    const std::string path = std::string(dir) + "/coins.log";
+    NiuChain::CoinsLog log;
+    NiuChain::BlockView view;
+    std::unique_ptr<NiuChain::CoinsCache> cache;
+    size_t height = blocks.size();
+    while (state.KeepRunning()) {
+        if (height == blocks.size()) {
+            // Start the chain over on an empty set
+            cache.reset();
+            log.Close();
+            unlink(path.c_str());
+            if (!log.Open(path))
+                abort();
+            cache.reset(new NiuChain::CoinsCache(log, 4 * 1024 * 1024));
+            height = 0;
+        }
+        if (!view.Parse(blocks[height].data(), blocks[height].size()) ||
+            !NiuChain::ConnectBlock(view, *cache, (uint32_t)height) || !cache->MaybeFlush())
+            abort();
+        height++;
+    }
+    cache.reset();
+    log.Close();
+    unlink(path.c_str());
+    rmdir(dir);
+}
+
+BENCHMARK(CoinsReplayBlock);
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Signature checks with the prebuilt libsecp256k1 over a canned dataset:
+// the keys, messages and signatures are derived from fixed bytes, so every
+// run checks exactly the same signatures.
+
+#include "bench.h"
+
+#include "sigbatch.h"
+
+#include <secp256k1.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+/** The checks must run whatever NDEBUG says, so no assert() */
+void Check(int ok)
+{
+    if (!ok)
+        abort();
+}
+
+struct EcdsaEntry
+{
+    unsigned char msg[32];
+    unsigned char pubkey[33];
+    unsigned char der[72];
+    size_t der_len;
+    secp256k1_pubkey parsed_pubkey;
+    secp256k1_ecdsa_signature parsed_sig;
+};
+
+struct EcdsaDataset
+{
+    secp256k1_context* ctx;
+    std::vector<EcdsaEntry> entries;
+
+    EcdsaDataset() : ctx(secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY)), entries(64)
+    {
+        for (size_t i = 0; i < entries.size(); i++) {
+            EcdsaEntry& e = entries[i];
+            unsigned char seckey[32];
+            for (int j = 0; j < 32; j++) {
+                seckey[j] = (unsigned char)(i * 71 + j * 13 + 1);
+                e.msg[j] = (unsigned char)(i * 29 + j * 131 + 7);
+            }
+            Check(secp256k1_ec_seckey_verify(ctx, seckey));
+            Check(secp256k1_ec_pubkey_create(ctx, &e.parsed_pubkey, seckey));
+            size_t pubkey_len = sizeof(e.pubkey);
+            secp256k1_ec_pubkey_serialize(ctx, e.pubkey, &pubkey_len, &e.parsed_pubkey, SECP256K1_EC_COMPRESSED);
+            Check(secp256k1_ecdsa_sign(ctx, &e.parsed_sig, e.msg, seckey, NULL, NULL));
+            e.der_len = sizeof(e.der);
+            secp256k1_ecdsa_signature_serialize_der(ctx, e.der, &e.der_len, &e.parsed_sig);
+        }
+    }
+
+    ~EcdsaDataset()
+    {
+        secp256k1_context_destroy(ctx);
+    }
+};
+
+const EcdsaDataset& Dataset()
+{
+    static const EcdsaDataset dataset;
+    return dataset;
+}
+
+} // namespace
+
+// Verification alone, with the key and signature already parsed
+static void EcdsaVerify(benchmark::State& state)
+{
+    const EcdsaDataset& data = Dataset();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const EcdsaEntry& e = data.entries[i++ % data.entries.size()];
+        Check(secp256k1_ecdsa_verify(data.ctx, &e.parsed_sig, e.msg, &e.parsed_pubkey));
+    }
+}
+
+// What a script signature check does: parse the serialized key and the DER
+// signature, normalize to lower S and verify
+static void EcdsaVerifyDer(benchmark::State& state)
+{
+    const EcdsaDataset& data = Dataset();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        const EcdsaEntry& e = data.entries[i++ % data.entries.size()];
+        secp256k1_pubkey pubkey;
+        secp256k1_ecdsa_signature sig;
+        Check(secp256k1_ec_pubkey_parse(data.ctx, &pubkey, e.pubkey, sizeof(e.pubkey)));
+        Check(secp256k1_ecdsa_signature_parse_der(data.ctx, &sig, e.der, e.der_len));
+        secp256k1_ecdsa_signature_normalize(data.ctx, &sig, &sig);
+        Check(secp256k1_ecdsa_verify(data.ctx, &sig, e.msg, &pubkey));
+    }
+}
+
+// The whole dataset through a SignatureBatch on the calling thread
+static void EcdsaBatch64(benchmark::State& state)
+{
+    const EcdsaDataset& data = Dataset();
+    NiuSig::SignatureBatch batch;
+    while (state.KeepRunning()) {
+        batch.Clear();
+        for (const EcdsaEntry& e : data.entries)
+            batch.AddEcdsa(e.pubkey, sizeof(e.pubkey), e.msg, e.der, e.der_len);
+        Check(batch.Verify());
+    }
+}
+
+// The same with every signature already in the cache
+static void EcdsaBatch64Cached(benchmark::State& state)
+{
+    const EcdsaDataset& data = Dataset();
+    NiuSig::SignatureCache cache;
+    NiuSig::SignatureBatch batch(&cache);
+    while (state.KeepRunning()) {
+        batch.Clear();
+        for (const EcdsaEntry& e : data.entries)
+            batch.AddEcdsa(e.pubkey, sizeof(e.pubkey), e.msg, e.der, e.der_len);
+        Check(batch.Verify());
+    }
+}
+
+BENCHMARK(EcdsaVerify);
+BENCHMARK(EcdsaVerifyDer);
+BENCHMARK(EcdsaBatch64);
+BENCHMARK(EcdsaBatch64Cached);
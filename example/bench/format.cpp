@@ -0,0 +1,82 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "tinyformat.h"
+#include "uint256.h"
+#include "utilstrencodings.h"
+
+static const uint256 HASH = uint256S("000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+
+static void StrprintfInt(benchmark::State& state)
+{
+    int i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(strprintf("%d", i++));
+    }
+}
+
+// The same conversion without tinyformat, see WriteInt64()
+static void Itostr(benchmark::State& state)
+{
+    int i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(itostr(i++));
+    }
+}
+
+static void I64tostr(benchmark::State& state)
+{
+    int64_t i = 1234567890123LL;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(i64tostr(i++));
+    }
+}
+
+static void StrprintfUpdateTip(benchmark::State& state)
+{
+    int height = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(strprintf("UpdateTip: new best=%s height=%d version=0x%08x log2_work=%.8g tx=%lu\n",
+                                           HASH.GetHex(), height++, 0x20000000, 87.5, 250000000ul));
+    }
+}
+
+// Same line with a format string checked and parsed at compile time
+static void StrprintfUpdateTipStatic(benchmark::State& state)
+{
+    int height = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(strprintf(TINYFORMAT_FMT("UpdateTip: new best=%s height=%d version=0x%08x log2_work=%.8g tx=%lu\n"),
+                                           HASH.GetHex(), height++, 0x20000000, 87.5, 250000000ul));
+    }
+}
+
+static void StrprintfPadded(benchmark::State& state)
+{
+    int i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(strprintf("%-12s|%08.3f|%+6d|%x", "peer", i * 0.25, i, i));
+        i++;
+    }
+}
+
+static void FormatParagraph80(benchmark::State& state)
+{
+    const std::string text = "Bind to given address and always listen on it. Use [host]:port notation for IPv6. "
+                             "Accept connections from outside (default: 1 if no -proxy or -connect). "
+                             "Maintain at most <n> connections to peers (default: 125)";
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(FormatParagraph(text, 79, 2));
+    }
+}
+
+BENCHMARK(StrprintfInt);
+BENCHMARK(Itostr);
+BENCHMARK(I64tostr);
+BENCHMARK(StrprintfUpdateTip);
+BENCHMARK(StrprintfUpdateTipStatic);
+BENCHMARK(StrprintfPadded);
+BENCHMARK(FormatParagraph80);
@@ -0,0 +1,28 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "logging.h"
+
+// Call-site cost of LogPrintf() while the logger thread drains to
+// /dev/null. Records dropped because the ring filled up are cheaper than
+// real ones, so the ring is sized to hold a whole measurement batch.
+static void LogPrintfHash(benchmark::State& state)
+{
+    const uint256 hash = uint256S("000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+    NiuLog::LogOptions options;
+    options.file_path = "/dev/null";
+    options.max_file_size = 0;
+    options.ring_size = 64 << 20;
+    NiuLog::Logger logger;
+    logger.Start(options);
+    int height = 0;
+    while (state.KeepRunning()) {
+        logger.Log(NiuLog::NONE, "UpdateTip: new best=%s height=%d\n", hash, height++);
+    }
+    logger.Stop();
+}
+
+BENCHMARK(LogPrintfHash);
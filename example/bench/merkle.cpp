@@ -0,0 +1,85 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "merkle.h"
+#include "merkletree.h"
+#include "sha256.h"
+
+static std::vector<uint256> Txids(size_t count)
+{
+    std::vector<uint256> txids(count);
+    for (size_t i = 0; i < count; i++) {
+        unsigned char* p = txids[i].begin();
+        for (int j = 0; j < 32; j++)
+            p[j] = (unsigned char)(i * 131 + j * 7 + (i >> 8));
+    }
+    return txids;
+}
+
+static void MerkleRoot(benchmark::State& state, size_t count)
+{
+    const std::vector<uint256> txids = Txids(count);
+    bool mutated;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(ComputeMerkleRoot(txids, &mutated));
+    }
+}
+
+/** The same on the portable implementation, for comparison */
+static void MerkleRootStandard(benchmark::State& state, size_t count)
+{
+    SHA256AutoDetect(sha256_implementation::STANDARD);
+    MerkleRoot(state, count);
+    SHA256AutoDetect();
+}
+
+static void MerkleRoot2000(benchmark::State& state) { MerkleRoot(state, 2000); }
+static void MerkleRoot10000(benchmark::State& state) { MerkleRoot(state, 10000); }
+static void MerkleRoot2000Standard(benchmark::State& state) { MerkleRootStandard(state, 2000); }
+static void MerkleRoot10000Standard(benchmark::State& state) { MerkleRootStandard(state, 10000); }
+
+static void SHA256D64_1024(benchmark::State& state)
+{
+    std::vector<unsigned char> in(64 * 1024, 0x5a);
+    std::vector<unsigned char> out(32 * 1024);
+    while (state.KeepRunning()) {
+        SHA256D64(out.data(), in.data(), 1024);
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+/** A block template refresh: new coinbase, then a new root */
+static void MerkleTreeCoinbase10000(benchmark::State& state)
+{
+    MerkleTree tree(Txids(10000));
+    uint256 coinbase = tree.Leaf(0);
+    while (state.KeepRunning()) {
+        coinbase.begin()[0]++;
+        tree.Update(0, coinbase);
+        benchmark::DoNotOptimize(tree.Root());
+    }
+}
+
+/** Replacing the last transactions of the template */
+static void MerkleTreeReplaceTail10000(benchmark::State& state)
+{
+    const std::vector<uint256> txids = Txids(10016);
+    const std::vector<uint256> tail(txids.end() - 16, txids.end());
+    MerkleTree tree(std::vector<uint256>(txids.begin(), txids.end() - 16));
+    while (state.KeepRunning()) {
+        tree.Truncate(9984);
+        tree.Append(tail);
+        benchmark::DoNotOptimize(tree.Root());
+    }
+}
+
+BENCHMARK(MerkleRoot2000);
+BENCHMARK(MerkleRoot10000);
+BENCHMARK(MerkleRoot2000Standard);
+BENCHMARK(MerkleRoot10000Standard);
+BENCHMARK(MerkleTreeCoinbase10000);
+BENCHMARK(MerkleTreeReplaceTail10000);
+BENCHMARK(SHA256D64_1024);
@@ -0,0 +1,326 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Performance regression check: runs the benchmarks named in a baseline file
+// and fails when a median got slower than the baseline allows.
+//
+// Each benchmark is measured in several repetitions, interleaved with the
+// other benchmarks so that slow drift on the machine hits all of them alike.
+// The median over the repetitions is compared with the baseline median,
+// after scaling by a calibration loop so a baseline recorded on one machine
+// stays usable on another.  The allowed slowdown is the larger of the
+// -tolerance floor and three times the noise between repetitions (a robust
+// estimate of their standard deviation), in the baseline or now.  A
+// benchmark over the limit is measured a second time and only fails if it
+// is still too slow.
+
+#include "bench.h"
+
+#include "tinyformat.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <math.h>
+#include <regex>
+#include <sched.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Fixed integer workload to compare the speed of two machines
+static void PerfCalibrate(benchmark::State& state)
+{
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 256; i++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            x *= 0xff51afd7ed558ccdULL;
+        }
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+BENCHMARK(PerfCalibrate);
+
+static const char* CALIBRATION = "PerfCalibrate";
+
+namespace {
+
+struct Entry
+{
+    std::string name;
+    double median_ns;
+    double noise;           //!< see Measurement::Noise()
+};
+
+struct Baseline
+{
+    double calibration_ns;
+    std::vector<Entry> entries;
+};
+
+/** Measurement of one benchmark over all repetitions */
+struct Measurement
+{
+    std::vector<double> medians;
+
+    double Median() const
+    {
+        return MedianOf(medians);
+    }
+
+    /** Median absolute deviation of the repetitions, scaled to estimate the
+     *  standard deviation and taken relative to the median.  Unlike the
+     *  range it is not thrown by a single disturbed repetition. */
+    double Noise() const
+    {
+        const double median = Median();
+        if (median <= 0)
+            return 0;
+        std::vector<double> dev;
+        for (double v : medians)
+            dev.push_back(fabs(v - median));
+        return 1.4826 * MedianOf(dev) / median;
+    }
+
+    static double MedianOf(std::vector<double> v)
+    {
+        std::sort(v.begin(), v.end());
+        const size_t n = v.size();
+        return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    }
+};
+
+/**
+ * Read a baseline written by WriteBaseline().  This is not a general JSON
+ * parser: it picks "key": value pairs out of the file, a benchmark being
+ * the flat object that holds a "name".
+ */
+bool ReadBaseline(const std::string& path, Baseline& baseline, std::string& error)
+{
+    std::ifstream in(path.c_str());
+    if (!in) {
+        error = "cannot read " + path;
+        return false;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const std::string text = ss.str();
+
+    const std::regex object("\\{[^{}]*\\}");
+    const std::regex pair("\"(\\w+)\"\\s*:\\s*(\"([^\"]*)\"|[-+0-9.eE]+)");
+    baseline.calibration_ns = 0;
+    baseline.entries.clear();
+
+    std::smatch m;
+    if (std::regex_search(text, m, std::regex("\"calibration_ns\"\\s*:\\s*([-+0-9.eE]+)")))
+        baseline.calibration_ns = atof(m[1].str().c_str());
+    for (std::sregex_iterator it(text.begin(), text.end(), object), end; it != end; ++it) {
+        const std::string obj = it->str();
+        std::map<std::string, std::string> fields;
+        for (std::sregex_iterator p(obj.begin(), obj.end(), pair); p != end; ++p)
+            fields[(*p)[1]] = (*p)[3].matched ? (*p)[3].str() : (*p)[2].str();
+        if (!fields.count("name"))
+            continue;
+        if (!fields.count("median_ns")) {
+            error = "benchmark " + fields["name"] + " has no median_ns";
+            return false;
+        }
+        Entry e;
+        e.name = fields["name"];
+        e.median_ns = atof(fields["median_ns"].c_str());
+        e.noise = fields.count("noise") ? atof(fields["noise"].c_str()) : 0;
+        baseline.entries.push_back(e);
+    }
+    if (baseline.calibration_ns <= 0 || baseline.entries.empty()) {
+        error = path + " is not a baseline file";
+        return false;
+    }
+    return true;
+}
+
+bool WriteBaseline(const std::string& path, const Baseline& baseline, const benchmark::CycleCounter& counter)
+{
+    std::ofstream out(path.c_str());
+    if (!out)
+        return false;
+    out << "{\n  \"cycle_source\": \"" << counter.Source() << "\",\n";
+    out << strprintf("  \"calibration_ns\": %.3f,\n  \"benchmarks\": [\n", baseline.calibration_ns);
+    for (size_t i = 0; i < baseline.entries.size(); i++) {
+        const Entry& e = baseline.entries[i];
+        out << strprintf("    {\"name\": \"%s\", \"median_ns\": %.3f, \"noise\": %.4f}%s\n",
+                         e.name, e.median_ns, e.noise, i + 1 < baseline.entries.size() ? "," : "");
+    }
+    out << "  ]\n}\n";
+    return bool(out);
+}
+
+/** Median ns/op of each named benchmark in every repetition */
+std::map<std::string, Measurement> Measure(const std::vector<std::string>& names, int reps,
+                                           const benchmark::Options& options,
+                                           const benchmark::CycleCounter& counter)
+{
+    std::map<std::string, Measurement> result;
+    for (int rep = 0; rep < reps; rep++) {
+        for (const std::string& name : names) {
+            const std::vector<benchmark::Result> r = benchmark::BenchRunner::RunAll("^" + name + "$", options, counter);
+            if (!r.empty())
+                result[name].medians.push_back(r[0].ns.median);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+static void Usage()
+{
+    fprintf(stderr,
+            "Usage: bench_regress -baseline=<file> [options]\n"
+            "  -baseline=<file>  baseline JSON to compare against, or to write with -update\n"
+            "  -update           measure and write the baseline instead of comparing\n"
+            "  -filter=<regex>   with -update, the benchmarks making up the suite\n"
+            "                    (default: the ones already in the baseline)\n"
+            "  -reps=<n>         repetitions per benchmark (default: 5)\n"
+            "  -time=<ms>        measurement time per repetition (default: 200)\n"
+            "  -tolerance=<pct>  smallest slowdown reported as a regression (default: 10)\n"
+            "  -no-normalize     compare raw times, without the calibration scaling\n"
+            "  -cpu=<n>          pin to CPU n, -1 to not pin (default: current CPU)\n");
+}
+
+static bool GetArg(const char* arg, const char* name, std::string& value)
+{
+    const size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0 || arg[len] != '=')
+        return false;
+    value = arg + len + 1;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    benchmark::Options options;
+    options.min_time = 0.2;
+    options.warmup_time = 0.05;
+    std::string path, filter, value;
+    bool update = false, normalize = true;
+    int reps = 5;
+    double tolerance = 0.10;
+    int cpu = sched_getcpu();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "-no-normalize") == 0) {
+            normalize = false;
+        } else if (GetArg(argv[i], "-baseline", value)) {
+            path = value;
+        } else if (GetArg(argv[i], "-filter", value)) {
+            filter = value;
+        } else if (GetArg(argv[i], "-reps", value)) {
+            reps = std::max(1, atoi(value.c_str()));
+        } else if (GetArg(argv[i], "-time", value)) {
+            options.min_time = atof(value.c_str()) / 1000;
+        } else if (GetArg(argv[i], "-tolerance", value)) {
+            tolerance = atof(value.c_str()) / 100;
+        } else if (GetArg(argv[i], "-cpu", value)) {
+            cpu = atoi(value.c_str());
+        } else {
+            Usage();
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        Usage();
+        return 2;
+    }
+
+    Baseline baseline;
+    std::string error;
+    const bool have_baseline = ReadBaseline(path, baseline, error);
+    if (!have_baseline && !(update && !filter.empty())) {
+        fprintf(stderr, "bench_regress: %s\n", error.c_str());
+        return 2;
+    }
+
+    std::vector<std::string> names;
+    if (update && !filter.empty()) {
+        const std::regex re(filter);
+        for (const std::string& name : benchmark::BenchRunner::List()) {
+            if (name != CALIBRATION && std::regex_search(name, re))
+                names.push_back(name);
+        }
+    } else {
+        const std::vector<std::string> known = benchmark::BenchRunner::List();
+        for (const Entry& e : baseline.entries) {
+            if (!std::binary_search(known.begin(), known.end(), e.name)) {
+                fprintf(stderr, "bench_regress: benchmark %s in %s is not built into this binary\n",
+                        e.name.c_str(), path.c_str());
+                return 2;
+            }
+            names.push_back(e.name);
+        }
+    }
+
+    if (cpu >= 0 && !benchmark::PinToCpu(cpu)) {
+        fprintf(stderr, "bench_regress: cannot pin to CPU %d, running unpinned\n", cpu);
+        cpu = -1;
+    }
+    benchmark::CycleCounter counter;
+    names.insert(names.begin(), CALIBRATION);
+    std::map<std::string, Measurement> now = Measure(names, reps, options, counter);
+    names.erase(names.begin());
+    const double calibration_ns = now[CALIBRATION].Median();
+
+    if (update) {
+        Baseline updated;
+        updated.calibration_ns = calibration_ns;
+        for (const std::string& name : names) {
+            const Entry e = {name, now[name].Median(), now[name].Noise()};
+            updated.entries.push_back(e);
+            std::cout << strprintf("%-32s %10.1f ns  noise %5.1f%%\n", name, e.median_ns, e.noise * 100);
+        }
+        if (!WriteBaseline(path, updated, counter)) {
+            fprintf(stderr, "bench_regress: cannot write %s\n", path.c_str());
+            return 2;
+        }
+        std::cout << strprintf("wrote %u benchmarks to %s\n", updated.entries.size(), path);
+        return 0;
+    }
+
+    const double scale = normalize ? calibration_ns / baseline.calibration_ns : 1.0;
+    std::cout << strprintf("calibration %.1f ns, baseline %.1f ns, scale %.3f\n",
+                           calibration_ns, baseline.calibration_ns, scale);
+    std::cout << strprintf("%-32s %12s %12s %8s %8s  %s\n", "# benchmark", "expected(ns)", "median(ns)",
+                           "change", "allowed", "result");
+    int regressions = 0;
+    for (const Entry& e : baseline.entries) {
+        const double expected = e.median_ns * scale;
+        double median = now[e.name].Median();
+        const double allowed = std::max(tolerance, 3 * std::max(e.noise, now[e.name].Noise()));
+        const char* result = "ok";
+        if (median > expected * (1 + allowed)) {
+            // Confirm before failing; a one-off disturbance will not repeat
+            const std::vector<std::string> one(1, e.name);
+            median = std::min(median, Measure(one, reps, options, counter)[e.name].Median());
+            if (median > expected * (1 + allowed)) {
+                result = "REGRESSION";
+                regressions++;
+            }
+        } else if (median < expected * (1 - allowed)) {
+            result = "faster, consider -update";
+        }
+        std::cout << strprintf("%-32s %12.1f %12.1f %+7.1f%% %7.1f%%  %s\n", e.name, expected, median,
+                               (median / expected - 1) * 100, allowed * 100, result);
+    }
+    if (regressions) {
+        std::cout << strprintf("%d of %u benchmarks regressed\n", regressions, baseline.entries.size());
+        return 1;
+    }
+    return 0;
+}
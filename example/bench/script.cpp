@@ -0,0 +1,74 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "script.h"
+
+#include <vector>
+
+/** 1000 output scripts, the usual mix of templates */
+static std::vector<Script> Outputs()
+{
+    std::vector<Script> scripts;
+    for (int i = 0; i < 1000; i++) {
+        std::vector<unsigned char> bytes;
+        switch (i % 5) {
+        case 0:
+            bytes = {OP_DUP, OP_HASH160, 20};
+            bytes.resize(23, (unsigned char)i);
+            bytes.insert(bytes.end(), {OP_EQUALVERIFY, OP_CHECKSIG});
+            break;
+        case 1:
+            bytes = {OP_HASH160, 20};
+            bytes.resize(22, (unsigned char)i);
+            bytes.push_back(OP_EQUAL);
+            break;
+        case 2:
+            bytes = {OP_0, 20};
+            bytes.resize(22, (unsigned char)i);
+            break;
+        case 3:
+            bytes = {OP_0, 32};
+            bytes.resize(34, (unsigned char)i);
+            break;
+        default:
+            bytes = {OP_RETURN, 32};
+            bytes.resize(34, (unsigned char)i);
+            break;
+        }
+        scripts.emplace_back(bytes.data(), bytes.size());
+    }
+    return scripts;
+}
+
+/** Classify by bytes */
+static void ScriptMatch1000(benchmark::State& state)
+{
+    const std::vector<Script> scripts = Outputs();
+    while (state.KeepRunning()) {
+        int standard = 0;
+        for (const Script& script : scripts)
+            standard += script.View().Match() != TX_NONSTANDARD;
+        benchmark::DoNotOptimize(standard);
+    }
+}
+
+/** Decode every script to operations, as an eager parser does */
+static void ScriptDecode1000(benchmark::State& state)
+{
+    const std::vector<Script> scripts = Outputs();
+    while (state.KeepRunning()) {
+        size_t count = 0;
+        for (const Script& script : scripts) {
+            std::vector<ScriptOp> ops;
+            script.View().Decode(ops);
+            count += ops.size();
+        }
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+BENCHMARK(ScriptMatch1000);
+BENCHMARK(ScriptDecode1000);
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "sighash.h"
+
+#include <string.h>
+
+/** A transaction spending count P2PKH outputs to two outputs */
+static PrecomputedTransactionData Transaction(size_t count)
+{
+    std::vector<SighashInput> inputs(count);
+    for (size_t i = 0; i < count; i++) {
+        memset(inputs[i].prevout, (int)i, sizeof(inputs[i].prevout));
+        inputs[i].sequence = 0xffffffff;
+    }
+    std::vector<unsigned char> outputs;
+    for (int i = 0; i < 2; i++) {
+        outputs.insert(outputs.end(), 8, 0x11);
+        outputs.push_back(25);
+        outputs.insert(outputs.end(), 25, 0x76);
+    }
+    return PrecomputedTransactionData(2, 0, std::move(inputs), std::move(outputs), 2);
+}
+
+/** Every input's SIGHASH_ALL digest, precomputation included */
+static void SighashAll(benchmark::State& state, size_t count)
+{
+    const std::vector<unsigned char> script_code(25, 0xac);
+    while (state.KeepRunning()) {
+        const PrecomputedTransactionData txdata = Transaction(count);
+        for (uint32_t i = 0; i < count; i++) {
+            benchmark::DoNotOptimize(SignatureHash(txdata, i, script_code.data(), script_code.size(),
+                                                   SIGHASH_ALL, 0, SigVersion::BASE));
+        }
+    }
+}
+
+static void SighashWitnessV0(benchmark::State& state, size_t count)
+{
+    const std::vector<unsigned char> script_code(25, 0xac);
+    while (state.KeepRunning()) {
+        const PrecomputedTransactionData txdata = Transaction(count);
+        for (uint32_t i = 0; i < count; i++) {
+            benchmark::DoNotOptimize(SignatureHash(txdata, i, script_code.data(), script_code.size(),
+                                                   SIGHASH_ALL, 1000, SigVersion::WITNESS_V0));
+        }
+    }
+}
+
+static void SighashAll10(benchmark::State& state) { SighashAll(state, 10); }
+static void SighashAll500(benchmark::State& state) { SighashAll(state, 500); }
+static void SighashWitnessV0_500(benchmark::State& state) { SighashWitnessV0(state, 500); }
+
+BENCHMARK(SighashAll10);
+BENCHMARK(SighashAll500);
+BENCHMARK(SighashWitnessV0_500);
@@ -0,0 +1,84 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "utilstrencodings.h"
+
+static std::vector<unsigned char> Data(size_t size)
+{
+    std::vector<unsigned char> data(size);
+    for (size_t i = 0; i < size; i++)
+        data[i] = (unsigned char)(i * 131 + 7);
+    return data;
+}
+
+static void HexStr32(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = Data(32);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(HexStr(data));
+    }
+}
+
+static void ParseHex32(benchmark::State& state)
+{
+    const std::string hex = HexStr(Data(32));
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(ParseHex(hex));
+    }
+}
+
+static void HexEncoder1K(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = Data(1024);
+    HexEncoder encoder;
+    char out[2048];
+    while (state.KeepRunning()) {
+        encoder.Update(data.data(), data.size(), out);
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+static void EncodeBase64_1K(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = Data(1024);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(EncodeBase64(data.data(), data.size()));
+    }
+}
+
+static void DecodeBase64_1K(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = Data(1024);
+    const std::string str = EncodeBase64(data.data(), data.size());
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(DecodeBase64(str));
+    }
+}
+
+static void EncodeBase32_1K(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = Data(1024);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(EncodeBase32(data.data(), data.size()));
+    }
+}
+
+static void DecodeBase32_1K(benchmark::State& state)
+{
+    const std::vector<unsigned char> data = Data(1024);
+    const std::string str = EncodeBase32(data.data(), data.size());
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(DecodeBase32(str));
+    }
+}
+
+BENCHMARK(HexStr32);
+BENCHMARK(ParseHex32);
+BENCHMARK(HexEncoder1K);
+BENCHMARK(EncodeBase64_1K);
+BENCHMARK(DecodeBase64_1K);
+BENCHMARK(EncodeBase32_1K);
+BENCHMARK(DecodeBase32_1K);
@@ -0,0 +1,53 @@
+// Copyright (c) 2026 The NiuBlock developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Renders binary logs written with LogOptions::binary as text.
+//
+//   logdecode debug.log.1 debug.log > debug.txt
+
+#include "binarylog.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdio.h>
+
+static bool DecodeFile(const char* path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "logdecode: cannot open %s\n", path);
+        return false;
+    }
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    NiuLog::BinaryLogReader reader(data.data(), data.size());
+    std::string out;
+    out.reserve(1 << 16);
+    while (reader.Next(out)) {
+        if (out.size() >= (1 << 16) - 1024) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    if (reader.Failed()) {
+        fprintf(stderr, "logdecode: %s: %s at offset %lu\n", path, reader.Error().c_str(),
+                (unsigned long)reader.ErrorOffset());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: logdecode <binary log>...\n");
+        return 1;
+    }
+    bool ok = true;
+    for (int i = 1; i < argc; i++)
+        ok &= DecodeFile(argv[i]);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+#! /bin/sh
+#
+# Profile guided build in two stages: an instrumented build runs the
+# pgo-train workload, then the tree is rebuilt in the same directory with
+# the collected profiles.  Extra arguments go to both cmake runs, e.g.
+#
+#   ./pgo.sh -DNIUBLOCK_OPT=O3 -DNIUBLOCK_LTO=FULL
+
+set -e
+
+BUILDDIR=cmake-build
+PGODIR=$(pwd)/${BUILDDIR}/pgo
+
+if [ -d ${BUILDDIR} ]; then
+    rm -rf ${BUILDDIR}
+fi
+
+mkdir ${BUILDDIR}
+
+cd ${BUILDDIR}
+cmake .. -DNIUBLOCK_PGO=GENERATE -DNIUBLOCK_PGO_DIR=${PGODIR} "$@"
+make
+make pgo-train
+
+# clang writes raw profiles which have to be merged first
+if ls ${PGODIR}/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -output=${PGODIR}/merged.profdata ${PGODIR}/*.profraw
+fi
+
+cmake .. -DNIUBLOCK_PGO=USE -DNIUBLOCK_PGO_DIR=${PGODIR} "$@"
+make